@@ -13,6 +13,8 @@ extern int interrupt;
 extern int nmi;
 
 extern int romsel;
+extern int cycles;      /* left in the current m6502_exec() slice */
+extern bool idle_skip;
 extern uint8_t ram1k, ram4k, ram8k;
 
 void m6502_reset(void);
@@ -22,6 +24,9 @@ void dumpregs(void);
 
 uint8_t readmem(uint16_t addr);
 void writemem(uint16_t addr, uint8_t val);
+void readmem_block(uint16_t addr, uint8_t *buf, uint32_t len);
+void writemem_block(uint16_t addr, const uint8_t *buf, uint32_t len);
+void m6502_set_paging(uint8_t fe30, uint8_t fe34);
 
 void m6502_savestate(FILE *f);
 void m6502_loadstate(FILE *f);
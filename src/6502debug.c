@@ -189,6 +189,19 @@ static uint8_t am_816[256]=
 /*F0*/  PCR,  INDY, IND,  SRY,  IMP,  ZPX,  ZPX,  INDYL,IMP,  ABSY, IMP,  IMP,  ABSX, ABSX, ABSX, ABSXL
 };
 
+const char *dbg6502_op_name(uint8_t op, m6502_t model)
+{
+    switch (model)
+    {
+    case M6502:
+        return op_names[op_nmos[op]];
+    case M65C02:
+        return op_names[op_cmos[op]];
+    default:
+        return op_names[op_816[op]];
+    }
+}
+
 uint32_t dbg6502_disassemble(cpu_debug_t *cpu, uint32_t addr, char *buf, size_t bufsize, m6502_t model)
 {
     uint8_t op, ni, p1, p2, p3;
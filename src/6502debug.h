@@ -32,5 +32,6 @@ enum register_numbers {
 extern const char *dbg6502_reg_names[];
 extern size_t dbg6502_print_flags(PREG *pp, char *buf, size_t bufsize);
 extern uint32_t dbg6502_disassemble(cpu_debug_t *cpu, uint32_t addr, char *buf, size_t bufsize, m6502_t model);
+extern const char *dbg6502_op_name(uint8_t op, m6502_t model);
 
 #endif
@@ -249,6 +249,29 @@ static void tube_6502_writemem(uint32_t addr, uint8_t value) {
     do_writemem(addr, value);
 }
 
+/*Block copies for VDFS go straight to or from RAM unless the range
+  takes in the Tube registers or, for reads, the ROM while paged in.*/
+
+static void tube_6502_readblock(uint32_t addr, uint8_t *buf, uint32_t len)
+{
+    uint32_t limit = tube_6502_rom_in ? 0xF000 : 0xFEF8;
+
+    if (addr < tuberamsize && len <= tuberamsize - addr && (addr >= 0x10000 || (addr < limit && len <= limit - addr)))
+        memcpy(buf, tuberam + addr, len);
+    else
+        while (len--)
+            *buf++ = do_readmem(addr++);
+}
+
+static void tube_6502_writeblock(uint32_t addr, const uint8_t *buf, uint32_t len)
+{
+    if (addr < tuberamsize && len <= tuberamsize - addr && (addr >= 0x10000 || (addr < 0xFEF8 && len <= 0xFEF8 - addr)))
+        memcpy(tuberam + addr, buf, len);
+    else
+        while (len--)
+            do_writemem(addr++, *buf++);
+}
+
 static uint8_t readmem(uint16_t addr)
 {
     return tube_6502_readmem(addr);
@@ -291,6 +314,8 @@ static bool common_init(void *rom, size_t memsize)
     tube_type = TUBE6502;
     tube_readmem = tube_6502_readmem;
     tube_writemem = tube_6502_writemem;
+    tube_readblock = tube_6502_readblock;
+    tube_writeblock = tube_6502_writeblock;
     tube_exec  = tube_6502_exec;
     tube_proc_savestate = tube_6502_savestate;
     tube_proc_loadstate = tube_6502_loadstate;
@@ -354,6 +354,70 @@ static void writememw65816(uint32_t a, uint16_t v)
     do_writemem65816(a + 1, v >> 8);
 }
 
+/*Block copies for VDFS.  The banking is resolved once for each 16K
+  slot and the copy goes a byte at a time only for the registers at
+  &FEF0-&FEFF.*/
+
+static uint8_t *block65816(uint32_t a, int rd)
+{
+    if (rd && (a & 0x78000) == 0x8000 && (def || (banking & 8)))
+        return w65816rom + (a & 0x7FFF);
+    if ((a & 0x7C000) == 0x4000 && !def && (banking & 1))
+        return w65816ram + ((a & 0x3FFF) | ((banknum & 7) << 14));
+    if ((a & 0x7C000) == 0x8000 && !def && (banking & 2))
+        return w65816ram + ((a & 0x3FFF) | (((banknum >> 3) & 7) << 14));
+    return w65816ram + a;
+}
+
+static uint32_t chunk65816(uint32_t a, uint32_t len)
+{
+    uint32_t n = 0x4000 - (a & 0x3FFF);
+
+    if ((a & 0xFFF0) == 0xFEF0)
+        return 0;
+    if ((a & 0xFFFF) < 0xFEF0 && (a & 0xFFFF) + n > 0xFEF0)
+        n = 0xFEF0 - (a & 0xFFFF);
+    return n < len ? n : len;
+}
+
+static void readblock65816(uint32_t addr, uint8_t *buf, uint32_t len)
+{
+    uint32_t n;
+
+    while (len) {
+        addr &= w65816mask;
+        if ((n = chunk65816(addr, len))) {
+            memcpy(buf, block65816(addr, 1), n);
+            addr += n;
+            buf += n;
+            len -= n;
+        }
+        else {
+            *buf++ = do_readmem65816(addr++);
+            len--;
+        }
+    }
+}
+
+static void writeblock65816(uint32_t addr, const uint8_t *buf, uint32_t len)
+{
+    uint32_t n;
+
+    while (len) {
+        addr &= w65816mask;
+        if ((n = chunk65816(addr, len))) {
+            memcpy(block65816(addr, 0), buf, n);
+            addr += n;
+            buf += n;
+            len -= n;
+        }
+        else {
+            do_writemem65816(addr++, *buf++);
+            len--;
+        }
+    }
+}
+
 #define readmem(a)     readmem65816(a)
 #define readmemw(a)    readmemw65816(a)
 #define writemem(a,v)  writemem65816(a,v)
@@ -5690,6 +5754,8 @@ bool w65816_init(void *rom)
     tube_type = TUBE65816;
     tube_readmem = readmem65816;
     tube_writemem = writemem65816;
+    tube_readblock = readblock65816;
+    tube_writeblock = writeblock65816;
     tube_exec  = w65816_exec;
     tube_proc_savestate = w65816_savestate;
     tube_proc_loadstate = w65816_loadstate;
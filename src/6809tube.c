@@ -69,6 +69,29 @@ void copro_mc6809nc_write(uint16_t addr, uint8_t data)
     writemem(addr, data);
 }
 
+/*Block copies for VDFS go straight to or from RAM for anything below
+  the Tube registers and, for reads, the overlaid ROM.*/
+
+static void readblock(uint32_t addr, uint8_t *buf, uint32_t len)
+{
+    uint32_t limit = overlay_rom ? 0xF800 : 0xFEE0;
+
+    if (addr < limit && len <= limit - addr)
+        memcpy(buf, copro_mc6809_ram + addr, len);
+    else
+        while (len--)
+            *buf++ = readmem(addr++);
+}
+
+static void writeblock(uint32_t addr, const uint8_t *buf, uint32_t len)
+{
+    if (addr < 0xFEE0 && len <= 0xFEE0 - addr)
+        memcpy(copro_mc6809_ram + addr, buf, len);
+    else
+        while (len--)
+            writemem(addr++, *buf++);
+}
+
 static void mc6809nc_savestate(ZFILE *zfp)
 {
     uint16_t reg;
@@ -132,6 +155,8 @@ bool tube_6809_init(void *rom)
     tube_type = TUBE6809;
     tube_readmem = readmem;
     tube_writemem = writemem;
+    tube_readblock = readblock;
+    tube_writeblock = writeblock;
     tube_exec  = mc6809nc_execute;
     tube_proc_savestate = mc6809nc_savestate;
     tube_proc_loadstate = mc6809nc_loadstate;
@@ -45,6 +45,72 @@ OperandSizeType OpSize;
 
 const uint32_t IndexLKUP[8] = { 0x0, 0x1, 0x4, 0x5, 0x8, 0x9, 0xC, 0xD };                    // See Page 2-3 of the manual!
 
+// Decoded instruction cache
+//
+// Decoding an instruction, including the displacements and immediate
+// values of its operands, is done once and the result kept in a direct
+// mapped cache indexed by its address.  Only the effective addresses are
+// worked out each time it runs.  Entries are tagged with the write count
+// of the page of RAM they were decoded from (see mem32016.c) so that
+// self-modifying and newly loaded code is decoded again.
+
+#define DECODE_CACHE_SIZE 4096
+
+#if defined(PC_SIMULATION)
+#define DECODE_CACHE_BYPASS 1
+#elif defined(INCLUDE_DEBUGGER)
+#define DECODE_CACHE_BYPASS n32016_debug_enabled
+#else
+#define DECODE_CACHE_BYPASS 0
+#endif
+
+typedef struct
+{
+   int32_t Disp[2];
+   Temp64Type Imm;
+} GenDescType;
+
+typedef struct
+{
+   uint32_t StartPc;
+   uint32_t PageGen;
+   uint32_t Opcode;
+   uint32_t Function;
+   OperandSizeType OpSize;
+   RegLKU Regs[2];
+   GenDescType Gen[2];
+   uint32_t Disp;
+   uint16_t Cycles;
+   uint8_t Length;
+   uint8_t WriteIndex;
+   uint8_t FpuFlag;
+} DecodedType;
+
+static DecodedType DecodeCache[DECODE_CACHE_SIZE];
+
+static void FlushDecodeCache(void)
+{
+   uint32_t Index;
+
+   for (Index = 0; Index < DECODE_CACHE_SIZE; Index++)
+   {
+      DecodeCache[Index].StartPc = 0xFFFFFFFF;
+   }
+}
+
+static inline uint32_t CodeGen(uint32_t Address)
+{
+   Address &= 0xFFFFFF;
+   return (Address < RAM_SIZE) ? code_gen[Address >> CODE_PAGE_SHIFT] : 0;
+}
+
+// Only instructions held within one page can be cached
+static inline int DecodeCacheable(uint32_t Address, uint32_t Length)
+{
+   Address &= 0xFFFFFF;
+   return ((Address >> CODE_PAGE_SHIFT) == ((Address + Length - 1) >> CODE_PAGE_SHIFT)) && (Address < (IO_BASE & ~0xFFF));
+}
+
 /* A custom warning logger for n32016 that logs the PC */
 
 void n32016_warn(char *fmt, ...)
@@ -103,6 +169,7 @@ const uint32_t OpSizeLookup[6] =
 void n32016_init()
 {
    init_ram();
+   FlushDecodeCache();
 }
 
 void n32016_close()
@@ -117,6 +184,7 @@ void n32016_reset()
 void n32016_reset_addr(uint32_t StartAddress)
 {
    n32016_build_matrix();
+   FlushDecodeCache();
 
    pc = StartAddress;
    psr = 0;
@@ -357,7 +425,82 @@ static void getgen(int gen, int c)
    }
 }
 
-static void GetGenPhase2(RegLKU gen, int c)
+// Reads the displacements and immediate value of an operand from the
+// instruction stream, leaving pc after them
+static void GenDecode(RegLKU gen, int c, GenDescType *pDesc)
+{
+   if (gen.Whole < 0xFFFF)                                              // Does this Operand exist ?
+   {
+      if (gen.OpType <= R7)
+      {
+         return;
+      }
+
+      if (gen.OpType == Immediate)
+      {
+         MultiReg temp3;
+
+         if (OpSize.Op[c] == sz64)
+         {
+            temp3.u32 = SWAP32(read_x32(pc));
+            pDesc->Imm.u64 = (((uint64_t) temp3.u32) << 32);
+            temp3.u32 = SWAP32(read_x32(pc + 4));
+            pDesc->Imm.u64 |= temp3.u32;
+         }
+         else
+         {
+            // Why can't they just decided on an endian and then stick to it?
+            temp3.u32 = SWAP32(read_x32(pc));
+            if (OpSize.Op[c] == sz8)
+               pDesc->Imm.u64 = temp3.u8;
+            else if (OpSize.Op[c] == sz16)
+               pDesc->Imm.u64 = temp3.u16;
+            else
+               pDesc->Imm.u64 = temp3.u32;
+         }
+
+         pc += OpSize.Op[c];
+         return;
+      }
+
+      if (gen.OpType <= R7_Offset)
+      {
+         pDesc->Disp[0] = GetDisplacement(&pc);
+         return;
+      }
+
+      if (gen.OpType >= EaPlusRn)
+      {
+         RegLKU NewPattern;
+         NewPattern.Whole = gen.IdxType;
+         GenDecode(NewPattern, c, pDesc);
+         return;
+      }
+
+      switch (gen.OpType)
+      {
+         case FrameRelative:
+         case StackRelative:
+         case StaticRelative:
+         case External:
+            pDesc->Disp[0] = GetDisplacement(&pc);
+            pDesc->Disp[1] = GetDisplacement(&pc);
+            break;
+
+         case Absolute:
+         case FpRelative:
+         case SpRelative:
+         case SbRelative:
+         case PcRelative:
+            pDesc->Disp[0] = GetDisplacement(&pc);
+            break;
+      }
+   }
+}
+
+// Works out where an operand is from the registers and memory as they are
+// now, using the displacements GenDecode() read
+static void GenEval(RegLKU gen, int c, const GenDescType *pDesc)
 {
    if (gen.Whole < 0xFFFF)                                              // Does this Operand exist ?
    {
@@ -395,28 +538,15 @@ static void GetGenPhase2(RegLKU gen, int c)
 
       if (gen.OpType == Immediate)
       {
-         MultiReg temp3;
-
          if (OpSize.Op[c] == sz64)
          {
-            temp3.u32 = SWAP32(read_x32(pc));
-            Immediate64.u64 = (((uint64_t) temp3.u32) << 32);
-            temp3.u32 = SWAP32(read_x32(pc + 4));
-            Immediate64.u64 |= temp3.u32;
+            Immediate64.u64 = pDesc->Imm.u64;
          }
          else
          {
-            // Why can't they just decided on an endian and then stick to it?
-            temp3.u32 = SWAP32(read_x32(pc));
-            if (OpSize.Op[c] == sz8)
-               genaddr[c] = temp3.u8;
-            else if (OpSize.Op[c] == sz16)
-               genaddr[c] = temp3.u16;
-            else
-               genaddr[c] = temp3.u32;
+            genaddr[c] = (uint32_t) pDesc->Imm.u64;
          }
 
-         pc += OpSize.Op[c];
          gentype[c] = OpImmediate;
          return;
       }
@@ -425,18 +555,18 @@ static void GetGenPhase2(RegLKU gen, int c)
 
       if (gen.OpType <= R7_Offset)
       {
-         genaddr[c] = r[gen.Whole & 7] + GetDisplacement(&pc);
+         genaddr[c] = r[gen.Whole & 7] + pDesc->Disp[0];
          return;
       }
 
-      uint32_t temp, temp2;
+      uint32_t temp;
 
       if (gen.OpType >= EaPlusRn)
       {
          uint32_t Shift = gen.Whole & 3;
          RegLKU NewPattern;
          NewPattern.Whole = gen.IdxType;
-         GetGenPhase2(NewPattern, c);
+         GenEval(NewPattern, c, pDesc);
 
          int32_t Offset = ((int32_t) r[gen.IdxReg]) * (1 << Shift);
          if (gentype[c] != Register)
@@ -455,35 +585,28 @@ static void GetGenPhase2(RegLKU gen, int c)
       switch (gen.OpType)
       {
          case FrameRelative:
-            temp = GetDisplacement(&pc);
-            temp2 = GetDisplacement(&pc);
-            genaddr[c] = read_x32(fp + temp);
-            genaddr[c] += temp2;
+            genaddr[c] = read_x32(fp + pDesc->Disp[0]);
+            genaddr[c] += pDesc->Disp[1];
             break;
 
          case StackRelative:
-            temp = GetDisplacement(&pc);
-            temp2 = GetDisplacement(&pc);
-            genaddr[c] = read_x32(GET_SP() + temp);
-            genaddr[c] += temp2;
+            genaddr[c] = read_x32(GET_SP() + pDesc->Disp[0]);
+            genaddr[c] += pDesc->Disp[1];
             break;
 
          case StaticRelative:
-            temp = GetDisplacement(&pc);
-            temp2 = GetDisplacement(&pc);
-            genaddr[c] = read_x32(sb + temp);
-            genaddr[c] += temp2;
+            genaddr[c] = read_x32(sb + pDesc->Disp[0]);
+            genaddr[c] += pDesc->Disp[1];
             break;
 
          case Absolute:
-            genaddr[c] = GetDisplacement(&pc);
+            genaddr[c] = pDesc->Disp[0];
             break;
 
          case External:
             temp = read_x32(mod + 4);
-            temp += ((int32_t) GetDisplacement(&pc)) * 4;
-            temp2 = read_x32(temp);
-            genaddr[c] = temp2 + GetDisplacement(&pc);
+            temp += pDesc->Disp[0] * 4;
+            genaddr[c] = read_x32(temp) + pDesc->Disp[1];
             break;
 
          case TopOfStack:
@@ -492,19 +615,19 @@ static void GetGenPhase2(RegLKU gen, int c)
             break;
 
          case FpRelative:
-            genaddr[c] = GetDisplacement(&pc) + fp;
+            genaddr[c] = pDesc->Disp[0] + fp;
             break;
 
          case SpRelative:
-            genaddr[c] = GetDisplacement(&pc) + GET_SP();
+            genaddr[c] = pDesc->Disp[0] + GET_SP();
             break;
 
          case SbRelative:
-            genaddr[c] = GetDisplacement(&pc) + sb;
+            genaddr[c] = pDesc->Disp[0] + sb;
             break;
 
          case PcRelative:
-            genaddr[c] = GetDisplacement(&pc) + startpc;
+            genaddr[c] = pDesc->Disp[0] + startpc;
             break;
 
          default:
@@ -514,6 +637,56 @@ static void GetGenPhase2(RegLKU gen, int c)
    }
 }
 
+// Clocks to find an operand and to move it over the 16-bit bus, excluding
+// the execution time of the instruction itself
+static uint32_t GenCycles(RegLKU gen, int c)
+{
+   uint32_t Cycles;
+
+   if (gen.Whole >= 0xFFFF || gen.OpType <= R7 || gen.OpType == Immediate)
+   {
+      return 0;
+   }
+
+   if (gen.OpType >= EaPlusRn)
+   {
+      RegLKU NewPattern;
+      NewPattern.Whole = gen.IdxType;
+      if (NewPattern.OpType > R7)
+      {
+         return 5 + GenCycles(NewPattern, c);
+      }
+
+      Cycles = 5;
+   }
+   else
+   {
+      switch (gen.OpType)
+      {
+         case FrameRelative:
+         case StackRelative:
+         case StaticRelative:
+            Cycles = 15;                                 // Includes reading the pointer
+            break;
+
+         case External:
+            Cycles = 23;                                 // Link table entry and module base
+            break;
+
+         case TopOfStack:
+            Cycles = 1;
+            break;
+
+         default:
+            Cycles = 4;
+            break;
+      }
+   }
+
+   // Four clocks per bus cycle
+   return Cycles + ((OpSize.Op[c] <= sz16) ? 4 : (OpSize.Op[c] == sz32) ? 8 : 16);
+}
+
 // From: http://homepage.cs.uiowa.edu/~jones/bcd/bcd.html
 static uint32_t bcd_add_16(uint32_t a, uint32_t b, uint32_t *carry)
 {
@@ -986,324 +1159,387 @@ uint32_t ReturnCommon(void)
    return 0;                     // OK
 }
 
-void n32016_exec()
+// Decodes the instruction at startpc, leaving pc after its operands.
+// Returns zero if it can't be decoded far enough to read the operands.
+static int Decode(uint32_t opcode, DecodedType *pDecode)
 {
-   uint32_t opcode, WriteIndex;
-   uint32_t temp, temp2, temp3;
-   Temp64Type temp64;
-   uint32_t Function;
+   uint32_t Function, Format, WriteIndex;
 
-   // Avoid a "might be uninitialized" warning
-   temp = 0;
-   temp64.u64 = 0;
+   WriteSize      = szVaries;                                            // The size a result may be written as
+   WriteIndex     = 1;                                                   // Default to writing operand 0
+   OpSize.Whole   = 0;
 
-   if (tube_irq & 2)
-   {
-      // NMI is edge sensitive, so it should be cleared here
-      tube_irq &= ~2;
-      TakeInterrupt(intbase + (1 * 4));
-   }
-   else if ((tube_irq & 1) && (psr & 0x800))
+   Regs[0].Whole  =
+   Regs[1].Whole  = 0xFFFF;
+
+   Function = FunctionLookup[opcode & 0xFF];
+   Format = Function >> 4;
+
+   if (Format < (FormatCount + 1))
    {
-      // IRQ is level sensitive, so the called should maintain the state
-      TakeInterrupt(intbase);
+      pc += FormatSizes[Format];                                        // Add the basic number of bytes for a particular instruction
    }
 
-   while (tubecycles > 0)
+   switch (Format)
    {
-      tubecycles -= 8;
-
-      CLEAR_TRAP();
-
-      WriteSize      = szVaries;                                            // The size a result may be written as
-      WriteIndex     = 1;                                                   // Default to writing operand 0
-      OpSize.Whole   = 0;
-
-      Regs[0].Whole  =
-      Regs[1].Whole  = 0xFFFF;
-
-      startpc  = pc;
-
-#ifdef INCLUDE_DEBUGGER
-      if (n32016_debug_enabled)
+      case Format0:
+      case Format1:
       {
-         debug_preexec(&n32016_cpu_debug, pc);
+         // Nothing here!
       }
-#endif
-
-      opcode = read_x32(pc);
+      break;
 
-      if (pc == PR.BPC)
+      case Format2:
       {
-         SET_TRAP(BreakPointHit);
-         goto DoTrap;
+         SET_OP_SIZE(opcode);
+         WriteIndex = 0;
+         getgen(opcode >> 11, 0);
       }
+      break;
 
-      BreakPoint(startpc, opcode);
-
-      Function = FunctionLookup[opcode & 0xFF];
-      uint32_t Format   = Function >> 4;
-
-      if (Format < (FormatCount + 1))
+      case Format3:
       {
-         pc += FormatSizes[Format];                                        // Add the basic number of bytes for a particular instruction
+         Function += ((opcode >> 7) & 0x0F);
+         SET_OP_SIZE(opcode);
+         getgen(opcode >> 11, 0);
       }
+      break;
 
-      switch (Format)
+      case Format4:
       {
-         case Format0:
-         case Format1:
-         {
-            // Nothing here!
-         }
-         break;
+         SET_OP_SIZE(opcode);
+         getgen(opcode >> 11, 0);
+         getgen(opcode >> 6, 1);
+      }
+      break;
 
-         case Format2:
+      case Format5:
+      {
+         Function += ((opcode >> 10) & 0x0F);
+         SET_OP_SIZE(opcode >> 8);
+         if (Function == SETCFG)
          {
-            SET_OP_SIZE(opcode);
-            WriteIndex = 0;
-            getgen(opcode >> 11, 0);
+            OpSize.Whole = 0;
          }
-         break;
-
-         case Format3:
+         else if (opcode & BIT(Translation))
          {
-            Function += ((opcode >> 7) & 0x0F);
-            SET_OP_SIZE(opcode);
-            getgen(opcode >> 11, 0);
+            SET_OP_SIZE(0);         // 8 Bit
          }
-         break;
+      }
+      break;
 
-         case Format4:
-         {
-            SET_OP_SIZE(opcode);
-            getgen(opcode >> 11, 0);
-            getgen(opcode >> 6, 1);
-         }
-         break;
+      case Format6:
+      {
+         Function += ((opcode >> 10) & 0x0F);
+         SET_OP_SIZE(opcode >> 8);
 
-         case Format5:
+         // Ordering important here, as getgen uses Operand Size
+         switch (Function)
          {
-            Function += ((opcode >> 10) & 0x0F);
-            SET_OP_SIZE(opcode >> 8);
-            if (Function == SETCFG)
-            {
-               OpSize.Whole = 0;
-            }
-            else if (opcode & BIT(Translation))
+            case ROT:
+            case ASH:
+            case LSH:
             {
-               SET_OP_SIZE(0);         // 8 Bit
+               OpSize.Op[0] = sz8;
             }
+            break;
          }
-         break;
 
-         case Format6:
-         {
-            Function += ((opcode >> 10) & 0x0F);
-            SET_OP_SIZE(opcode >> 8);
-
-            // Ordering important here, as getgen uses Operand Size
-            switch (Function)
-            {
-               case ROT:
-               case ASH:
-               case LSH:
-               {
-                  OpSize.Op[0] = sz8;
-               }
-               break;
-            }
-
-            getgen(opcode >> 19, 0);
-            getgen(opcode >> 14, 1);
-         }
-         break;
+         getgen(opcode >> 19, 0);
+         getgen(opcode >> 14, 1);
+      }
+      break;
 
-         case Format7:
-         {
-            Function += ((opcode >> 10) & 0x0F);
-            SET_OP_SIZE(opcode >> 8);
+      case Format7:
+      {
+         Function += ((opcode >> 10) & 0x0F);
+         SET_OP_SIZE(opcode >> 8);
 
-            getgen(opcode >> 19, 0);
-            getgen(opcode >> 14, 1);
-         }
-         break;
+         getgen(opcode >> 19, 0);
+         getgen(opcode >> 14, 1);
+      }
+      break;
 
-         case Format8:
+      case Format8:
+      {
+         if (opcode & 0x400)
          {
-            if (opcode & 0x400)
+            if (opcode & 0x80)
             {
-               if (opcode & 0x80)
+               switch (opcode & 0x3CC0)
                {
-                  switch (opcode & 0x3CC0)
+                  case 0x0C80:
                   {
-                     case 0x0C80:
-                     {
-                        Function = MOVUS;
-                     }
-                     break;
-
-                     case 0x1C80:
-                     {
-                        Function = MOVSU;
-                     }
-                     break;
-
-                     default:
-                     {
-                        Function = TRAP;
-                     }
-                     break;
+                     Function = MOVUS;
                   }
-               }
-               else
-               {
-                  Function = (opcode & 0x40) ? FFS : INDEX;
+                  break;
+
+                  case 0x1C80:
+                  {
+                     Function = MOVSU;
+                  }
+                  break;
+
+                  default:
+                  {
+                     Function = TRAP;
+                  }
+                  break;
                }
             }
             else
             {
-               Function += ((opcode >> 6) & 3);
+               Function = (opcode & 0x40) ? FFS : INDEX;
             }
+         }
+         else
+         {
+            Function += ((opcode >> 6) & 3);
+         }
 
-            SET_OP_SIZE(opcode >> 8);
+         SET_OP_SIZE(opcode >> 8);
 
-            if (Function == CVTP)
-            {
-               SET_OP_SIZE(3);               // 32 Bit
-            }
+         if (Function == CVTP)
+         {
+            SET_OP_SIZE(3);               // 32 Bit
+         }
 
-            getgen(opcode >> 19, 0);
-            getgen(opcode >> 14, 1);
+         getgen(opcode >> 19, 0);
+         getgen(opcode >> 14, 1);
+      }
+      break;
+
+      case Format9:
+      {
+         if (nscfg.fpu_flag == 0)
+         {
+            SET_TRAP(UnknownInstruction);
+            return 0;
          }
-         break;
 
-         case Format9:
+         Function += ((opcode >> 11) & 0x07);
+         switch (Function)
          {
-            if (nscfg.fpu_flag == 0)
+            case MOVif:
             {
-               GOTO_TRAP(UnknownInstruction);
+               OpSize.Op[0] = ((opcode >> 8) & 3) + 1;                           // Source Size (Integer)
+               WriteSize    =
+               OpSize.Op[1] = GET_F_SIZE(opcode & BIT(10));                      // Destination Size (Float/ Double)
+               getgen(opcode >> 19, 0);                                          // Source Operand
+               getgen(opcode >> 14, 1);                                          // Destination Operand
+               Regs[1].RegType = GET_PRECISION(opcode & BIT(10));
             }
+            break;
 
-            Function += ((opcode >> 11) & 0x07);
-            switch (Function)
+            case ROUND:
+            case TRUNC:
+            case FLOOR:
             {
-               case MOVif:
-               {
-                  OpSize.Op[0] = ((opcode >> 8) & 3) + 1;                           // Source Size (Integer)
-                  WriteSize    =
-                  OpSize.Op[1] = GET_F_SIZE(opcode & BIT(10));                      // Destination Size (Float/ Double)
-                  getgen(opcode >> 19, 0);                                          // Source Operand
-                  getgen(opcode >> 14, 1);                                          // Destination Operand
-                  Regs[1].RegType = GET_PRECISION(opcode & BIT(10));
-               }
-               break;
-
-               case ROUND:
-               case TRUNC:
-               case FLOOR:
-               {
-                  OpSize.Op[0] = GET_F_SIZE(opcode & BIT(10));                      // Source Size (Float/ Double)
-                  WriteSize =
-                  OpSize.Op[1] = ((opcode >> 8) & 3) + 1;                           // Destination Size (Integer)
-                  getgen(opcode >> 19, 0);                                          // Source Operand
-                  getgen(opcode >> 14, 1);                                          // Destination Operand
-                  Regs[0].RegType = GET_PRECISION(opcode & BIT(10));
-               }
-               break;
-
-               case MOVFL:
-               {
-                  OpSize.Op[0] = sz32;
-                  WriteSize =
-                  OpSize.Op[1] = sz64;
-                  getgen(opcode >> 19, 0);                                          // Source Operand
-                  getgen(opcode >> 14, 1);                                          // Destination Operand
-                  Regs[0].RegType = SinglePrecision;
-                  Regs[1].RegType = DoublePrecision;
-               }
-               break;
-
-               case MOVLF:
-               {
-                  OpSize.Op[0] = sz64;
-                  WriteSize =
-                  OpSize.Op[1] = sz32;
-                  getgen(opcode >> 19, 0);                                          // Source Operand
-                  getgen(opcode >> 14, 1);                                          // Destination Operand
-                  Regs[0].RegType = DoublePrecision;
-                  Regs[1].RegType = SinglePrecision;
-               }
-               break;
+               OpSize.Op[0] = GET_F_SIZE(opcode & BIT(10));                      // Source Size (Float/ Double)
+               WriteSize =
+               OpSize.Op[1] = ((opcode >> 8) & 3) + 1;                           // Destination Size (Integer)
+               getgen(opcode >> 19, 0);                                          // Source Operand
+               getgen(opcode >> 14, 1);                                          // Destination Operand
+               Regs[0].RegType = GET_PRECISION(opcode & BIT(10));
+            }
+            break;
 
-               case LFSR:
-               {
-                  SET_OP_SIZE(3);
-                  getgen(opcode >> 19, 0);
-               }
-               break;
+            case MOVFL:
+            {
+               OpSize.Op[0] = sz32;
+               WriteSize =
+               OpSize.Op[1] = sz64;
+               getgen(opcode >> 19, 0);                                          // Source Operand
+               getgen(opcode >> 14, 1);                                          // Destination Operand
+               Regs[0].RegType = SinglePrecision;
+               Regs[1].RegType = DoublePrecision;
+            }
+            break;
 
-               case SFSR:
-               {
-                  SET_OP_SIZE(3);
-                  getgen(opcode >> 14, 1);
-               }
-               break;
+            case MOVLF:
+            {
+               OpSize.Op[0] = sz64;
+               WriteSize =
+               OpSize.Op[1] = sz32;
+               getgen(opcode >> 19, 0);                                          // Source Operand
+               getgen(opcode >> 14, 1);                                          // Destination Operand
+               Regs[0].RegType = DoublePrecision;
+               Regs[1].RegType = SinglePrecision;
+            }
+            break;
 
-               default:
-               {
-                  PiWARN("Unexpected Format 9 Decode: Function = %"PRId32, Function);
-               }
-               break;
+            case LFSR:
+            {
+               SET_OP_SIZE(3);
+               getgen(opcode >> 19, 0);
             }
-         }
-         break;
+            break;
 
-         case Format11:
-         case Format12:
-         {
-            if (nscfg.fpu_flag == 0)
+            case SFSR:
             {
-               GOTO_TRAP(UnknownInstruction);
+               SET_OP_SIZE(3);
+               getgen(opcode >> 14, 1);
             }
+            break;
 
-            Function += ((opcode >> 10) & 0x0F);
-            WriteSize    =
-            OpSize.Op[0] =
-            OpSize.Op[1] = GET_F_SIZE(opcode & BIT(8));
-            getgen(opcode >> 19, 0);
-            getgen(opcode >> 14, 1);
-            Regs[0].RegType =
-            Regs[1].RegType = GET_PRECISION(opcode & BIT(8));
+            default:
+            {
+               PiWARN("Unexpected Format 9 Decode: Function = %"PRId32, Function);
+            }
+            break;
          }
-         break;
+      }
+      break;
 
-         case Format14:
+      case Format11:
+      case Format12:
+      {
+         if (nscfg.fpu_flag == 0)
          {
-            Function += ((opcode >> 10) & 0x0F);
+            SET_TRAP(UnknownInstruction);
+            return 0;
          }
-         break;
 
-         default:
-         {
-            SET_TRAP(UnknownFormat);
-         }
-         break;
+         Function += ((opcode >> 10) & 0x0F);
+         WriteSize    =
+         OpSize.Op[0] =
+         OpSize.Op[1] = GET_F_SIZE(opcode & BIT(8));
+         getgen(opcode >> 19, 0);
+         getgen(opcode >> 14, 1);
+         Regs[0].RegType =
+         Regs[1].RegType = GET_PRECISION(opcode & BIT(8));
+      }
+      break;
+
+      case Format14:
+      {
+         Function += ((opcode >> 10) & 0x0F);
+      }
+      break;
+
+      default:
+      {
+         SET_TRAP(UnknownFormat);
       }
+      break;
+   }
 
 #ifdef PC_SIMULATION
-      uint32_t Temp = pc;
-      n32016_show_instruction(startpc, &Temp, opcode, Function, &OpSize);
+   uint32_t Temp = pc;
+   n32016_show_instruction(startpc, &Temp, opcode, Function, &OpSize);
+#endif
+
+   memset(pDecode->Gen, 0, sizeof(pDecode->Gen));
+   GenDecode(Regs[0], 0, &pDecode->Gen[0]);
+   GenDecode(Regs[1], 1, &pDecode->Gen[1]);
+
+   pDecode->Disp = 0;
+   if (Function <= RETT)
+   {
+      pDecode->Disp = GetDisplacement(&pc);
+   }
+
+   pDecode->Opcode      = opcode;
+   pDecode->Function    = Function;
+   pDecode->OpSize      = OpSize;
+   pDecode->Regs[0]     = Regs[0];
+   pDecode->Regs[1]     = Regs[1];
+   pDecode->WriteIndex  = WriteIndex;
+   pDecode->Length      = pc - startpc;
+   pDecode->Cycles      = ((Function < InstructionCount) && FunctionCycles[Function]) ? FunctionCycles[Function] : TRAP_CYCLES;
+   pDecode->Cycles     += GenCycles(Regs[0], 0) + GenCycles(Regs[1], 1);
+
+   return 1;
+}
+
+void n32016_exec()
+{
+   uint32_t opcode, WriteIndex;
+   uint32_t temp, temp2, temp3;
+   Temp64Type temp64;
+   uint32_t Function;
+
+   // Avoid a "might be uninitialized" warning
+   temp = 0;
+   temp64.u64 = 0;
+
+   if (tube_irq & 2)
+   {
+      // NMI is edge sensitive, so it should be cleared here
+      tube_irq &= ~2;
+      TakeInterrupt(intbase + (1 * 4));
+   }
+   else if ((tube_irq & 1) && (psr & 0x800))
+   {
+      // IRQ is level sensitive, so the called should maintain the state
+      TakeInterrupt(intbase);
+   }
+
+   while (tubecycles > 0)
+   {
+      DecodedType *pDecode, Uncached;
+
+      CLEAR_TRAP();
+
+      startpc  = pc;
+
+#ifdef INCLUDE_DEBUGGER
+      if (n32016_debug_enabled)
+      {
+         debug_preexec(&n32016_cpu_debug, pc);
+      }
 #endif
 
-      GetGenPhase2(Regs[0], 0);
-      GetGenPhase2(Regs[1], 1);
+      if (pc == PR.BPC)
+      {
+         tubecycles -= TRAP_CYCLES;
+         SET_TRAP(BreakPointHit);
+         goto DoTrap;
+      }
 
-      if (Function <= RETT)
+      pDecode = &DecodeCache[startpc & (DECODE_CACHE_SIZE - 1)];
+
+      if (pDecode->StartPc != startpc || pDecode->PageGen != CodeGen(startpc) || pDecode->FpuFlag != nscfg.fpu_flag || DECODE_CACHE_BYPASS)
       {
-         temp = GetDisplacement(&pc);
+         opcode = read_x32(pc);
+         BreakPoint(startpc, opcode);
+
+         if (Decode(opcode, &Uncached) == 0)
+         {
+            tubecycles -= TRAP_CYCLES;
+            goto DoTrap;
+         }
+
+         if (TrapFlags || DECODE_CACHE_BYPASS || !DecodeCacheable(startpc, Uncached.Length))
+         {
+            pDecode = &Uncached;
+         }
+         else
+         {
+            *pDecode          = Uncached;
+            pDecode->StartPc  = startpc;
+            pDecode->PageGen  = CodeGen(startpc);
+            pDecode->FpuFlag  = nscfg.fpu_flag;
+            if ((startpc & 0xFFFFFF) < RAM_SIZE)
+            {
+               code_page[(startpc & 0xFFFFFF) >> CODE_PAGE_SHIFT] = 1;
+            }
+         }
       }
 
+      opcode      = pDecode->Opcode;
+      Function    = pDecode->Function;
+      OpSize      = pDecode->OpSize;
+      Regs[0]     = pDecode->Regs[0];
+      Regs[1]     = pDecode->Regs[1];
+      WriteIndex  = pDecode->WriteIndex;
+      temp        = pDecode->Disp;
+      pc          = startpc + pDecode->Length;
+      tubecycles -= pDecode->Cycles;
+
+      GenEval(Regs[0], 0, &pDecode->Gen[0]);
+      GenEval(Regs[1], 1, &pDecode->Gen[1]);
+
       if (TrapFlags)
       {
          DoTrap:
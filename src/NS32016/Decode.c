@@ -16,6 +16,46 @@ const uint8_t FormatSizes[FormatCount + 1] =
    1, 1, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 1
 };
 
+// Zero for instructions that trap
+const uint8_t FunctionCycles[InstructionCount] =
+{
+   [BEQ] = 7, [BNE] = 7, [BCS] = 7, [BCC] = 7, [BH] = 7, [BLS] = 7, [BGT] = 7, [BLE] = 7,
+   [BFS] = 7, [BFC] = 7, [BLO] = 7, [BHS] = 7, [BLT] = 7, [BGE] = 7, [BR] = 7, [BN] = 6,
+
+   [BSR] = 6, [RET] = 4, [CXP] = 16, [RXP] = 18, [RETT] = 29, [RETI] = 39, [SAVE] = 21,
+   [RESTORE] = 23, [ENTER] = 26, [EXIT] = 25, [NOP] = 3, [WAIT] = 6, [DIA] = 6, [FLAG] = 4,
+   [SVC] = 40, [BPT] = 40,
+
+   [ADDQ] = 4, [CMPQ] = 3, [SPR] = 21, [Scond] = 10, [ACB] = 18, [MOVQ] = 3, [LPR] = 19,
+
+   [CXPD] = 13, [BICPSR] = 18, [JUMP] = 2, [BISPSR] = 18, [ADJSP] = 6, [JSR] = 5, [CASE] = 10,
+
+   [ADD] = 3, [CMP] = 3, [BIC] = 3, [ADDC] = 3, [MOV] = 3, [OR] = 3, [SUB] = 3, [ADDR] = 3,
+   [AND] = 3, [SUBC] = 3, [TBIT] = 10, [XOR] = 3,
+
+   [MOVS] = 22, [CMPS] = 27, [SETCFG] = 15, [SKPS] = 19,                 // Per element
+
+   [ROT] = 14, [ASH] = 14, [CBIT] = 15, [CBITI] = 15, [LSH] = 14, [SBIT] = 15, [SBITI] = 15,
+   [NEG] = 5, [NOT] = 5, [SUBP] = 16, [ABS] = 8, [COM] = 5, [IBIT] = 15, [ADDP] = 16,
+
+   [MOVM] = 20, [CMPM] = 24, [INSS] = 20, [EXTS] = 18, [MOVXiW] = 6, [MOVZiW] = 5,
+   [MOVZiD] = 5, [MOVXiD] = 6, [MUL] = 53, [MEI] = 69, [DEI] = 90, [QUO] = 60, [REM] = 60,
+   [MOD] = 66, [DIV] = 66,
+
+   [EXT] = 17, [CVTP] = 7, [INS] = 20, [CHECK] = 10, [INDEX] = 40, [FFS] = 22, [MOVUS] = 20,
+   [MOVSU] = 20,
+
+   [MOVif] = 60, [LFSR] = 20, [MOVLF] = 50, [MOVFL] = 50, [ROUND] = 60, [TRUNC] = 60,
+   [SFSR] = 20, [FLOOR] = 60,
+
+   [ADDf] = 70, [MOVf] = 20, [CMPf] = 50, [SUBf] = 70, [NEGf] = 20, [DIVf] = 120, [MULf] = 80,
+   [ABSf] = 20,
+   [ADDf + 16] = 70, [MOVf + 16] = 20, [CMPf + 16] = 50, [SUBf + 16] = 70, [NEGf + 16] = 20,
+   [DIVf + 16] = 120, [MULf + 16] = 80, [ABSf + 16] = 20,                // Format 12
+
+   [RDVAL] = 20, [WRVAL] = 20, [LMR] = 20, [SMR] = 20, [CINV] = 20
+};
+
 #define FUNC(FORMAT, OFFSET) (((FORMAT) << 4) + (OFFSET))
 
 uint8_t GetFunction(uint8_t FirstByte)
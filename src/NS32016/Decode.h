@@ -170,6 +170,12 @@ enum Functions
    BAD = 0xFF
 };
 
+// Approximate execution times in clocks with register operands, see
+// Appendix D of the NS32016 datasheet.  Operand addressing is added on
+// when the instruction is decoded.
+#define TRAP_CYCLES 40
+extern const uint8_t FunctionCycles[InstructionCount];
+
 // See Table 4-1 page 4-5 in the manual
 enum OperandFlags
 {
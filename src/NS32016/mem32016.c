@@ -47,6 +47,30 @@ static uint8_t * ns32016ram;
 #define PANDORA_VERSION PandoraV2_00
 #endif
 
+// Pages of RAM that instructions have been decoded from and a count of the
+// writes to each of them, which lets the decoded instruction cache in
+// 32016.c tell when one of its entries has gone stale.
+uint8_t  code_page[CODE_PAGES];
+uint32_t code_gen[CODE_PAGES];
+
+#define CODE_WRITTEN(addr, size) \
+   if (code_page[(addr) >> CODE_PAGE_SHIFT] | code_page[((addr) + (size) - 1) >> CODE_PAGE_SHIFT]) \
+      code_written(addr, size)
+
+void code_written(uint32_t addr, uint32_t Size)
+{
+   uint32_t Page;
+
+   for (Page = addr >> CODE_PAGE_SHIFT; Page <= ((addr + Size - 1) >> CODE_PAGE_SHIFT); Page++)
+   {
+      if (code_page[Page])
+      {
+         code_page[Page] = 0;
+         code_gen[Page]++;
+      }
+   }
+}
+
 void init_ram(void)
 {
 #ifndef BEM
@@ -202,6 +226,29 @@ uint32_t read_n(uint32_t addr, uint32_t Size)
    }
 }
 
+void read_Arbitary(uint32_t addr, void* pData, uint32_t Size)
+{
+   addr &= 0xFFFFFF;
+
+#ifdef NS_FAST_RAM
+#ifdef INCLUDE_DEBUGGER
+   if ((addr + Size) <= IO_BASE && !n32016_debug_enabled)
+#else
+   if ((addr + Size) <= IO_BASE)
+#endif
+   {
+      memcpy(pData, ns32016ram + addr, Size);
+      return;
+   }
+#endif
+
+   register uint8_t* pValue = (uint8_t*) pData;
+   while (Size--)
+   {
+      *pValue++ = read_x8(addr++);
+   }
+}
+
 void write_x8(uint32_t addr, uint8_t val)
 #ifdef INCLUDE_DEBUGGER
 {
@@ -218,6 +265,7 @@ void write_x8_internal(uint32_t addr, uint8_t val)
 
    if (addr <= (RAM_SIZE - sizeof(uint8_t)))
    {
+      CODE_WRITTEN(addr, 1);
 #ifdef USE_MEMORY_POINTER
       ns32016ram[addr] = val;
 #else
@@ -237,6 +285,7 @@ void write_x8_internal(uint32_t addr, uint8_t val)
 #ifdef PANDORA_ROM_PAGE_OUT
       PiTRACE("Pandora ROM no longer occupying the entire memory space!")
       memset(ns32016ram, 0, RAM_SIZE);
+      code_written(0, RAM_SIZE);
 #else
       PiTRACE("Pandora ROM write to 0xF90000");
 #endif
@@ -264,6 +313,7 @@ void write_x16(uint32_t addr, uint16_t val)
          debug_memwrite(&n32016_cpu_debug, addr, val, 2);
       }
 #endif
+      CODE_WRITTEN(addr, 2);
 #ifdef USE_MEMORY_POINTER
       *((uint16_t*) (ns32016ram + addr)) = val;
 #else
@@ -290,6 +340,7 @@ void write_x32(uint32_t addr, uint32_t val)
          debug_memwrite(&n32016_cpu_debug, addr, val, 4);
       }
 #endif
+      CODE_WRITTEN(addr, 4);
 #ifdef USE_MEMORY_POINTER
       *((uint32_t*) (ns32016ram + addr)) = val;
 #else
@@ -342,6 +393,10 @@ void write_Arbitary(uint32_t addr, void* pData, uint32_t Size)
    if ((addr + Size) <= RAM_SIZE) 
 #endif
    {
+      if (Size)
+      {
+         CODE_WRITTEN(addr, Size);
+      }
       memcpy(ns32016ram + addr, pData, Size);
       return;
    }
@@ -11,6 +11,15 @@
 //#define PANDORA_ROM_PAGE_OUT
 #define NS_FAST_RAM
 
+// Code pages, used to invalidate decoded instructions when RAM is written
+#define CODE_PAGE_SHIFT 12
+#define CODE_PAGES      (RAM_SIZE >> CODE_PAGE_SHIFT)
+
+extern uint8_t  code_page[CODE_PAGES];
+extern uint32_t code_gen[CODE_PAGES];
+
+void code_written(uint32_t addr, uint32_t Size);
+
 void init_ram(void);
 
 #ifdef INCLUDE_DEBUGGER
@@ -22,6 +31,7 @@ uint16_t read_x16(uint32_t addr);
 uint32_t read_x32(uint32_t addr);
 uint64_t read_x64(uint32_t addr);
 uint32_t read_n(uint32_t addr, uint32_t Size);
+void     read_Arbitary(uint32_t addr, void* pData, uint32_t Size);
 
 #ifdef INCLUDE_DEBUGGER
 void     write_x8_internal(uint32_t addr, uint8_t val);
@@ -159,6 +159,19 @@ static uint32_t rotatelookup[4096];
 
 static void refillpipeline2();
 
+/*Block translation, see below.*/
+
+#define ARM_JIT_PAGES (ARM_RAM_SIZE>>12)
+
+bool arm_translate=true, arm_lockstep=false;
+static uint8_t arm_jit_code[ARM_JIT_PAGES];
+
+typedef struct arm_block arm_block_t;
+static arm_block_t *arm_blocks;
+
+static void arm_jit_written(uint32_t addr);
+static void arm_jit_flush(void);
+
 #define countbits(c) countbitstable[c]
 static int countbitstable[65536];
 
@@ -214,6 +227,7 @@ void arm_reset()
         mode=3;
         memmode=2;
         memcpy(armramb,armromb,ARM_ROM_SIZE);
+        arm_jit_flush();
         refillpipeline2();
 }
 
@@ -239,6 +253,10 @@ void arm_close()
         free(armram);
         armram = NULL;
     }
+    if (arm_blocks) {
+        free(arm_blocks);
+        arm_blocks = NULL;
+    }
 }
 
 static unsigned char *save_regset(unsigned char *ptr, uint32_t *regs)
@@ -297,6 +315,7 @@ static void arm_loadstate(ZFILE *zfp)
     databort = *ptr;
     savestate_zread(zfp, armram, ARM_RAM_SIZE);
     savestate_zread(zfp, armrom, ARM_ROM_SIZE);
+    arm_jit_flush();
 }
 
 static int endtimeslice=0;
@@ -358,6 +377,7 @@ static inline void do_writearmb(uint32_t addr, uint8_t val)
         if (addr<0x400000)
         {
                 armramb[addr]=val;
+                if (arm_jit_code[addr>>12]) arm_jit_written(addr);
                 return;
         }
         if ((addr&~0x1F)==0x1000000)
@@ -379,6 +399,37 @@ static void writearmb(uint32_t addr, uint8_t val)
     do_writearmb(addr, val);
 }
 
+/*Block copies for VDFS.  The part of the range in RAM is copied
+  straight, dropping any translated code from the pages written.*/
+
+static void arm_readblock(uint32_t addr, uint8_t *buf, uint32_t len)
+{
+        uint32_t chunk=0;
+
+        if (addr<ARM_RAM_SIZE)
+        {
+                chunk=(len<ARM_RAM_SIZE-addr)?len:ARM_RAM_SIZE-addr;
+                memcpy(buf,armramb+addr,chunk);
+        }
+        for (;chunk<len;chunk++)
+                buf[chunk]=do_readarmb(addr+chunk);
+}
+
+static void arm_writeblock(uint32_t addr, const uint8_t *buf, uint32_t len)
+{
+        uint32_t chunk=0,page;
+
+        if (addr<ARM_RAM_SIZE && len)
+        {
+                chunk=(len<ARM_RAM_SIZE-addr)?len:ARM_RAM_SIZE-addr;
+                memcpy(armramb+addr,buf,chunk);
+                for (page=addr>>12;page<=(addr+chunk-1)>>12;page++)
+                        if (arm_jit_code[page]) arm_jit_written(page<<12);
+        }
+        for (;chunk<len;chunk++)
+                do_writearmb(addr+chunk,buf[chunk]);
+}
+
 static void writearml(uint32_t addr, uint32_t val)
 {
         if (arm_debug_enabled)
@@ -386,6 +437,7 @@ static void writearml(uint32_t addr, uint32_t val)
         if (addr<0x400000)
         {
                 armram[addr>>2]=val;
+                if (arm_jit_code[addr>>12]) arm_jit_written(addr);
                 return;
         }
 /*        if (addr<0x400010) return;
@@ -665,6 +717,8 @@ bool arm_init(void *rom)
     tube_type = TUBEARM;
     tube_readmem = readarmb;
     tube_writemem = writearmb;
+    tube_readblock = arm_readblock;
+    tube_writeblock = arm_writeblock;
     tube_exec  = arm_exec;
     tube_proc_savestate = arm_savestate;
     tube_proc_loadstate = arm_loadstate;
@@ -676,66 +730,30 @@ bool arm_init(void *rom)
  * CPU Implementation
  *****************************************************/
 
-#define checkneg(v) (v&0x80000000)
-#define checkpos(v) !(v&0x80000000)
+/*Carry and overflow come from the sign bits of the operands and result,
+  worked out together rather than flag by flag.  ADC and SBC set the
+  flags as ADD and SUB do.*/
 
 static inline void setadd(uint32_t op1, uint32_t op2, uint32_t res)
 {
-        armregs[15]&=0xFFFFFFF;
-        if ((checkneg(op1) && checkneg(op2)) ||
-            (checkneg(op1) && checkpos(res)) ||
-            (checkneg(op2) && checkpos(res)))  armregs[15]|=CFLAG;
-        if ((checkneg(op1) && checkneg(op2) && checkpos(res)) ||
-            (checkpos(op1) && checkpos(op2) && checkneg(res)))
-            armregs[15]|=VFLAG;
-        if (!res)                          armregs[15]|=ZFLAG;
-        else if (checkneg(res))            armregs[15]|=NFLAG;
+        armregs[15]=(armregs[15]&0xFFFFFFF)|(res&NFLAG)|(res?0:ZFLAG)|
+                    ((((op1&op2)|((op1|op2)&~res))>>2)&CFLAG)|
+                    ((((op1^res)&(op2^res))>>3)&VFLAG);
 }
 
 static inline void setsub(uint32_t op1, uint32_t op2, uint32_t res)
 {
-        armregs[15]&=0xFFFFFFF;
-        if ((checkneg(op1) && checkpos(op2)) ||
-            (checkneg(op1) && checkpos(res)) ||
-            (checkpos(op2) && checkpos(res)))  armregs[15]|=CFLAG;
-        if (!res)               armregs[15]|=ZFLAG;
-        else if (checkneg(res)) armregs[15]|=NFLAG;
-        if ((checkneg(op1) && checkpos(op2) && checkpos(res)) ||
-            (checkpos(op1) && checkneg(op2) && checkneg(res)))
-            armregs[15]|=VFLAG;
+        armregs[15]=(armregs[15]&0xFFFFFFF)|(res&NFLAG)|(res?0:ZFLAG)|
+                    ((((op1&~op2)|((op1|~op2)&~res))>>2)&CFLAG)|
+                    ((((op1^op2)&(op1^res))>>3)&VFLAG);
 }
 
-static inline void setsbc(uint32_t op1, uint32_t op2, uint32_t res)
-{
-        armregs[15]&=0xFFFFFFF;
-        if (!res)                           armregs[15]|=ZFLAG;
-        else if (checkneg(res))             armregs[15]|=NFLAG;
-        if ((checkneg(op1) && checkpos(op2)) ||
-            (checkneg(op1) && checkpos(res)) ||
-            (checkpos(op2) && checkpos(res)))  armregs[15]|=CFLAG;
-        if ((checkneg(op1) && checkpos(op2) && checkpos(res)) ||
-            (checkpos(op1) && checkneg(op2) && checkneg(res)))
-            armregs[15]|=VFLAG;
-}
-
-static inline void setadc(uint32_t op1, uint32_t op2, uint32_t res)
-{
-        armregs[15]&=0xFFFFFFF;
-        if ((checkneg(op1) && checkneg(op2)) ||
-            (checkneg(op1) && checkpos(res)) ||
-            (checkneg(op2) && checkpos(res)))  armregs[15]|=CFLAG;
-        if ((checkneg(op1) && checkneg(op2) && checkpos(res)) ||
-            (checkpos(op1) && checkpos(op2) && checkneg(res)))
-            armregs[15]|=VFLAG;
-        if (!res)                          armregs[15]|=ZFLAG;
-        else if (checkneg(res))            armregs[15]|=NFLAG;
-}
+#define setsbc setsub
+#define setadc setadd
 
 static inline void setarmzn(uint32_t op)
 {
-        armregs[15]&=0x3FFFFFFF;
-        if (!op)               armregs[15]|=ZFLAG;
-        else if (checkneg(op)) armregs[15]|=NFLAG;
+        armregs[15]=(armregs[15]&0x3FFFFFFF)|(op&NFLAG)|(op?0:ZFLAG);
 }
 
 static inline uint32_t shift(uint32_t opcode)
@@ -910,19 +928,13 @@ static void refillpipeline2()
 }
 
 int accc=0;
-void arm_exec()
+
+/*Execute one instruction that has passed its condition check.*/
+
+static void arm_insn(uint32_t opcode)
 {
-        uint32_t opcode,templ,templ2,mask,addr,addr2;
+        uint32_t templ,templ2,mask,addr,addr2;
         int c;
-        while (tubecycles>0)
-        {
-                opcode=opcode2;
-                opcode2=opcode3;
-                opcode3=readarml(PC);
-                if (arm_debug_enabled)
-                    debug_preexec(&tubearm_cpu_debug, PC);
-                if (flaglookup[opcode>>28][armregs[15]>>28])
-                        {
                                 switch ((opcode>>20)&0xFF)
                                 {
                                         case 0x00: /*AND reg*/
@@ -2344,7 +2356,14 @@ void arm_exec()
                                         default:
                                         break;
                                 }
-                        }
+}
+
+/*Take any pending abort or interrupt and move on to the next instruction.*/
+
+static inline void arm_insn_end(void)
+{
+        uint32_t templ;
+
                         if (databort|armirq|tube_irq)
                         {
                                 if (databort==1)     /*Data abort*/
@@ -2396,6 +2415,21 @@ void arm_exec()
                 armirq=tube_irq;
                 if ((armregs[15]&3)!=mode) updatemode(armregs[15]&3);
                 armregs[15]+=4;
+}
+
+static void arm_interpret(void)
+{
+        uint32_t opcode;
+        while (tubecycles>0)
+        {
+                opcode=opcode2;
+                opcode2=opcode3;
+                opcode3=readarml(PC);
+                if (arm_debug_enabled)
+                    debug_preexec(&tubearm_cpu_debug, PC);
+                if (flaglookup[opcode>>28][armregs[15]>>28])
+                        arm_insn(opcode);
+                arm_insn_end();
 //                log_debug("%08X : %08X %08X %08X  %08X\n",PC,armregs[0],armregs[1],armregs[2],opcode);
 /*                if (!PC)
                 {
@@ -2411,3 +2445,441 @@ void arm_exec()
 //                if (output && !(*armregs[15]&0x8000000) && PC<0x2000000) log_debug("%07X : %08X %08X %08X %08X %08X %08X %08X %08X\n%08i: %08X %08X %08X %08X %08X %08X %08X %08X\n",PC,*armregs[0],*armregs[1],*armregs[2],*armregs[3],*armregs[4],*armregs[5],*armregs[6],*armregs[7],inscount,*armregs[8],*armregs[9],*armregs[10],*armregs[11],*armregs[12],*armregs[13],*armregs[14],*armregs[15]);
         }
 }
+
+/*****************************************************
+ * Block translation
+ *
+ * Straight runs of code are decoded once into blocks of instructions
+ * that each carry a handler.  The common data processing, branch and
+ * immediate offset load and store forms have handlers of their own
+ * which do just what the interpreter does for that case without
+ * fetching and decoding the instruction again.  Everything else is
+ * passed to the interpreter's own code.  A block keeps the words it was
+ * decoded from so the prefetch pipeline is filled exactly as the
+ * interpreter fills it.
+ *
+ * Blocks are found by address in a direct mapped cache and are only
+ * used while the generation count of their 4K page is unchanged.  The
+ * count is bumped by any write to a page code has been decoded from.
+ *****************************************************/
+
+#define ARM_JIT_BLOCKS 2048
+#define ARM_JIT_LEN    32
+
+typedef struct arm_tinsn arm_tinsn_t;
+
+struct arm_tinsn {
+    void (*fn)(const arm_tinsn_t *i);
+    uint32_t opcode;
+    uint32_t imm;       /* rotated immediate, offset or branch displacement */
+    uint8_t cond, rd, rn;
+};
+
+struct arm_block {
+    uint32_t addr;
+    uint32_t gen;
+    int len;
+    arm_tinsn_t insns[ARM_JIT_LEN];
+    uint32_t words[ARM_JIT_LEN+2];
+};
+static uint32_t arm_jit_gen[ARM_JIT_PAGES+ARM_ROM_SIZE/4096];
+static unsigned arm_jit_writes;
+
+static void arm_jit_written(uint32_t addr)
+{
+    arm_jit_gen[addr>>12]++;
+    arm_jit_code[addr>>12]=0;
+    arm_jit_writes++;
+}
+
+static void arm_jit_flush(void)
+{
+    if (arm_blocks)
+        for (int c = 0; c < ARM_JIT_BLOCKS; c++)
+            arm_blocks[c].addr = 0xFFFFFFFF;
+    memset(arm_jit_code, 0, sizeof arm_jit_code);
+}
+
+#define TRD armregs[i->rd]
+#define TRN armregs[i->rn]
+#define OP2  (imm ? i->imm : shift2(i->opcode))
+#define OP2S (imm ? rotate(i->opcode) : shift(i->opcode))
+
+/*Each data processing handler is made in register and immediate forms.
+  The expressions follow the interpreter's for Rd!=15 exactly.*/
+
+#define ARM_T_DP(name, body) \
+static inline void arm_t_##name(const arm_tinsn_t *i, int imm) \
+{ \
+        uint32_t templ; \
+        body; \
+        tubecycles--; \
+} \
+static void arm_t_##name##_r(const arm_tinsn_t *i) { arm_t_##name(i, 0); } \
+static void arm_t_##name##_i(const arm_tinsn_t *i) { arm_t_##name(i, 1); }
+
+ARM_T_DP(and,  templ=OP2;  TRD=TRN&templ)
+ARM_T_DP(ands, templ=OP2S; TRD=TRN&templ; setarmzn(TRD))
+ARM_T_DP(eor,  templ=OP2;  TRD=TRN^templ)
+ARM_T_DP(eors, templ=OP2S; TRD=TRN^templ; setarmzn(TRD))
+ARM_T_DP(sub,  templ=OP2;  TRD=TRN-templ)
+ARM_T_DP(subs, templ=OP2;  setsub(TRN,templ,TRN-templ); TRD=TRN-templ)
+ARM_T_DP(rsb,  templ=OP2;  TRD=templ-TRN)
+ARM_T_DP(rsbs, templ=OP2;  setsub(templ,TRN,templ-TRN); TRD=templ-TRN)
+ARM_T_DP(add,  templ=OP2;  TRD=TRN+templ)
+ARM_T_DP(adds, templ=OP2;  setadd(TRN,templ,TRN+templ); TRD=TRN+templ)
+ARM_T_DP(adc,  uint32_t templ2=CFSET; templ=OP2; TRD=TRN+templ+templ2)
+ARM_T_DP(adcs, uint32_t templ2=CFSET; templ=OP2; setadc(TRN,templ,TRN+templ+templ2); TRD=TRN+templ+templ2)
+ARM_T_DP(sbc,  uint32_t templ2=(CFSET)?0:1; templ=OP2; TRD=TRN-(templ+templ2))
+ARM_T_DP(sbcs, uint32_t templ2=(CFSET)?0:1; templ=OP2; setsbc(TRN,templ,TRN-(templ+templ2)); TRD=TRN-(templ+templ2))
+ARM_T_DP(rsc,  uint32_t templ2=(CFSET)?0:1; templ=OP2; TRD=templ-(TRN+templ2))
+ARM_T_DP(rscs, uint32_t templ2=(CFSET)?0:1; templ=OP2; setsbc(templ,TRN,templ-(TRN+templ2)); TRD=templ-(TRN+templ2))
+ARM_T_DP(tst,  templ=OP2S; setarmzn(TRN&templ))
+ARM_T_DP(teq,  templ=OP2S; setarmzn(TRN^templ))
+ARM_T_DP(cmp,  templ=OP2;  setsub(TRN,templ,TRN-templ))
+ARM_T_DP(cmn,  templ=OP2;  setadd(TRN,templ,TRN+templ))
+ARM_T_DP(orr,  templ=OP2;  TRD=TRN|templ)
+ARM_T_DP(orrs, templ=OP2S; TRD=TRN|templ; setarmzn(TRD))
+ARM_T_DP(mov,  templ=OP2;  TRD=templ)
+ARM_T_DP(movs, templ=OP2S; TRD=templ; setarmzn(TRD))
+ARM_T_DP(bic,  templ=OP2;  TRD=TRN&~templ)
+ARM_T_DP(bics, templ=OP2S; TRD=TRN&~templ; setarmzn(TRD))
+ARM_T_DP(mvn,  templ=OP2;  TRD=~templ)
+ARM_T_DP(mvns, templ=OP2S; TRD=~templ; setarmzn(TRD))
+
+#define ARM_T_PAIR(name) arm_t_##name##_r, arm_t_##name##_i
+
+/*Indexed by bits 20-24 of the opcode, register form first.*/
+static void (*const arm_t_dp[32][2])(const arm_tinsn_t *i) = {
+    { ARM_T_PAIR(and)  }, { ARM_T_PAIR(ands) }, { ARM_T_PAIR(eor)  }, { ARM_T_PAIR(eors) },
+    { ARM_T_PAIR(sub)  }, { ARM_T_PAIR(subs) }, { ARM_T_PAIR(rsb)  }, { ARM_T_PAIR(rsbs) },
+    { ARM_T_PAIR(add)  }, { ARM_T_PAIR(adds) }, { ARM_T_PAIR(adc)  }, { ARM_T_PAIR(adcs) },
+    { ARM_T_PAIR(sbc)  }, { ARM_T_PAIR(sbcs) }, { ARM_T_PAIR(rsc)  }, { ARM_T_PAIR(rscs) },
+    { NULL, NULL       }, { ARM_T_PAIR(tst)  }, { NULL, NULL       }, { ARM_T_PAIR(teq)  },
+    { NULL, NULL       }, { ARM_T_PAIR(cmp)  }, { NULL, NULL       }, { ARM_T_PAIR(cmn)  },
+    { ARM_T_PAIR(orr)  }, { ARM_T_PAIR(orrs) }, { ARM_T_PAIR(mov)  }, { ARM_T_PAIR(movs) },
+    { ARM_T_PAIR(bic)  }, { ARM_T_PAIR(bics) }, { ARM_T_PAIR(mvn)  }, { ARM_T_PAIR(mvns) }
+};
+
+/*Single loads and stores with an immediate offset, which is held
+  already negated for a down offset.*/
+
+static void arm_t_str_pre(const arm_tinsn_t *i)
+{
+        uint32_t addr=TRN+i->imm;
+        writearml(addr,TRD);
+        if (databort) return;
+        if (i->opcode&0x200000) TRN=addr;
+        tubecycles-=3;
+}
+
+static void arm_t_strb_pre(const arm_tinsn_t *i)
+{
+        uint32_t addr=TRN+i->imm;
+        writearmb(addr,TRD);
+        if (databort) return;
+        if (i->opcode&0x200000) TRN=addr;
+        tubecycles-=3;
+}
+
+static void arm_t_ldr_pre(const arm_tinsn_t *i)
+{
+        uint32_t addr=TRN+i->imm,templ;
+        templ=readarml(addr);
+        templ=ldrresult(templ,addr);
+        if (databort) return;
+        if (i->opcode&0x200000) TRN=addr;
+        TRD=templ;
+        tubecycles-=4;
+}
+
+static void arm_t_ldrb_pre(const arm_tinsn_t *i)
+{
+        uint32_t addr=TRN+i->imm,templ;
+        templ=readarmb(addr);
+        if (databort) return;
+        if (i->opcode&0x200000) TRN=addr;
+        TRD=templ;
+        tubecycles-=4;
+}
+
+static void arm_t_str_post(const arm_tinsn_t *i)
+{
+        writearml(TRN,TRD);
+        if (databort) return;
+        TRN+=i->imm;
+        tubecycles-=3;
+}
+
+static void arm_t_strb_post(const arm_tinsn_t *i)
+{
+        writearmb(TRN,TRD);
+        if (databort) return;
+        TRN+=i->imm;
+        tubecycles-=3;
+}
+
+static void arm_t_ldr_post(const arm_tinsn_t *i)
+{
+        uint32_t addr=TRN,templ2;
+        templ2=ldrresult(readarml(addr),addr);
+        if (databort) return;
+        TRD=templ2;
+        TRN+=i->imm;
+        tubecycles-=4;
+}
+
+static void arm_t_ldrb_post(const arm_tinsn_t *i)
+{
+        uint32_t addr=TRN,templ;
+        templ=readarmb(addr);
+        if (databort) return;
+        TRN=addr+i->imm;
+        TRD=templ;
+        tubecycles-=4;
+}
+
+/*Indexed by the pre-index, byte, writeback and load bits.*/
+static void (*const arm_t_ldst[16])(const arm_tinsn_t *i) = {
+    arm_t_str_post,  arm_t_ldr_post,  NULL,            NULL,
+    arm_t_strb_post, arm_t_ldrb_post, NULL,            NULL,
+    arm_t_str_pre,   arm_t_ldr_pre,   arm_t_str_pre,   arm_t_ldr_pre,
+    arm_t_strb_pre,  arm_t_ldrb_pre,  arm_t_strb_pre,  arm_t_ldrb_pre
+};
+
+static void arm_t_b(const arm_tinsn_t *i)
+{
+        armregs[15]=((armregs[15]+i->imm)&0x3FFFFFC)|(armregs[15]&0xFC000003);
+        refillpipeline();
+        tubecycles-=4;
+}
+
+static void arm_t_bl(const arm_tinsn_t *i)
+{
+        armregs[14]=armregs[15]-4;
+        armregs[15]=((armregs[15]+i->imm)&0x3FFFFFC)|(armregs[15]&0xFC000003);
+        refillpipeline();
+        tubecycles-=4;
+}
+
+static void arm_t_insn(const arm_tinsn_t *i)
+{
+        arm_insn(i->opcode);
+}
+
+static void arm_jit_decode(arm_tinsn_t *i, uint32_t opcode)
+{
+        void (*fn)(const arm_tinsn_t *i)=NULL;
+
+        i->opcode=opcode;
+        i->cond=opcode>>28;
+        i->rd=RD;
+        i->rn=RN;
+        i->imm=0;
+        switch ((opcode>>25)&7)
+        {
+                case 0: /*Data processing, register operand*/
+                if (RM==15)
+                        break;
+                if (opcode&0x10)
+                {
+                        if (((opcode>>8)&15)==15)
+                                break;
+                }
+                else if ((opcode&0xFF0)==0x060)
+                        break; /*RRX*/
+                /*Fall through*/
+                case 1: /*Data processing, immediate operand*/
+                if (RD==15 || (RN==15 && (opcode&0x1A00000)!=0x1A00000))
+                        break;
+                fn=arm_t_dp[(opcode>>20)&31][(opcode>>25)&1];
+                i->imm=rotatelookup[opcode&4095];
+                break;
+
+                case 2: /*Load or store, immediate offset*/
+                if (RD==15 || RN==15)
+                        break;
+                fn=arm_t_ldst[(((opcode>>24)&1)<<3)|(((opcode>>22)&1)<<2)|(((opcode>>21)&1)<<1)|((opcode>>20)&1)];
+                i->imm=(opcode&0x800000) ? (opcode&0xFFF) : -(opcode&0xFFF);
+                break;
+
+                case 5: /*Branch*/
+                fn=(opcode&0x1000000) ? arm_t_bl : arm_t_b;
+                i->imm=((opcode&0xFFFFFF)<<2)+4;
+                break;
+        }
+        i->fn=fn ? fn : arm_t_insn;
+}
+
+static inline int arm_jit_page(uint32_t addr)
+{
+        if (addr<ARM_RAM_SIZE)
+                return addr>>12;
+        if (addr>=0x3000000 && addr<0x3000000+ARM_ROM_SIZE)
+                return ARM_JIT_PAGES+((addr&(ARM_ROM_SIZE-1))>>12);
+        return -1;
+}
+
+/*Find or make the block starting at addr.  A block stops after an
+  unconditional branch or SWI and never runs past the end of its page,
+  including the two words the pipeline has fetched beyond it.*/
+
+static const arm_block_t *arm_jit_block(uint32_t addr)
+{
+        arm_block_t *b;
+        uint32_t opcode;
+        int page,room,n;
+
+        if ((page=arm_jit_page(addr))<0)
+                return NULL;
+        b=&arm_blocks[(addr>>2)&(ARM_JIT_BLOCKS-1)];
+        if (b->addr==addr && b->gen==arm_jit_gen[page])
+                return b;
+        room=(0x1000-(addr&0xFFF))>>2;
+        if (room<3)
+                return NULL;
+        room-=2;
+        if (room>ARM_JIT_LEN)
+                room=ARM_JIT_LEN;
+        for (n=0; n<room;)
+        {
+                opcode=b->words[n]=do_readarml(addr+(n<<2));
+                arm_jit_decode(&b->insns[n++],opcode);
+                if ((opcode>>28)==14 && ((((opcode>>25)&7)==5) || ((opcode>>24)&15)==15))
+                        break;
+        }
+        b->words[n]=do_readarml(addr+(n<<2));
+        b->words[n+1]=do_readarml(addr+(n<<2)+4);
+        b->len=n;
+        b->addr=addr;
+        b->gen=arm_jit_gen[page];
+        if (page<ARM_JIT_PAGES)
+                arm_jit_code[page]=1;
+        return b;
+}
+
+/*Run a translated instruction and then the interpreter's code for it
+  from the same state, keeping the interpreter's result and reporting
+  any difference.  Loads and stores outside RAM are left to the
+  interpreter alone as reads and writes there can have side effects.*/
+
+static void arm_jit_check(const arm_tinsn_t *i)
+{
+        uint32_t regs[16],tregs[16],addr=0,old=0,tword=0;
+        uint32_t op2=opcode2,op3=opcode3,top2,top3;
+        int cycles=tubecycles,tcycles;
+        bool mem=false;
+
+        if (i->fn==arm_t_insn)
+        {
+                arm_insn(i->opcode);
+                return;
+        }
+        if (((i->opcode>>25)&7)==2)
+        {
+                addr=TRN;
+                if (i->opcode&0x1000000)
+                        addr+=i->imm;
+                if (addr>=ARM_RAM_SIZE)
+                {
+                        arm_insn(i->opcode);
+                        return;
+                }
+                addr&=~3;
+                old=armram[addr>>2];
+                mem=true;
+        }
+        memcpy(regs,armregs,sizeof regs);
+        i->fn(i);
+        memcpy(tregs,armregs,sizeof tregs);
+        tcycles=tubecycles;
+        top2=opcode2;
+        top3=opcode3;
+        if (mem)
+        {
+                tword=armram[addr>>2];
+                armram[addr>>2]=old;
+        }
+        memcpy(armregs,regs,sizeof regs);
+        tubecycles=cycles;
+        opcode2=op2;
+        opcode3=op3;
+        arm_insn(i->opcode);
+        if (memcmp(tregs,armregs,sizeof tregs) || tcycles!=tubecycles ||
+            top2!=opcode2 || top3!=opcode3 || (mem && tword!=armram[addr>>2]))
+                log_warn("arm: translated %08X at %07X differs from the interpreter",i->opcode,(regs[15]&0x3FFFFFC)-8);
+}
+
+static void arm_run_blocks(void)
+{
+        const arm_block_t *b;
+        const arm_tinsn_t *i;
+        uint32_t opcode,next;
+        unsigned writes;
+        int n;
+
+        while (tubecycles>0)
+        {
+                b=arm_jit_block((PC-8)&0x3FFFFFC);
+                if (!b || b->words[0]!=opcode2 || b->words[1]!=opcode3)
+                {
+                        opcode=opcode2;
+                        opcode2=opcode3;
+                        opcode3=readarml(PC);
+                        if (flaglookup[opcode>>28][armregs[15]>>28])
+                                arm_insn(opcode);
+                        arm_insn_end();
+                        if (endtimeslice)
+                        {
+                                endtimeslice=0;
+                                return;
+                        }
+                        continue;
+                }
+                writes=arm_jit_writes;
+                next=b->addr+8;
+                for (n=0;;)
+                {
+                        i=&b->insns[n];
+                        opcode2=b->words[n+1];
+                        opcode3=b->words[n+2];
+                        if (flaglookup[i->cond][armregs[15]>>28])
+                        {
+                                if (arm_lockstep)
+                                        arm_jit_check(i);
+                                else
+                                        i->fn(i);
+                        }
+                        arm_insn_end();
+                        if (endtimeslice)
+                        {
+                                endtimeslice=0;
+                                return;
+                        }
+                        next+=4;
+                        if (++n==b->len || PC!=(next&0x3FFFFFC) || arm_jit_writes!=writes || tubecycles<=0)
+                                break;
+                }
+        }
+}
+
+void arm_exec(void)
+{
+        if (arm_translate && !arm_debug_enabled)
+        {
+                if (!arm_blocks)
+                {
+                        if (!(arm_blocks=malloc(ARM_JIT_BLOCKS*sizeof(arm_block_t))))
+                        {
+                                log_error("arm: unable to allocate translation cache");
+                                arm_translate=false;
+                                arm_interpret();
+                                return;
+                        }
+                        arm_jit_flush();
+                }
+                arm_run_blocks();
+        }
+        else
+                arm_interpret();
+}
@@ -0,0 +1,435 @@
+/*B-em v2.2 by Tom Walker
+  bemtrace - decode a binary trace of the host 6502 written by the
+  debugger's btrace command or b-em-headless -trace.*/
+
+#include <ctype.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "btrace.h"
+
+enum
+{
+        IMP,IMPA,IMM,ZP,ZPX,ZPY,INDX,INDY,IND,ABS,ABSX,ABSY,IND16,IND1X,BRA
+};
+
+static const char dopname[256][6]=
+{
+/*00*/  "BRK","ORA","---","---","TSB","ORA","ASL","---","PHP","ORA","ASL","---","TSB","ORA","ASL","---",
+/*10*/  "BPL","ORA","ORA","---","TRB","ORA","ASL","---","CLC","ORA","INC","---","TRB","ORA","ASL","---",
+/*20*/  "JSR","AND","---","---","BIT","AND","ROL","---","PLP","AND","ROL","---","BIT","AND","ROL","---",
+/*30*/  "BMI","AND","AND","---","BIT","AND","ROL","---","SEC","AND","DEC","---","BIT","AND","ROL","---",
+/*40*/  "RTI","EOR","---","---","---","EOR","LSR","---","PHA","EOR","LSR","---","JMP","EOR","LSR","---",
+/*50*/  "BVC","EOR","EOR","---","---","EOR","LSR","---","CLI","EOR","PHY","---","---","EOR","LSR","---",
+/*60*/  "RTS","ADC","---","---","STZ","ADC","ROR","---","PLA","ADC","ROR","---","JMP","ADC","ROR","---",
+/*70*/  "BVS","ADC","ADC","---","STZ","ADC","ROR","---","SEI","ADC","PLY","---","JMP","ADC","ROR","---",
+/*80*/  "BRA","STA","---","---","STY","STA","STX","---","DEY","BIT","TXA","---","STY","STA","STX","---",
+/*90*/  "BCC","STA","STA","---","STY","STA","STX","---","TYA","STA","TXS","---","STZ","STA","STZ","---",
+/*A0*/  "LDY","LDA","LDX","---","LDY","LDA","LDX","---","TAY","LDA","TAX","---","LDY","LDA","LDX","---",
+/*B0*/  "BCS","LDA","LDA","---","LDY","LDA","LDX","---","CLV","LDA","TSX","---","LDY","LDA","LDX","---",
+/*C0*/  "CPY","CMP","---","---","CPY","CMP","DEC","---","INY","CMP","DEX","WAI","CPY","CMP","DEC","---",
+/*D0*/  "BNE","CMP","CMP","---","---","CMP","DEC","---","CLD","CMP","PHX","STP","---","CMP","DEC","---",
+/*E0*/  "CPX","SBC","---","---","CPX","SBC","INC","---","INX","SBC","NOP","---","CPX","SBC","INC","---",
+/*F0*/  "BEQ","SBC","SBC","---","---","SBC","INC","---","SED","SBC","PLX","---","---","SBC","INC","---",
+};
+
+static const int dopaddr[256]=
+{
+/*00*/  IMP,  INDX, IMP,  IMP,  ZP,   ZP,   ZP,   IMP,  IMP,  IMM,  IMPA, IMP,  ABS,  ABS,  ABS,  IMP,
+/*10*/  BRA,  INDY, IND,  IMP,  ZP,   ZPX,  ZPX,  IMP,  IMP,  ABSY, IMPA, IMP,  ABS,  ABSX, ABSX, IMP,
+/*20*/  ABS,  INDX, IMP,  IMP,  ZP,   ZP,   ZP,   IMP,  IMP,  IMM,  IMPA, IMP,  ABS,  ABS,  ABS,  IMP,
+/*30*/  BRA,  INDY, IND,  IMP,  ZPX,  ZPX,  ZPX,  IMP,  IMP,  ABSY, IMPA, IMP,  ABSX, ABSX, ABSX, IMP,
+/*40*/  IMP,  INDX, IMP,  IMP,  ZP,   ZP,   ZP,   IMP,  IMP,  IMM,  IMPA, IMP,  ABS,  ABS,  ABS,  IMP,
+/*50*/  BRA,  INDY, IND,  IMP,  ZP,   ZPX,  ZPX,  IMP,  IMP,  ABSY, IMP,  IMP,  ABS,  ABSX, ABSX, IMP,
+/*60*/  IMP,  INDX, IMP,  IMP,  ZP,   ZP,   ZP,   IMP,  IMP,  IMM,  IMPA, IMP,  IND16,ABS,  ABS,  IMP,
+/*70*/  BRA,  INDY, IND,  IMP,  ZPX,  ZPX,  ZPX,  IMP,  IMP,  ABSY, IMP,  IMP,  IND1X,ABSX, ABSX, IMP,
+/*80*/  BRA,  INDX, IMP,  IMP,  ZP,   ZP,   ZP,   IMP,  IMP,  IMM,  IMP,  IMP,  ABS,  ABS,  ABS,  IMP,
+/*90*/  BRA,  INDY, IND,  IMP,  ZPX,  ZPX,  ZPY,  IMP,  IMP,  ABSY, IMP,  IMP,  ABS,  ABSX, ABSX, IMP,
+/*A0*/  IMM,  INDX, IMM,  IMP,  ZP,   ZP,   ZP,   IMP,  IMP,  IMM,  IMP,  IMP,  ABS,  ABS,  ABS,  IMP,
+/*B0*/  BRA,  INDY, IND,  IMP,  ZPX,  ZPX,  ZPY,  IMP,  IMP,  ABSY, IMP,  IMP,  ABSX, ABSX, ABSY, IMP,
+/*C0*/  IMM,  INDX, IMP,  IMP,  ZP,   ZP,   ZP,   IMP,  IMP,  IMM,  IMP,  IMP,  ABS,  ABS,  ABS,  IMP,
+/*D0*/  BRA,  INDY, IND,  IMP,  ZP,   ZPX,  ZPX,  IMP,  IMP,  ABSY, IMP,  IMP,  ABS,  ABSX, ABSX, IMP,
+/*E0*/  IMM,  INDX, IMP,  IMP,  ZP,   ZP,   ZP,   IMP,  IMP,  IMM,  IMP,  IMP,  ABS,  ABS,  ABS,  IMP,
+/*F0*/  BRA,  INDY, IND,  IMP,  ZP,   ZPX,  ZPX,  IMP,  IMP,  ABSY, IMP,  IMP,  ABS,  ABSX, ABSX, IMP,
+};
+
+static const char dopnamenmos[256][6]=
+{
+/*00*/  "BRK","ORA","HLT","SLO","NOP","ORA","ASL","SLO","PHP","ORA","ASL","ANC","NOP","ORA","ASL","SLO",
+/*10*/  "BPL","ORA","HLT","SLO","NOP","ORA","ASL","SLO","CLC","ORA","NOP","SLO","NOP","ORA","ASL","SLO",
+/*20*/  "JSR","AND","HLT","RLA","NOP","AND","ROL","RLA","PLP","AND","ROL","ANC","BIT","AND","ROL","RLA",
+/*30*/  "BMI","AND","HLT","RLA","NOP","AND","ROL","RLA","SEC","AND","NOP","RLA","NOP","AND","ROL","RLA",
+/*40*/  "RTI","EOR","HLT","SRE","NOP","EOR","LSR","SRE","PHA","EOR","LSR","ASR","JMP","EOR","LSR","SRE",
+/*50*/  "BVC","EOR","HLT","SRE","NOP","EOR","LSR","SRE","CLI","EOR","NOP","SRE","NOP","EOR","LSR","SRE",
+/*60*/  "RTS","ADC","HLT","RRA","NOP","ADC","ROR","RRA","PLA","ADC","ROR","ARR","JMP","ADC","ROR","RRA",
+/*70*/  "BVS","ADC","HLT","RRA","NOP","ADC","ROR","RRA","SEI","ADC","NOP","RRA","NOP","ADC","ROR","RRA",
+/*80*/  "BRA","STA","NOP","SAX","STY","STA","STX","SAX","DEY","NOP","TXA","ANE","STY","STA","STX","SAX",
+/*90*/  "BCC","STA","HLT","SHA","STY","STA","STX","SAX","TYA","STA","TXS","SHS","SHY","STA","SHX","SHA",
+/*A0*/  "LDY","LDA","LDX","LAX","LDY","LDA","LDX","LAX","TAY","LDA","TAX","LXA","LDY","LDA","LDX","LAX",
+/*B0*/  "BCS","LDA","HLT","LAX","LDY","LDA","LDX","LAX","CLV","LDA","TSX","LAS","LDY","LDA","LDX","LAX",
+/*C0*/  "CPY","CMP","NOP","DCP","CPY","CMP","DEC","DCP","INY","CMP","DEX","SBX","CPY","CMP","DEC","DCP",
+/*D0*/  "BNE","CMP","HLT","DCP","NOP","CMP","DEC","DCP","CLD","CMP","NOP","DCP","NOP","CMP","DEC","DCP",
+/*E0*/  "CPX","SBC","NOP","ISB","CPX","SBC","INC","ISB","INX","SBC","NOP","SBC","CPX","SBC","INC","ISB",
+/*F0*/  "BEQ","SBC","HLT","ISB","NOP","SBC","INC","ISB","SED","SBC","NOP","ISB","NOP","SBC","INC","ISB",
+};
+
+static const int dopaddrnmos[256]=
+{
+/*00*/  IMP,  INDX, IMP,  INDX, ZP,   ZP,   ZP,   ZP,   IMP,  IMM,  IMPA, IMM,  ABS,  ABS,  ABS,  ABS,
+/*10*/  BRA,  INDY, IMP,  INDY, ZPX,  ZPX,  ZPX,  ZPX,  IMP,  ABSY, IMP,  ABSY, ABSX, ABSX, ABSX, ABSX,
+/*20*/  ABS,  INDX, IMP,  INDX, ZP,   ZP,   ZP,   ZP,   IMP,  IMM,  IMPA, IMM,  ABS,  ABS,  ABS,  ABS,
+/*30*/  BRA,  INDY, IMP,  INDY, ZPX,  ZPX,  ZPX,  ZPX,  IMP,  ABSY, IMP,  ABSY, ABSX, ABSX, ABSX, ABSX,
+/*40*/  IMP,  INDX, IMP,  INDX, ZP,   ZP,   ZP,   ZP,   IMP,  IMM,  IMPA, IMM,  ABS,  ABS,  ABS,  ABS,
+/*50*/  BRA,  INDY, IMP,  INDY, ZPX,  ZPX,  ZPX,  ZPX,  IMP,  ABSY, IMP,  ABSY, ABSX, ABSX, ABSX, ABSX,
+/*60*/  IMP,  INDX, IMP,  INDX, ZP,   ZP,   ZP,   ZP,   IMP,  IMM,  IMPA, IMM,  IND16,ABS,  ABS,  ABS,
+/*70*/  BRA,  INDY, IMP,  INDY, ZPX,  ZPX,  ZPX,  ZPX,  IMP,  ABSY, IMP,  ABSY, ABSX, ABSX, ABSX, ABSX,
+/*80*/  BRA,  INDX, IMM,  INDX, ZP,   ZP,   ZP,   ZP,   IMP,  IMM,  IMP,  IMM,  ABS,  ABS,  ABS,  ABS,
+/*90*/  BRA,  INDY, IMP,  INDY, ZPX,  ZPX,  ZPY,  ZPY,  IMP,  ABSY, IMP,  ABSY, ABSX, ABSX, ABSX, ABSX,
+/*A0*/  IMM,  INDX, IMM,  INDX, ZP,   ZP,   ZP,   ZP,   IMP,  IMM,  IMP,  IMM,  ABS,  ABS,  ABS,  ABS,
+/*B0*/  BRA,  INDY, IMP,  INDY, ZPX,  ZPX,  ZPY,  ZPY,  IMP,  ABSY, IMP,  ABSY, ABSX, ABSX, ABSY, ABSX,
+/*C0*/  IMM,  INDX, IMM,  INDX, ZP,   ZP,   ZP,   ZP,   IMP,  IMM,  IMP,  IMM,  ABS,  ABS,  ABS,  ABS,
+/*D0*/  BRA,  INDY, IMP,  INDY, ZPX,  ZPX,  ZPX,  ZPX,  IMP,  ABSY, IMP,  ABSY, ABSX, ABSX, ABSX, ABSX,
+/*E0*/  IMM,  INDX, IMM,  INDX, ZP,   ZP,   ZP,   ZP,   IMP,  IMM,  IMP,  IMM,  ABS,  ABS,  ABS,  ABS,
+/*F0*/  BRA,  INDY, IMP,  INDY, ZPX,  ZPX,  ZPX,  ZPX,  IMP,  ABSY, IMP,  ABSY, ABSX, ABSX, ABSX, ABSX,
+};
+
+typedef struct {
+    uint32_t addr;
+    char     name[33];
+} symbol_t;
+
+static symbol_t *symbols;
+static size_t num_syms, max_syms;
+
+static int sym_cmp(const void *a, const void *b)
+{
+    uint32_t aa = ((const symbol_t *)a)->addr;
+    uint32_t ba = ((const symbol_t *)b)->addr;
+    return aa < ba ? -1 : aa > ba ? 1 : 0;
+}
+
+/*Symbol files use the same form as the debugger's symbol command so a
+  debugger exec file can be used as is: [symbol ]name=[rom:]addr with
+  addresses in hex.  Anything else is ignored.*/
+
+static bool load_symbols(const char *fn)
+{
+    FILE *fp;
+    char line[256], name[33];
+    char *ptr, *end;
+    unsigned long addr, rom;
+
+    if (!(fp = fopen(fn, "r"))) {
+        fprintf(stderr, "bemtrace: unable to open symbol file %s: %s\n", fn, strerror(errno));
+        return false;
+    }
+    while (fgets(line, sizeof line, fp)) {
+        for (ptr = line; isspace(*ptr); ptr++);
+        if (!strncasecmp(ptr, "symbol", 6) && isspace(ptr[6]))
+            for (ptr += 6; isspace(*ptr); ptr++);
+        if (sscanf(ptr, "%32[^= \t]", name) != 1 || !(ptr = strchr(ptr, '=')))
+            continue;
+        for (ptr++; isspace(*ptr); ptr++);
+        if (*ptr == '&' || *ptr == '$')
+            ptr++;
+        addr = strtoul(ptr, &end, 16);
+        if (end == ptr)
+            continue;
+        if (*end == ':') {
+            rom = addr;
+            ptr = end + 1;
+            addr = strtoul(ptr, &end, 16);
+            if (end == ptr)
+                continue;
+            addr |= rom << 28;
+        }
+        if (num_syms == max_syms) {
+            size_t new_max = max_syms ? max_syms * 2 : 256;
+            symbol_t *new_syms = realloc(symbols, new_max * sizeof(symbol_t));
+            if (!new_syms) {
+                fputs("bemtrace: out of memory\n", stderr);
+                fclose(fp);
+                return false;
+            }
+            symbols = new_syms;
+            max_syms = new_max;
+        }
+        symbols[num_syms].addr = addr;
+        strcpy(symbols[num_syms++].name, name);
+    }
+    fclose(fp);
+    qsort(symbols, num_syms, sizeof(symbol_t), sym_cmp);
+    return true;
+}
+
+static const char *find_symbol(uint32_t addr)
+{
+    symbol_t key, *sym;
+
+    if (!num_syms)
+        return NULL;
+    key.addr = addr;
+    sym = bsearch(&key, symbols, num_syms, sizeof(symbol_t), sym_cmp);
+    return sym ? sym->name : NULL;
+}
+
+/*Addresses in the sideways ROM area take the ROM bank of the
+  instruction that refers to them.*/
+
+static uint32_t with_bank(uint32_t pc, uint32_t addr)
+{
+    if (addr >= 0x8000 && addr < 0xc000)
+        addr |= pc & 0xf0000000;
+    return addr;
+}
+
+static void print_addr(uint32_t addr, FILE *out)
+{
+    if (addr & 0xf0000000)
+        fprintf(out, "%X:%04X", addr >> 28, addr & 0xffff);
+    else
+        fprintf(out, "  %04X", addr);
+}
+
+static const char *disassemble(int cmos, const btrace_rec_t *rec, FILE *out)
+{
+    uint16_t addr = rec->addr;
+    uint8_t op = rec->bytes[0], p1 = rec->bytes[1], p2 = rec->bytes[2];
+    const char *opname = cmos ? dopname[op] : dopnamenmos[op];
+    const char *sym = NULL;
+    unsigned temp;
+
+    if (!rec->nbytes) {
+        fputs("??             ???              ", out);
+        return NULL;
+    }
+    fprintf(out, "%02X ", op);
+    switch (cmos ? dopaddr[op] : dopaddrnmos[op])
+    {
+        case IMP:
+            fprintf(out, "      %s         ", opname);
+            break;
+        case IMPA:
+            fprintf(out, "      %s A       ", opname);
+            break;
+        case IMM:
+            fprintf(out, "%02X    %s #%02X     ", p1, opname, p1);
+            break;
+        case ZP:
+            fprintf(out, "%02X    %s %02X      ", p1, opname, p1);
+            break;
+        case ZPX:
+            fprintf(out, "%02X    %s %02X,X    ", p1, opname, p1);
+            break;
+        case ZPY:
+            fprintf(out, "%02X    %s %02X,Y    ", p1, opname, p1);
+            break;
+        case IND:
+            fprintf(out, "%02X    %s (%02X)    ", p1, opname, p1);
+            break;
+        case INDX:
+            fprintf(out, "%02X    %s (%02X,X)  ", p1, opname, p1);
+            break;
+        case INDY:
+            fprintf(out, "%02X    %s (%02X),Y  ", p1, opname, p1);
+            break;
+        case ABS:
+            fprintf(out, "%02X %02X %s %02X%02X    ", p1, p2, opname, p2, p1);
+            sym = find_symbol(with_bank(rec->addr, p1 | (p2 << 8)));
+            break;
+        case ABSX:
+            fprintf(out, "%02X %02X %s %02X%02X,X  ", p1, p2, opname, p2, p1);
+            sym = find_symbol(with_bank(rec->addr, p1 | (p2 << 8)));
+            break;
+        case ABSY:
+            fprintf(out, "%02X %02X %s %02X%02X,Y  ", p1, p2, opname, p2, p1);
+            sym = find_symbol(with_bank(rec->addr, p1 | (p2 << 8)));
+            break;
+        case IND16:
+            fprintf(out, "%02X %02X %s (%02X%02X)  ", p1, p2, opname, p2, p1);
+            sym = find_symbol(with_bank(rec->addr, p1 | (p2 << 8)));
+            break;
+        case IND1X:
+            fprintf(out, "%02X %02X %s (%02X%02X,X)", p1, p2, opname, p2, p1);
+            break;
+        case BRA:
+            temp = (uint16_t)(addr + 2 + (signed char)p1);
+            fprintf(out, "%02X    %s %04X    ", p1, opname, temp);
+            sym = find_symbol(with_bank(rec->addr, temp));
+            break;
+    }
+    return sym;
+}
+
+static void print_exec(int cmos, const btrace_rec_t *rec, FILE *out)
+{
+    const char *sym = find_symbol(rec->addr);
+    uint8_t f = rec->p;
+
+    if (sym)
+        fprintf(out, "%s:\n", sym);
+    fprintf(out, "%12" PRId64 " ", rec->cycle);
+    print_addr(rec->addr, out);
+    fputs(" : ", out);
+    sym = disassemble(cmos, rec, out);
+    fprintf(out, " %02X %02X %02X %02X ", rec->a, rec->x, rec->y, rec->s);
+    putc((f & 0x80) ? 'N' : '.', out);
+    putc((f & 0x40) ? 'V' : '.', out);
+    putc((f & 0x08) ? 'D' : '.', out);
+    putc((f & 0x04) ? 'I' : '.', out);
+    putc((f & 0x02) ? 'Z' : '.', out);
+    putc((f & 0x01) ? 'C' : '.', out);
+    if (sym)
+        fprintf(out, " \\ %s", sym);
+    putc('\n', out);
+}
+
+static void print_mem(const btrace_rec_t *rec, FILE *out)
+{
+    const char *sym = find_symbol(rec->addr);
+
+    fprintf(out, "%12" PRId64 "   %s ", rec->cycle, rec->type == BTRACE_WRITE ? "write" : "read ");
+    print_addr(rec->addr, out);
+    fprintf(out, " = %02X", rec->bytes[0]);
+    if (sym)
+        fprintf(out, " \\ %s", sym);
+    putc('\n', out);
+}
+
+static bool show_mem;
+static int64_t from_cycle = 0, to_cycle = INT64_MAX;
+static uint32_t from_pc = 0, to_pc = 0xffff;
+static int only_rom = -1;
+
+static bool wanted(const btrace_rec_t *rec)
+{
+    uint32_t pc = rec->addr & 0xffff;
+
+    if (rec->cycle < from_cycle || rec->cycle > to_cycle)
+        return false;
+    if (pc < from_pc || pc > to_pc)
+        return false;
+    if (only_rom >= 0 && (pc < 0x8000 || pc >= 0xc000 || (rec->addr >> 28) != only_rom))
+        return false;
+    return true;
+}
+
+static int display_trace(const char *filename, FILE *fp)
+{
+    btrace_hdr_t hdr;
+    btrace_rec_t rec;
+    bool shown = false;
+
+    if (fread(&hdr, sizeof hdr, 1, fp) != 1 || memcmp(hdr.magic, BTRACE_MAGIC, sizeof hdr.magic)) {
+        fprintf(stderr, "bemtrace: %s is not a B-em binary trace file\n", filename);
+        return 1;
+    }
+    if (hdr.version != BTRACE_VERSION || hdr.rec_size != sizeof(btrace_rec_t)) {
+        fprintf(stderr, "bemtrace: %s: unsupported trace version %d, record size %d\n", filename, hdr.version, hdr.rec_size);
+        return 1;
+    }
+    while (fread(&rec, sizeof rec, 1, fp) == 1) {
+        if (rec.type == BTRACE_EXEC) {
+            if ((shown = wanted(&rec)))
+                print_exec(hdr.cmos, &rec, stdout);
+        }
+        else if (show_mem && shown)
+            print_mem(&rec, stdout);
+    }
+    if (ferror(fp)) {
+        fprintf(stderr, "bemtrace: error reading %s: %s\n", filename, strerror(errno));
+        return 1;
+    }
+    return 0;
+}
+
+static bool parse_range(const char *arg, int base, int64_t *from, int64_t *to)
+{
+    char *end;
+
+    *from = strtoll(arg, &end, base);
+    if (end == arg)
+        return false;
+    if (*end == '-' || *end == ',') {
+        arg = end + 1;
+        *to = strtoll(arg, &end, base);
+        if (end == arg)
+            return false;
+    }
+    else if (*end)
+        return false;
+    return true;
+}
+
+static const char usage[] =
+    "Usage: bemtrace [options] trace-file...\n\n"
+    "-s file       - load symbols from file, as name=[rom:]addr lines\n"
+    "-m            - show memory reads and writes\n"
+    "-c from[-to]  - only instructions within a range of cycles (decimal)\n"
+    "-p from[-to]  - only instructions within a range of addresses (hex)\n"
+    "-r rom        - only instructions within sideways ROM bank rom (hex)\n";
+
+int main(int argc, char **argv)
+{
+    int c, status = 0;
+    int64_t from, to;
+    const char *filename;
+    FILE *fp;
+
+    while ((c = getopt(argc, argv, "s:mc:p:r:")) != -1) {
+        switch (c) {
+            case 's':
+                if (!load_symbols(optarg))
+                    return 1;
+                break;
+            case 'm':
+                show_mem = true;
+                break;
+            case 'c':
+                to = INT64_MAX;
+                if (!parse_range(optarg, 10, &from, &to)) {
+                    fputs(usage, stderr);
+                    return 1;
+                }
+                from_cycle = from;
+                to_cycle = to;
+                break;
+            case 'p':
+                to = 0xffff;
+                if (!parse_range(optarg, 16, &from, &to)) {
+                    fputs(usage, stderr);
+                    return 1;
+                }
+                from_pc = from;
+                to_pc = to;
+                break;
+            case 'r':
+                only_rom = strtol(optarg, NULL, 16) & 15;
+                break;
+            default:
+                fputs(usage, stderr);
+                return 1;
+        }
+    }
+    if (optind == argc)
+        status = display_trace("<stdin>", stdin);
+    else {
+        for (; optind < argc; optind++) {
+            filename = argv[optind];
+            if ((fp = fopen(filename, "rb"))) {
+                status += display_trace(filename, fp);
+                fclose(fp);
+            } else {
+                fprintf(stderr, "bemtrace: unable to open %s: %s\n", filename, strerror(errno));
+                status++;
+            }
+        }
+    }
+    return status;
+}
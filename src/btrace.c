@@ -0,0 +1,146 @@
+/*B-em v2.2 by Tom Walker
+  Binary trace of the host 6502.
+
+  The emulation thread fills one block of records at a time.  When a
+  block is full it is passed to a writer thread through a ring of
+  blocks and the next free block is taken, so the CPU never waits for
+  the file unless the writer falls a whole ring behind.*/
+
+#include "b-em.h"
+#include <errno.h>
+#include "btrace.h"
+#include "spsc.h"
+
+#define BTRACE_BLOCK_RECS 4096
+#define BTRACE_NBLOCKS    64
+
+bool btrace_active = false;
+btrace_rec_t *btrace_ptr, *btrace_end, *btrace_limit, *btrace_insn;
+
+static btrace_rec_t *btrace_blocks;
+static unsigned btrace_fill[BTRACE_NBLOCKS];
+static volatile unsigned btrace_head, btrace_tail;
+static bool btrace_stopping;
+
+static FILE *btrace_fp;
+static ALLEGRO_THREAD *btrace_thread;
+static ALLEGRO_MUTEX *btrace_mutex;
+static ALLEGRO_COND *btrace_cond;
+
+static void *btrace_writer(ALLEGRO_THREAD *thread, void *data)
+{
+    unsigned tail = btrace_tail;
+    btrace_rec_t *block;
+
+    al_lock_mutex(btrace_mutex);
+    for (;;) {
+        while (tail == spsc_load(&btrace_head) && !btrace_stopping)
+            al_wait_cond(btrace_cond, btrace_mutex);
+        if (tail == spsc_load(&btrace_head))
+            break;
+        al_unlock_mutex(btrace_mutex);
+        block = btrace_blocks + (tail % BTRACE_NBLOCKS) * BTRACE_BLOCK_RECS;
+        if (fwrite(block, sizeof(btrace_rec_t), btrace_fill[tail % BTRACE_NBLOCKS], btrace_fp) != btrace_fill[tail % BTRACE_NBLOCKS])
+            log_error("btrace: write error: %s", strerror(errno));
+        spsc_store(&btrace_tail, ++tail);
+        al_lock_mutex(btrace_mutex);
+    }
+    al_unlock_mutex(btrace_mutex);
+    return NULL;
+}
+
+static void btrace_publish(void)
+{
+    unsigned head = btrace_head;
+    btrace_rec_t *block = btrace_blocks + (head % BTRACE_NBLOCKS) * BTRACE_BLOCK_RECS;
+
+    btrace_fill[head % BTRACE_NBLOCKS] = btrace_ptr - block;
+    al_lock_mutex(btrace_mutex);
+    spsc_store(&btrace_head, head + 1);
+    al_signal_cond(btrace_cond);
+    al_unlock_mutex(btrace_mutex);
+}
+
+/*Called when an instruction starts past btrace_end, so the whole of
+  the instruction goes in the new block.  Data accesses only roll over
+  if BTRACE_INSN_RECS was not enough, and then the bytes still to come
+  of the instruction, whose record has gone to the writer, are lost.*/
+
+btrace_rec_t *btrace_block(void)
+{
+    unsigned head;
+
+    btrace_publish();
+    head = btrace_head;
+    while (head - spsc_load(&btrace_tail) >= BTRACE_NBLOCKS)
+        al_rest(0.001);
+    btrace_ptr = btrace_blocks + (head % BTRACE_NBLOCKS) * BTRACE_BLOCK_RECS;
+    btrace_limit = btrace_ptr + BTRACE_BLOCK_RECS;
+    btrace_end = btrace_limit - BTRACE_INSN_RECS;
+    btrace_insn = NULL;
+    return btrace_ptr;
+}
+
+bool btrace_open(const char *fn, bool cmos)
+{
+    btrace_hdr_t hdr;
+
+    btrace_close();
+    if (!(btrace_fp = fopen(fn, "wb"))) {
+        log_error("btrace: unable to open %s for writing: %s", fn, strerror(errno));
+        return false;
+    }
+    memset(&hdr, 0, sizeof hdr);
+    memcpy(hdr.magic, BTRACE_MAGIC, sizeof hdr.magic);
+    hdr.version = BTRACE_VERSION;
+    hdr.cmos = cmos;
+    hdr.rec_size = sizeof(btrace_rec_t);
+    fwrite(&hdr, sizeof hdr, 1, btrace_fp);
+
+    if (!btrace_blocks && !(btrace_blocks = malloc(BTRACE_NBLOCKS * BTRACE_BLOCK_RECS * sizeof(btrace_rec_t)))) {
+        log_error("btrace: out of memory");
+        fclose(btrace_fp);
+        btrace_fp = NULL;
+        return false;
+    }
+    btrace_head = btrace_tail = 0;
+    btrace_stopping = false;
+    btrace_ptr = btrace_blocks;
+    btrace_limit = btrace_ptr + BTRACE_BLOCK_RECS;
+    btrace_end = btrace_limit - BTRACE_INSN_RECS;
+    btrace_insn = NULL;
+    if ((btrace_mutex = al_create_mutex())) {
+        if ((btrace_cond = al_create_cond())) {
+            if ((btrace_thread = al_create_thread(btrace_writer, NULL))) {
+                al_start_thread(btrace_thread);
+                btrace_active = true;
+                return true;
+            }
+            al_destroy_cond(btrace_cond);
+        }
+        al_destroy_mutex(btrace_mutex);
+    }
+    log_error("btrace: unable to start writer thread");
+    fclose(btrace_fp);
+    btrace_fp = NULL;
+    return false;
+}
+
+void btrace_close(void)
+{
+    if (btrace_active) {
+        btrace_active = false;
+        btrace_publish();
+        al_lock_mutex(btrace_mutex);
+        btrace_stopping = true;
+        al_signal_cond(btrace_cond);
+        al_unlock_mutex(btrace_mutex);
+        al_join_thread(btrace_thread, NULL);
+        al_destroy_thread(btrace_thread);
+        al_destroy_cond(btrace_cond);
+        al_destroy_mutex(btrace_mutex);
+        fclose(btrace_fp);
+        btrace_fp = NULL;
+        btrace_insn = NULL;
+    }
+}
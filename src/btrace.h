@@ -0,0 +1,79 @@
+#ifndef __INC_BTRACE_H
+#define __INC_BTRACE_H
+
+/*Binary trace of the host 6502.
+
+  Fixed size records are appended to blocks of an in-memory ring and a
+  writer thread saves each block as it fills.  The file starts with a
+  btrace_hdr_t and is decoded by the separate bemtrace tool.  Records
+  are written in the byte order of the machine that made them.*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define BTRACE_MAGIC   "BEMTRACE"
+#define BTRACE_VERSION 1
+
+enum {
+    BTRACE_EXEC = 1,    /* instruction about to execute */
+    BTRACE_READ,        /* data read, value in bytes[0] */
+    BTRACE_WRITE        /* data write, value in bytes[0] */
+};
+
+typedef struct {
+    char     magic[8];
+    uint8_t  version;
+    uint8_t  cmos;      /* 65C02 rather than NMOS 6502 */
+    uint16_t rec_size;
+    uint32_t reserved;
+} btrace_hdr_t;
+
+typedef struct {
+    int64_t  cycle;     /* 2MHz host cycle count */
+    uint32_t addr;      /* PC or data address, ROM bank in bits 28-31 */
+    uint8_t  type;
+    uint8_t  nbytes;    /* instruction bytes captured so far */
+    uint8_t  bytes[3];
+    uint8_t  a, x, y, p, s;
+    uint8_t  pad[2];
+} btrace_rec_t;
+
+/*Room left at the end of each block so an instruction, with its data
+  accesses and any interrupt that follows it, never has to roll over
+  into the next block part way through.*/
+#define BTRACE_INSN_RECS 16
+
+extern bool btrace_active;
+extern btrace_rec_t *btrace_ptr, *btrace_end, *btrace_limit, *btrace_insn;
+
+bool btrace_open(const char *fn, bool cmos);
+void btrace_close(void);
+btrace_rec_t *btrace_block(void);
+
+static inline btrace_rec_t *btrace_rec(uint8_t type, uint32_t addr, int64_t cycle)
+{
+    btrace_rec_t *rec = btrace_ptr;
+
+    if (rec == btrace_limit)
+        rec = btrace_block();
+    btrace_ptr = rec + 1;
+    memset(rec, 0, sizeof(btrace_rec_t));
+    rec->cycle = cycle;
+    rec->addr = addr;
+    rec->type = type;
+    return rec;
+}
+
+/*Instruction bytes arrive as the CPU fetches them, after the record
+  for the instruction has been made.*/
+
+static inline void btrace_fetch(uint8_t val)
+{
+    btrace_rec_t *rec = btrace_insn;
+
+    if (rec && rec->nbytes < sizeof(rec->bytes))
+        rec->bytes[rec->nbytes++] = val;
+}
+
+#endif
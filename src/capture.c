@@ -0,0 +1,327 @@
+/*B-em screenshot and video capture
+
+  Frames to be saved are copied into one of a small pool of buffers and
+  handed to a thread of their own to encode and write, so neither the
+  emulation nor the display waits on a PNG encoder or the disc.  If the
+  encoder falls so far behind that the pool is empty the frame is not
+  captured, rather than holding up the caller.
+
+  A recording saves every capture_every'th frame, either as a numbered
+  sequence of images or, for a file name ending in .raw, as one stream
+  of raw 32-bit BGRA frames that the encoder need not compress.*/
+
+#include "b-em.h"
+#include "capture.h"
+
+#define CAPTURE_BUFFERS 8
+
+typedef enum {
+    CAPTURE_SHOT,
+    CAPTURE_IMAGE,
+    CAPTURE_RAW,
+    CAPTURE_END
+} capture_kind_t;
+
+typedef struct {
+    capture_kind_t kind;
+    uint32_t *pixels;
+    int width, height;
+    FILE *fp;
+    char name[260];
+} capture_job_t;
+
+bool capture_recording = false;
+int capture_every = 1;
+
+static ALLEGRO_THREAD *capture_thread;
+static ALLEGRO_MUTEX *capture_mutex;
+static ALLEGRO_COND *capture_cond;
+static bool capture_stopping;
+
+static uint32_t *capture_free[CAPTURE_BUFFERS];
+static int capture_nfree, capture_allocated;
+
+/*One more slot than buffers so the end of a recording always fits.*/
+static capture_job_t capture_queue[CAPTURE_BUFFERS + 1];
+static int capture_head, capture_count;
+
+/*Recording state, changed by the GUI and read by the emulation thread.*/
+static char rec_name[260];
+static const char *rec_ext;
+static FILE *rec_fp;
+static unsigned rec_frames, rec_seq, rec_dropped;
+
+static void capture_queue_job(const capture_job_t *job)
+{
+    capture_queue[(capture_head + capture_count) % (CAPTURE_BUFFERS + 1)] = *job;
+    capture_count++;
+    al_signal_cond(capture_cond);
+}
+
+static void capture_release(uint32_t *pixels)
+{
+    if (pixels)
+        capture_free[capture_nfree++] = pixels;
+}
+
+static uint32_t *capture_take(void)
+{
+    uint32_t *pixels = NULL;
+
+    if (capture_nfree)
+        pixels = capture_free[--capture_nfree];
+    else if (capture_allocated < CAPTURE_BUFFERS) {
+        if ((pixels = malloc(CAPTURE_MAX_WIDTH * CAPTURE_MAX_HEIGHT * sizeof(uint32_t))))
+            capture_allocated++;
+        else
+            log_error("capture: out of memory for frame buffer");
+    }
+    return pixels;
+}
+
+uint32_t *capture_buffer(void)
+{
+    uint32_t *pixels = NULL;
+
+    if (capture_mutex) {
+        al_lock_mutex(capture_mutex);
+        pixels = capture_take();
+        al_unlock_mutex(capture_mutex);
+    }
+    return pixels;
+}
+
+void capture_shot(uint32_t *pixels, int width, int height, const char *name)
+{
+    capture_job_t job;
+
+    job.kind = CAPTURE_SHOT;
+    job.pixels = pixels;
+    job.width = width;
+    job.height = height;
+    job.fp = NULL;
+    strncpy(job.name, name, sizeof(job.name) - 1);
+    job.name[sizeof(job.name) - 1] = 0;
+    al_lock_mutex(capture_mutex);
+    capture_queue_job(&job);
+    al_unlock_mutex(capture_mutex);
+}
+
+bool capture_start(const char *name)
+{
+    const char *ext;
+
+    if (!capture_mutex || capture_recording)
+        return false;
+    strncpy(rec_name, name, sizeof(rec_name) - 1);
+    rec_name[sizeof(rec_name) - 1] = 0;
+    ext = strrchr(rec_name, '.');
+    if (ext && strpbrk(ext, "/\\"))
+        ext = NULL;
+    rec_ext = ext ? ext : rec_name + strlen(rec_name);
+    rec_fp = NULL;
+    if (ext && !strcasecmp(ext, ".raw")) {
+        if (!(rec_fp = fopen(rec_name, "wb"))) {
+            log_error("capture: unable to open %s for writing: %s", rec_name, strerror(errno));
+            return false;
+        }
+    }
+    else if (!ext) {
+        log_error("capture: %s has no image type extension", rec_name);
+        return false;
+    }
+    if (capture_every < 1)
+        capture_every = 1;
+    al_lock_mutex(capture_mutex);
+    rec_frames = rec_seq = rec_dropped = 0;
+    capture_recording = true;
+    al_unlock_mutex(capture_mutex);
+    log_info("capture: recording every %d frame(s) to %s", capture_every, rec_name);
+    return true;
+}
+
+void capture_stop(void)
+{
+    capture_job_t job;
+    unsigned seq, dropped;
+
+    if (!capture_recording)
+        return;
+    job.kind = CAPTURE_END;
+    job.pixels = NULL;
+    job.width = job.height = 0;
+    job.fp = rec_fp;
+    strcpy(job.name, rec_name);
+    al_lock_mutex(capture_mutex);
+    capture_recording = false;
+    capture_queue_job(&job);
+    seq = rec_seq;
+    dropped = rec_dropped;
+    al_unlock_mutex(capture_mutex);
+    if (dropped)
+        log_warn("capture: %u frame(s) not recorded as saving fell behind", dropped);
+    log_info("capture: recorded %u frame(s) to %s", seq, rec_name);
+    rec_fp = NULL;
+}
+
+uint32_t *capture_frame_buffer(void)
+{
+    uint32_t *pixels = NULL;
+
+    if (capture_recording && ++rec_frames >= capture_every) {
+        rec_frames = 0;
+        al_lock_mutex(capture_mutex);
+        if (capture_recording && !(pixels = capture_take()))
+            rec_dropped++;
+        al_unlock_mutex(capture_mutex);
+    }
+    return pixels;
+}
+
+void capture_frame(uint32_t *pixels, int width, int height)
+{
+    capture_job_t job;
+
+    job.pixels = pixels;
+    job.width = width;
+    job.height = height;
+    al_lock_mutex(capture_mutex);
+    if (!capture_recording)
+        capture_release(pixels);
+    else {
+        job.fp = rec_fp;
+        if (rec_fp) {
+            job.kind = CAPTURE_RAW;
+            strcpy(job.name, rec_name);
+        }
+        else {
+            job.kind = CAPTURE_IMAGE;
+            snprintf(job.name, sizeof(job.name), "%.*s%05u%s", (int)(rec_ext - rec_name), rec_name, rec_seq, rec_ext);
+        }
+        rec_seq++;
+        capture_queue_job(&job);
+    }
+    al_unlock_mutex(capture_mutex);
+}
+
+static void capture_save_image(ALLEGRO_BITMAP **bmp, const capture_job_t *job)
+{
+    ALLEGRO_LOCKED_REGION *region;
+
+    if (*bmp && (al_get_bitmap_width(*bmp) != job->width || al_get_bitmap_height(*bmp) != job->height)) {
+        al_destroy_bitmap(*bmp);
+        *bmp = NULL;
+    }
+    if (!*bmp && !(*bmp = al_create_bitmap(job->width, job->height))) {
+        log_error("capture: unable to create bitmap for %s", job->name);
+        return;
+    }
+    if ((region = al_lock_bitmap(*bmp, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_WRITEONLY))) {
+        for (int y = 0; y < job->height; y++)
+            memcpy((char *)region->data + region->pitch * y, job->pixels + y * job->width, job->width * sizeof(uint32_t));
+        al_unlock_bitmap(*bmp);
+        if (!al_save_bitmap(job->name, *bmp))
+            log_error("capture: unable to save %s", job->name);
+    }
+}
+
+static void capture_write_raw(const capture_job_t *job, int *width, int *height)
+{
+    static const uint32_t black[CAPTURE_MAX_WIDTH];
+
+    // The first frame fixes the size; later ones are cropped or padded to it.
+    if (!*width) {
+        *width = job->width;
+        *height = job->height;
+        log_info("capture: %s is raw BGRA video, %dx%d at %g frames/s", job->name, *width, *height, 50.0 / capture_every);
+    }
+    int len = (job->width < *width) ? job->width : *width;
+    for (int y = 0; y < *height; y++) {
+        if (y < job->height) {
+            fwrite(job->pixels + y * job->width, sizeof(uint32_t), len, job->fp);
+            fwrite(black, sizeof(uint32_t), *width - len, job->fp);
+        }
+        else
+            fwrite(black, sizeof(uint32_t), *width, job->fp);
+    }
+}
+
+static void *capture_thread_main(ALLEGRO_THREAD *thread, void *data)
+{
+    ALLEGRO_BITMAP *bmp = NULL;
+    int raw_width = 0, raw_height = 0;
+    capture_job_t job;
+
+    al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+    al_set_new_bitmap_format(ALLEGRO_PIXEL_FORMAT_ARGB_8888);
+    for (;;) {
+        al_lock_mutex(capture_mutex);
+        while (!capture_count && !capture_stopping)
+            al_wait_cond(capture_cond, capture_mutex);
+        if (!capture_count) {
+            al_unlock_mutex(capture_mutex);
+            break;
+        }
+        job = capture_queue[capture_head];
+        capture_head = (capture_head + 1) % (CAPTURE_BUFFERS + 1);
+        capture_count--;
+        al_unlock_mutex(capture_mutex);
+
+        switch (job.kind) {
+            case CAPTURE_SHOT:
+            case CAPTURE_IMAGE:
+                capture_save_image(&bmp, &job);
+                break;
+            case CAPTURE_RAW:
+                capture_write_raw(&job, &raw_width, &raw_height);
+                break;
+            case CAPTURE_END:
+                if (job.fp)
+                    fclose(job.fp);
+                raw_width = raw_height = 0;
+                break;
+        }
+
+        al_lock_mutex(capture_mutex);
+        capture_release(job.pixels);
+        al_unlock_mutex(capture_mutex);
+    }
+    if (bmp)
+        al_destroy_bitmap(bmp);
+    return NULL;
+}
+
+void capture_init(void)
+{
+    if ((capture_mutex = al_create_mutex())) {
+        if ((capture_cond = al_create_cond())) {
+            if ((capture_thread = al_create_thread(capture_thread_main, NULL))) {
+                al_start_thread(capture_thread);
+                return;
+            }
+            al_destroy_cond(capture_cond);
+        }
+        al_destroy_mutex(capture_mutex);
+    }
+    capture_mutex = NULL;
+    log_error("capture: unable to start capture thread, screenshots are disabled");
+}
+
+void capture_close(void)
+{
+    if (capture_mutex) {
+        capture_stop();
+        al_lock_mutex(capture_mutex);
+        capture_stopping = true;
+        al_signal_cond(capture_cond);
+        al_unlock_mutex(capture_mutex);
+        al_join_thread(capture_thread, NULL);
+        al_destroy_thread(capture_thread);
+        al_destroy_cond(capture_cond);
+        al_destroy_mutex(capture_mutex);
+        capture_mutex = NULL;
+        while (capture_nfree)
+            free(capture_free[--capture_nfree]);
+        capture_allocated = 0;
+    }
+}
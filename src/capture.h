@@ -0,0 +1,21 @@
+#ifndef __INC_CAPTURE_H
+#define __INC_CAPTURE_H
+
+#define CAPTURE_MAX_WIDTH  1280
+#define CAPTURE_MAX_HEIGHT 800
+
+extern bool capture_recording;
+extern int capture_every;
+
+void capture_init(void);
+void capture_close(void);
+
+uint32_t *capture_buffer(void);
+void capture_shot(uint32_t *pixels, int width, int height, const char *name);
+
+bool capture_start(const char *name);
+void capture_stop(void);
+uint32_t *capture_frame_buffer(void);
+void capture_frame(uint32_t *pixels, int width, int height);
+
+#endif
@@ -3,6 +3,9 @@
 
 #include "b-em.h"
 
+#include "6502.h"
+#include "arm.h"
+#include "capture.h"
 #include "config.h"
 #include "ddnoise.h"
 #include "disc.h"
@@ -12,6 +15,7 @@
 #include "ide.h"
 #include "midi.h"
 #include "scsi.h"
+#include "savestate.h"
 #include "sdf.h"
 #include "sn76489.h"
 #include "sound.h"
@@ -149,6 +153,12 @@ void config_load(void)
     curmodel         = get_config_int(NULL, "model",         3);
     selecttube       = get_config_int(NULL, "tube",         -1);
     tube_speed_num   = get_config_int(NULL, "tubespeed",     0);
+    tube_threaded    = get_config_bool(NULL, "tubethread",   false);
+    tube_idle_skip   = get_config_bool(NULL, "tubeidleskip", true);
+    idle_skip        = get_config_bool(NULL, "idleskip",     true);
+    arm_translate    = get_config_bool(NULL, "armtranslate", true);
+    arm_lockstep     = get_config_bool(NULL, "armlockstep",  false);
+    savestate_rewind_frames = get_config_int(NULL, "rewindframes", 0);
 
     sound_internal   = get_config_bool("sound", "sndinternal",   true);
     sound_beebsid    = get_config_bool("sound", "sndbeebsid",    true);
@@ -170,6 +180,7 @@ void config_load(void)
 
     vid_ledlocation  = get_config_int("video", "ledlocation",   0);
     vid_ledvisibility = get_config_int("video", "ledvisibility", 2);
+    capture_every    = get_config_int("video", "captureevery",  1);
 
     c                = get_config_int("video", "displaymode",   0);
     if (c >= 4) {
@@ -282,6 +293,12 @@ void config_save(void)
         set_config_int(NULL, "model", curmodel);
         set_config_int(NULL, "tube", selecttube);
         set_config_int(NULL, "tubespeed", tube_speed_num);
+        set_config_bool(NULL, "tubethread", tube_threaded);
+        set_config_bool(NULL, "tubeidleskip", tube_idle_skip);
+        set_config_bool(NULL, "idleskip", idle_skip);
+        set_config_bool(NULL, "armtranslate", arm_translate);
+        set_config_bool(NULL, "armlockstep", arm_lockstep);
+        set_config_int(NULL, "rewindframes", savestate_rewind_frames);
 
         set_config_bool("sound", "sndinternal", sound_internal);
         set_config_bool("sound", "sndbeebsid",  sound_beebsid);
@@ -308,6 +325,7 @@ void config_save(void)
         if (vid_ledlocation >= 0)
             set_config_int("video", "ledlocation", vid_ledlocation);
         set_config_int("video", "ledvisibility", vid_ledvisibility);
+        set_config_int("video", "captureevery", capture_every);
 
         set_config_bool("tape", "fasttape", fasttape);
 
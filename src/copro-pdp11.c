@@ -68,6 +68,24 @@ void copro_pdp11_write16(const uint16_t addr, const uint16_t data)
     write_byte(addr+1, data >> 8);
 }
 
+static void read_block(uint32_t addr, uint8_t *buf, uint32_t len)
+{
+    if (addr < 0xFFF0 && len <= 0xFFF0 - addr)
+        memcpy(buf, memory + addr, len);
+    else
+        while (len--)
+            *buf++ = read_byte(addr++);
+}
+
+static void write_block(uint32_t addr, const uint8_t *buf, uint32_t len)
+{
+    if (addr < 0xF800 && len <= 0xF800 - addr)
+        memcpy(memory + addr, buf, len);
+    else
+        while (len--)
+            write_byte(addr++, *buf++);
+}
+
 bool tube_pdp11_init(void *rom)
 {
     if (!memory) {
@@ -81,6 +99,8 @@ bool tube_pdp11_init(void *rom)
 
     tube_readmem  = read_byte;
     tube_writemem = write_byte;
+    tube_readblock  = read_block;
+    tube_writeblock = write_block;
     tube_exec = pdp11_execute;
     tube_proc_savestate = NULL;
     tube_proc_loadstate = NULL;
@@ -14,6 +14,10 @@
 #include "model.h"
 #include "6502.h"
 #include "debugger_symbols.h"
+#include "btrace.h"
+#include "profiler.h"
+#include "savestate.h"
+#include "tube.h"
 
 #include <allegro5/allegro_primitives.h>
 
@@ -220,6 +224,8 @@ static inline void debug_cons_close(void) {}
 void debug_kill()
 {
     close_trace();
+    btrace_close();
+    profiler_close();
     debug_memview_close();
     debug_cons_close();
 }
@@ -335,6 +341,7 @@ static const char helptext[] =
     "    break n    - set a breakpoint at n\n"
     "    breakr n   - break on reads from address n\n"
     "    breakw n   - break on writes to address n\n"
+    "    btrace fn  - binary trace of host 6502 to file for bemtrace, close file if no fn\n"
     "    breaki n   - break on input from I/O port\n"
     "    breako n   - break on output to I/O port\n"
     "    c          - continue running until breakpoint\n"
@@ -344,6 +351,12 @@ static const char helptext[] =
     "    n          - step, but treat a called subroutine as one step\n"
     "    m [n]      - memory dump from address n\n"
     "    paste s    - paste string s as keyboard input\n"
+    "    profile on|off|clear\n"
+    "               - start, stop or reset the host 6502 cycle profiler\n"
+    "    profile report f\n"
+    "               - write cycles by address, ROM and opcode to file f\n"
+    "    profile stacks f\n"
+    "               - write collapsed call stacks for a flame graph to f\n"
     "    q          - force emulator exit\n"
     "    r          - print 6502 registers\n"
     "    r sysvia   - print System VIA registers\n"
@@ -352,6 +365,7 @@ static const char helptext[] =
     "    r vidproc  - print VIDPROC registers\n"
     "    r sound    - print Sound registers\n"
     "    reset      - reset emulated machine\n"
+    "    rewind [n] - go back to the start of this frame or n frames before it\n"
     "    s [n]      - step n instructions (or 1 if no parameter)\n"
     "    symbol name=[rom:]addr\n"
     "               - add debugger symbol\n"
@@ -627,6 +641,64 @@ static void debug_paste(const char *iptr)
     }
 }
 
+static void debug_rewind(cpu_debug_t *cpu, const char *iptr)
+{
+    int frames = 0, done;
+
+    if (cpu != &core6502_cpu_debug)
+        debug_outf("Rewind is only possible from the host 6502\n");
+    else if (!savestate_rewind_frames)
+        debug_outf("Rewind is not enabled, set rewindframes in the config file\n");
+    else {
+        sscanf(iptr, "%d", &frames);
+        if ((done = savestate_rewind(frames)) < 0)
+            debug_outf("Nothing to rewind to\n");
+        else
+            debug_outf("Rewound %d frames\n", done);
+    }
+}
+
+static void debug_profile(char *iptr)
+{
+    size_t arglen = strcspn(iptr, " \t\n");
+    char *fn = iptr + arglen;
+
+    while (isspace(*fn))
+        fn++;
+    if (!arglen)
+        debug_outf("Profiler is %s\n", profiler_active ? "on" : "off");
+    else if (!strncasecmp(iptr, "on", arglen)) {
+        profiler_start();
+        debug_outf("Profiling host 6502\n");
+    }
+    else if (!strncasecmp(iptr, "off", arglen)) {
+        profiler_stop();
+        debug_outf("Profiler stopped\n");
+    }
+    else if (!strncasecmp(iptr, "clear", arglen)) {
+        profiler_clear();
+        debug_outf("Profile cleared\n");
+    }
+    else if (!strncasecmp(iptr, "report", arglen) || !strncasecmp(iptr, "stacks", arglen)) {
+        bool ok;
+        if (!*fn) {
+            debug_outf("Missing file name\n");
+            return;
+        }
+        errno = 0;
+        if (*iptr == 'r' || *iptr == 'R')
+            ok = profiler_report(fn);
+        else
+            ok = profiler_stacks(fn);
+        if (ok)
+            debug_outf("Profile written to %s\n", fn);
+        else
+            debug_outf("Unable to write profile to '%s': %s\n", fn, errno ? strerror(errno) : "no profile data");
+    }
+    else
+        debug_outf("Bad profile command\n");
+}
+
 static void save_points(FILE *sfp, const char *cmd, int *points)
 {
     for (int c = 0; c < NUM_BREAKPOINTS; c++) {
@@ -672,6 +744,8 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
     uint32_t next_addr;
     char ins[256];
 
+    if (cpu == &core6502_cpu_debug)
+        tube_quiesce();
     main_pause();
     indebug = 1;
     const char *sym;
@@ -759,6 +833,16 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
                     clear_point(cpu, breakr, iptr, "Read breakpoint");
                 else if (!strncmp(cmd, "bclearw", cmdlen))
                     clear_point(cpu, breakw, iptr, "Write breakpoint");
+                else if (!strncmp(cmd, "btrace", cmdlen)) {
+                    btrace_close();
+                    if (*iptr) {
+                        if (btrace_open(iptr, x65c02))
+                            debug_outf("Binary trace of host 6502 to %s\n", iptr);
+                        else
+                            debug_outf("Unable to open binary trace file '%s'\n", iptr);
+                    } else
+                        debug_outf("Binary trace file closed\n");
+                }
                 else
                     badcmd = true;
                 break;
@@ -845,6 +929,8 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
             case 'p':
                 if (!strncmp(cmd, "paste", cmdlen))
                     debug_paste(iptr);
+                else if (!strncmp(cmd, "profile", cmdlen))
+                    debug_profile(iptr);
                 else
                     badcmd = true;
                 break;
@@ -853,10 +939,13 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
                 if (cmdlen >= 3 && !strncmp(cmd, "reset", cmdlen)) {
                     main_reset();
                     debug_outf("Emulator reset\n");
-                } else if (*iptr) {
+                } else if (cmdlen >= 3 && !strncmp(cmd, "rewind", cmdlen))
+                    debug_rewind(cpu, iptr);
+                else if (*iptr) {
                     size_t arglen = strcspn(iptr, " \t\n");
                     iptr[arglen] = 0;
                     if (!strncasecmp(iptr, "sysvia", arglen)) {
+                        via_sync(&sysvia);
                         debug_outf("    System VIA registers :\n");
                         debug_outf("    ORA  %02X ORB  %02X IRA %02X IRB %02X\n", sysvia.ora, sysvia.orb, sysvia.ira, sysvia.irb);
                         debug_outf("    DDRA %02X DDRB %02X ACR %02X PCR %02X\n", sysvia.ddra, sysvia.ddrb, sysvia.acr, sysvia.pcr);
@@ -865,6 +954,7 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
                         debug_outf("    IER %02X IFR %02X\n", sysvia.ier, sysvia.ifr);
                     }
                     else if (!strncasecmp(iptr, "uservia", arglen)) {
+                        via_sync(&uservia);
                         debug_outf("    User VIA registers :\n");
                         debug_outf("    ORA  %02X ORB  %02X IRA %02X IRB %02X\n", uservia.ora, uservia.orb, uservia.ira, uservia.irb);
                         debug_outf("    DDRA %02X DDRB %02X ACR %02X PCR %02X\n", uservia.ddra, uservia.ddrb, uservia.acr, uservia.pcr);
@@ -873,6 +963,7 @@ void debugger_do(cpu_debug_t *cpu, uint32_t addr)
                         debug_outf("    IER %02X IFR %02X\n", uservia.ier, uservia.ifr);
                     }
                     else if (!strncasecmp(iptr, "crtc", arglen)) {
+                        video_catchup();
                         debug_outf("    CRTC registers :\n");
                         debug_outf("    Index=%i\n", crtc_i);
                         debug_outf("    R0 =%02X  R1 =%02X  R2 =%02X  R3 =%02X  R4 =%02X  R5 =%02X  R6 =%02X  R7 =%02X  R8 =%02X\n", crtc[0], crtc[1], crtc[2], crtc[3], crtc[4], crtc[5], crtc[6], crtc[7], crtc[8]);
@@ -8,6 +8,7 @@
 #include "disc.h"
 #include "sdf.h"
 #include "imd.h"
+#include "scheduler.h"
 
 #include "ddnoise.h"
 
@@ -79,8 +80,58 @@ void disc_close(int drive)
 
 int disc_notfound=0;
 
+/*fdc_time and disc_time are countdowns in host cycles.  Rather than
+  decrementing them on every instruction they are brought up to date
+  when the disc event fires or just before the FDC registers are
+  accessed, and only count while the motor is on.*/
+static sched_event_t disc_event;
+static int64_t disc_synced;
+
+void disc_sync_time(void)
+{
+        int elapsed = sched_clock - disc_synced;
+        disc_synced = sched_clock;
+        if (motoron) {
+                if (fdc_time) {
+                        fdc_time -= elapsed;
+                        if (!fdc_time)
+                                fdc_time = -1;  /* still due, zero means idle */
+                }
+                disc_time -= elapsed;
+        }
+}
+
+void disc_schedule(void)
+{
+        int delay;
+
+        if (motoron) {
+                delay = disc_time;
+                if (fdc_time && fdc_time < delay)
+                        delay = fdc_time;
+                sched_at(&disc_event, disc_synced + delay);
+        }
+        else
+                sched_cancel(&disc_event);
+}
+
+static void disc_event_fire(void)
+{
+        disc_sync_time();
+        if (motoron) {
+                if (fdc_time && fdc_time <= 0)
+                        fdc_callback();
+                if (disc_time <= 0) {
+                        disc_time += 16;
+                        disc_poll();
+                }
+        }
+        disc_schedule();
+}
+
 void disc_init()
 {
+        sched_event_init(&disc_event, "disc", disc_event_fire);
         drives[0].poll = drives[1].poll = 0;
         drives[0].seek = drives[1].seek = 0;
         drives[0].readsector = drives[1].readsector = 0;
@@ -38,6 +38,9 @@ void disc_readtrack(int drive, int track, int side, int density);
 void disc_abort(int drive);
 int disc_verify(int drive, int track, int density);
 
+void disc_sync_time(void);
+void disc_schedule(void);
+
 extern int disc_time;
 
 extern void (*fdc_callback)(void);
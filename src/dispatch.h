@@ -0,0 +1,26 @@
+#ifndef __INC_DISPATCH_H
+#define __INC_DISPATCH_H
+
+/*Opcode dispatch for the interpreted second processors.
+
+  The execute loops are written as switch statements with the case
+  labels spelt OP(table, opcode) and OP_DEFAULT(table).  Built with GCC
+  or Clang, unless configured with --disable-threaded-dispatch, each of
+  those also becomes a label, every switch is entered through a table
+  of label addresses and the core's NEXT can fetch and dispatch the
+  following instruction from the end of each handler rather than going
+  back round the loop (threaded dispatch).  Otherwise these are just
+  the switch.*/
+
+#if defined(__GNUC__) && !defined(NO_THREADED_DISPATCH)
+#define THREADED_DISPATCH 1
+#define DISPATCH(t, op) goto *t##_tbl[op]; switch (op)
+#define OP(t, n)        case n: t##_##n
+#define OP_DEFAULT(t)   default: t##_default
+#else
+#define DISPATCH(t, op) switch (op)
+#define OP(t, n)        case n
+#define OP_DEFAULT(t)   default
+#endif
+
+#endif
@@ -1,6 +1,7 @@
 #include "b-em.h"
 #include <allegro5/allegro_native_dialog.h>
 #include "gui-allegro.h"
+#include "capture.h"
 
 #include "6502.h"
 #include "ide.h"
@@ -107,10 +108,12 @@ static ALLEGRO_MENU *create_file_menu(void)
     al_append_menu_item(menu, "Hard Reset", IDM_FILE_RESET, 0, NULL, NULL);
     al_append_menu_item(menu, "Load state...", IDM_FILE_LOAD_STATE, 0, NULL, NULL);
     al_append_menu_item(menu, "Save State...", IDM_FILE_SAVE_STATE, 0, NULL, NULL);
+    al_append_menu_item(menu, "Rewind 1 second", IDM_FILE_REWIND, 0, NULL, NULL);
     al_append_menu_item(menu, "Save Screenshot...", IDM_FILE_SCREEN_SHOT, 0, NULL, NULL);
     add_checkbox_item(menu, "Print to file", IDM_FILE_PRINT, prt_fp);
     add_checkbox_item(menu, "Record Music 5000 to file", IDM_FILE_M5000, music5000_fp);
     add_checkbox_item(menu, "Record Paula to file", IDM_FILE_PAULAREC, paula_fp);
+    add_checkbox_item(menu, "Record video to file", IDM_FILE_VIDREC, capture_recording);
     al_append_menu_item(menu, "Exit", IDM_FILE_EXIT, 0, NULL, NULL);
     return menu;
 }
@@ -297,6 +300,7 @@ static ALLEGRO_MENU *create_tube_menu(void)
     for (i = 0; i < NUM_TUBE_SPEEDS; i++)
         add_radio_item(sub, tube_speeds[i].name, IDM_TUBE_SPEED, i, tube_speed_num);
     al_append_menu_item(menu, "Tube speed", 0, 0, NULL, sub);
+    add_checkbox_item(menu, "Run on own thread", IDM_TUBE_THREAD, tube_threaded);
     return menu;
 }
 
@@ -622,6 +626,25 @@ static void paula_rec(ALLEGRO_EVENT *event)
     }
 }
 
+static void video_rec(ALLEGRO_EVENT *event)
+{
+    ALLEGRO_FILECHOOSER *chooser;
+    ALLEGRO_DISPLAY *display;
+
+    if (capture_recording)
+        capture_stop();
+    else if ((chooser = al_create_native_file_dialog(savestate_name, "Record video to file", "*.raw;*.png;*.bmp;*.tga;*.jpg", ALLEGRO_FILECHOOSER_SAVE))) {
+        display = (ALLEGRO_DISPLAY *)(event->user.data2);
+        while (al_show_native_file_dialog(display, chooser)) {
+            if (al_get_native_file_dialog_count(chooser) <= 0)
+                break;
+            if (capture_start(al_get_native_file_dialog_path(chooser, 0)))
+                break;
+        }
+        al_destroy_native_file_dialog(chooser);
+    }
+}
+
 static void edit_paste_start(ALLEGRO_EVENT *event)
 {
     ALLEGRO_DISPLAY *display = (ALLEGRO_DISPLAY *)(event->user.data2);
@@ -1031,6 +1054,12 @@ void gui_allegro_event(ALLEGRO_EVENT *event)
         case IDM_FILE_SAVE_STATE:
             file_save_state(event);
             break;
+        case IDM_FILE_REWIND:
+            if (savestate_rewind_frames)
+                savestate_wantrewind = 50;
+            else
+                log_warn("gui: rewind is not enabled, set rewindframes in the config file");
+            break;
         case IDM_FILE_SCREEN_SHOT:
             file_save_scrshot(event);
             break;
@@ -1043,6 +1072,9 @@ void gui_allegro_event(ALLEGRO_EVENT *event)
         case IDM_FILE_PAULAREC:
             paula_rec(event);
             break;
+        case IDM_FILE_VIDREC:
+            video_rec(event);
+            break;
         case IDM_FILE_EXIT:
             quitting = true;
             break;
@@ -1148,6 +1180,9 @@ void gui_allegro_event(ALLEGRO_EVENT *event)
         case IDM_TUBE_SPEED:
             change_tube_speed(event);
             break;
+        case IDM_TUBE_THREAD:
+            tube_threaded = !tube_threaded;
+            break;
         case IDM_VIDEO_DISPTYPE:
             video_set_disptype(radio_event_simple(event, vid_dtype_user));
             break;
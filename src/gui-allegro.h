@@ -6,10 +6,12 @@ typedef enum {
     IDM_FILE_RESET,
     IDM_FILE_LOAD_STATE,
     IDM_FILE_SAVE_STATE,
+    IDM_FILE_REWIND,
     IDM_FILE_SCREEN_SHOT,
     IDM_FILE_PRINT,
     IDM_FILE_M5000,
     IDM_FILE_PAULAREC,
+    IDM_FILE_VIDREC,
     IDM_FILE_EXIT,
     IDM_EDIT_PASTE,
     IDM_EDIT_COPY,
@@ -49,6 +51,7 @@ typedef enum {
     IDM_MODEL,
     IDM_TUBE,
     IDM_TUBE_SPEED,
+    IDM_TUBE_THREAD,
     IDM_VIDEO_DISPTYPE,
     IDM_VIDEO_PAL,
     IDM_VIDEO_BORDERS,
@@ -0,0 +1,412 @@
+/*B-em
+  Headless batch runner.
+
+  Runs the emulated machine with no display, sound or GUI, as fast as
+  the host allows, until a frame/cycle budget runs out or an exit
+  condition is met.  Intended for running test programs unattended.*/
+
+#include "b-em.h"
+#include <sys/stat.h>
+#include <time.h>
+
+#include "6502.h"
+#include "adc.h"
+#include "btrace.h"
+#include "model.h"
+#include "config.h"
+#include "cpu_debug.h"
+#include "debugger.h"
+#include "disc.h"
+#include "fdi.h"
+#include "hfe.h"
+#include "i8271.h"
+#include "ide.h"
+#include "keyboard.h"
+#include "led.h"
+#include "main.h"
+#include "mem.h"
+#include "midi.h"
+#include "music4000.h"
+#include "paula.h"
+#include "profiler.h"
+#include "scheduler.h"
+#include "scsi.h"
+#include "sdf.h"
+#include "serial.h"
+#include "sid_b-em.h"
+#include "sn76489.h"
+#include "sound.h"
+#include "sysacia.h"
+#include "tape.h"
+#include "tube.h"
+#include "via.h"
+#include "sysvia.h"
+#include "uservia.h"
+#include "vdfs.h"
+#include "video.h"
+#include "video_render.h"
+#include "wd1770.h"
+
+#include "NS32016/32016.h"
+#include "6502tube.h"
+#include "65816.h"
+#include "arm.h"
+#include "x86_tube.h"
+#include "z80.h"
+#include "6809tube.h"
+
+#define CYCLES_PER_FRAME 40000
+
+/*Things normally provided by the front end, sound and debugger modules
+  which are not linked into the headless build.*/
+
+int autoboot = 0;
+int joybutton[2];
+float joyaxes[4];
+bool quitting = false;
+int framesrun = 0;
+
+bool sound_internal = false, sound_beebsid = false, sound_dac = false;
+bool sound_ddnoise = false, sound_tape = false;
+bool sound_music5000 = false, sound_filter = false;
+bool sound_paula = false;
+size_t buflen_m5 = BUFLEN_M5;
+int ddnoise_vol = 3;
+int ddnoise_type = 0;
+int ddnoise_ticks = 0;
+
+enum vid_disptype vid_dtype_user, vid_dtype_intern;
+bool vid_pal;
+int vid_fskipmax = 1;
+int vid_fullborders = 1;
+int vid_ledlocation = LED_LOC_NONE;
+int vid_ledvisibility = LED_VIS_ALWAYS;
+bool vid_print_mode = false;
+int vid_savescrshot = 0;
+char vid_scrshotname[260];
+int capture_every = 1;
+int winsizex, winsizey;
+
+ALLEGRO_LOCKED_REGION *region;
+static ALLEGRO_LOCKED_REGION render_region;
+static uint32_t *render_buf;
+
+int debug_core = 0, debug_tube = 0, debug_step = 0;
+int readc[65536], writec[65536], fetchc[65536];
+
+void sound_poll(void) {}
+void music5000_reset(void) {}
+void music5000_write(uint16_t addr, uint8_t val) {}
+void music5000_savestate(FILE *f) {}
+void music5000_loadstate(FILE *f) {}
+
+void ddnoise_seek(int len)
+{
+    /* seek time without drive noise, as in ddnoise.c */
+    fdc_time = 200;
+}
+
+void ddnoise_spinup(void) {}
+void ddnoise_spindown(void) {}
+void tapenoise_addhigh(void) {}
+void tapenoise_adddat(uint8_t dat) {}
+void tapenoise_motorchange(int stat) {}
+void cataddname(char *s) {}
+void midi_load_config(void) {}
+void midi_save_config(void) {}
+void midi_send_msg(midi_dev_t *dev, uint8_t *msg, size_t size) {}
+void led_update(led_name_t led_name, bool b, int ticks) {}
+void gui_allegro_set_eject_text(int drive, ALLEGRO_PATH *path) {}
+
+void main_key_break(void) {}
+void main_key_pause(void) {}
+void main_key_fullscreen(void) {}
+void main_start_fullspeed(void) {}
+void main_stop_fullspeed(bool hostshift) {}
+
+void main_setquit(void)
+{
+    quitting = true;
+}
+
+void video_frames_init(void)
+{
+    if (!(render_buf = malloc(1280 * 800 * sizeof(uint32_t)))) {
+        log_fatal("headless: out of memory allocating render buffer");
+        exit(1);
+    }
+    render_region.data = render_buf;
+    render_region.format = ALLEGRO_PIXEL_FORMAT_ARGB_8888;
+    render_region.pitch = 1280 * sizeof(uint32_t);
+    render_region.pixel_size = sizeof(uint32_t);
+    region = &render_region;
+    video_clear_frame(true);
+}
+
+void video_clear_frame(bool pal_too)
+{
+    for (int c = 0; c < 1280 * 800; c++)
+        render_buf[c] = 0xff000000;
+}
+
+void video_doblit(bool non_ttx, uint8_t vtotal)
+{
+    firstx = firsty = 65535;
+    lastx  = lasty  = 0;
+}
+
+/*Exit conditions.  The PC and text checks use the per-instruction
+  debug hook of the host 6502, so cost nothing unless asked for.*/
+
+static int exit_pc = -1;
+static const char *exit_text;
+static const char *exit_file;
+static const char *profile_fn;
+static const char *trace_fn;
+static char vdu_buf[256];
+static size_t vdu_len;
+static const char *stop_reason;
+
+void debug_preexec(cpu_debug_t *cpu, uint32_t addr)
+{
+    if (cpu != &core6502_cpu_debug)
+        return;
+    addr &= 0xffff;
+    if ((int)addr == exit_pc)
+        stop_reason = "PC reached";
+    else if (exit_text && addr == (ram[0x20e] | (ram[0x20f] << 8))) {
+        /* entry to the routine OSWRCH is vectored through */
+        size_t len = strlen(exit_text);
+        if (vdu_len == sizeof(vdu_buf) - 1) {
+            memmove(vdu_buf, vdu_buf + vdu_len - len, len);
+            vdu_len = len;
+        }
+        vdu_buf[vdu_len++] = a;
+        vdu_buf[vdu_len] = 0;
+        if (vdu_len >= len && !memcmp(vdu_buf + vdu_len - len, exit_text, len))
+            stop_reason = "text written";
+    }
+}
+
+void debug_memread (cpu_debug_t *cpu, uint32_t addr, uint32_t value, uint8_t size) {}
+void debug_memwrite(cpu_debug_t *cpu, uint32_t addr, uint32_t value, uint8_t size) {}
+void debug_ioread  (cpu_debug_t *cpu, uint32_t addr, uint32_t value, uint8_t size) {}
+void debug_iowrite (cpu_debug_t *cpu, uint32_t addr, uint32_t value, uint8_t size) {}
+
+void debug_trap(cpu_debug_t *cpu, uint32_t addr, int reason)
+{
+    log_warn("headless: cpu %s: %s at %08X", cpu->cpu_name, cpu->trap_names[reason], addr);
+}
+
+size_t debug_print_8bit(uint32_t value, char *buf, size_t bufsize)
+{
+    return snprintf(buf, bufsize, "%02X", value & 0xff) + 1;
+}
+
+size_t debug_print_16bit(uint32_t value, char *buf, size_t bufsize)
+{
+    return snprintf(buf, bufsize, "%04X", value & 0xffff) + 1;
+}
+
+size_t debug_print_addr16(cpu_debug_t *cpu, uint32_t value, char *buf, size_t bufsize, bool include_symbol)
+{
+    size_t ret = snprintf(buf, bufsize, "%04X", value);
+    return ret > bufsize ? bufsize : ret;
+}
+
+size_t debug_print_addr32(cpu_debug_t *cpu, uint32_t value, char *buf, size_t bufsize, bool include_symbol)
+{
+    size_t ret = snprintf(buf, bufsize, "%08X", value);
+    return ret > bufsize ? bufsize : ret;
+}
+
+static const char helptext[] =
+    VERSION_STR " headless command line options:\n\n"
+    "-mx             - start as model x (see readme.txt for models)\n"
+    "-tx             - start with tube x (see readme.txt for tubes)\n"
+    "-disc disc.ssd  - load disc.ssd into drives :0/:2\n"
+    "-disc1 disc.ssd - load disc.ssd into drives :1/:3\n"
+    "-autoboot       - boot disc in drive :0\n"
+    "-tape tape.uef  - load tape.uef\n"
+    "-fasttape       - set tape speed to fast\n"
+    "-frames n       - stop after n frames (default 3000)\n"
+    "-cycles n       - stop after n 2MHz host cycles\n"
+    "-exitpc addr    - stop when the host 6502 reaches hex address addr\n"
+    "-exittext str   - stop once str has been written via OSWRCH\n"
+    "-exitfile file  - stop once file exists, e.g. written via VDFS\n"
+    "-profile file   - profile the host 6502, writing a report to file\n"
+    "                  and collapsed call stacks to file.folded\n"
+    "-trace file     - write a binary trace of the host 6502 to file\n"
+    "-tubethread     - run the tube processor on its own thread\n"
+    "-arminterp      - interpret the ARM 2nd processor, not translate it\n"
+    "-armcheck       - check translated ARM code against the interpreter\n\n"
+    "The exit status is 0 if an exit condition was met and 2 if the\n"
+    "frame or cycle budget ran out first.\n";
+
+int main(int argc, char **argv)
+{
+    int c;
+    int tapenext = 0, discnext = 0;
+    int64_t frames = 3000, frame;
+    int64_t cycle_limit = -1, start_clock, ran;
+    struct stat st;
+    struct timespec start, end;
+    double secs;
+
+    if (!al_init()) {
+        fputs("Failed to initialise Allegro!\n", stderr);
+        return 1;
+    }
+    config_load();
+    log_open();
+    log_info("headless: starting %s", VERSION_STR);
+    model_loadcfg();
+
+    for (c = 1; c < argc; c++) {
+        if (!strcasecmp(argv[c], "--help") || !strcasecmp(argv[c], "-?") || !strcasecmp(argv[c], "-h")) {
+            fwrite(helptext, sizeof helptext-1, 1, stdout);
+            return 1;
+        }
+        else if (!strcasecmp(argv[c], "-frames") && c+1 < argc)
+            frames = strtoll(argv[++c], NULL, 0);
+        else if (!strcasecmp(argv[c], "-cycles") && c+1 < argc)
+            cycle_limit = strtoll(argv[++c], NULL, 0);
+        else if (!strcasecmp(argv[c], "-exitpc") && c+1 < argc)
+            exit_pc = strtol(argv[++c], NULL, 16) & 0xffff;
+        else if (!strcasecmp(argv[c], "-exittext") && c+1 < argc)
+            exit_text = argv[++c];
+        else if (!strcasecmp(argv[c], "-exitfile") && c+1 < argc)
+            exit_file = argv[++c];
+        else if (!strcasecmp(argv[c], "-profile") && c+1 < argc)
+            profile_fn = argv[++c];
+        else if (!strcasecmp(argv[c], "-trace") && c+1 < argc)
+            trace_fn = argv[++c];
+        else if (!strcasecmp(argv[c], "-tubethread"))
+            tube_threaded = true;
+        else if (!strcasecmp(argv[c], "-arminterp"))
+            arm_translate = false;
+        else if (!strcasecmp(argv[c], "-armcheck"))
+            arm_lockstep = true;
+        else if (!strcasecmp(argv[c], "-tape"))
+            tapenext = 2;
+        else if (!strcasecmp(argv[c], "-disc") || !strcasecmp(argv[c], "-disk"))
+            discnext = 1;
+        else if (!strcasecmp(argv[c], "-disc1"))
+            discnext = 2;
+        else if (argv[c][0] == '-' && (argv[c][1] == 'm' || argv[c][1] == 'M'))
+            sscanf(&argv[c][2], "%i", &curmodel);
+        else if (argv[c][0] == '-' && (argv[c][1] == 't' || argv[c][1] == 'T'))
+            sscanf(&argv[c][2], "%i", &selecttube);
+        else if (!strcasecmp(argv[c], "-fasttape"))
+            fasttape = true;
+        else if (!strcasecmp(argv[c], "-autoboot"))
+            autoboot = 150;
+        else if (tapenext) {
+            if (tape_fn)
+                al_destroy_path(tape_fn);
+            tape_fn = al_create_path(argv[c]);
+        }
+        else if (discnext) {
+            if (discfns[discnext-1])
+                al_destroy_path(discfns[discnext-1]);
+            discfns[discnext-1] = al_create_path(argv[c]);
+            discnext = 0;
+        }
+        else {
+            fprintf(stderr, "headless: unrecognised option '%s'\n", argv[c]);
+            return 1;
+        }
+        if (tapenext) tapenext--;
+    }
+    if (exit_text && strlen(exit_text) >= sizeof(vdu_buf) / 2) {
+        fputs("headless: exit text too long\n", stderr);
+        return 1;
+    }
+
+    video_init();
+    mode7_makechars();
+    mem_init();
+    sid_init();
+    sid_settype(sidmethod, cursid);
+    paula_init();
+    adc_init();
+    disc_init();
+    fdi_init();
+    hfe_init();
+    scsi_init();
+    ide_init();
+    vdfs_init(vdfs_cfg_root);
+    model_init();
+    main_reset();
+
+    if (mmb_fn)
+        mmb_load(mmb_fn);
+    else
+        disc_load(0, discfns[0]);
+    disc_load(1, discfns[1]);
+    tape_load(tape_fn);
+    if (defaultwriteprot)
+        writeprot[0] = writeprot[1] = 1;
+
+    if (exit_pc >= 0 || exit_text)
+        core6502_cpu_debug.debug_enable(1);
+
+    if (profile_fn)
+        profiler_start();
+    if (trace_fn && !btrace_open(trace_fn, x65c02))
+        return 1;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    start_clock = sched_clock;
+    for (frame = 0; (cycle_limit >= 0 || frame < frames) && !stop_reason && !quitting; frame++) {
+        if (cycle_limit >= 0) {
+            int64_t left = cycle_limit - (sched_clock - start_clock);
+            if (left <= 0)
+                break;
+            /* The last frame is cut short to end on the cycle asked for,
+               bar the rest of the instruction running at the time. */
+            if (left < CYCLES_PER_FRAME)
+                cycles = (int)left - CYCLES_PER_FRAME;
+        }
+        if (autoboot)
+            autoboot--;
+        framesrun++;
+        if (x65c02)
+            m65c02_exec();
+        else
+            m6502_exec();
+        if (exit_file && !stat(exit_file, &st))
+            stop_reason = "file written";
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ran = sched_clock - start_clock;
+    tube_thread_stop();
+    btrace_close();
+
+    secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("headless: %s after %" PRId64 " frames, %" PRId64 " cycles in %.3fs, %.3fMHz\n",
+           stop_reason ? stop_reason : (quitting ? "quit" : "budget exhausted"),
+           frame, ran, secs, secs > 0 ? ran / secs / 1e6 : 0.0);
+
+    if (profile_fn) {
+        char *stacks_fn = malloc(strlen(profile_fn) + 8);
+        if (!profiler_report(profile_fn))
+            fprintf(stderr, "headless: unable to write profile to %s\n", profile_fn);
+        if (stacks_fn) {
+            sprintf(stacks_fn, "%s.folded", profile_fn);
+            if (!profiler_stacks(stacks_fn))
+                fprintf(stderr, "headless: unable to write profile to %s\n", stacks_fn);
+            free(stacks_fn);
+        }
+        profiler_close();
+    }
+
+    mem_close();
+    disc_close(0);
+    disc_close(1);
+    scsi_close();
+    ide_close();
+    vdfs_close();
+    log_close();
+    return (stop_reason || quitting) ? 0 : 2;
+}
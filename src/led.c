@@ -22,6 +22,7 @@ typedef struct {
     bool transient;
     int index;
     bool state;
+    bool drawn;
     int turn_off_at;
     char cfgcol[8];
     ALLEGRO_COLOR colour;
@@ -99,6 +100,7 @@ void led_init(void)
                 led_details[i].colour = get_config_colour("leds", led_details[i].cfgcol, dcol);
                 draw_led_full(&led_details[i], false, bgcol);
                 led_details[i].state = false;
+                led_details[i].drawn = false;
             }
             return;
         }
@@ -110,7 +112,6 @@ void led_update(led_name_t led_name, bool b, int ticks)
 {
     if (vid_ledlocation > LED_LOC_NONE && led_name < LED_MAX) {
         if (b != led_details[led_name].state) {
-            draw_led(&led_details[led_name], b);
             last_led_update_at = framesrun;
             led_details[led_name].state = b;
         }
@@ -134,7 +135,6 @@ void led_timer_fired(void)
                     if (led_details[i].state != false) {
                         last_led_update_at = framesrun;
                         led_details[i].state = false;
-                        draw_led(&led_details[i], false);
                     }
                     led_details[i].turn_off_at = 0;
                 }
@@ -149,6 +149,24 @@ void led_timer_fired(void)
     }
 }
 
+/*LED state changes on the emulation thread but the bitmap can only be
+  drawn on from the display thread, so redraw any that changed here.*/
+bool led_draw_changes(void)
+{
+    bool changed = false;
+    if (vid_ledlocation > LED_LOC_NONE) {
+        for (int i = 0; i < sizeof(led_details)/sizeof(led_details[0]); i++) {
+            bool state = led_details[i].state;
+            if (state != led_details[i].drawn) {
+                draw_led(&led_details[i], state);
+                led_details[i].drawn = state;
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
 bool led_any_transient_led_on(void)
 {
     for (int i = 0; i < sizeof(led_details)/sizeof(led_details[0]); i++)
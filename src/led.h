@@ -38,6 +38,7 @@ typedef enum {
 void led_init(void);
 void led_update(led_name_t led_name, bool b, int ticks);
 void led_timer_fired(void);
+bool led_draw_changes(void);
 bool led_any_transient_led_on(void);
 
 #endif
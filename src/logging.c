@@ -3,7 +3,9 @@
 #include "b-em.h"
 #include "config.h"
 
+#ifndef HEADLESS
 #include <allegro5/allegro_native_dialog.h>
+#endif
 #include <errno.h>
 #include <stdarg.h>
 #include <time.h>
@@ -43,6 +45,12 @@ static FILE *log_fp;
 static char   tmstr[20];
 static time_t last = 0;
 
+#ifdef HEADLESS
+static void log_msgbox(const char *level, char *msg)
+{
+    fprintf(stderr, "%s: %s\n", level, msg);
+}
+#else
 static void log_msgbox(const char *level, char *msg)
 {
     const int max_len = 80;
@@ -69,6 +77,7 @@ static void log_msgbox(const char *level, char *msg)
             al_show_native_message_box(display, level, msg, "", NULL, 0);
     }
 }
+#endif
 
 static void log_common(unsigned dest, const char *level, char *msg, size_t len)
 {
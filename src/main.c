@@ -42,6 +42,7 @@
 #include "sid_b-em.h"
 #include "sn76489.h"
 #include "sound.h"
+#include "spsc.h"
 #include "sysacia.h"
 #include "tape.h"
 #include "tapecat-allegro.h"
@@ -77,6 +78,20 @@ static ALLEGRO_TIMER *timer;
 static ALLEGRO_EVENT_QUEUE *queue;
 static ALLEGRO_EVENT_SOURCE evsrc;
 
+/*The emulation runs on its own thread, driven by the timer on its own
+  event queue, so a slow buffer flip on the display thread does not hold
+  up the emulated machine.  Input events are passed across through a
+  lock-free queue and finished frames come back via video_present().
+  Anything else on the display thread that touches emulated state must
+  hold emu_mutex.*/
+static ALLEGRO_EVENT_QUEUE *emu_queue;
+static ALLEGRO_EVENT_SOURCE input_evsrc;
+static ALLEGRO_EVENT_SOURCE disp_evsrc;
+static ALLEGRO_MUTEX *emu_mutex;
+static spsc_t input_queue;
+
+#define INPUT_QUEUE_SIZE 256
+
 static ALLEGRO_DISPLAY *tmp_display;
 
 typedef enum {
@@ -103,29 +118,6 @@ const emu_speed_t emu_speeds[NUM_EMU_SPEEDS] = {
     { "500%", 1.0 / (50.0 * 5.00), 5 }
 };
 
-void main_reset()
-{
-    m6502_reset();
-    crtc_reset();
-    video_reset();
-    sysvia_reset();
-    uservia_reset();
-    serial_reset();
-    acia_reset(&sysacia);
-    wd1770_reset();
-    i8271_reset();
-    scsi_reset();
-    vdfs_reset();
-    sid_reset();
-    music4000_reset();
-    music5000_reset();
-    paula_reset();
-    sn_init();
-    if (curtube != -1) tubes[curtube].reset();
-    else               tube_exec = NULL;
-    tube_reset();
-}
-
 static const char helptext[] =
     VERSION_STR " command line options:\n\n"
     "-mx             - start as model x (see readme.txt for models)\n"
@@ -246,11 +238,19 @@ void main_init(int argc, char *argv[])
 
     mem_init();
 
-    if (!(queue = al_create_event_queue())) {
+    if (!(queue = al_create_event_queue()) || !(emu_queue = al_create_event_queue())) {
         log_fatal("main: unable to create event queue");
         exit(1);
     }
     al_register_event_source(queue, al_get_display_event_source(display));
+    al_init_user_event_source(&disp_evsrc);
+    al_register_event_source(queue, &disp_evsrc);
+    al_init_user_event_source(&input_evsrc);
+    al_register_event_source(emu_queue, &input_evsrc);
+    if (!(emu_mutex = al_create_mutex_recursive()) || !spsc_init(&input_queue, INPUT_QUEUE_SIZE, sizeof(ALLEGRO_EVENT))) {
+        log_fatal("main: unable to create emulation thread resources");
+        exit(1);
+    }
 
     if (!al_install_audio()) {
         log_fatal("main: unable to initialise audio");
@@ -268,10 +268,10 @@ void main_init(int argc, char *argv[])
     sound_init();
     sid_init();
     sid_settype(sidmethod, cursid);
-    music5000_init(queue);
+    music5000_init(emu_queue);
     paula_init();
     ddnoise_init();
-    tapenoise_init(queue);
+    tapenoise_init(emu_queue);
 
     adc_init();
     pal_init();
@@ -299,9 +299,9 @@ void main_init(int argc, char *argv[])
         log_fatal("main: unable to create timer");
         exit(1);
     }
-    al_register_event_source(queue, al_get_timer_event_source(timer));
+    al_register_event_source(emu_queue, al_get_timer_event_source(timer));
     al_init_user_event_source(&evsrc);
-    al_register_event_source(queue, &evsrc);
+    al_register_event_source(emu_queue, &evsrc);
 
     al_register_event_source(queue, al_get_keyboard_event_source());
 
@@ -326,16 +326,6 @@ void main_init(int argc, char *argv[])
     debug_start();
 }
 
-void main_restart()
-{
-    main_pause();
-    cmos_save(&models[oldmodel]);
-
-    model_init();
-    main_reset();
-    main_resume();
-}
-
 int resetting = 0;
 int framesrun = 0;
 
@@ -392,6 +382,11 @@ void main_key_fullspeed(void)
         main_start_fullspeed();
 }
 
+void main_key_fullscreen(void)
+{
+    main_display_event(BEM_EVENT_FULLSCREEN, 0);
+}
+
 void main_key_pause(void)
 {
     if (bempause) {
@@ -414,6 +409,7 @@ void lost_focus() {
 double prev_time = 0;
 int execs = 0;
 double spd = 0;
+static unsigned prev_tube_clock, prev_underruns;
 
 static void main_timer(ALLEGRO_EVENT *event)
 {
@@ -447,8 +443,17 @@ static void main_timer(ALLEGRO_EVENT *event)
             savestate_doload();
         if (savestate_wantsave)
             savestate_dosave();
+        if (savestate_rewind_frames)
+            savestate_rewind_capture();
+        if (savestate_wantrewind)
+            savestate_dorewind();
         if (fullspeed == FSPEED_RUNNING)
             al_emit_user_event(&evsrc, event, NULL);
+        else {
+            double load = (al_get_time() - now) / al_get_timer_speed(timer);
+            tube_auto_frame(load, sound_underruns != prev_underruns);
+        }
+        prev_underruns = sound_underruns;
 
         if (now - prev_time > 0.1) {
 
@@ -460,80 +465,175 @@ static void main_timer(ALLEGRO_EVENT *event)
                 spd = spd * 0.75 + 0.25 * (100.0 * speed / 2000000);
 
 
-            char buf[120];
-            snprintf(buf, 120, "%s %.3fMHz %.1f%%", VERSION_STR, speed / 1000000, spd);
-            al_set_window_title(tmp_display, buf);
+            char *buf = malloc(120);
+            if (buf) {
+                int len = snprintf(buf, 120, "%s %.3fMHz %.1f%%", VERSION_STR, speed / 1000000, spd);
+                if (tube_exec)
+                    snprintf(buf + len, 120 - len, " Tube %.2fMHz", (tube_clock - prev_tube_clock) / (now - prev_time) / 1000000);
+                main_display_event(BEM_EVENT_TITLE, (intptr_t)buf);
+            }
 
             execs = 0;
             prev_time = now;
+            prev_tube_clock = tube_clock;
         }
     }
+    else if (fullspeed != FSPEED_RUNNING)
+        tube_auto_frame(1.0, true);
+}
+
+void main_display_event(int type, intptr_t data)
+{
+    ALLEGRO_EVENT event;
+
+    event.user.type = type;
+    event.user.data1 = data;
+    al_emit_user_event(&disp_evsrc, &event, NULL);
+}
+
+static void main_queue_input(ALLEGRO_EVENT *event)
+{
+    if (spsc_put(&input_queue, event)) {
+        ALLEGRO_EVENT wake;
+        wake.user.type = BEM_EVENT_INPUT;
+        al_emit_user_event(&input_evsrc, &wake, NULL);
+    }
+    else
+        log_warn("main: input queue full, event %d dropped", event->type);
+}
+
+static void main_input_event(ALLEGRO_EVENT *event)
+{
+    switch(event->type) {
+        case ALLEGRO_EVENT_KEY_DOWN:
+            key_down_event(event);
+            break;
+        case ALLEGRO_EVENT_KEY_CHAR:
+            key_char_event(event);
+            break;
+        case ALLEGRO_EVENT_KEY_UP:
+            key_up_event(event);
+            break;
+        case ALLEGRO_EVENT_MOUSE_AXES:
+            mouse_axes(event);
+            break;
+        case ALLEGRO_EVENT_MOUSE_BUTTON_DOWN:
+            log_debug("main: mouse button down");
+            mouse_btn_down(event);
+            break;
+        case ALLEGRO_EVENT_MOUSE_BUTTON_UP:
+            log_debug("main: mouse button up");
+            mouse_btn_up(event);
+            break;
+        case ALLEGRO_EVENT_JOYSTICK_AXIS:
+            joystick_axis(event);
+            break;
+        case ALLEGRO_EVENT_JOYSTICK_BUTTON_DOWN:
+            joystick_button_down(event);
+            break;
+        case ALLEGRO_EVENT_JOYSTICK_BUTTON_UP:
+            joystick_button_up(event);
+            break;
+        case ALLEGRO_EVENT_DISPLAY_SWITCH_OUT:
+            lost_focus();
+            break;
+    }
+}
+
+static void *main_emu_thread(ALLEGRO_THREAD *thread, void *arg)
+{
+    ALLEGRO_EVENT event;
+
+    log_debug("main: emulation thread started");
+    while (!quitting) {
+        al_wait_for_event(emu_queue, &event);
+        al_lock_mutex(emu_mutex);
+        {
+            ALLEGRO_EVENT input;
+            while (spsc_get(&input_queue, &input))
+                main_input_event(&input);
+        }
+        switch(event.type) {
+            case ALLEGRO_EVENT_TIMER:
+                main_timer(&event);
+                break;
+            case ALLEGRO_EVENT_AUDIO_STREAM_FRAGMENT:
+                music5000_streamfrag();
+                break;
+        }
+        al_unlock_mutex(emu_mutex);
+    }
+    main_display_event(BEM_EVENT_QUIT, 0);
+    log_debug("main: emulation thread finished");
+    return NULL;
 }
 
 void main_run()
 {
     ALLEGRO_EVENT event;
+    ALLEGRO_THREAD *emu_thread;
 
     log_debug("main: about to start timer");
     al_start_timer(timer);
 
+    if (!(emu_thread = al_create_thread(main_emu_thread, NULL))) {
+        log_fatal("main: unable to create emulation thread");
+        exit(1);
+    }
+    al_start_thread(emu_thread);
+
     log_debug("main: entering main loop");
     while (!quitting) {
         al_wait_for_event(queue, &event);
         switch(event.type) {
             case ALLEGRO_EVENT_KEY_DOWN:
-                key_down_event(&event);
-                break;
             case ALLEGRO_EVENT_KEY_CHAR:
-                key_char_event(&event);
-                break;
             case ALLEGRO_EVENT_KEY_UP:
-                key_up_event(&event);
-                break;
             case ALLEGRO_EVENT_MOUSE_AXES:
-                mouse_axes(&event);
-                break;
             case ALLEGRO_EVENT_MOUSE_BUTTON_DOWN:
-                log_debug("main: mouse button down");
-                mouse_btn_down(&event);
-                break;
             case ALLEGRO_EVENT_MOUSE_BUTTON_UP:
-                log_debug("main: mouse button up");
-                mouse_btn_up(&event);
-                break;
             case ALLEGRO_EVENT_JOYSTICK_AXIS:
-                joystick_axis(&event);
-                break;
             case ALLEGRO_EVENT_JOYSTICK_BUTTON_DOWN:
-                joystick_button_down(&event);
-                break;
             case ALLEGRO_EVENT_JOYSTICK_BUTTON_UP:
-                joystick_button_up(&event);
+            case ALLEGRO_EVENT_DISPLAY_SWITCH_OUT:
+                main_queue_input(&event);
                 break;
             case ALLEGRO_EVENT_DISPLAY_CLOSE:
                 log_debug("main: event display close - quitting");
                 quitting = true;
                 break;
-            case ALLEGRO_EVENT_TIMER:
-                main_timer(&event);
-                break;
             case ALLEGRO_EVENT_MENU_CLICK:
                 main_pause();
+                al_lock_mutex(emu_mutex);
                 gui_allegro_event(&event);
+                al_unlock_mutex(emu_mutex);
                 main_resume();
                 break;
-            case ALLEGRO_EVENT_AUDIO_STREAM_FRAGMENT:
-                music5000_streamfrag();
-                break;
             case ALLEGRO_EVENT_DISPLAY_RESIZE:
                 video_update_window_size(&event);
                 break;
-            case ALLEGRO_EVENT_DISPLAY_SWITCH_OUT:
-                lost_focus();
+            case BEM_EVENT_FRAME:
+                video_present();
+                break;
+            case BEM_EVENT_FULLSCREEN:
+                video_toggle_fullscreen();
+                break;
+            case BEM_EVENT_TITLE:
+                al_set_window_title(tmp_display, (char *)event.user.data1);
+                free((char *)event.user.data1);
+                break;
+            case BEM_EVENT_QUIT:
+                quitting = true;
                 break;
         }
     }
     log_debug("main: end loop");
+
+    /* wake the emulation thread so it sees quitting is set */
+    event.user.type = BEM_EVENT_INPUT;
+    al_emit_user_event(&input_evsrc, &event, NULL);
+    al_join_thread(emu_thread, NULL);
+    al_destroy_thread(emu_thread);
 }
 
 void main_close()
@@ -550,6 +650,7 @@ void main_close()
     mem_close();
     uef_close();
     csw_close();
+    tube_thread_stop();
     tube_6502_close();
     arm_close();
     x86_close();
@@ -567,6 +668,8 @@ void main_close()
     tapenoise_close();
 
     video_close();
+    spsc_close(&input_queue);
+    al_destroy_mutex(emu_mutex);
     log_close();
 }
 
@@ -17,6 +17,14 @@ extern int framesrun;
 
 extern bool quitting;
 
+/*User events sent to the display thread.*/
+#define BEM_EVENT_FRAME      ALLEGRO_GET_EVENT_TYPE('B','F','r','m')
+#define BEM_EVENT_FULLSCREEN ALLEGRO_GET_EVENT_TYPE('B','F','u','l')
+#define BEM_EVENT_TITLE      ALLEGRO_GET_EVENT_TYPE('B','T','i','t')
+#define BEM_EVENT_QUIT       ALLEGRO_GET_EVENT_TYPE('B','Q','u','i')
+/*User event sent to the emulation thread.*/
+#define BEM_EVENT_INPUT      ALLEGRO_GET_EVENT_TYPE('B','I','n','p')
+
 void main_init(int argc, char *argv[]);
 void main_softreset(void);
 void main_reset(void);
@@ -29,9 +37,11 @@ void main_setspeed(int speed);
 void main_setquit(void);
 void main_start_fullspeed(void);
 void main_stop_fullspeed(bool hostshift);
+void main_display_event(int type, intptr_t data);
 
 void main_key_break(void);
 void main_key_pause(void);
+void main_key_fullscreen(void);
 
 void main_cleardrawit(void);
 void main_setmouse(void);
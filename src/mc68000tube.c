@@ -126,6 +126,28 @@ void m68k_write_memory_32(unsigned int address, unsigned int value)
     writemem(address+3, value);
 }
 
+/*Block copies for VDFS.  Reads go a byte at a time while the ROM is
+  still paged in low so the ROM is paged out as it would be for the
+  68000.*/
+
+static void readblock(uint32_t addr, uint8_t *buf, uint32_t len)
+{
+    if (!rom_low && addr < MC68000_RAM_SIZE && len <= MC68000_RAM_SIZE - addr)
+        memcpy(buf, mc68000_ram + addr, len);
+    else
+        while (len--)
+            *buf++ = readmem(addr++);
+}
+
+static void writeblock(uint32_t addr, const uint8_t *buf, uint32_t len)
+{
+    if (addr < MC68000_RAM_SIZE && len <= MC68000_RAM_SIZE - addr)
+        memcpy(mc68000_ram + addr, buf, len);
+    else
+        while (len--)
+            writemem(addr++, *buf++);
+}
+
 static void mc6809nc_exec(void)
 {
     m68k_execute(tubecycles);
@@ -184,6 +206,8 @@ bool tube_68000_init(void *rom)
     tube_type = TUBE68000;
     tube_readmem = readmem;
     tube_writemem = writemem;
+    tube_readblock = readblock;
+    tube_writeblock = writeblock;
     tube_exec  = mc6809nc_exec;
     tube_proc_savestate = mc68000_savestate;
     tube_proc_loadstate = mc68000_loadstate;
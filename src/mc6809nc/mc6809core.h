@@ -0,0 +1,1518 @@
+/*
+ * 6809 execution loop.
+ *
+ * Not a normal header: mc6809nc.c includes this once with CORE_DEBUG
+ * set to 1 and once with it set to 0, CORE_NAME giving each copy its
+ * own names.  With CORE_DEBUG at 0 the debugger hook is compiled out.
+ * See ../dispatch.h for how the opcode switches are entered.
+ */
+
+#define fetch_opcode     CORE_NAME(fetch_opcode)
+#define mc6809nc_execute CORE_NAME(mc6809nc_execute)
+
+static inline unsigned fetch_opcode (void)
+{
+  iPC = PC;
+#if CORE_DEBUG
+  if (mc6809nc_debug_enabled)
+    debug_preexec (&mc6809nc_cpu_debug, PC);
+#endif
+  return imm_byte ();
+}
+
+/* Finishes an instruction in the main opcode switch, when threaded by
+   fetching and dispatching the next one straight away. */
+
+#ifdef THREADED_DISPATCH
+#define NEXT \
+          if (cc_changed) \
+            cc_modified (); \
+          tubeUseCycles(1); \
+          if (!tubeContinueRunning()) \
+            goto done; \
+          opcode = fetch_opcode (); \
+          goto *main_tbl[opcode]
+#else
+#define NEXT break
+#endif
+
+static void mc6809nc_execute (void)
+{
+  unsigned opcode;
+#ifdef THREADED_DISPATCH
+  static const void *const main_tbl[256] = {
+      &&main_0x00, &&main_default, &&main_default, &&main_0x03, &&main_0x04, &&main_default, &&main_0x06, &&main_0x07,
+      &&main_0x08, &&main_0x09, &&main_0x0a, &&main_default, &&main_0x0c, &&main_0x0d, &&main_0x0e, &&main_0x0f,
+      &&main_0x10, &&main_0x11, &&main_0x12, &&main_0x13, &&main_default, &&main_default, &&main_0x16, &&main_0x17,
+      &&main_default, &&main_0x19, &&main_0x1a, &&main_default, &&main_0x1c, &&main_0x1d, &&main_0x1e, &&main_0x1f,
+      &&main_0x20, &&main_0x21, &&main_0x22, &&main_0x23, &&main_0x24, &&main_0x25, &&main_0x26, &&main_0x27,
+      &&main_0x28, &&main_0x29, &&main_0x2a, &&main_0x2b, &&main_0x2c, &&main_0x2d, &&main_0x2e, &&main_0x2f,
+      &&main_0x30, &&main_0x31, &&main_0x32, &&main_0x33, &&main_0x34, &&main_0x35, &&main_0x36, &&main_0x37,
+      &&main_default, &&main_0x39, &&main_0x3a, &&main_0x3b, &&main_0x3c, &&main_0x3d, &&main_default, &&main_0x3f,
+      &&main_0x40, &&main_default, &&main_default, &&main_0x43, &&main_0x44, &&main_default, &&main_0x46, &&main_0x47,
+      &&main_0x48, &&main_0x49, &&main_0x4a, &&main_default, &&main_0x4c, &&main_0x4d, &&main_default, &&main_0x4f,
+      &&main_0x50, &&main_default, &&main_default, &&main_0x53, &&main_0x54, &&main_default, &&main_0x56, &&main_0x57,
+      &&main_0x58, &&main_0x59, &&main_0x5a, &&main_default, &&main_0x5c, &&main_0x5d, &&main_default, &&main_0x5f,
+      &&main_0x60, &&main_default, &&main_default, &&main_0x63, &&main_0x64, &&main_default, &&main_0x66, &&main_0x67,
+      &&main_0x68, &&main_0x69, &&main_0x6a, &&main_default, &&main_0x6c, &&main_0x6d, &&main_0x6e, &&main_0x6f,
+      &&main_0x70, &&main_default, &&main_default, &&main_0x73, &&main_0x74, &&main_default, &&main_0x76, &&main_0x77,
+      &&main_0x78, &&main_0x79, &&main_0x7a, &&main_default, &&main_0x7c, &&main_0x7d, &&main_0x7e, &&main_0x7f,
+      &&main_0x80, &&main_0x81, &&main_0x82, &&main_0x83, &&main_0x84, &&main_0x85, &&main_0x86, &&main_default,
+      &&main_0x88, &&main_0x89, &&main_0x8a, &&main_0x8b, &&main_0x8c, &&main_0x8d, &&main_0x8e, &&main_default,
+      &&main_0x90, &&main_0x91, &&main_0x92, &&main_0x93, &&main_0x94, &&main_0x95, &&main_0x96, &&main_0x97,
+      &&main_0x98, &&main_0x99, &&main_0x9a, &&main_0x9b, &&main_0x9c, &&main_0x9d, &&main_0x9e, &&main_0x9f,
+      &&main_0xa0, &&main_0xa1, &&main_0xa2, &&main_0xa3, &&main_0xa4, &&main_0xa5, &&main_0xa6, &&main_0xa7,
+      &&main_0xa8, &&main_0xa9, &&main_0xaa, &&main_0xab, &&main_0xac, &&main_0xad, &&main_0xae, &&main_0xaf,
+      &&main_0xb0, &&main_0xb1, &&main_0xb2, &&main_0xb3, &&main_0xb4, &&main_0xb5, &&main_0xb6, &&main_0xb7,
+      &&main_0xb8, &&main_0xb9, &&main_0xba, &&main_0xbb, &&main_0xbc, &&main_0xbd, &&main_0xbe, &&main_0xbf,
+      &&main_0xc0, &&main_0xc1, &&main_0xc2, &&main_0xc3, &&main_0xc4, &&main_0xc5, &&main_0xc6, &&main_default,
+      &&main_0xc8, &&main_0xc9, &&main_0xca, &&main_0xcb, &&main_0xcc, &&main_default, &&main_0xce, &&main_default,
+      &&main_0xd0, &&main_0xd1, &&main_0xd2, &&main_0xd3, &&main_0xd4, &&main_0xd5, &&main_0xd6, &&main_0xd7,
+      &&main_0xd8, &&main_0xd9, &&main_0xda, &&main_0xdb, &&main_0xdc, &&main_0xdd, &&main_0xde, &&main_0xdf,
+      &&main_0xe0, &&main_0xe1, &&main_0xe2, &&main_0xe3, &&main_0xe4, &&main_0xe5, &&main_0xe6, &&main_0xe7,
+      &&main_0xe8, &&main_0xe9, &&main_0xea, &&main_0xeb, &&main_0xec, &&main_0xed, &&main_0xee, &&main_0xef,
+      &&main_0xf0, &&main_0xf1, &&main_0xf2, &&main_0xf3, &&main_0xf4, &&main_0xf5, &&main_0xf6, &&main_0xf7,
+      &&main_0xf8, &&main_0xf9, &&main_0xfa, &&main_0xfb, &&main_0xfc, &&main_0xfd, &&main_0xfe, &&main_0xff
+  };
+  static const void *const page2_tbl[256] = {
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_0x21, &&page2_0x22, &&page2_0x23, &&page2_0x24, &&page2_0x25, &&page2_0x26, &&page2_0x27,
+      &&page2_0x28, &&page2_0x29, &&page2_0x2a, &&page2_0x2b, &&page2_0x2c, &&page2_0x2d, &&page2_0x2e, &&page2_0x2f,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_0x3f,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_0x83, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_0x8c, &&page2_default, &&page2_0x8e, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_0x93, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_0x9c, &&page2_default, &&page2_0x9e, &&page2_0x9f,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_0xa3, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_0xac, &&page2_default, &&page2_0xae, &&page2_0xaf,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_0xb3, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_0xbc, &&page2_default, &&page2_0xbe, &&page2_0xbf,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_0xce, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_0xde, &&page2_0xdf,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_0xee, &&page2_0xef,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default,
+      &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_default, &&page2_0xfe, &&page2_0xff
+  };
+  static const void *const page3_tbl[256] = {
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_0x3f,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_0x83, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_0x8c, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_0x93, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_0x9c, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_0xa3, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_0xac, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_0xb3, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_0xbc, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default,
+      &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default, &&page3_default
+  };
+#endif
+
+  cpu_period = cpu_clk = tubecycles;
+
+  if (sync_flag) {
+     return;
+  }
+
+  do
+    {
+      opcode = fetch_opcode ();
+
+      DISPATCH(main, opcode)
+        {
+        OP(main, 0x00):
+          direct ();
+          cpu_clk -= 4;
+          WRMEM (ea, neg (RDMEM (ea)));
+          NEXT;                /* NEG direct */
+#ifdef H6309
+        OP(main, 0x01):              /* OIM */
+          NEXT;
+        OP(main, 0x02):              /* AIM */
+          NEXT;
+#endif
+        OP(main, 0x03):
+          direct ();
+          cpu_clk -= 4;
+          WRMEM (ea, com (RDMEM (ea)));
+          NEXT;                /* COM direct */
+        OP(main, 0x04):
+          direct ();
+          cpu_clk -= 4;
+          WRMEM (ea, lsr (RDMEM (ea)));
+          NEXT;                /* LSR direct */
+#ifdef H6309
+        OP(main, 0x05):              /* EIM */
+          NEXT;
+#endif
+        OP(main, 0x06):
+          direct ();
+          cpu_clk -= 4;
+          WRMEM (ea, ror (RDMEM (ea)));
+          NEXT;                /* ROR direct */
+        OP(main, 0x07):
+          direct ();
+          cpu_clk -= 4;
+          WRMEM (ea, asr (RDMEM (ea)));
+          NEXT;                /* ASR direct */
+        OP(main, 0x08):
+          direct ();
+          cpu_clk -= 4;
+          WRMEM (ea, asl (RDMEM (ea)));
+          NEXT;                /* ASL direct */
+        OP(main, 0x09):
+          direct ();
+          cpu_clk -= 4;
+          WRMEM (ea, rol (RDMEM (ea)));
+          NEXT;                /* ROL direct */
+        OP(main, 0x0a):
+          direct ();
+          cpu_clk -= 4;
+          WRMEM (ea, dec (RDMEM (ea)));
+          NEXT;                /* DEC direct */
+#ifdef H6309
+        OP(main, 0x0B):              /* TIM */
+          NEXT;
+#endif
+        OP(main, 0x0c):
+          direct ();
+          cpu_clk -= 4;
+          WRMEM (ea, inc (RDMEM (ea)));
+          NEXT;                /* INC direct */
+        OP(main, 0x0d):
+          direct ();
+          cpu_clk -= 4;
+          tst (RDMEM (ea));
+          NEXT;                /* TST direct */
+        OP(main, 0x0e):
+          direct ();
+          cpu_clk -= 3;
+          PC = ea;
+     check_pc ();
+          NEXT;                /* JMP direct */
+        OP(main, 0x0f):
+          direct ();
+          cpu_clk -= 4;
+          WRMEM (ea, clr (RDMEM (ea)));
+          NEXT;                /* CLR direct */
+        OP(main, 0x10):
+          {
+            opcode = imm_byte ();
+
+            DISPATCH(page2, opcode)
+              {
+              OP(page2, 0x21):
+                cpu_clk -= 5;
+                PC += 2;
+                break;
+              OP(page2, 0x22):
+                long_branch (cond_HI ());
+                break;
+              OP(page2, 0x23):
+                long_branch (cond_LS ());
+                break;
+              OP(page2, 0x24):
+                long_branch (cond_HS ());
+                break;
+              OP(page2, 0x25):
+                long_branch (cond_LO ());
+                break;
+              OP(page2, 0x26):
+                long_branch (cond_NE ());
+                break;
+              OP(page2, 0x27):
+                long_branch (cond_EQ ());
+                break;
+              OP(page2, 0x28):
+                long_branch (cond_VC ());
+                break;
+              OP(page2, 0x29):
+                long_branch (cond_VS ());
+                break;
+              OP(page2, 0x2a):
+                long_branch (cond_PL ());
+                break;
+              OP(page2, 0x2b):
+                long_branch (cond_MI ());
+                break;
+              OP(page2, 0x2c):
+                long_branch (cond_GE ());
+                break;
+              OP(page2, 0x2d):
+                long_branch (cond_LT ());
+                break;
+              OP(page2, 0x2e):
+                long_branch (cond_GT ());
+                break;
+              OP(page2, 0x2f):
+                long_branch (cond_LE ());
+                break;
+#ifdef H6309
+              OP(page2, 0x30):        /* ADDR */
+                break;
+              OP(page2, 0x31):        /* ADCR */
+                break;
+              OP(page2, 0x32):        /* SUBR */
+                break;
+              OP(page2, 0x33):        /* SBCR */
+                break;
+              OP(page2, 0x34):        /* ANDR */
+                break;
+              OP(page2, 0x35):        /* ORR */
+                break;
+              OP(page2, 0x36):        /* EORR */
+                break;
+              OP(page2, 0x37):        /* CMPR */
+                break;
+              OP(page2, 0x38):        /* PSHSW */
+                break;
+              OP(page2, 0x39):        /* PULSW */
+                break;
+              OP(page2, 0x3a):        /* PSHUW */
+                break;
+              OP(page2, 0x3b):        /* PULUW */
+                break;
+#endif
+              OP(page2, 0x3f):
+                swi2 ();
+                break;
+#ifdef H6309
+              OP(page2, 0x40):        /* NEGD */
+                break;
+              OP(page2, 0x43):        /* COMD */
+                break;
+              OP(page2, 0x44):        /* LSRD */
+                break;
+              OP(page2, 0x46):        /* RORD */
+                break;
+              OP(page2, 0x47):        /* ASRD */
+                break;
+              OP(page2, 0x48):        /* ASLD/LSLD */
+                break;
+              OP(page2, 0x49):        /* ROLD */
+                break;
+              OP(page2, 0x4a):        /* DECD */
+                break;
+              OP(page2, 0x4c):        /* INCD */
+                break;
+              OP(page2, 0x4d):        /* TSTD */
+                break;
+              OP(page2, 0x4f):        /* CLRD */
+                break;
+              OP(page2, 0x53):        /* COMW */
+                break;
+              OP(page2, 0x54):        /* LSRW */
+                break;
+              OP(page2, 0x56):        /* ??RORW */
+                break;
+              OP(page2, 0x59):        /* ROLW */
+                break;
+              OP(page2, 0x5a):        /* DECW */
+                break;
+              OP(page2, 0x5c):        /* INCW */
+                break;
+              OP(page2, 0x5d):        /* TSTW */
+                break;
+              OP(page2, 0x5f):        /* CLRW */
+                break;
+              OP(page2, 0x80):        /* SUBW */
+                break;
+              OP(page2, 0x81):        /* CMPW */
+                break;
+              OP(page2, 0x82):        /* SBCD */
+                break;
+#endif
+              OP(page2, 0x83):
+                cpu_clk -= 5;
+                cmp16 (get_d (), imm_word ());
+                break;
+#ifdef H6309
+              OP(page2, 0x84):        /* ANDD */
+                break;
+              OP(page2, 0x85):        /* BITD */
+                break;
+              OP(page2, 0x86):        /* LDW */
+                break;
+              OP(page2, 0x88):        /* EORD */
+                break;
+              OP(page2, 0x89):        /* ADCD */
+                break;
+              OP(page2, 0x8a):        /* ORD */
+                break;
+              OP(page2, 0x8b):        /* ADDW */
+                break;
+#endif
+              OP(page2, 0x8c):
+                cpu_clk -= 5;
+                cmp16 (Y, imm_word ());
+                break;
+              OP(page2, 0x8e):
+                cpu_clk -= 4;
+                Y = ld16 (imm_word ());
+                break;
+#ifdef H6309
+              OP(page2, 0x90):        /* SUBW */
+                break;
+              OP(page2, 0x91):        /* CMPW */
+                break;
+              OP(page2, 0x92):        /* SBCD */
+                break;
+#endif
+              OP(page2, 0x93):
+                direct ();
+                cpu_clk -= 5;
+                cmp16 (get_d (), RDMEM16 (ea));
+                cpu_clk--;
+                break;
+              OP(page2, 0x9c):
+                direct ();
+                cpu_clk -= 5;
+                cmp16 (Y, RDMEM16 (ea));
+                cpu_clk--;
+                break;
+              OP(page2, 0x9e):
+                direct ();
+                cpu_clk -= 5;
+                Y = ld16 (RDMEM16 (ea));
+                break;
+              OP(page2, 0x9f):
+                direct ();
+                cpu_clk -= 5;
+                st16 (Y);
+                break;
+              OP(page2, 0xa3):
+                cpu_clk--;
+                indexed ();
+                cmp16 (get_d (), RDMEM16 (ea));
+                cpu_clk--;
+                break;
+              OP(page2, 0xac):
+                cpu_clk--;
+                indexed ();
+                cmp16 (Y, RDMEM16 (ea));
+                cpu_clk--;
+                break;
+              OP(page2, 0xae):
+                cpu_clk--;
+                indexed ();
+                Y = ld16 (RDMEM16 (ea));
+                break;
+              OP(page2, 0xaf):
+                cpu_clk--;
+                indexed ();
+                st16 (Y);
+                break;
+              OP(page2, 0xb3):
+                extended ();
+                cpu_clk -= 6;
+                cmp16 (get_d (), RDMEM16 (ea));
+                cpu_clk--;
+                break;
+              OP(page2, 0xbc):
+                extended ();
+                cpu_clk -= 6;
+                cmp16 (Y, RDMEM16 (ea));
+                cpu_clk--;
+                break;
+              OP(page2, 0xbe):
+                extended ();
+                cpu_clk -= 6;
+                Y = ld16 (RDMEM16 (ea));
+                break;
+              OP(page2, 0xbf):
+                extended ();
+                cpu_clk -= 6;
+                st16 (Y);
+                break;
+              OP(page2, 0xce):
+                cpu_clk -= 4;
+                S = ld16 (imm_word ());
+                break;
+              OP(page2, 0xde):
+                direct ();
+                cpu_clk -= 5;
+                S = ld16 (RDMEM16 (ea));
+                break;
+              OP(page2, 0xdf):
+                direct ();
+                cpu_clk -= 5;
+                st16 (S);
+                break;
+              OP(page2, 0xee):
+                cpu_clk--;
+                indexed ();
+                S = ld16 (RDMEM16 (ea));
+                break;
+              OP(page2, 0xef):
+                cpu_clk--;
+                indexed ();
+                st16 (S);
+                break;
+              OP(page2, 0xfe):
+                extended ();
+                cpu_clk -= 6;
+                S = ld16 (RDMEM16 (ea));
+                break;
+              OP(page2, 0xff):
+                extended ();
+                cpu_clk -= 6;
+                st16 (S);
+                break;
+              OP_DEFAULT(page2):
+                log_warn("mc6809nc: invalid opcode (1) at %04x", iPC);
+                break;
+              }
+          }
+          NEXT;
+
+        OP(main, 0x11):
+          {
+            opcode = imm_byte ();
+
+            DISPATCH(page3, opcode)
+              {
+              OP(page3, 0x3f):
+                swi3 ();
+                break;
+#ifdef H6309
+                        OP(page3, 0x80): /* SUBE */
+                        OP(page3, 0x81): /* CMPE */
+#endif
+              OP(page3, 0x83):
+                cpu_clk -= 5;
+                cmp16 (U, imm_word ());
+                break;
+#ifdef H6309
+                        OP(page3, 0x86): /* LDE */
+                        OP(page3, 0x8B): /* ADDE */
+#endif
+              OP(page3, 0x8c):
+                cpu_clk -= 5;
+                cmp16 (S, imm_word ());
+                break;
+#ifdef H6309
+                        OP(page3, 0x8D): /* DIVD */
+                        OP(page3, 0x8E): /* DIVQ */
+                        OP(page3, 0x8F): /* MULD */
+                        OP(page3, 0x90): /* SUBE */
+                        OP(page3, 0x91): /* CMPE */
+#endif
+              OP(page3, 0x93):
+                direct ();
+                cpu_clk -= 5;
+                cmp16 (U, RDMEM16 (ea));
+                cpu_clk--;
+                break;
+              OP(page3, 0x9c):
+                direct ();
+                cpu_clk -= 5;
+                cmp16 (S, RDMEM16 (ea));
+                cpu_clk--;
+                break;
+              OP(page3, 0xa3):
+                cpu_clk--;
+                indexed ();
+                cmp16 (U, RDMEM16 (ea));
+                cpu_clk--;
+                break;
+              OP(page3, 0xac):
+                cpu_clk--;
+                indexed ();
+                cmp16 (S, RDMEM16 (ea));
+                cpu_clk--;
+                break;
+              OP(page3, 0xb3):
+                extended ();
+                cpu_clk -= 6;
+                cmp16 (U, RDMEM16 (ea));
+                cpu_clk--;
+                break;
+              OP(page3, 0xbc):
+                extended ();
+                cpu_clk -= 6;
+                cmp16 (S, RDMEM16 (ea));
+                cpu_clk--;
+                break;
+              OP_DEFAULT(page3):
+                log_warn ("mc6809nc: invalid opcode (2) at %04x", iPC);
+                break;
+              }
+          }
+          NEXT;
+
+        OP(main, 0x12):
+          nop ();
+          NEXT;
+        OP(main, 0x13):
+          sync ();
+          NEXT;
+#ifdef H6309
+        OP(main, 0x14):              /* SEXW */
+          NEXT;
+#endif
+        OP(main, 0x16):
+          long_bra ();
+          cpu_clk -= 5;
+          NEXT;
+        OP(main, 0x17):
+          long_bsr ();
+          NEXT;
+        OP(main, 0x19):
+          daa ();
+          NEXT;
+        OP(main, 0x1a):
+          orcc ();
+          NEXT;
+        OP(main, 0x1c):
+          andcc ();
+          NEXT;
+        OP(main, 0x1d):
+          sex ();
+          NEXT;
+        OP(main, 0x1e):
+          exg ();
+          NEXT;
+        OP(main, 0x1f):
+          tfr ();
+          NEXT;
+
+        OP(main, 0x20):
+          bra ();
+          cpu_clk -= 3;
+          NEXT;
+        OP(main, 0x21):
+          PC++;
+          cpu_clk -= 3;
+          NEXT;
+        OP(main, 0x22):
+          branch (cond_HI ());
+          NEXT;
+        OP(main, 0x23):
+          branch (cond_LS ());
+          NEXT;
+        OP(main, 0x24):
+          branch (cond_HS ());
+          NEXT;
+        OP(main, 0x25):
+          branch (cond_LO ());
+          NEXT;
+        OP(main, 0x26):
+          branch (cond_NE ());
+          NEXT;
+        OP(main, 0x27):
+          branch (cond_EQ ());
+          NEXT;
+        OP(main, 0x28):
+          branch (cond_VC ());
+          NEXT;
+        OP(main, 0x29):
+          branch (cond_VS ());
+          NEXT;
+        OP(main, 0x2a):
+          branch (cond_PL ());
+          NEXT;
+        OP(main, 0x2b):
+          branch (cond_MI ());
+          NEXT;
+        OP(main, 0x2c):
+          branch (cond_GE ());
+          NEXT;
+        OP(main, 0x2d):
+          branch (cond_LT ());
+          NEXT;
+        OP(main, 0x2e):
+          branch (cond_GT ());
+          NEXT;
+        OP(main, 0x2f):
+          branch (cond_LE ());
+          NEXT;
+
+        OP(main, 0x30):
+          indexed ();
+          Z = X = ea;
+          NEXT;                /* LEAX indexed */
+        OP(main, 0x31):
+          indexed ();
+          Z = Y = ea;
+          NEXT;                /* LEAY indexed */
+        OP(main, 0x32):
+          indexed ();
+          S = ea;
+          NEXT;                /* LEAS indexed */
+        OP(main, 0x33):
+          indexed ();
+          U = ea;
+          NEXT;                /* LEAU indexed */
+        OP(main, 0x34):
+          pshs ();
+          NEXT;                /* PSHS implied */
+        OP(main, 0x35):
+          puls ();
+          NEXT;                /* PULS implied */
+        OP(main, 0x36):
+          pshu ();
+          NEXT;                /* PSHU implied */
+        OP(main, 0x37):
+          pulu ();
+          NEXT;                /* PULU implied */
+        OP(main, 0x39):
+          rts ();
+          NEXT;                /* RTS implied  */
+        OP(main, 0x3a):
+          abx ();
+          NEXT;                /* ABX implied  */
+        OP(main, 0x3b):
+          rti ();
+          NEXT;                /* RTI implied  */
+        OP(main, 0x3c):
+          cwai ();
+          NEXT;                /* CWAI implied */
+        OP(main, 0x3d):
+          mul ();
+          NEXT;                /* MUL implied  */
+        OP(main, 0x3f):
+          swi ();
+          NEXT;                /* SWI implied  */
+
+        OP(main, 0x40):
+          A = neg (A);
+          NEXT;                /* NEGA implied */
+        OP(main, 0x43):
+          A = com (A);
+          NEXT;                /* COMA implied */
+        OP(main, 0x44):
+          A = lsr (A);
+          NEXT;                /* LSRA implied */
+        OP(main, 0x46):
+          A = ror (A);
+          NEXT;                /* RORA implied */
+        OP(main, 0x47):
+          A = asr (A);
+          NEXT;                /* ASRA implied */
+        OP(main, 0x48):
+          A = asl (A);
+          NEXT;                /* ASLA implied */
+        OP(main, 0x49):
+          A = rol (A);
+          NEXT;                /* ROLA implied */
+        OP(main, 0x4a):
+          A = dec (A);
+          NEXT;                /* DECA implied */
+        OP(main, 0x4c):
+          A = inc (A);
+          NEXT;                /* INCA implied */
+        OP(main, 0x4d):
+          tst (A);
+          NEXT;                /* TSTA implied */
+        OP(main, 0x4f):
+          A = clr (A);
+          NEXT;                /* CLRA implied */
+
+        OP(main, 0x50):
+          B = neg (B);
+          NEXT;                /* NEGB implied */
+        OP(main, 0x53):
+          B = com (B);
+          NEXT;                /* COMB implied */
+        OP(main, 0x54):
+          B = lsr (B);
+          NEXT;                /* LSRB implied */
+        OP(main, 0x56):
+          B = ror (B);
+          NEXT;                /* RORB implied */
+        OP(main, 0x57):
+          B = asr (B);
+          NEXT;                /* ASRB implied */
+        OP(main, 0x58):
+          B = asl (B);
+          NEXT;                /* ASLB implied */
+        OP(main, 0x59):
+          B = rol (B);
+          NEXT;                /* ROLB implied */
+        OP(main, 0x5a):
+          B = dec (B);
+          NEXT;                /* DECB implied */
+        OP(main, 0x5c):
+          B = inc (B);
+          NEXT;                /* INCB implied */
+        OP(main, 0x5d):
+          tst (B);
+          NEXT;                /* TSTB implied */
+        OP(main, 0x5f):
+          B = clr (B);
+          NEXT;                /* CLRB implied */
+        OP(main, 0x60):
+          indexed ();
+          WRMEM (ea, neg (RDMEM (ea)));
+          NEXT;                /* NEG indexed */
+#ifdef H6309
+        OP(main, 0x61):              /* OIM indexed */
+          NEXT;
+        OP(main, 0x62):              /* AIM indexed */
+          NEXT;
+#endif
+        OP(main, 0x63):
+          indexed ();
+          WRMEM (ea, com (RDMEM (ea)));
+          NEXT;                /* COM indexed */
+        OP(main, 0x64):
+          indexed ();
+          WRMEM (ea, lsr (RDMEM (ea)));
+          NEXT;                /* LSR indexed */
+#ifdef H6309
+        OP(main, 0x65):              /* EIM indexed */
+          NEXT;
+#endif
+        OP(main, 0x66):
+          indexed ();
+          WRMEM (ea, ror (RDMEM (ea)));
+          NEXT;                /* ROR indexed */
+        OP(main, 0x67):
+          indexed ();
+          WRMEM (ea, asr (RDMEM (ea)));
+          NEXT;                /* ASR indexed */
+        OP(main, 0x68):
+          indexed ();
+          WRMEM (ea, asl (RDMEM (ea)));
+          NEXT;                /* ASL indexed */
+        OP(main, 0x69):
+          indexed ();
+          WRMEM (ea, rol (RDMEM (ea)));
+          NEXT;                /* ROL indexed */
+        OP(main, 0x6a):
+          indexed ();
+          WRMEM (ea, dec (RDMEM (ea)));
+          NEXT;                /* DEC indexed */
+#ifdef H6309
+        OP(main, 0x6b):              /* TIM indexed */
+          NEXT;
+#endif
+        OP(main, 0x6c):
+          indexed ();
+          WRMEM (ea, inc (RDMEM (ea)));
+          NEXT;                /* INC indexed */
+        OP(main, 0x6d):
+          indexed ();
+          tst (RDMEM (ea));
+          NEXT;                /* TST indexed */
+        OP(main, 0x6e):
+          indexed ();
+          cpu_clk += 1;
+          PC = ea;
+          check_pc ();
+          NEXT;                /* JMP indexed */
+        OP(main, 0x6f):
+          indexed ();
+          WRMEM (ea, clr (RDMEM (ea)));
+          NEXT;                /* CLR indexed */
+        OP(main, 0x70):
+          extended ();
+          cpu_clk -= 5;
+          WRMEM (ea, neg (RDMEM (ea)));
+          NEXT;                /* NEG extended */
+#ifdef H6309
+        OP(main, 0x71):              /* OIM extended */
+          NEXT;
+        OP(main, 0x72):              /* AIM extended */
+          NEXT;
+#endif
+        OP(main, 0x73):
+          extended ();
+          cpu_clk -= 5;
+          WRMEM (ea, com (RDMEM (ea)));
+          NEXT;                /* COM extended */
+        OP(main, 0x74):
+          extended ();
+          cpu_clk -= 5;
+          WRMEM (ea, lsr (RDMEM (ea)));
+          NEXT;                /* LSR extended */
+#ifdef H6309
+        OP(main, 0x75):              /* EIM extended */
+          NEXT;
+#endif
+        OP(main, 0x76):
+          extended ();
+          cpu_clk -= 5;
+          WRMEM (ea, ror (RDMEM (ea)));
+          NEXT;                /* ROR extended */
+        OP(main, 0x77):
+          extended ();
+          cpu_clk -= 5;
+          WRMEM (ea, asr (RDMEM (ea)));
+          NEXT;                /* ASR extended */
+        OP(main, 0x78):
+          extended ();
+          cpu_clk -= 5;
+          WRMEM (ea, asl (RDMEM (ea)));
+          NEXT;                /* ASL extended */
+        OP(main, 0x79):
+          extended ();
+          cpu_clk -= 5;
+          WRMEM (ea, rol (RDMEM (ea)));
+          NEXT;                /* ROL extended */
+        OP(main, 0x7a):
+          extended ();
+          cpu_clk -= 5;
+          WRMEM (ea, dec (RDMEM (ea)));
+          NEXT;                /* DEC extended */
+#ifdef H6309
+        OP(main, 0x7b):              /* TIM indexed */
+          NEXT;
+#endif
+        OP(main, 0x7c):
+          extended ();
+          cpu_clk -= 5;
+          WRMEM (ea, inc (RDMEM (ea)));
+          NEXT;                /* INC extended */
+        OP(main, 0x7d):
+          extended ();
+          cpu_clk -= 5;
+          tst (RDMEM (ea));
+          NEXT;                /* TST extended */
+        OP(main, 0x7e):
+          extended ();
+          cpu_clk -= 4;
+          PC = ea;
+          check_pc ();
+          NEXT;                /* JMP extended */
+        OP(main, 0x7f):
+          extended ();
+          cpu_clk -= 5;
+          WRMEM (ea, clr (RDMEM (ea)));
+          NEXT;                /* CLR extended */
+        OP(main, 0x80):
+          cpu_clk -= 2;
+          A = sub (A, imm_byte ());
+          NEXT;
+        OP(main, 0x81):
+          cpu_clk -= 2;
+          cmp (A, imm_byte ());
+          NEXT;
+        OP(main, 0x82):
+          cpu_clk -= 2;
+          A = sbc (A, imm_byte ());
+          NEXT;
+        OP(main, 0x83):
+          cpu_clk -= 4;
+          subd (imm_word ());
+          NEXT;
+        OP(main, 0x84):
+          cpu_clk -= 2;
+          A = and (A, imm_byte ());
+          NEXT;
+        OP(main, 0x85):
+          cpu_clk -= 2;
+          bit (A, imm_byte ());
+          NEXT;
+        OP(main, 0x86):
+          cpu_clk -= 2;
+          A = ld (imm_byte ());
+          NEXT;
+        OP(main, 0x88):
+          cpu_clk -= 2;
+          A = eor (A, imm_byte ());
+          NEXT;
+        OP(main, 0x89):
+          cpu_clk -= 2;
+          A = adc (A, imm_byte ());
+          NEXT;
+        OP(main, 0x8a):
+          cpu_clk -= 2;
+          A = or (A, imm_byte ());
+          NEXT;
+        OP(main, 0x8b):
+          cpu_clk -= 2;
+          A = add (A, imm_byte ());
+          NEXT;
+        OP(main, 0x8c):
+          cpu_clk -= 4;
+          cmp16 (X, imm_word ());
+          NEXT;
+        OP(main, 0x8d):
+          bsr ();
+          NEXT;
+        OP(main, 0x8e):
+          cpu_clk -= 3;
+          X = ld16 (imm_word ());
+          NEXT;
+
+        OP(main, 0x90):
+          direct ();
+          cpu_clk -= 4;
+          A = sub (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0x91):
+          direct ();
+          cpu_clk -= 4;
+          cmp (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0x92):
+          direct ();
+          cpu_clk -= 4;
+          A = sbc (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0x93):
+          direct ();
+          cpu_clk -= 4;
+          subd (RDMEM16 (ea));
+          cpu_clk--;
+          NEXT;
+        OP(main, 0x94):
+          direct ();
+          cpu_clk -= 4;
+          A = and (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0x95):
+          direct ();
+          cpu_clk -= 4;
+          bit (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0x96):
+          direct ();
+          cpu_clk -= 4;
+          A = ld (RDMEM (ea));
+          NEXT;
+        OP(main, 0x97):
+          direct ();
+          cpu_clk -= 4;
+          st (A);
+          NEXT;
+        OP(main, 0x98):
+          direct ();
+          cpu_clk -= 4;
+          A = eor (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0x99):
+          direct ();
+          cpu_clk -= 4;
+          A = adc (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0x9a):
+          direct ();
+          cpu_clk -= 4;
+          A = or (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0x9b):
+          direct ();
+          cpu_clk -= 4;
+          A = add (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0x9c):
+          direct ();
+          cpu_clk -= 4;
+          cmp16 (X, RDMEM16 (ea));
+          cpu_clk--;
+          NEXT;
+        OP(main, 0x9d):
+          direct ();
+          cpu_clk -= 7;
+          jsr ();
+          NEXT;
+        OP(main, 0x9e):
+          direct ();
+          cpu_clk -= 4;
+          X = ld16 (RDMEM16 (ea));
+          NEXT;
+        OP(main, 0x9f):
+          direct ();
+          cpu_clk -= 4;
+          st16 (X);
+          NEXT;
+
+        OP(main, 0xa0):
+          indexed ();
+          A = sub (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xa1):
+          indexed ();
+          cmp (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xa2):
+          indexed ();
+          A = sbc (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xa3):
+          indexed ();
+          subd (RDMEM16 (ea));
+          cpu_clk--;
+          NEXT;
+        OP(main, 0xa4):
+          indexed ();
+          A = and (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xa5):
+          indexed ();
+          bit (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xa6):
+          indexed ();
+          A = ld (RDMEM (ea));
+          NEXT;
+        OP(main, 0xa7):
+          indexed ();
+          st (A);
+          NEXT;
+        OP(main, 0xa8):
+          indexed ();
+          A = eor (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xa9):
+          indexed ();
+          A = adc (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xaa):
+          indexed ();
+          A = or (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xab):
+          indexed ();
+          A = add (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xac):
+          indexed ();
+          cmp16 (X, RDMEM16 (ea));
+          cpu_clk--;
+          NEXT;
+        OP(main, 0xad):
+          indexed ();
+          cpu_clk -= 3;
+          jsr ();
+          NEXT;
+        OP(main, 0xae):
+          indexed ();
+          X = ld16 (RDMEM16 (ea));
+          NEXT;
+        OP(main, 0xaf):
+          indexed ();
+          st16 (X);
+          NEXT;
+
+        OP(main, 0xb0):
+          extended ();
+          cpu_clk -= 5;
+          A = sub (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xb1):
+          extended ();
+          cpu_clk -= 5;
+          cmp (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xb2):
+          extended ();
+          cpu_clk -= 5;
+          A = sbc (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xb3):
+          extended ();
+          cpu_clk -= 5;
+          subd (RDMEM16 (ea));
+          cpu_clk--;
+          NEXT;
+        OP(main, 0xb4):
+          extended ();
+          cpu_clk -= 5;
+          A = and (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xb5):
+          extended ();
+          cpu_clk -= 5;
+          bit (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xb6):
+          extended ();
+          cpu_clk -= 5;
+          A = ld (RDMEM (ea));
+          NEXT;
+        OP(main, 0xb7):
+          extended ();
+          cpu_clk -= 5;
+          st (A);
+          NEXT;
+        OP(main, 0xb8):
+          extended ();
+          cpu_clk -= 5;
+          A = eor (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xb9):
+          extended ();
+          cpu_clk -= 5;
+          A = adc (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xba):
+          extended ();
+          cpu_clk -= 5;
+          A = or (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xbb):
+          extended ();
+          cpu_clk -= 5;
+          A = add (A, RDMEM (ea));
+          NEXT;
+        OP(main, 0xbc):
+          extended ();
+          cpu_clk -= 5;
+          cmp16 (X, RDMEM16 (ea));
+          cpu_clk--;
+          NEXT;
+        OP(main, 0xbd):
+          extended ();
+          cpu_clk -= 8;
+          jsr ();
+          NEXT;
+        OP(main, 0xbe):
+          extended ();
+          cpu_clk -= 5;
+          X = ld16 (RDMEM16 (ea));
+          NEXT;
+        OP(main, 0xbf):
+          extended ();
+          cpu_clk -= 5;
+          st16 (X);
+          NEXT;
+
+        OP(main, 0xc0):
+          cpu_clk -= 2;
+          B = sub (B, imm_byte ());
+          NEXT;
+        OP(main, 0xc1):
+          cpu_clk -= 2;
+          cmp (B, imm_byte ());
+          NEXT;
+        OP(main, 0xc2):
+          cpu_clk -= 2;
+          B = sbc (B, imm_byte ());
+          NEXT;
+        OP(main, 0xc3):
+          cpu_clk -= 4;
+          addd (imm_word ());
+          NEXT;
+        OP(main, 0xc4):
+          cpu_clk -= 2;
+          B = and (B, imm_byte ());
+          NEXT;
+        OP(main, 0xc5):
+          cpu_clk -= 2;
+          bit (B, imm_byte ());
+          NEXT;
+        OP(main, 0xc6):
+          cpu_clk -= 2;
+          B = ld (imm_byte ());
+          NEXT;
+        OP(main, 0xc8):
+          cpu_clk -= 2;
+          B = eor (B, imm_byte ());
+          NEXT;
+        OP(main, 0xc9):
+          cpu_clk -= 2;
+          B = adc (B, imm_byte ());
+          NEXT;
+        OP(main, 0xca):
+          cpu_clk -= 2;
+          B = or (B, imm_byte ());
+          NEXT;
+        OP(main, 0xcb):
+          cpu_clk -= 2;
+          B = add (B, imm_byte ());
+          NEXT;
+        OP(main, 0xcc):
+          cpu_clk -= 3;
+          ldd (imm_word ());
+          NEXT;
+#ifdef H6309
+        OP(main, 0xcd):              /* LDQ immed */
+          NEXT;
+#endif
+        OP(main, 0xce):
+          cpu_clk -= 3;
+          U = ld16 (imm_word ());
+          NEXT;
+
+        OP(main, 0xd0):
+          direct ();
+          cpu_clk -= 4;
+          B = sub (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xd1):
+          direct ();
+          cpu_clk -= 4;
+          cmp (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xd2):
+          direct ();
+          cpu_clk -= 4;
+          B = sbc (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xd3):
+          direct ();
+          cpu_clk -= 4;
+          addd (RDMEM16 (ea));
+          cpu_clk--;
+          NEXT;
+        OP(main, 0xd4):
+          direct ();
+          cpu_clk -= 4;
+          B = and (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xd5):
+          direct ();
+          cpu_clk -= 4;
+          bit (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xd6):
+          direct ();
+          cpu_clk -= 4;
+          B = ld (RDMEM (ea));
+          NEXT;
+        OP(main, 0xd7):
+          direct ();
+          cpu_clk -= 4;
+          st (B);
+          NEXT;
+        OP(main, 0xd8):
+          direct ();
+          cpu_clk -= 4;
+          B = eor (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xd9):
+          direct ();
+          cpu_clk -= 4;
+          B = adc (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xda):
+          direct ();
+          cpu_clk -= 4;
+          B = or (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xdb):
+          direct ();
+          cpu_clk -= 4;
+          B = add (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xdc):
+          direct ();
+          cpu_clk -= 4;
+          ldd (RDMEM16 (ea));
+          NEXT;
+        OP(main, 0xdd):
+          direct ();
+          cpu_clk -= 4;
+          std ();
+          NEXT;
+        OP(main, 0xde):
+          direct ();
+          cpu_clk -= 4;
+          U = ld16 (RDMEM16 (ea));
+          NEXT;
+        OP(main, 0xdf):
+          direct ();
+          cpu_clk -= 4;
+          st16 (U);
+          NEXT;
+
+        OP(main, 0xe0):
+          indexed ();
+          B = sub (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xe1):
+          indexed ();
+          cmp (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xe2):
+          indexed ();
+          B = sbc (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xe3):
+          indexed ();
+          addd (RDMEM16 (ea));
+          cpu_clk--;
+          NEXT;
+        OP(main, 0xe4):
+          indexed ();
+          B = and (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xe5):
+          indexed ();
+          bit (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xe6):
+          indexed ();
+          B = ld (RDMEM (ea));
+          NEXT;
+        OP(main, 0xe7):
+          indexed ();
+          st (B);
+          NEXT;
+        OP(main, 0xe8):
+          indexed ();
+          B = eor (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xe9):
+          indexed ();
+          B = adc (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xea):
+          indexed ();
+          B = or (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xeb):
+          indexed ();
+          B = add (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xec):
+          indexed ();
+          ldd (RDMEM16 (ea));
+          NEXT;
+        OP(main, 0xed):
+          indexed ();
+          std ();
+          NEXT;
+        OP(main, 0xee):
+          indexed ();
+          U = ld16 (RDMEM16 (ea));
+          NEXT;
+        OP(main, 0xef):
+          indexed ();
+          st16 (U);
+          NEXT;
+
+        OP(main, 0xf0):
+          extended ();
+          cpu_clk -= 5;
+          B = sub (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xf1):
+          extended ();
+          cpu_clk -= 5;
+          cmp (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xf2):
+          extended ();
+          cpu_clk -= 5;
+          B = sbc (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xf3):
+          extended ();
+          cpu_clk -= 5;
+          addd (RDMEM16 (ea));
+          cpu_clk--;
+          NEXT;
+        OP(main, 0xf4):
+          extended ();
+          cpu_clk -= 5;
+          B = and (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xf5):
+          extended ();
+          cpu_clk -= 5;
+          bit (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xf6):
+          extended ();
+          cpu_clk -= 5;
+          B = ld (RDMEM (ea));
+          NEXT;
+        OP(main, 0xf7):
+          extended ();
+          cpu_clk -= 5;
+          st (B);
+          NEXT;
+        OP(main, 0xf8):
+          extended ();
+          cpu_clk -= 5;
+          B = eor (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xf9):
+          extended ();
+          cpu_clk -= 5;
+          B = adc (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xfa):
+          extended ();
+          cpu_clk -= 5;
+          B = or (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xfb):
+          extended ();
+          cpu_clk -= 5;
+          B = add (B, RDMEM (ea));
+          NEXT;
+        OP(main, 0xfc):
+          extended ();
+          cpu_clk -= 5;
+          ldd (RDMEM16 (ea));
+          NEXT;
+        OP(main, 0xfd):
+          extended ();
+          cpu_clk -= 5;
+          std ();
+          NEXT;
+        OP(main, 0xfe):
+          extended ();
+          cpu_clk -= 5;
+          U = ld16 (RDMEM16 (ea));
+          NEXT;
+        OP(main, 0xff):
+          extended ();
+          cpu_clk -= 5;
+          st16 (U);
+          NEXT;
+
+        OP_DEFAULT(main):
+          cpu_clk -= 2;
+          log_warn ("mc6809nc: invalid opcode '%02X'", opcode);
+          PC = iPC;
+          NEXT;
+        }
+
+        if (cc_changed)
+          cc_modified ();
+
+   tubeUseCycles(1);
+  } while (tubeContinueRunning());
+
+#ifdef THREADED_DISPATCH
+done:
+#endif
+  cpu_period -= cpu_clk;
+  cpu_clk = cpu_period;
+}
+
+#undef NEXT
+#undef fetch_opcode
+#undef mc6809nc_execute
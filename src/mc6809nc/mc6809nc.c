@@ -25,6 +25,12 @@
 #include "../6809tube.h"
 #include "../logging.h"
 
+/* The threaded dispatch tables do not cover the 6309 opcodes. */
+#ifdef H6309
+#define NO_THREADED_DISPATCH
+#endif
+#include "../dispatch.h"
+
 #ifdef INCLUDE_DEBUGGER
 #include "mc6809_debug.h"
 #include "../cpu_debug.h"
@@ -1566,1385 +1572,35 @@ static void bsr (void)
   change_pc (ea);
 }
 
-/* Execute 6809 code for tubecycles cycles. */
-void mc6809nc_execute(void)
-{
-  unsigned opcode;
-
-  cpu_period = cpu_clk = tubecycles;
-
-  if (sync_flag) {
-     return;
-  }
-
-  do
-    {
-
-      iPC = PC;
+/* The execution loop is built from mc6809core.h once with the debugger
+   hook and once without.  The plain variant runs unless the debugger
+   is enabled for the 6809. */
 
 #ifdef INCLUDE_DEBUGGER
-      if (mc6809nc_debug_enabled)
-      {
-         debug_preexec(&mc6809nc_cpu_debug, PC);
-      }
-#endif
-
-      opcode = imm_byte ();
-
-      switch (opcode)
-        {
-        case 0x00:
-          direct ();
-          cpu_clk -= 4;
-          WRMEM (ea, neg (RDMEM (ea)));
-          break;                /* NEG direct */
-#ifdef H6309
-        case 0x01:              /* OIM */
-          break;
-        case 0x02:              /* AIM */
-          break;
-#endif
-        case 0x03:
-          direct ();
-          cpu_clk -= 4;
-          WRMEM (ea, com (RDMEM (ea)));
-          break;                /* COM direct */
-        case 0x04:
-          direct ();
-          cpu_clk -= 4;
-          WRMEM (ea, lsr (RDMEM (ea)));
-          break;                /* LSR direct */
-#ifdef H6309
-        case 0x05:              /* EIM */
-          break;
-#endif
-        case 0x06:
-          direct ();
-          cpu_clk -= 4;
-          WRMEM (ea, ror (RDMEM (ea)));
-          break;                /* ROR direct */
-        case 0x07:
-          direct ();
-          cpu_clk -= 4;
-          WRMEM (ea, asr (RDMEM (ea)));
-          break;                /* ASR direct */
-        case 0x08:
-          direct ();
-          cpu_clk -= 4;
-          WRMEM (ea, asl (RDMEM (ea)));
-          break;                /* ASL direct */
-        case 0x09:
-          direct ();
-          cpu_clk -= 4;
-          WRMEM (ea, rol (RDMEM (ea)));
-          break;                /* ROL direct */
-        case 0x0a:
-          direct ();
-          cpu_clk -= 4;
-          WRMEM (ea, dec (RDMEM (ea)));
-          break;                /* DEC direct */
-#ifdef H6309
-        case 0x0B:              /* TIM */
-          break;
-#endif
-        case 0x0c:
-          direct ();
-          cpu_clk -= 4;
-          WRMEM (ea, inc (RDMEM (ea)));
-          break;                /* INC direct */
-        case 0x0d:
-          direct ();
-          cpu_clk -= 4;
-          tst (RDMEM (ea));
-          break;                /* TST direct */
-        case 0x0e:
-          direct ();
-          cpu_clk -= 3;
-          PC = ea;
-     check_pc ();
-          break;                /* JMP direct */
-        case 0x0f:
-          direct ();
-          cpu_clk -= 4;
-          WRMEM (ea, clr (RDMEM (ea)));
-          break;                /* CLR direct */
-        case 0x10:
-          {
-            opcode = imm_byte ();
-
-            switch (opcode)
-              {
-              case 0x21:
-                cpu_clk -= 5;
-                PC += 2;
-                break;
-              case 0x22:
-                long_branch (cond_HI ());
-                break;
-              case 0x23:
-                long_branch (cond_LS ());
-                break;
-              case 0x24:
-                long_branch (cond_HS ());
-                break;
-              case 0x25:
-                long_branch (cond_LO ());
-                break;
-              case 0x26:
-                long_branch (cond_NE ());
-                break;
-              case 0x27:
-                long_branch (cond_EQ ());
-                break;
-              case 0x28:
-                long_branch (cond_VC ());
-                break;
-              case 0x29:
-                long_branch (cond_VS ());
-                break;
-              case 0x2a:
-                long_branch (cond_PL ());
-                break;
-              case 0x2b:
-                long_branch (cond_MI ());
-                break;
-              case 0x2c:
-                long_branch (cond_GE ());
-                break;
-              case 0x2d:
-                long_branch (cond_LT ());
-                break;
-              case 0x2e:
-                long_branch (cond_GT ());
-                break;
-              case 0x2f:
-                long_branch (cond_LE ());
-                break;
-#ifdef H6309
-              case 0x30:        /* ADDR */
-                break;
-              case 0x31:        /* ADCR */
-                break;
-              case 0x32:        /* SUBR */
-                break;
-              case 0x33:        /* SBCR */
-                break;
-              case 0x34:        /* ANDR */
-                break;
-              case 0x35:        /* ORR */
-                break;
-              case 0x36:        /* EORR */
-                break;
-              case 0x37:        /* CMPR */
-                break;
-              case 0x38:        /* PSHSW */
-                break;
-              case 0x39:        /* PULSW */
-                break;
-              case 0x3a:        /* PSHUW */
-                break;
-              case 0x3b:        /* PULUW */
-                break;
-#endif
-              case 0x3f:
-                swi2 ();
-                break;
-#ifdef H6309
-              case 0x40:        /* NEGD */
-                break;
-              case 0x43:        /* COMD */
-                break;
-              case 0x44:        /* LSRD */
-                break;
-              case 0x46:        /* RORD */
-                break;
-              case 0x47:        /* ASRD */
-                break;
-              case 0x48:        /* ASLD/LSLD */
-                break;
-              case 0x49:        /* ROLD */
-                break;
-              case 0x4a:        /* DECD */
-                break;
-              case 0x4c:        /* INCD */
-                break;
-              case 0x4d:        /* TSTD */
-                break;
-              case 0x4f:        /* CLRD */
-                break;
-              case 0x53:        /* COMW */
-                break;
-              case 0x54:        /* LSRW */
-                break;
-              case 0x56:        /* ??RORW */
-                break;
-              case 0x59:        /* ROLW */
-                break;
-              case 0x5a:        /* DECW */
-                break;
-              case 0x5c:        /* INCW */
-                break;
-              case 0x5d:        /* TSTW */
-                break;
-              case 0x5f:        /* CLRW */
-                break;
-              case 0x80:        /* SUBW */
-                break;
-              case 0x81:        /* CMPW */
-                break;
-              case 0x82:        /* SBCD */
-                break;
-#endif
-              case 0x83:
-                cpu_clk -= 5;
-                cmp16 (get_d (), imm_word ());
-                break;
-#ifdef H6309
-              case 0x84:        /* ANDD */
-                break;
-              case 0x85:        /* BITD */
-                break;
-              case 0x86:        /* LDW */
-                break;
-              case 0x88:        /* EORD */
-                break;
-              case 0x89:        /* ADCD */
-                break;
-              case 0x8a:        /* ORD */
-                break;
-              case 0x8b:        /* ADDW */
-                break;
-#endif
-              case 0x8c:
-                cpu_clk -= 5;
-                cmp16 (Y, imm_word ());
-                break;
-              case 0x8e:
-                cpu_clk -= 4;
-                Y = ld16 (imm_word ());
-                break;
-#ifdef H6309
-              case 0x90:        /* SUBW */
-                break;
-              case 0x91:        /* CMPW */
-                break;
-              case 0x92:        /* SBCD */
-                break;
-#endif
-              case 0x93:
-                direct ();
-                cpu_clk -= 5;
-                cmp16 (get_d (), RDMEM16 (ea));
-                cpu_clk--;
-                break;
-              case 0x9c:
-                direct ();
-                cpu_clk -= 5;
-                cmp16 (Y, RDMEM16 (ea));
-                cpu_clk--;
-                break;
-              case 0x9e:
-                direct ();
-                cpu_clk -= 5;
-                Y = ld16 (RDMEM16 (ea));
-                break;
-              case 0x9f:
-                direct ();
-                cpu_clk -= 5;
-                st16 (Y);
-                break;
-              case 0xa3:
-                cpu_clk--;
-                indexed ();
-                cmp16 (get_d (), RDMEM16 (ea));
-                cpu_clk--;
-                break;
-              case 0xac:
-                cpu_clk--;
-                indexed ();
-                cmp16 (Y, RDMEM16 (ea));
-                cpu_clk--;
-                break;
-              case 0xae:
-                cpu_clk--;
-                indexed ();
-                Y = ld16 (RDMEM16 (ea));
-                break;
-              case 0xaf:
-                cpu_clk--;
-                indexed ();
-                st16 (Y);
-                break;
-              case 0xb3:
-                extended ();
-                cpu_clk -= 6;
-                cmp16 (get_d (), RDMEM16 (ea));
-                cpu_clk--;
-                break;
-              case 0xbc:
-                extended ();
-                cpu_clk -= 6;
-                cmp16 (Y, RDMEM16 (ea));
-                cpu_clk--;
-                break;
-              case 0xbe:
-                extended ();
-                cpu_clk -= 6;
-                Y = ld16 (RDMEM16 (ea));
-                break;
-              case 0xbf:
-                extended ();
-                cpu_clk -= 6;
-                st16 (Y);
-                break;
-              case 0xce:
-                cpu_clk -= 4;
-                S = ld16 (imm_word ());
-                break;
-              case 0xde:
-                direct ();
-                cpu_clk -= 5;
-                S = ld16 (RDMEM16 (ea));
-                break;
-              case 0xdf:
-                direct ();
-                cpu_clk -= 5;
-                st16 (S);
-                break;
-              case 0xee:
-                cpu_clk--;
-                indexed ();
-                S = ld16 (RDMEM16 (ea));
-                break;
-              case 0xef:
-                cpu_clk--;
-                indexed ();
-                st16 (S);
-                break;
-              case 0xfe:
-                extended ();
-                cpu_clk -= 6;
-                S = ld16 (RDMEM16 (ea));
-                break;
-              case 0xff:
-                extended ();
-                cpu_clk -= 6;
-                st16 (S);
-                break;
-              default:
-                log_warn("mc6809nc: invalid opcode (1) at %04x", iPC);
-                break;
-              }
-          }
-          break;
-
-        case 0x11:
-          {
-            opcode = imm_byte ();
-
-            switch (opcode)
-              {
-              case 0x3f:
-                swi3 ();
-                break;
-#ifdef H6309
-                        case 0x80: /* SUBE */
-                        case 0x81: /* CMPE */
-#endif
-              case 0x83:
-                cpu_clk -= 5;
-                cmp16 (U, imm_word ());
-                break;
-#ifdef H6309
-                        case 0x86: /* LDE */
-                        case 0x8B: /* ADDE */
-#endif
-              case 0x8c:
-                cpu_clk -= 5;
-                cmp16 (S, imm_word ());
-                break;
-#ifdef H6309
-                        case 0x8D: /* DIVD */
-                        case 0x8E: /* DIVQ */
-                        case 0x8F: /* MULD */
-                        case 0x90: /* SUBE */
-                        case 0x91: /* CMPE */
-#endif
-              case 0x93:
-                direct ();
-                cpu_clk -= 5;
-                cmp16 (U, RDMEM16 (ea));
-                cpu_clk--;
-                break;
-              case 0x9c:
-                direct ();
-                cpu_clk -= 5;
-                cmp16 (S, RDMEM16 (ea));
-                cpu_clk--;
-                break;
-              case 0xa3:
-                cpu_clk--;
-                indexed ();
-                cmp16 (U, RDMEM16 (ea));
-                cpu_clk--;
-                break;
-              case 0xac:
-                cpu_clk--;
-                indexed ();
-                cmp16 (S, RDMEM16 (ea));
-                cpu_clk--;
-                break;
-              case 0xb3:
-                extended ();
-                cpu_clk -= 6;
-                cmp16 (U, RDMEM16 (ea));
-                cpu_clk--;
-                break;
-              case 0xbc:
-                extended ();
-                cpu_clk -= 6;
-                cmp16 (S, RDMEM16 (ea));
-                cpu_clk--;
-                break;
-              default:
-                log_warn ("mc6809nc: invalid opcode (2) at %04x", iPC);
-                break;
-              }
-          }
-          break;
-
-        case 0x12:
-          nop ();
-          break;
-        case 0x13:
-          sync ();
-          break;
-#ifdef H6309
-        case 0x14:              /* SEXW */
-          break;
-#endif
-        case 0x16:
-          long_bra ();
-          cpu_clk -= 5;
-          break;
-        case 0x17:
-          long_bsr ();
-          break;
-        case 0x19:
-          daa ();
-          break;
-        case 0x1a:
-          orcc ();
-          break;
-        case 0x1c:
-          andcc ();
-          break;
-        case 0x1d:
-          sex ();
-          break;
-        case 0x1e:
-          exg ();
-          break;
-        case 0x1f:
-          tfr ();
-          break;
-
-        case 0x20:
-          bra ();
-          cpu_clk -= 3;
-          break;
-        case 0x21:
-          PC++;
-          cpu_clk -= 3;
-          break;
-        case 0x22:
-          branch (cond_HI ());
-          break;
-        case 0x23:
-          branch (cond_LS ());
-          break;
-        case 0x24:
-          branch (cond_HS ());
-          break;
-        case 0x25:
-          branch (cond_LO ());
-          break;
-        case 0x26:
-          branch (cond_NE ());
-          break;
-        case 0x27:
-          branch (cond_EQ ());
-          break;
-        case 0x28:
-          branch (cond_VC ());
-          break;
-        case 0x29:
-          branch (cond_VS ());
-          break;
-        case 0x2a:
-          branch (cond_PL ());
-          break;
-        case 0x2b:
-          branch (cond_MI ());
-          break;
-        case 0x2c:
-          branch (cond_GE ());
-          break;
-        case 0x2d:
-          branch (cond_LT ());
-          break;
-        case 0x2e:
-          branch (cond_GT ());
-          break;
-        case 0x2f:
-          branch (cond_LE ());
-          break;
-
-        case 0x30:
-          indexed ();
-          Z = X = ea;
-          break;                /* LEAX indexed */
-        case 0x31:
-          indexed ();
-          Z = Y = ea;
-          break;                /* LEAY indexed */
-        case 0x32:
-          indexed ();
-          S = ea;
-          break;                /* LEAS indexed */
-        case 0x33:
-          indexed ();
-          U = ea;
-          break;                /* LEAU indexed */
-        case 0x34:
-          pshs ();
-          break;                /* PSHS implied */
-        case 0x35:
-          puls ();
-          break;                /* PULS implied */
-        case 0x36:
-          pshu ();
-          break;                /* PSHU implied */
-        case 0x37:
-          pulu ();
-          break;                /* PULU implied */
-        case 0x39:
-          rts ();
-          break;                /* RTS implied  */
-        case 0x3a:
-          abx ();
-          break;                /* ABX implied  */
-        case 0x3b:
-          rti ();
-          break;                /* RTI implied  */
-        case 0x3c:
-          cwai ();
-          break;                /* CWAI implied */
-        case 0x3d:
-          mul ();
-          break;                /* MUL implied  */
-        case 0x3f:
-          swi ();
-          break;                /* SWI implied  */
-
-        case 0x40:
-          A = neg (A);
-          break;                /* NEGA implied */
-        case 0x43:
-          A = com (A);
-          break;                /* COMA implied */
-        case 0x44:
-          A = lsr (A);
-          break;                /* LSRA implied */
-        case 0x46:
-          A = ror (A);
-          break;                /* RORA implied */
-        case 0x47:
-          A = asr (A);
-          break;                /* ASRA implied */
-        case 0x48:
-          A = asl (A);
-          break;                /* ASLA implied */
-        case 0x49:
-          A = rol (A);
-          break;                /* ROLA implied */
-        case 0x4a:
-          A = dec (A);
-          break;                /* DECA implied */
-        case 0x4c:
-          A = inc (A);
-          break;                /* INCA implied */
-        case 0x4d:
-          tst (A);
-          break;                /* TSTA implied */
-        case 0x4f:
-          A = clr (A);
-          break;                /* CLRA implied */
-
-        case 0x50:
-          B = neg (B);
-          break;                /* NEGB implied */
-        case 0x53:
-          B = com (B);
-          break;                /* COMB implied */
-        case 0x54:
-          B = lsr (B);
-          break;                /* LSRB implied */
-        case 0x56:
-          B = ror (B);
-          break;                /* RORB implied */
-        case 0x57:
-          B = asr (B);
-          break;                /* ASRB implied */
-        case 0x58:
-          B = asl (B);
-          break;                /* ASLB implied */
-        case 0x59:
-          B = rol (B);
-          break;                /* ROLB implied */
-        case 0x5a:
-          B = dec (B);
-          break;                /* DECB implied */
-        case 0x5c:
-          B = inc (B);
-          break;                /* INCB implied */
-        case 0x5d:
-          tst (B);
-          break;                /* TSTB implied */
-        case 0x5f:
-          B = clr (B);
-          break;                /* CLRB implied */
-        case 0x60:
-          indexed ();
-          WRMEM (ea, neg (RDMEM (ea)));
-          break;                /* NEG indexed */
-#ifdef H6309
-        case 0x61:              /* OIM indexed */
-          break;
-        case 0x62:              /* AIM indexed */
-          break;
-#endif
-        case 0x63:
-          indexed ();
-          WRMEM (ea, com (RDMEM (ea)));
-          break;                /* COM indexed */
-        case 0x64:
-          indexed ();
-          WRMEM (ea, lsr (RDMEM (ea)));
-          break;                /* LSR indexed */
-#ifdef H6309
-        case 0x65:              /* EIM indexed */
-          break;
-#endif
-        case 0x66:
-          indexed ();
-          WRMEM (ea, ror (RDMEM (ea)));
-          break;                /* ROR indexed */
-        case 0x67:
-          indexed ();
-          WRMEM (ea, asr (RDMEM (ea)));
-          break;                /* ASR indexed */
-        case 0x68:
-          indexed ();
-          WRMEM (ea, asl (RDMEM (ea)));
-          break;                /* ASL indexed */
-        case 0x69:
-          indexed ();
-          WRMEM (ea, rol (RDMEM (ea)));
-          break;                /* ROL indexed */
-        case 0x6a:
-          indexed ();
-          WRMEM (ea, dec (RDMEM (ea)));
-          break;                /* DEC indexed */
-#ifdef H6309
-        case 0x6b:              /* TIM indexed */
-          break;
-#endif
-        case 0x6c:
-          indexed ();
-          WRMEM (ea, inc (RDMEM (ea)));
-          break;                /* INC indexed */
-        case 0x6d:
-          indexed ();
-          tst (RDMEM (ea));
-          break;                /* TST indexed */
-        case 0x6e:
-          indexed ();
-          cpu_clk += 1;
-          PC = ea;
-          check_pc ();
-          break;                /* JMP indexed */
-        case 0x6f:
-          indexed ();
-          WRMEM (ea, clr (RDMEM (ea)));
-          break;                /* CLR indexed */
-        case 0x70:
-          extended ();
-          cpu_clk -= 5;
-          WRMEM (ea, neg (RDMEM (ea)));
-          break;                /* NEG extended */
-#ifdef H6309
-        case 0x71:              /* OIM extended */
-          break;
-        case 0x72:              /* AIM extended */
-          break;
-#endif
-        case 0x73:
-          extended ();
-          cpu_clk -= 5;
-          WRMEM (ea, com (RDMEM (ea)));
-          break;                /* COM extended */
-        case 0x74:
-          extended ();
-          cpu_clk -= 5;
-          WRMEM (ea, lsr (RDMEM (ea)));
-          break;                /* LSR extended */
-#ifdef H6309
-        case 0x75:              /* EIM extended */
-          break;
+#define CORE_DEBUG 1
+#define CORE_NAME(name) name##_debug
+#include "mc6809core.h"
+#undef CORE_DEBUG
+#undef CORE_NAME
 #endif
-        case 0x76:
-          extended ();
-          cpu_clk -= 5;
-          WRMEM (ea, ror (RDMEM (ea)));
-          break;                /* ROR extended */
-        case 0x77:
-          extended ();
-          cpu_clk -= 5;
-          WRMEM (ea, asr (RDMEM (ea)));
-          break;                /* ASR extended */
-        case 0x78:
-          extended ();
-          cpu_clk -= 5;
-          WRMEM (ea, asl (RDMEM (ea)));
-          break;                /* ASL extended */
-        case 0x79:
-          extended ();
-          cpu_clk -= 5;
-          WRMEM (ea, rol (RDMEM (ea)));
-          break;                /* ROL extended */
-        case 0x7a:
-          extended ();
-          cpu_clk -= 5;
-          WRMEM (ea, dec (RDMEM (ea)));
-          break;                /* DEC extended */
-#ifdef H6309
-        case 0x7b:              /* TIM indexed */
-          break;
-#endif
-        case 0x7c:
-          extended ();
-          cpu_clk -= 5;
-          WRMEM (ea, inc (RDMEM (ea)));
-          break;                /* INC extended */
-        case 0x7d:
-          extended ();
-          cpu_clk -= 5;
-          tst (RDMEM (ea));
-          break;                /* TST extended */
-        case 0x7e:
-          extended ();
-          cpu_clk -= 4;
-          PC = ea;
-          check_pc ();
-          break;                /* JMP extended */
-        case 0x7f:
-          extended ();
-          cpu_clk -= 5;
-          WRMEM (ea, clr (RDMEM (ea)));
-          break;                /* CLR extended */
-        case 0x80:
-          cpu_clk -= 2;
-          A = sub (A, imm_byte ());
-          break;
-        case 0x81:
-          cpu_clk -= 2;
-          cmp (A, imm_byte ());
-          break;
-        case 0x82:
-          cpu_clk -= 2;
-          A = sbc (A, imm_byte ());
-          break;
-        case 0x83:
-          cpu_clk -= 4;
-          subd (imm_word ());
-          break;
-        case 0x84:
-          cpu_clk -= 2;
-          A = and (A, imm_byte ());
-          break;
-        case 0x85:
-          cpu_clk -= 2;
-          bit (A, imm_byte ());
-          break;
-        case 0x86:
-          cpu_clk -= 2;
-          A = ld (imm_byte ());
-          break;
-        case 0x88:
-          cpu_clk -= 2;
-          A = eor (A, imm_byte ());
-          break;
-        case 0x89:
-          cpu_clk -= 2;
-          A = adc (A, imm_byte ());
-          break;
-        case 0x8a:
-          cpu_clk -= 2;
-          A = or (A, imm_byte ());
-          break;
-        case 0x8b:
-          cpu_clk -= 2;
-          A = add (A, imm_byte ());
-          break;
-        case 0x8c:
-          cpu_clk -= 4;
-          cmp16 (X, imm_word ());
-          break;
-        case 0x8d:
-          bsr ();
-          break;
-        case 0x8e:
-          cpu_clk -= 3;
-          X = ld16 (imm_word ());
-          break;
-
-        case 0x90:
-          direct ();
-          cpu_clk -= 4;
-          A = sub (A, RDMEM (ea));
-          break;
-        case 0x91:
-          direct ();
-          cpu_clk -= 4;
-          cmp (A, RDMEM (ea));
-          break;
-        case 0x92:
-          direct ();
-          cpu_clk -= 4;
-          A = sbc (A, RDMEM (ea));
-          break;
-        case 0x93:
-          direct ();
-          cpu_clk -= 4;
-          subd (RDMEM16 (ea));
-          cpu_clk--;
-          break;
-        case 0x94:
-          direct ();
-          cpu_clk -= 4;
-          A = and (A, RDMEM (ea));
-          break;
-        case 0x95:
-          direct ();
-          cpu_clk -= 4;
-          bit (A, RDMEM (ea));
-          break;
-        case 0x96:
-          direct ();
-          cpu_clk -= 4;
-          A = ld (RDMEM (ea));
-          break;
-        case 0x97:
-          direct ();
-          cpu_clk -= 4;
-          st (A);
-          break;
-        case 0x98:
-          direct ();
-          cpu_clk -= 4;
-          A = eor (A, RDMEM (ea));
-          break;
-        case 0x99:
-          direct ();
-          cpu_clk -= 4;
-          A = adc (A, RDMEM (ea));
-          break;
-        case 0x9a:
-          direct ();
-          cpu_clk -= 4;
-          A = or (A, RDMEM (ea));
-          break;
-        case 0x9b:
-          direct ();
-          cpu_clk -= 4;
-          A = add (A, RDMEM (ea));
-          break;
-        case 0x9c:
-          direct ();
-          cpu_clk -= 4;
-          cmp16 (X, RDMEM16 (ea));
-          cpu_clk--;
-          break;
-        case 0x9d:
-          direct ();
-          cpu_clk -= 7;
-          jsr ();
-          break;
-        case 0x9e:
-          direct ();
-          cpu_clk -= 4;
-          X = ld16 (RDMEM16 (ea));
-          break;
-        case 0x9f:
-          direct ();
-          cpu_clk -= 4;
-          st16 (X);
-          break;
 
-        case 0xa0:
-          indexed ();
-          A = sub (A, RDMEM (ea));
-          break;
-        case 0xa1:
-          indexed ();
-          cmp (A, RDMEM (ea));
-          break;
-        case 0xa2:
-          indexed ();
-          A = sbc (A, RDMEM (ea));
-          break;
-        case 0xa3:
-          indexed ();
-          subd (RDMEM16 (ea));
-          cpu_clk--;
-          break;
-        case 0xa4:
-          indexed ();
-          A = and (A, RDMEM (ea));
-          break;
-        case 0xa5:
-          indexed ();
-          bit (A, RDMEM (ea));
-          break;
-        case 0xa6:
-          indexed ();
-          A = ld (RDMEM (ea));
-          break;
-        case 0xa7:
-          indexed ();
-          st (A);
-          break;
-        case 0xa8:
-          indexed ();
-          A = eor (A, RDMEM (ea));
-          break;
-        case 0xa9:
-          indexed ();
-          A = adc (A, RDMEM (ea));
-          break;
-        case 0xaa:
-          indexed ();
-          A = or (A, RDMEM (ea));
-          break;
-        case 0xab:
-          indexed ();
-          A = add (A, RDMEM (ea));
-          break;
-        case 0xac:
-          indexed ();
-          cmp16 (X, RDMEM16 (ea));
-          cpu_clk--;
-          break;
-        case 0xad:
-          indexed ();
-          cpu_clk -= 3;
-          jsr ();
-          break;
-        case 0xae:
-          indexed ();
-          X = ld16 (RDMEM16 (ea));
-          break;
-        case 0xaf:
-          indexed ();
-          st16 (X);
-          break;
+#define CORE_DEBUG 0
+#define CORE_NAME(name) name##_fast
+#include "mc6809core.h"
+#undef CORE_DEBUG
+#undef CORE_NAME
 
-        case 0xb0:
-          extended ();
-          cpu_clk -= 5;
-          A = sub (A, RDMEM (ea));
-          break;
-        case 0xb1:
-          extended ();
-          cpu_clk -= 5;
-          cmp (A, RDMEM (ea));
-          break;
-        case 0xb2:
-          extended ();
-          cpu_clk -= 5;
-          A = sbc (A, RDMEM (ea));
-          break;
-        case 0xb3:
-          extended ();
-          cpu_clk -= 5;
-          subd (RDMEM16 (ea));
-          cpu_clk--;
-          break;
-        case 0xb4:
-          extended ();
-          cpu_clk -= 5;
-          A = and (A, RDMEM (ea));
-          break;
-        case 0xb5:
-          extended ();
-          cpu_clk -= 5;
-          bit (A, RDMEM (ea));
-          break;
-        case 0xb6:
-          extended ();
-          cpu_clk -= 5;
-          A = ld (RDMEM (ea));
-          break;
-        case 0xb7:
-          extended ();
-          cpu_clk -= 5;
-          st (A);
-          break;
-        case 0xb8:
-          extended ();
-          cpu_clk -= 5;
-          A = eor (A, RDMEM (ea));
-          break;
-        case 0xb9:
-          extended ();
-          cpu_clk -= 5;
-          A = adc (A, RDMEM (ea));
-          break;
-        case 0xba:
-          extended ();
-          cpu_clk -= 5;
-          A = or (A, RDMEM (ea));
-          break;
-        case 0xbb:
-          extended ();
-          cpu_clk -= 5;
-          A = add (A, RDMEM (ea));
-          break;
-        case 0xbc:
-          extended ();
-          cpu_clk -= 5;
-          cmp16 (X, RDMEM16 (ea));
-          cpu_clk--;
-          break;
-        case 0xbd:
-          extended ();
-          cpu_clk -= 8;
-          jsr ();
-          break;
-        case 0xbe:
-          extended ();
-          cpu_clk -= 5;
-          X = ld16 (RDMEM16 (ea));
-          break;
-        case 0xbf:
-          extended ();
-          cpu_clk -= 5;
-          st16 (X);
-          break;
-
-        case 0xc0:
-          cpu_clk -= 2;
-          B = sub (B, imm_byte ());
-          break;
-        case 0xc1:
-          cpu_clk -= 2;
-          cmp (B, imm_byte ());
-          break;
-        case 0xc2:
-          cpu_clk -= 2;
-          B = sbc (B, imm_byte ());
-          break;
-        case 0xc3:
-          cpu_clk -= 4;
-          addd (imm_word ());
-          break;
-        case 0xc4:
-          cpu_clk -= 2;
-          B = and (B, imm_byte ());
-          break;
-        case 0xc5:
-          cpu_clk -= 2;
-          bit (B, imm_byte ());
-          break;
-        case 0xc6:
-          cpu_clk -= 2;
-          B = ld (imm_byte ());
-          break;
-        case 0xc8:
-          cpu_clk -= 2;
-          B = eor (B, imm_byte ());
-          break;
-        case 0xc9:
-          cpu_clk -= 2;
-          B = adc (B, imm_byte ());
-          break;
-        case 0xca:
-          cpu_clk -= 2;
-          B = or (B, imm_byte ());
-          break;
-        case 0xcb:
-          cpu_clk -= 2;
-          B = add (B, imm_byte ());
-          break;
-        case 0xcc:
-          cpu_clk -= 3;
-          ldd (imm_word ());
-          break;
-#ifdef H6309
-        case 0xcd:              /* LDQ immed */
-          break;
+/* Execute 6809 code for tubecycles cycles. */
+void mc6809nc_execute(void)
+{
+#ifdef INCLUDE_DEBUGGER
+  if (mc6809nc_debug_enabled)
+    {
+      mc6809nc_execute_debug ();
+      return;
+    }
 #endif
-        case 0xce:
-          cpu_clk -= 3;
-          U = ld16 (imm_word ());
-          break;
-
-        case 0xd0:
-          direct ();
-          cpu_clk -= 4;
-          B = sub (B, RDMEM (ea));
-          break;
-        case 0xd1:
-          direct ();
-          cpu_clk -= 4;
-          cmp (B, RDMEM (ea));
-          break;
-        case 0xd2:
-          direct ();
-          cpu_clk -= 4;
-          B = sbc (B, RDMEM (ea));
-          break;
-        case 0xd3:
-          direct ();
-          cpu_clk -= 4;
-          addd (RDMEM16 (ea));
-          cpu_clk--;
-          break;
-        case 0xd4:
-          direct ();
-          cpu_clk -= 4;
-          B = and (B, RDMEM (ea));
-          break;
-        case 0xd5:
-          direct ();
-          cpu_clk -= 4;
-          bit (B, RDMEM (ea));
-          break;
-        case 0xd6:
-          direct ();
-          cpu_clk -= 4;
-          B = ld (RDMEM (ea));
-          break;
-        case 0xd7:
-          direct ();
-          cpu_clk -= 4;
-          st (B);
-          break;
-        case 0xd8:
-          direct ();
-          cpu_clk -= 4;
-          B = eor (B, RDMEM (ea));
-          break;
-        case 0xd9:
-          direct ();
-          cpu_clk -= 4;
-          B = adc (B, RDMEM (ea));
-          break;
-        case 0xda:
-          direct ();
-          cpu_clk -= 4;
-          B = or (B, RDMEM (ea));
-          break;
-        case 0xdb:
-          direct ();
-          cpu_clk -= 4;
-          B = add (B, RDMEM (ea));
-          break;
-        case 0xdc:
-          direct ();
-          cpu_clk -= 4;
-          ldd (RDMEM16 (ea));
-          break;
-        case 0xdd:
-          direct ();
-          cpu_clk -= 4;
-          std ();
-          break;
-        case 0xde:
-          direct ();
-          cpu_clk -= 4;
-          U = ld16 (RDMEM16 (ea));
-          break;
-        case 0xdf:
-          direct ();
-          cpu_clk -= 4;
-          st16 (U);
-          break;
-
-        case 0xe0:
-          indexed ();
-          B = sub (B, RDMEM (ea));
-          break;
-        case 0xe1:
-          indexed ();
-          cmp (B, RDMEM (ea));
-          break;
-        case 0xe2:
-          indexed ();
-          B = sbc (B, RDMEM (ea));
-          break;
-        case 0xe3:
-          indexed ();
-          addd (RDMEM16 (ea));
-          cpu_clk--;
-          break;
-        case 0xe4:
-          indexed ();
-          B = and (B, RDMEM (ea));
-          break;
-        case 0xe5:
-          indexed ();
-          bit (B, RDMEM (ea));
-          break;
-        case 0xe6:
-          indexed ();
-          B = ld (RDMEM (ea));
-          break;
-        case 0xe7:
-          indexed ();
-          st (B);
-          break;
-        case 0xe8:
-          indexed ();
-          B = eor (B, RDMEM (ea));
-          break;
-        case 0xe9:
-          indexed ();
-          B = adc (B, RDMEM (ea));
-          break;
-        case 0xea:
-          indexed ();
-          B = or (B, RDMEM (ea));
-          break;
-        case 0xeb:
-          indexed ();
-          B = add (B, RDMEM (ea));
-          break;
-        case 0xec:
-          indexed ();
-          ldd (RDMEM16 (ea));
-          break;
-        case 0xed:
-          indexed ();
-          std ();
-          break;
-        case 0xee:
-          indexed ();
-          U = ld16 (RDMEM16 (ea));
-          break;
-        case 0xef:
-          indexed ();
-          st16 (U);
-          break;
-
-        case 0xf0:
-          extended ();
-          cpu_clk -= 5;
-          B = sub (B, RDMEM (ea));
-          break;
-        case 0xf1:
-          extended ();
-          cpu_clk -= 5;
-          cmp (B, RDMEM (ea));
-          break;
-        case 0xf2:
-          extended ();
-          cpu_clk -= 5;
-          B = sbc (B, RDMEM (ea));
-          break;
-        case 0xf3:
-          extended ();
-          cpu_clk -= 5;
-          addd (RDMEM16 (ea));
-          cpu_clk--;
-          break;
-        case 0xf4:
-          extended ();
-          cpu_clk -= 5;
-          B = and (B, RDMEM (ea));
-          break;
-        case 0xf5:
-          extended ();
-          cpu_clk -= 5;
-          bit (B, RDMEM (ea));
-          break;
-        case 0xf6:
-          extended ();
-          cpu_clk -= 5;
-          B = ld (RDMEM (ea));
-          break;
-        case 0xf7:
-          extended ();
-          cpu_clk -= 5;
-          st (B);
-          break;
-        case 0xf8:
-          extended ();
-          cpu_clk -= 5;
-          B = eor (B, RDMEM (ea));
-          break;
-        case 0xf9:
-          extended ();
-          cpu_clk -= 5;
-          B = adc (B, RDMEM (ea));
-          break;
-        case 0xfa:
-          extended ();
-          cpu_clk -= 5;
-          B = or (B, RDMEM (ea));
-          break;
-        case 0xfb:
-          extended ();
-          cpu_clk -= 5;
-          B = add (B, RDMEM (ea));
-          break;
-        case 0xfc:
-          extended ();
-          cpu_clk -= 5;
-          ldd (RDMEM16 (ea));
-          break;
-        case 0xfd:
-          extended ();
-          cpu_clk -= 5;
-          std ();
-          break;
-        case 0xfe:
-          extended ();
-          cpu_clk -= 5;
-          U = ld16 (RDMEM16 (ea));
-          break;
-        case 0xff:
-          extended ();
-          cpu_clk -= 5;
-          st16 (U);
-          break;
-
-        default:
-          cpu_clk -= 2;
-          log_warn ("mc6809nc: invalid opcode '%02X'", opcode);
-          PC = iPC;
-          break;
-        }
-
-        if (cc_changed)
-          cc_modified ();
-
-   tubeUseCycles(1);
-  } while (tubeContinueRunning());
-
-  cpu_period -= cpu_clk;
-  cpu_clk = cpu_period;
+  mc6809nc_execute_fast ();
 }
 
 void mc6809nc_reset (void)
@@ -330,15 +330,15 @@ void mem_loadzlib(ZFILE *zfp)
     unsigned char latches[2];
 
     savestate_zread(zfp, latches, 2);
-    writemem(0xFE30, latches[0]);
-    writemem(0xFE34, latches[1]);
+    m6502_set_paging(latches[0], latches[1]);
     savestate_zread(zfp, ram, RAM_SIZE);
     savestate_zread(zfp, rom, ROM_SIZE*ROM_NSLOT);
 }
 
 void mem_loadstate(FILE *f) {
-    writemem(0xFE30, getc(f));
-    writemem(0xFE34, getc(f));
+    int fe30 = getc(f);
+
+    m6502_set_paging(fe30, getc(f));
     fread(ram, RAM_SIZE, 1, f);
     fread(rom, ROM_SIZE*ROM_NSLOT, 1, f);
 }
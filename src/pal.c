@@ -207,126 +207,383 @@ void pal_convert(ALLEGRO_BITMAP *inb, int x1, int y1, int x2, int y2, int yoff)
 
 #ifdef PAL_FLOAT
 
-static inline int get_pixel(ALLEGRO_LOCKED_REGION *region, int x, int y)
+/*
+ * The filters run along each scanline and carry their state from one
+ * line into the next, and each line's chroma is averaged with the line
+ * above.  To share the work out the lines are split into bands, four
+ * per thread, which a thread runs side by side in the four lanes of a
+ * vector.  Each band starts two lines early on warm-up lines that are
+ * filtered but not drawn.  The filters forget their past within a few
+ * pixels, so by the end of the first the filter state, and across the
+ * second the line above, are in step with what the whole frame in order
+ * would have given, bar rounding.  Lines before the top of the frame
+ * are black, which leaves everything zero as a single pass would have
+ * started.
+ *
+ * This is not quite what the single pass gave.  Each frame now starts
+ * with its filters clear where the single pass carried them on from the
+ * last line of the frame before, which changed the first few pixels of
+ * the first line by up to ten levels.  Lines just after the start of a
+ * band, and so at the borders between bands, may differ by one level
+ * from rounding in the warm-up.  paltest.c checks all this against the
+ * single pass and times the two.
+ */
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+
+typedef __m128 pal_vec;
+
+#define pv_set1(a)       _mm_set1_ps(a)
+#define pv_set(a,b,c,d)  _mm_setr_ps(a, b, c, d)
+#define pv_add(a,b)      _mm_add_ps(a, b)
+#define pv_sub(a,b)      _mm_sub_ps(a, b)
+#define pv_mul(a,b)      _mm_mul_ps(a, b)
+#define pv_load(p)       _mm_loadu_ps(p)
+#define pv_store(p,a)    _mm_storeu_ps(p, a)
+
+static inline void pv_unpack(const uint32_t *px, pal_vec *r, pal_vec *g, pal_vec *b)
 {
-    return *((uint32_t *)((char *)region->data + region->pitch * y + x * region->pixel_size));
+    __m128i pix = _mm_loadu_si128((const __m128i *)px);
+    __m128i mask = _mm_set1_epi32(0xff);
+    *r = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pix, 16), mask));
+    *g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pix, 8), mask));
+    *b = _mm_cvtepi32_ps(_mm_and_si128(pix, mask));
 }
 
-static inline void put_pixel(ALLEGRO_LOCKED_REGION *region, int x, int y, uint32_t colour)
+static inline void pv_pack(pal_vec r, pal_vec g, pal_vec b, uint32_t *px)
 {
-    *((uint32_t *)((char *)region->data + region->pitch * y + x * region->pixel_size)) = colour;
+    __m128 lo = _mm_setzero_ps(), hi = _mm_set1_ps(255.0f);
+    __m128i ri = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(r, lo), hi));
+    __m128i gi = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(g, lo), hi));
+    __m128i bi = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(b, lo), hi));
+    __m128i pix = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(ri, 16), _mm_slli_epi32(gi, 8)), bi);
+    _mm_storeu_si128((__m128i *)px, _mm_or_si128(pix, _mm_set1_epi32(0xff000000)));
 }
 
-static float vision_iir(float NewSample) {
-    static float x; //input samples
+#else
 
-    x = (x + NewSample) * 0.5;
-//    x = NewSample;
+typedef struct { float f[4]; } pal_vec;
 
-    return x;
+static inline pal_vec pv_set(float a, float b, float c, float d)
+{
+    pal_vec v = { { a, b, c, d } };
+    return v;
 }
 
+static inline pal_vec pv_set1(float a)
+{
+    return pv_set(a, a, a, a);
+}
 
-#define NCoef 2
+#define PV_OP(name, op) \
+static inline pal_vec name(pal_vec a, pal_vec b) \
+{ \
+    for (int l = 0; l < 4; l++) \
+        a.f[l] = a.f[l] op b.f[l]; \
+    return a; \
+}
 
-static inline float chroma_iir(float NewSample) {
-    static float y[NCoef+1]; //output samples
-    static float x[NCoef+1]; //input samples
+PV_OP(pv_add, +)
+PV_OP(pv_sub, -)
+PV_OP(pv_mul, *)
 
-    x[2] = x[1];
-    x[1] = x[0];
-    x[0] = NewSample;
-    y[2] = y[1];
-    y[1] = y[0];
+static inline pal_vec pv_load(const float *p)
+{
+    return pv_set(p[0], p[1], p[2], p[3]);
+}
 
+static inline void pv_store(float *p, pal_vec a)
+{
+    memcpy(p, a.f, sizeof(a.f));
+}
 
-    //Calculate the new output
-    y[0]  = 0.754226 * x[0];
-    y[0] -= 0.184815 * y[1];
-    y[0] -= 0.754226 * x[2];
-    y[0] -= 0.332316 * y[2];
+static inline void pv_unpack(const uint32_t *px, pal_vec *r, pal_vec *g, pal_vec *b)
+{
+    for (int l = 0; l < 4; l++) {
+        r->f[l] = (float)((px[l] >> 16) & 0xff);
+        g->f[l] = (float)((px[l] >> 8) & 0xff);
+        b->f[l] = (float)(px[l] & 0xff);
+    }
+}
 
-    return y[0];
+static inline uint32_t pv_clamp(float f)
+{
+    if (f > 255) f = 255;
+    if (f < 0)   f = 0;
+    return (uint32_t)f;
 }
 
+static inline void pv_pack(pal_vec r, pal_vec g, pal_vec b, uint32_t *px)
+{
+    for (int l = 0; l < 4; l++)
+        px[l] = 0xff000000|(pv_clamp(r.f[l]) << 16)|(pv_clamp(g.f[l]) << 8)|pv_clamp(b.f[l]);
+}
+
+#endif
+
+#define PAL_WIDTH   1536
+#define PAL_PERIOD  832
+#define PAL_LANES   4
+#define PAL_WARMUP  2
+#define PAL_MAX_THREADS 4
+
 #define WT_INC ((4433618.75 / 16000000.0) * (2 * 3.14))
 
-static float sint[832*2], cost[832*2];
+/*A line starts anywhere in the first period and may run its full width.*/
+static float sint[PAL_PERIOD+PAL_WIDTH], cost[PAL_PERIOD+PAL_WIDTH];
+static int pal_wt;
+
+typedef struct {
+    const ALLEGRO_LOCKED_REGION *src;
+    ALLEGRO_LOCKED_REGION *dst;
+    int x1, x2, y1, yoff;
+    int rows, wt, bands;
+} pal_job_t;
+
+typedef struct {
+    float u[2][PAL_WIDTH * PAL_LANES];      /* this line and the last, by lane */
+    float v[2][PAL_WIDTH * PAL_LANES];
+    uint32_t scratch[PAL_WIDTH];            /* where lanes with no line left draw */
+    ALLEGRO_THREAD *thread;
+    int band;
+} pal_worker_t;
+
+static const uint32_t pal_black[PAL_WIDTH];
+static pal_worker_t *pal_workers[PAL_MAX_THREADS];
+static int pal_threads;
+
+static pal_job_t pal_job;
+static ALLEGRO_MUTEX *pal_mutex;
+static ALLEGRO_COND *pal_start_cond, *pal_done_cond;
+static unsigned pal_job_gen;
+static int pal_pending;
+static bool pal_stopping;
+
+static void pal_band(const pal_job_t *job, pal_worker_t *w)
+{
+    const uint32_t *sptr[PAL_LANES];
+    uint32_t *dptr[PAL_LANES];
+    int k0[PAL_LANES], k1[PAL_LANES], wt[PAL_LANES];
+    uint32_t px[PAL_LANES];
+    int steps = 0;
+
+    for (int l = 0; l < PAL_LANES; l++) {
+        int sub = w->band * PAL_LANES + l;
+        k0[l] = (int)((int64_t)job->rows * sub / (job->bands * PAL_LANES));
+        k1[l] = (int)((int64_t)job->rows * (sub + 1) / (job->bands * PAL_LANES));
+        if (k1[l] - k0[l] > steps)
+            steps = k1[l] - k0[l];
+    }
+
+    pal_vec vis = pv_set1(0), cx1 = vis, cx2 = vis, cy1 = vis, cy2 = vis;
+    pal_vec uf[4] = { vis, vis, vis, vis }, vf[4] = { vis, vis, vis, vis };
+    int cur = 0;
+
+    for (int s = 0; s < steps + PAL_WARMUP; s++) {
+        for (int l = 0; l < PAL_LANES; l++) {
+            int k = k0[l] - PAL_WARMUP + s;
+            if (k < 0 || k >= k1[l]) {
+                sptr[l] = pal_black;
+                wt[l] = 0;
+            } else {
+                int y = job->y1 + k * job->yoff;
+                sptr[l] = (const uint32_t *)((const char *)job->src->data + job->src->pitch * y);
+                wt[l] = k ? (job->wt + 192 * k) % PAL_PERIOD : job->wt;
+            }
+            if (k < k0[l] || k >= k1[l])
+                dptr[l] = w->scratch;
+            else
+                dptr[l] = (uint32_t *)((char *)job->dst->data + job->dst->pitch * (job->y1 + k * job->yoff));
+        }
+        float *uo = w->u[cur], *vo = w->v[cur];
+        const float *up = w->u[cur ^ 1], *vp = w->v[cur ^ 1];
+
+        for (int x = job->x1; x < job->x2; x++) {
+            int i = x - job->x1;
+            pal_vec r, g, b, Y, U, V, sn, cs, c0, signal;
+
+            for (int l = 0; l < PAL_LANES; l++)
+                px[l] = sptr[l][x];
+            pv_unpack(px, &r, &g, &b);
+
+            vis = pv_mul(pv_add(vis, pv_add(pv_add(pv_mul(pv_set1(0.299f), r), pv_mul(pv_set1(0.587f), g)), pv_mul(pv_set1(0.114f), b))), pv_set1(0.5f));
+            Y = vis;
+            U = pv_add(pv_sub(pv_mul(pv_set1(-0.147f), r), pv_mul(pv_set1(0.289f), g)), pv_mul(pv_set1(0.436f), b));
+            V = pv_sub(pv_sub(pv_mul(pv_set1(0.615f), r), pv_mul(pv_set1(0.515f), g)), pv_mul(pv_set1(0.100f), b));
+
+            sn = pv_set(sint[wt[0] + i], sint[wt[1] + i], sint[wt[2] + i], sint[wt[3] + i]);
+            cs = pv_set(cost[wt[0] + i], cost[wt[1] + i], cost[wt[2] + i], cost[wt[3] + i]);
+
+            // Chroma band-pass, as chroma_iir in the single line version.
+            c0 = pv_add(pv_mul(U, sn), pv_mul(V, cs));
+            pal_vec y0 = pv_mul(pv_set1(0.754226f), c0);
+            y0 = pv_sub(y0, pv_mul(pv_set1(0.184815f), cy1));
+            y0 = pv_sub(y0, pv_mul(pv_set1(0.754226f), cx2));
+            y0 = pv_sub(y0, pv_mul(pv_set1(0.332316f), cy2));
+            cx2 = cx1;
+            cx1 = c0;
+            cy2 = cy1;
+            cy1 = y0;
+            signal = pv_add(Y, y0);
+
+            uf[x & 3] = pv_mul(signal, sn);
+            vf[x & 3] = pv_mul(signal, cs);
+            U = pv_add(pv_add(pv_add(uf[0], uf[1]), uf[2]), uf[3]);
+            V = pv_add(pv_add(pv_add(vf[0], vf[1]), vf[2]), vf[3]);
+            pv_store(uo + x * PAL_LANES, U);
+            pv_store(vo + x * PAL_LANES, V);
+            if (s > 0) {
+                U = pv_add(U, pv_load(up + x * PAL_LANES));
+                V = pv_add(V, pv_load(vp + x * PAL_LANES));
+            }
+
+            r = pv_add(Y, pv_mul(pv_set1(1.140f/2.0f), V));
+            g = pv_sub(pv_sub(Y, pv_mul(pv_set1(0.396f/2.0f), U)), pv_mul(pv_set1(0.581f/8.0f), V));
+            b = pv_add(Y, pv_mul(pv_set1(2.029f/2.0f), U));
+            pv_pack(r, g, b, px);
+            for (int l = 0; l < PAL_LANES; l++)
+                dptr[l][x] = px[l];
+        }
+        cur ^= 1;
+    }
+}
+
+static void *pal_thread(ALLEGRO_THREAD *thread, void *data)
+{
+    pal_worker_t *w = data;
+    unsigned seen = 0;
+
+    for (;;) {
+        al_lock_mutex(pal_mutex);
+        while (pal_job_gen == seen && !pal_stopping)
+            al_wait_cond(pal_start_cond, pal_mutex);
+        seen = pal_job_gen;
+        al_unlock_mutex(pal_mutex);
+        if (pal_stopping)
+            break;
+        pal_band(&pal_job, w);
+        al_lock_mutex(pal_mutex);
+        if (!--pal_pending)
+            al_signal_cond(pal_done_cond);
+        al_unlock_mutex(pal_mutex);
+    }
+    return NULL;
+}
+
+static pal_worker_t *pal_new_worker(int band)
+{
+    pal_worker_t *w = malloc(sizeof(pal_worker_t));
+    if (w) {
+        w->thread = NULL;
+        w->band = band;
+    }
+    return w;
+}
+
+static void pal_start_threads(void)
+{
+    int want = al_get_cpu_count() - 2;
+
+    if (want > PAL_MAX_THREADS - 1)
+        want = PAL_MAX_THREADS - 1;
+    if (want <= 0)
+        return;
+    if (!(pal_mutex = al_create_mutex()) || !(pal_start_cond = al_create_cond()) || !(pal_done_cond = al_create_cond())) {
+        log_error("pal: unable to create thread resources, filtering on one thread");
+        return;
+    }
+    while (pal_threads < want) {
+        pal_worker_t *w = pal_new_worker(pal_threads + 1);
+        if (!w || !(w->thread = al_create_thread(pal_thread, w))) {
+            log_error("pal: unable to start filter thread");
+            free(w);
+            break;
+        }
+        pal_workers[++pal_threads] = w;
+        al_start_thread(w->thread);
+    }
+    log_debug("pal: filtering on %d threads", pal_threads + 1);
+}
 
 void pal_init(void)
 {
         int c;
         float wt = 0.0;
-        for (c = 0; c < 832*2; c++)
+        for (c = 0; c < PAL_PERIOD+PAL_WIDTH; c++)
         {
                 sint[c] = sin(wt);
                 cost[c] = cos(wt);
                 wt += WT_INC;
         }
+        if (!(pal_workers[0] = pal_new_worker(0))) {
+            log_fatal("pal: out of memory");
+            exit(1);
+        }
+        pal_start_threads();
 }
 
-void pal_convert(int x1, int y1, int x2, int y2, int yoff)
+void pal_close(void)
 {
-        int x, y;
-        uint32_t pixel;
-        float r, g, b, Y, U, V, signal;
-        static int wt;
-        float u_old[2][1536], v_old[2][1536];
-        float u_filt[4], v_filt[4];
-        float *uo[2], *vo[2];
-        ALLEGRO_LOCKED_REGION *dr;
-
-        for (x = x1; x < x2; x++)
-            u_old[0][x] = u_old[1][x] = v_old[0][x] = v_old[1][x] = 0.0;
-        for (x = 0; x < 4; x++)
-            u_filt[x] = v_filt[x] = 0.0;
-        dr = al_lock_bitmap(b32, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_WRITEONLY);
-        for (y = y1; y < y2; y += yoff)
-        {
-                uo[0] = u_old[y&1];
-                vo[0] = v_old[y&1];
-                uo[1] = u_old[(y&1)^1];
-                vo[1] = v_old[(y&1)^1];
-                for (x = x1; x < x2; x++)
-                {
-                        pixel = get_pixel(region, x, y);
-                        r = (float)((pixel >> 16) & 0xff);
-                        g = (float)((pixel >> 8) & 0xff);
-                        b = (float)(pixel & 0xff);
-                        Y = vision_iir(0.299 * r + 0.587 * g + 0.114 * b);
-                        U = -0.147 * r - 0.289 * g + 0.436 * b;
-                        V = 0.615 * r - 0.515 * g - 0.100 * b;
-
-                        signal = Y + chroma_iir(U * sint[wt] + V * cost[wt]);
-
-                        u_filt[x & 3] = signal * sint[wt];
-                        v_filt[x & 3] = signal * cost[wt];
-                        U = u_filt[0] + u_filt[1] + u_filt[2] + u_filt[3];
-                        V = v_filt[0] + v_filt[1] + v_filt[2] + v_filt[3];
-                        uo[0][x] = U;
-                        vo[0][x] = V;
-                        U += uo[1][x];
-                        V += vo[1][x];
-                        wt++;
-
-                        r = Y + (1.140/2.0) * V;
-                        g = Y - (0.396/2.0) * U - (0.581/8.0) * V;
-                        b = Y + (2.029/2.0) * U;
-
-                        if (r > 255) r = 255;
-                        if (r < 0)   r = 0;
-                        if (g > 255) g = 255;
-                        if (g < 0)   g = 0;
-                        if (b > 255) b = 255;
-                        if (b < 0)   b = 0;
-
-                        put_pixel(dr, x, y, 0xff000000|((uint32_t)r << 16)|((uint32_t)g << 8)|(uint32_t)b);
-                }
+    if (pal_threads) {
+        al_lock_mutex(pal_mutex);
+        pal_stopping = true;
+        al_broadcast_cond(pal_start_cond);
+        al_unlock_mutex(pal_mutex);
+        for (int c = 1; c <= pal_threads; c++) {
+            al_join_thread(pal_workers[c]->thread, NULL);
+            al_destroy_thread(pal_workers[c]->thread);
+            free(pal_workers[c]);
+            pal_workers[c] = NULL;
+        }
+        pal_threads = 0;
+    }
+    if (pal_done_cond)
+        al_destroy_cond(pal_done_cond);
+    if (pal_start_cond)
+        al_destroy_cond(pal_start_cond);
+    if (pal_mutex)
+        al_destroy_mutex(pal_mutex);
+    pal_done_cond = pal_start_cond = NULL;
+    pal_mutex = NULL;
+    free(pal_workers[0]);
+    pal_workers[0] = NULL;
+}
 
-                wt += (1024 - (x2 - x1));
-                wt %= 832;
+void pal_convert(ALLEGRO_LOCKED_REGION *src, int x1, int y1, int x2, int y2, int yoff)
+{
+        if (x2 > PAL_WIDTH)
+            x2 = PAL_WIDTH;
+        if (x1 >= x2 || y1 >= y2)
+            return;
+
+        pal_job.src = src;
+        pal_job.x1 = x1;
+        pal_job.x2 = x2;
+        pal_job.y1 = y1;
+        pal_job.yoff = yoff;
+        pal_job.rows = (y2 - y1 + yoff - 1) / yoff;
+        pal_job.wt = pal_wt;
+        pal_job.bands = pal_threads + 1;
+        pal_job.dst = al_lock_bitmap(b32, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_WRITEONLY);
+
+        if (pal_threads) {
+            al_lock_mutex(pal_mutex);
+            pal_pending = pal_threads;
+            pal_job_gen++;
+            al_broadcast_cond(pal_start_cond);
+            al_unlock_mutex(pal_mutex);
+        }
+        pal_band(&pal_job, pal_workers[0]);
+        if (pal_threads) {
+            al_lock_mutex(pal_mutex);
+            while (pal_pending)
+                al_wait_cond(pal_done_cond, pal_mutex);
+            al_unlock_mutex(pal_mutex);
         }
         al_unlock_bitmap(b32);
+
+        pal_wt = (int)((pal_wt + 192 * (int64_t)pal_job.rows) % PAL_PERIOD);
 }
 
 #endif
@@ -0,0 +1,290 @@
+/*
+ * Check and time the PAL filter.
+ *
+ * The filter in pal.c is checked against the original scalar version,
+ * kept below, one pixel at a time, on frames of coloured character cells
+ * like those the BBC draws.  Each channel of each pixel must be within
+ * one level of the reference.  The reference starts each frame with its
+ * filters clear as pal.c does; the original carried them on from the
+ * last line of the frame before.
+ *
+ * paltest                 run the check
+ * paltest -bench [n]      time n frames (default 200) of each filter
+ */
+
+#include <math.h>
+#include <stdarg.h>
+#include <time.h>
+#include "b-em.h"
+
+#include "pal.h"
+
+#define TEST_WIDTH  1536
+#define TEST_HEIGHT 800
+#define TEST_FRAMES 4
+
+ALLEGRO_BITMAP *b32;
+
+void log_fatal(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    putc('\n', stderr);
+}
+
+void log_error(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    putc('\n', stderr);
+}
+
+void log_warn(const char *fmt, ...) {}
+void log_info(const char *fmt, ...) {}
+#ifdef _DEBUG
+void log_debug(const char *fmt, ...) {}
+#endif
+
+/*The original filter, with its state pulled out so it can be cleared.*/
+
+#define WT_INC ((4433618.75 / 16000000.0) * (2 * 3.14))
+
+static float ref_sint[832*2], ref_cost[832*2];
+
+typedef struct {
+    float vis;
+    float cx[3], cy[3];
+    int wt;
+} ref_state_t;
+
+static void ref_init(void)
+{
+    float wt = 0.0;
+    for (int c = 0; c < 832*2; c++) {
+        ref_sint[c] = sin(wt);
+        ref_cost[c] = cos(wt);
+        wt += WT_INC;
+    }
+}
+
+static inline float ref_chroma_iir(ref_state_t *st, float NewSample)
+{
+    st->cx[2] = st->cx[1];
+    st->cx[1] = st->cx[0];
+    st->cx[0] = NewSample;
+    st->cy[2] = st->cy[1];
+    st->cy[1] = st->cy[0];
+
+    st->cy[0]  = 0.754226 * st->cx[0];
+    st->cy[0] -= 0.184815 * st->cy[1];
+    st->cy[0] -= 0.754226 * st->cx[2];
+    st->cy[0] -= 0.332316 * st->cy[2];
+
+    return st->cy[0];
+}
+
+static void ref_convert(ref_state_t *st, const ALLEGRO_LOCKED_REGION *src, uint32_t *dst, int x1, int y1, int x2, int y2, int yoff)
+{
+    static float u_old[2][TEST_WIDTH], v_old[2][TEST_WIDTH];
+    float u_filt[4], v_filt[4];
+    float *uo[2], *vo[2];
+
+    for (int x = x1; x < x2; x++)
+        u_old[0][x] = u_old[1][x] = v_old[0][x] = v_old[1][x] = 0.0;
+    for (int x = 0; x < 4; x++)
+        u_filt[x] = v_filt[x] = 0.0;
+    for (int y = y1; y < y2; y += yoff) {
+        const uint32_t *sp = (const uint32_t *)((const char *)src->data + src->pitch * y);
+        uo[0] = u_old[y&1];
+        vo[0] = v_old[y&1];
+        uo[1] = u_old[(y&1)^1];
+        vo[1] = v_old[(y&1)^1];
+        for (int x = x1; x < x2; x++) {
+            uint32_t pixel = sp[x];
+            float r = (float)((pixel >> 16) & 0xff);
+            float g = (float)((pixel >> 8) & 0xff);
+            float b = (float)(pixel & 0xff);
+            float Y, U, V, signal;
+
+            st->vis = (st->vis + (0.299 * r + 0.587 * g + 0.114 * b)) * 0.5;
+            Y = st->vis;
+            U = -0.147 * r - 0.289 * g + 0.436 * b;
+            V = 0.615 * r - 0.515 * g - 0.100 * b;
+
+            signal = Y + ref_chroma_iir(st, U * ref_sint[st->wt] + V * ref_cost[st->wt]);
+
+            u_filt[x & 3] = signal * ref_sint[st->wt];
+            v_filt[x & 3] = signal * ref_cost[st->wt];
+            U = u_filt[0] + u_filt[1] + u_filt[2] + u_filt[3];
+            V = v_filt[0] + v_filt[1] + v_filt[2] + v_filt[3];
+            uo[0][x] = U;
+            vo[0][x] = V;
+            U += uo[1][x];
+            V += vo[1][x];
+            st->wt++;
+
+            r = Y + (1.140/2.0) * V;
+            g = Y - (0.396/2.0) * U - (0.581/8.0) * V;
+            b = Y + (2.029/2.0) * U;
+
+            if (r > 255) r = 255;
+            if (r < 0)   r = 0;
+            if (g > 255) g = 255;
+            if (g < 0)   g = 0;
+            if (b > 255) b = 255;
+            if (b < 0)   b = 0;
+
+            dst[y * TEST_WIDTH + x] = 0xff000000|((uint32_t)r << 16)|((uint32_t)g << 8)|(uint32_t)b;
+        }
+        st->wt += (1024 - (x2 - x1));
+        st->wt %= 832;
+    }
+}
+
+static uint32_t rand_state;
+
+static uint32_t test_rand(void)
+{
+    rand_state = rand_state * 1103515245 + 12345;
+    return rand_state >> 8;
+}
+
+/*A black border round cells of the eight BBC colours, or of any colour
+  as NuLA might give.*/
+static void make_frame(uint32_t *pixels, bool any_colour, int *x1, int *y1, int *x2, int *y2)
+{
+    static const uint32_t cols[8] = {
+        0xff000000, 0xffff0000, 0xff00ff00, 0xffffff00,
+        0xff0000ff, 0xffff00ff, 0xff00ffff, 0xffffffff
+    };
+
+    for (int c = 0; c < TEST_WIDTH * TEST_HEIGHT; c++)
+        pixels[c] = 0xff000000;
+    for (int y = 40; y < 600; y++) {
+        for (int x = 300; x < 1000; x += 8) {
+            uint32_t col = cols[test_rand() & 7];
+            if (any_colour && (test_rand() & 1))
+                col = 0xff000000 | (test_rand() & 0xffffff);
+            for (int k = 0; k < 8; k++)
+                pixels[y * TEST_WIDTH + x + k] = col;
+        }
+    }
+    *x1 = 240 + (test_rand() % 5) * 16;
+    *x2 = 1072 - (test_rand() % 5) * 16;
+    *y1 = test_rand() % 40;
+    *y2 = 560 + test_rand() % 40;
+}
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static int run_check(uint32_t *src_pixels, uint32_t *ref_pixels, ALLEGRO_LOCKED_REGION *src)
+{
+    ref_state_t st;
+    int failures = 0;
+
+    // The phase runs on from frame to frame in both filters.
+    memset(&st, 0, sizeof(st));
+    for (int seed = 1; seed <= 8; seed++) {
+        int worst = 0;
+
+        rand_state = seed;
+        for (int frame = 0; frame < TEST_FRAMES; frame++) {
+            int x1, y1, x2, y2;
+            make_frame(src_pixels, seed & 1, &x1, &y1, &x2, &y2);
+
+            st.vis = 0;
+            memset(st.cx, 0, sizeof(st.cx));
+            memset(st.cy, 0, sizeof(st.cy));
+            ref_convert(&st, src, ref_pixels, x1, y1, x2, y2, 1);
+            pal_convert(src, x1, y1, x2, y2, 1);
+
+            ALLEGRO_LOCKED_REGION *dr = al_lock_bitmap(b32, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READONLY);
+            for (int y = y1; y < y2; y++) {
+                const uint32_t *got = (const uint32_t *)((const char *)dr->data + dr->pitch * y);
+                const uint32_t *want = ref_pixels + y * TEST_WIDTH;
+                for (int x = x1; x < x2; x++) {
+                    for (int s = 0; s < 24; s += 8) {
+                        int d = abs((int)((got[x] >> s) & 0xff) - (int)((want[x] >> s) & 0xff));
+                        if (d > worst)
+                            worst = d;
+                        if (d > 1 && failures++ < 10)
+                            fprintf(stderr, "paltest: seed %d frame %d at %d,%d got %08X want %08X\n", seed, frame, x, y, got[x], want[x]);
+                    }
+                }
+            }
+            al_unlock_bitmap(b32);
+        }
+        printf("paltest: seed %d largest difference %d\n", seed, worst);
+    }
+    return failures;
+}
+
+static void run_bench(uint32_t *src_pixels, uint32_t *ref_pixels, ALLEGRO_LOCKED_REGION *src, int frames)
+{
+    ref_state_t st;
+    int x1, y1, x2, y2;
+    double start, ref_ms, pal_ms;
+
+    memset(&st, 0, sizeof(st));
+    rand_state = 1;
+    make_frame(src_pixels, false, &x1, &y1, &x2, &y2);
+
+    start = now_ms();
+    for (int frame = 0; frame < frames; frame++)
+        ref_convert(&st, src, ref_pixels, x1, y1, x2, y2, 1);
+    ref_ms = (now_ms() - start) / frames;
+
+    start = now_ms();
+    for (int frame = 0; frame < frames; frame++)
+        pal_convert(src, x1, y1, x2, y2, 1);
+    pal_ms = (now_ms() - start) / frames;
+
+    printf("paltest: %dx%d, %d frames: scalar %.2f ms/frame, pal.c %.2f ms/frame (%d CPUs)\n",
+           x2 - x1, y2 - y1, frames, ref_ms, pal_ms, al_get_cpu_count());
+}
+
+int main(int argc, char **argv)
+{
+    ALLEGRO_LOCKED_REGION src;
+    uint32_t *src_pixels, *ref_pixels;
+    int failures = 0;
+
+    if (!al_init()) {
+        fputs("paltest: unable to initialise Allegro\n", stderr);
+        return 1;
+    }
+    al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+    b32 = al_create_bitmap(TEST_WIDTH, TEST_HEIGHT);
+    src_pixels = malloc(TEST_WIDTH * TEST_HEIGHT * sizeof(uint32_t));
+    ref_pixels = calloc(TEST_WIDTH * TEST_HEIGHT, sizeof(uint32_t));
+    if (!b32 || !src_pixels || !ref_pixels) {
+        fputs("paltest: out of memory\n", stderr);
+        return 1;
+    }
+    src.data = src_pixels;
+    src.format = ALLEGRO_PIXEL_FORMAT_ARGB_8888;
+    src.pitch = TEST_WIDTH * sizeof(uint32_t);
+    src.pixel_size = sizeof(uint32_t);
+
+    ref_init();
+    pal_init();
+    if (argc > 1 && !strcmp(argv[1], "-bench"))
+        run_bench(src_pixels, ref_pixels, &src, argc > 2 ? atoi(argv[2]) : 200);
+    else if ((failures = run_check(src_pixels, ref_pixels, &src)))
+        fprintf(stderr, "paltest: %d channel values differ by more than one level\n", failures);
+    pal_close();
+
+    al_destroy_bitmap(b32);
+    free(src_pixels);
+    free(ref_pixels);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,313 @@
+/*B-em v2.2 by Tom Walker
+  Host 6502 cycle profiler.
+
+  While active, the debug variant of the host core calls profiler_exec
+  before each instruction is fetched and the cycles used since the
+  previous call are charged to the previous instruction's address, to
+  its opcode and to the call stack it ran in.  Addresses in the sideways
+  ROM area carry the bank number in the top bits as for the debugger so
+  both they and symbols from the debugger's symbol table are kept apart
+  per ROM.
+
+  The call stack is followed from the stack pointer: a JSR, BRK or
+  interrupt opens a frame and the frame closes again once S rises above
+  the level it had on entry.  This also copes with code that discards
+  its return address or resets the stack.*/
+
+#include "b-em.h"
+#include <inttypes.h>
+
+#include "6502.h"
+#include "model.h"
+#include "profiler.h"
+#include "scheduler.h"
+#include "debugger_symbols.h"
+
+#define PROF_BANKED 0x10000
+#define PROF_SLOTS  (PROF_BANKED + 16 * 0x4000)
+#define PROF_DEPTH  256
+#define PROF_TOP    200
+
+typedef struct {
+    uint32_t addr;
+    uint32_t parent;
+    uint32_t child;
+    uint32_t sibling;
+    uint64_t cycles;
+} prof_node_t;
+
+bool profiler_active = false;
+
+static uint64_t *pc_cycles;
+static uint64_t op_count[256];
+static uint64_t op_cycles[256];
+
+static prof_node_t *nodes;
+static uint32_t num_nodes, max_nodes;
+
+static uint32_t frame_node[PROF_DEPTH];
+static uint8_t  frame_sp[PROF_DEPTH];
+static int      depth;
+
+static bool     have_last;
+static uint32_t last_addr;
+static int64_t  last_clock;
+static bool     irq_taken;
+
+static inline uint32_t prof_slot(uint32_t addr)
+{
+    uint32_t addr16 = addr & 0xffff;
+
+    if (addr16 >= 0x8000 && addr16 < 0xc000)
+        return PROF_BANKED + ((addr >> 28) << 14) + (addr16 & 0x3fff);
+    return addr16;
+}
+
+static uint32_t prof_slot_addr(uint32_t slot)
+{
+    if (slot >= PROF_BANKED) {
+        slot -= PROF_BANKED;
+        return ((slot >> 14) << 28) | 0x8000 | (slot & 0x3fff);
+    }
+    return slot;
+}
+
+static uint32_t prof_child(uint32_t parent, uint32_t addr)
+{
+    uint32_t n;
+
+    for (n = nodes[parent].child; n; n = nodes[n].sibling)
+        if (nodes[n].addr == addr)
+            return n;
+    if (num_nodes == max_nodes) {
+        prof_node_t *new_nodes = realloc(nodes, max_nodes * 2 * sizeof(prof_node_t));
+        if (!new_nodes)
+            return parent;
+        nodes = new_nodes;
+        max_nodes *= 2;
+    }
+    n = num_nodes++;
+    nodes[n].addr = addr;
+    nodes[n].parent = parent;
+    nodes[n].child = 0;
+    nodes[n].sibling = nodes[parent].child;
+    nodes[n].cycles = 0;
+    nodes[parent].child = n;
+    return n;
+}
+
+void profiler_clear(void)
+{
+    if (pc_cycles)
+        memset(pc_cycles, 0, PROF_SLOTS * sizeof(uint64_t));
+    memset(op_count, 0, sizeof op_count);
+    memset(op_cycles, 0, sizeof op_cycles);
+    if (nodes) {
+        memset(&nodes[0], 0, sizeof(prof_node_t));
+        num_nodes = 1;
+    }
+    depth = 0;
+    have_last = false;
+}
+
+void profiler_start(void)
+{
+    if (!pc_cycles && !(pc_cycles = calloc(PROF_SLOTS, sizeof(uint64_t)))) {
+        log_error("profiler: out of memory");
+        return;
+    }
+    if (!nodes) {
+        if (!(nodes = malloc(4096 * sizeof(prof_node_t)))) {
+            log_error("profiler: out of memory");
+            return;
+        }
+        max_nodes = 4096;
+        memset(&nodes[0], 0, sizeof(prof_node_t));
+        num_nodes = 1;
+    }
+    have_last = false;
+    irq_taken = false;
+    profiler_active = true;
+}
+
+void profiler_stop(void)
+{
+    profiler_active = false;
+}
+
+void profiler_close(void)
+{
+    profiler_active = false;
+    if (pc_cycles) {
+        free(pc_cycles);
+        pc_cycles = NULL;
+    }
+    if (nodes) {
+        free(nodes);
+        nodes = NULL;
+    }
+}
+
+void profiler_interrupt(void)
+{
+    irq_taken = true;
+}
+
+void profiler_exec(uint32_t addr, uint8_t lastop, uint8_t sp)
+{
+    int64_t used;
+    int entry;
+
+    if (have_last) {
+        used = sched_clock - last_clock;
+        pc_cycles[prof_slot(last_addr)] += used;
+        op_count[lastop]++;
+        op_cycles[lastop] += used;
+        nodes[depth ? frame_node[depth-1] : 0].cycles += used;
+
+        /* Bytes pushed on the way into a new frame, if any. */
+        if (irq_taken)
+            entry = 3;
+        else if (lastop == 0x20)
+            entry = 2;
+        else if (lastop == 0x00)
+            entry = 3;
+        else
+            entry = 0;
+        while (depth && sp + entry > frame_sp[depth-1])
+            depth--;
+        if (entry && depth < PROF_DEPTH) {
+            frame_node[depth] = prof_child(depth ? frame_node[depth-1] : 0, addr);
+            frame_sp[depth++] = sp;
+        }
+    }
+    irq_taken = false;
+    have_last = true;
+    last_addr = addr;
+    last_clock = sched_clock;
+}
+
+static size_t prof_name(uint32_t addr, char *buf, size_t bufsize, bool offset)
+{
+    cpu_debug_t *cpu = &core6502_cpu_debug;
+    const char *sym;
+    uint32_t found, min;
+    size_t len;
+
+    if (!offset && symbol_find_by_addr(cpu->symbols, addr, &sym))
+        return snprintf(buf, bufsize, "%s", sym);
+    len = cpu->print_addr(cpu, addr, buf, bufsize, false);
+    if (offset && len < bufsize) {
+        min = (addr & 0xffff) >= 0x1000 ? addr - 0x1000 : addr & 0xf0000000;
+        if (symbol_find_by_addr_near(cpu->symbols, addr, min, addr, &found, &sym)) {
+            if (found == addr)
+                len += snprintf(buf + len, bufsize - len, " %s", sym);
+            else
+                len += snprintf(buf + len, bufsize - len, " %s+%u", sym, addr - found);
+        }
+    }
+    return len;
+}
+
+static int prof_cmp(const void *a, const void *b)
+{
+    uint64_t ca = pc_cycles[*(const uint32_t *)a];
+    uint64_t cb = pc_cycles[*(const uint32_t *)b];
+
+    return ca < cb ? 1 : ca > cb ? -1 : 0;
+}
+
+bool profiler_report(const char *fn)
+{
+    FILE *fp;
+    uint64_t total = 0, insns = 0, banks[16], other = 0;
+    uint32_t *top, slot, ntop = 0;
+    m6502_t model = x65c02 ? M65C02 : M6502;
+    char name[SYM_MAX + 32];
+    int c;
+
+    if (!pc_cycles)
+        return false;
+    if (!(fp = fopen(fn, "w")))
+        return false;
+    if (!(top = malloc(PROF_SLOTS * sizeof(uint32_t)))) {
+        fclose(fp);
+        return false;
+    }
+    for (c = 0; c < 256; c++) {
+        total += op_cycles[c];
+        insns += op_count[c];
+    }
+    if (!total)
+        total = 1;
+    memset(banks, 0, sizeof banks);
+    for (slot = 0; slot < PROF_SLOTS; slot++) {
+        if (pc_cycles[slot]) {
+            if (slot >= PROF_BANKED)
+                banks[(slot - PROF_BANKED) >> 14] += pc_cycles[slot];
+            else
+                other += pc_cycles[slot];
+            top[ntop++] = slot;
+        }
+    }
+
+    fprintf(fp, "Host 6502 profile: %"PRIu64" cycles, %"PRIu64" instructions\n\n", total, insns);
+    fputs("Cycles by ROM bank:\n", fp);
+    for (c = 0; c < 16; c++)
+        if (banks[c])
+            fprintf(fp, "  ROM %X  %14"PRIu64" %6.2f%%\n", c, banks[c], banks[c] * 100.0 / total);
+    if (other)
+        fprintf(fp, "  other  %14"PRIu64" %6.2f%%\n", other, other * 100.0 / total);
+
+    qsort(top, ntop, sizeof(uint32_t), prof_cmp);
+    fprintf(fp, "\nTop %d addresses by cycles:\n", PROF_TOP);
+    for (slot = 0; slot < ntop && slot < PROF_TOP; slot++) {
+        prof_name(prof_slot_addr(top[slot]), name, sizeof name, true);
+        fprintf(fp, "  %14"PRIu64" %6.2f%%  %s\n", pc_cycles[top[slot]], pc_cycles[top[slot]] * 100.0 / total, name);
+    }
+
+    fputs("\nOpcodes:\n  op  name          count         cycles      %\n", fp);
+    for (c = 0; c < 256; c++)
+        if (op_count[c])
+            fprintf(fp, "  %02X  %s %14"PRIu64" %14"PRIu64" %6.2f%%\n", c, dbg6502_op_name(c, model), op_count[c], op_cycles[c], op_cycles[c] * 100.0 / total);
+
+    free(top);
+    fclose(fp);
+    return true;
+}
+
+static void prof_path(FILE *fp, uint32_t n)
+{
+    char name[SYM_MAX + 32];
+
+    if (n) {
+        prof_path(fp, nodes[n].parent);
+        prof_name(nodes[n].addr, name, sizeof name, false);
+        putc(';', fp);
+        fputs(name, fp);
+    }
+    else
+        fputs("6502", fp);
+}
+
+/*Collapsed stacks, one line per call path with the cycles spent in
+  the innermost frame, as read by flamegraph.pl and similar tools.*/
+
+bool profiler_stacks(const char *fn)
+{
+    FILE *fp;
+    uint32_t n;
+
+    if (!nodes)
+        return false;
+    if (!(fp = fopen(fn, "w")))
+        return false;
+    for (n = 0; n < num_nodes; n++) {
+        if (nodes[n].cycles) {
+            prof_path(fp, n);
+            fprintf(fp, " %"PRIu64"\n", nodes[n].cycles);
+        }
+    }
+    fclose(fp);
+    return true;
+}
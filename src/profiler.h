@@ -0,0 +1,18 @@
+#ifndef __INC_PROFILER_H
+#define __INC_PROFILER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+extern bool profiler_active;
+
+void profiler_start(void);
+void profiler_stop(void);
+void profiler_clear(void);
+void profiler_close(void);
+void profiler_interrupt(void);
+void profiler_exec(uint32_t addr, uint8_t lastop, uint8_t sp);
+bool profiler_report(const char *fn);
+bool profiler_stacks(const char *fn);
+
+#endif
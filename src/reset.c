@@ -0,0 +1,65 @@
+/*B-em v2.2 by Tom Walker
+  Resetting and restarting the emulated machine, shared by the GUI and
+  headless builds.*/
+
+#include "b-em.h"
+
+#include "6502.h"
+#include "model.h"
+#include "cmos.h"
+#include "i8271.h"
+#include "main.h"
+#include "music4000.h"
+#include "music5000.h"
+#include "paula.h"
+#include "scsi.h"
+#include "serial.h"
+#include "sid_b-em.h"
+#include "sn76489.h"
+#include "sysacia.h"
+#include "tube.h"
+#include "via.h"
+#include "sysvia.h"
+#include "uservia.h"
+#include "vdfs.h"
+#include "video.h"
+#include "wd1770.h"
+
+void main_reset(void)
+{
+    m6502_reset();
+    crtc_reset();
+    video_reset();
+    sysvia_reset();
+    uservia_reset();
+    serial_reset();
+    acia_reset(&sysacia);
+    wd1770_reset();
+    i8271_reset();
+    scsi_reset();
+    vdfs_reset();
+    sid_reset();
+    music4000_reset();
+    music5000_reset();
+    paula_reset();
+    sn_init();
+    if (curtube != -1) tubes[curtube].reset();
+    else               tube_exec = NULL;
+    tube_reset();
+}
+
+/*The headless build has no timer to pause and leaves the CMOS files as
+  they were.*/
+
+void main_restart(void)
+{
+#ifndef HEADLESS
+    main_pause();
+    cmos_save(&models[oldmodel]);
+#endif
+    model_init();
+    main_reset();
+#ifndef HEADLESS
+    main_resume();
+#endif
+}
@@ -1,6 +1,7 @@
 /*B-em v2.2 by Tom Walker
   Savestate handling*/
 #include "b-em.h"
+#include <limits.h>
 #include <zlib.h>
 
 #include "6502.h"
@@ -11,6 +12,7 @@
 #include "music5000.h"
 #include "paula.h"
 #include "savestate.h"
+#include "scheduler.h"
 #include "serial.h"
 #include "sn76489.h"
 #include "sysacia.h"
@@ -25,13 +27,19 @@ struct _sszfile {
     z_stream zs;
     size_t togo;
     int flush;
+    bool raw;
     unsigned char buf[BUFSIZ];
 };
 
-int savestate_wantsave, savestate_wantload;
+int savestate_wantsave, savestate_wantload, savestate_wantrewind;
+int savestate_rewind_frames;
 char *savestate_name;
 FILE *savestate_fp;
 
+/* In-memory snapshots are not compressed so the zlib sections are
+ * written and read directly. */
+static bool savestate_raw;
+
 void savestate_save(const char *name)
 {
     size_t name_len;
@@ -143,6 +151,12 @@ static void save_zlib(int key, void (*save_func)(ZFILE *zpf))
     start = ftell(savestate_fp);
     fseek(savestate_fp, 3, SEEK_CUR);
 
+    if ((zfile.raw = savestate_raw)) {
+        save_func(&zfile);
+        end = ftell(savestate_fp);
+        save_tail(start, end, end - start - 3);
+        return;
+    }
     zfile.zs.zalloc = Z_NULL;
     zfile.zs.zfree = Z_NULL;
     zfile.zs.opaque = Z_NULL;
@@ -173,6 +187,10 @@ void savestate_zwrite(ZFILE *zfp, void *src, size_t size)
 {
     int res;
 
+    if (zfp->raw) {
+        fwrite(src, size, 1, savestate_fp);
+        return;
+    }
     zfp->zs.next_in = src;
     zfp->zs.avail_in = size;
     while ((res = deflate(&zfp->zs, Z_NO_FLUSH) == Z_OK)) {
@@ -187,10 +205,8 @@ void savestate_zwrite(ZFILE *zfp, void *src, size_t size)
     log_warn("savestate: compression error %d (%s)", res, zfp->zs.msg);
 }
 
-void savestate_dosave(void)
+static void save_sections(void)
 {
-    fwrite("BEMSNAP2", 8, 1, savestate_fp);
-    save_sect('m', model_savestate);
     save_sect('6', m6502_savestate);
     save_zlib('M', mem_savezlib);
     save_sect('S', sysvia_savestate);
@@ -209,6 +225,14 @@ void savestate_dosave(void)
         save_sect('T', tube_ula_savestate);
         save_zlib('P', tube_proc_savestate);
     }
+    save_sect('E', sched_savestate);
+}
+
+void savestate_dosave(void)
+{
+    fwrite("BEMSNAP2", 8, 1, savestate_fp);
+    save_sect('m', model_savestate);
+    save_sections();
     fclose(savestate_fp);
     savestate_wantsave = 0;
     savestate_fp = NULL;
@@ -241,6 +265,10 @@ static void load_zlib(long size, void (*load_func)(ZFILE *zpf))
 {
     ZFILE zfile;
 
+    if ((zfile.raw = savestate_raw)) {
+        load_func(&zfile);
+        return;
+    }
     zfile.zs.zalloc = Z_NULL;
     zfile.zs.zfree = Z_NULL;
     zfile.zs.opaque = Z_NULL;
@@ -258,6 +286,10 @@ void savestate_zread(ZFILE *zfp, void *dest, size_t size)
     int res;
     size_t chunk;
 
+    if (zfp->raw) {
+        fread(dest, size, 1, savestate_fp);
+        return;
+    }
     zfp->zs.next_out = dest;
     zfp->zs.avail_out = size;
     do {
@@ -280,14 +312,24 @@ void savestate_zread(ZFILE *zfp, void *dest, size_t size)
     } while (res == Z_OK && zfp->zs.avail_out > 0);
 }
 
-static void load_state_two(void)
+/*End of the section being loaded so loaders can tell whether state
+  added to a section since it was first defined is present.*/
+static long sect_end;
+
+bool savestate_sect_more(FILE *f)
+{
+    return ftell(f) < sect_end;
+}
+
+static void load_sections(long limit)
 {
     unsigned char hdr[4];
     long start, end, size;
 
-    while (fread(hdr, sizeof hdr, 1, savestate_fp) == 1) {
+    while (ftell(savestate_fp) < limit && fread(hdr, sizeof hdr, 1, savestate_fp) == 1) {
         size = hdr[1] | (hdr[2] << 8) | (hdr[3] << 16);
         start = ftell(savestate_fp);
+        sect_end = start + size;
         log_debug("savestate: found section %c of %ld bytes", hdr[0], size);
 
         switch(hdr[0]) {
@@ -343,6 +385,9 @@ static void load_state_two(void)
                 break;
             case 'p':
                 paula_loadstate(savestate_fp);
+                break;
+            case 'E':
+                sched_loadstate(savestate_fp);
         }
         end = ftell(savestate_fp);
         if (end == start) {
@@ -354,6 +399,12 @@ static void load_state_two(void)
             fseek(savestate_fp, start + size, SEEK_SET);
         }
     }
+    sect_end = 0;
+}
+
+static void load_state_two(void)
+{
+    load_sections(LONG_MAX);
     log_debug("savestate: loaded V2 snapshot file");
 }
 
@@ -374,6 +425,404 @@ void savestate_doload(void)
     savestate_fp = NULL;
 }
 
+/*In-memory snapshots.  These hold the same sections as a file but
+  without the model section or compression, so they can be taken every
+  frame, and are only ever restored into the same model and tube.  The
+  snapshot buffer is kept and reused by the next snapshot taken into
+  it.*/
+
+#define SNAP_HDR 2
+#define SNAP_MIN (512 * 1024)
+
+static bool snap_grow(savestate_snap_t *snap, size_t size)
+{
+    unsigned char *data;
+
+    if (size <= snap->alloc)
+        return true;
+    if (!(data = realloc(snap->data, size))) {
+        log_error("savestate: out of memory for snapshot");
+        return false;
+    }
+    snap->data = data;
+    snap->alloc = size;
+    return true;
+}
+
+#ifdef HAVE_FMEMOPEN
+
+static bool snap_write(savestate_snap_t *snap)
+{
+    long size;
+
+    if (!snap_grow(snap, SNAP_MIN))
+        return false;
+    for (;;) {
+        if (!(savestate_fp = fmemopen(snap->data, snap->alloc, "w+b"))) {
+            log_error("savestate: unable to open snapshot stream: %s", strerror(errno));
+            return false;
+        }
+        putc(curmodel, savestate_fp);
+        putc(curtube, savestate_fp);
+        save_sections();
+        fflush(savestate_fp);
+        size = ftell(savestate_fp);
+        if (!ferror(savestate_fp) && size < snap->alloc) {
+            fclose(savestate_fp);
+            snap->size = size;
+            return true;
+        }
+        /* Out of room: try again with a bigger buffer. */
+        fclose(savestate_fp);
+        if (!snap_grow(snap, snap->alloc * 2))
+            return false;
+    }
+}
+
+static bool snap_read(const savestate_snap_t *snap)
+{
+    if (!(savestate_fp = fmemopen(snap->data, snap->size, "rb"))) {
+        log_error("savestate: unable to open snapshot stream: %s", strerror(errno));
+        return false;
+    }
+    fseek(savestate_fp, SNAP_HDR, SEEK_SET);
+    load_sections(snap->size);
+    fclose(savestate_fp);
+    return true;
+}
+
+#else
+
+/* Without memory streams the sections go via a temporary file which,
+ * being small and rewritten constantly, should stay in the OS cache. */
+
+static FILE *snap_fp;
+
+static bool snap_open(void)
+{
+    if (!snap_fp && !(snap_fp = tmpfile())) {
+        log_error("savestate: unable to create snapshot file: %s", strerror(errno));
+        return false;
+    }
+    savestate_fp = snap_fp;
+    fseek(savestate_fp, 0, SEEK_SET);
+    return true;
+}
+
+static bool snap_write(savestate_snap_t *snap)
+{
+    long size;
+
+    if (!snap_open())
+        return false;
+    putc(curmodel, savestate_fp);
+    putc(curtube, savestate_fp);
+    save_sections();
+    size = ftell(savestate_fp);
+    if (!snap_grow(snap, size < SNAP_MIN ? SNAP_MIN : size))
+        return false;
+    fseek(savestate_fp, 0, SEEK_SET);
+    if (fread(snap->data, size, 1, savestate_fp) != 1) {
+        log_error("savestate: unable to read back snapshot: %s", strerror(errno));
+        return false;
+    }
+    snap->size = size;
+    return true;
+}
+
+static bool snap_read(const savestate_snap_t *snap)
+{
+    if (!snap_open())
+        return false;
+    fwrite(snap->data, snap->size, 1, savestate_fp);
+    fseek(savestate_fp, SNAP_HDR, SEEK_SET);
+    load_sections(snap->size);
+    return true;
+}
+
+#endif
+
+bool savestate_snapshot(savestate_snap_t *snap)
+{
+    bool ok;
+
+    if (savestate_fp)
+        return false;
+    if (curtube != -1 && !tube_proc_savestate)
+        return false;
+    savestate_raw = true;
+    ok = snap_write(snap);
+    savestate_raw = false;
+    savestate_fp = NULL;
+    return ok;
+}
+
+bool savestate_restore(const savestate_snap_t *snap)
+{
+    bool ok;
+
+    if (savestate_fp)
+        return false;
+    if (snap->size < SNAP_HDR || snap->data[0] != (unsigned char)curmodel || snap->data[1] != (unsigned char)curtube) {
+        log_error("savestate: snapshot is for a different model or tube");
+        return false;
+    }
+    savestate_raw = true;
+    ok = snap_read(snap);
+    savestate_raw = false;
+    savestate_fp = NULL;
+    return ok;
+}
+
+void savestate_snap_free(savestate_snap_t *snap)
+{
+    if (snap->data)
+        free(snap->data);
+    snap->data = NULL;
+    snap->size = snap->alloc = 0;
+}
+
+/*Rewind.  Once a frame the state is snapshotted and the difference
+  from the previous snapshot is kept in a ring, XORed and with the runs
+  of zero words squeezed out, as most of memory does not change from
+  one frame to the next.  Only the newest snapshot is kept whole and
+  stepping back applies deltas to it in turn.
+
+  A delta is a sequence of: count of zero words, count of literal
+  words, then the literal words, with the counts stored seven bits to
+  a byte, low first, with the top bit set on the last byte.*/
+
+typedef struct {
+    unsigned char *data;
+    size_t len, alloc;
+    size_t size;        /* size of the older snapshot */
+} rewind_delta_t;
+
+static rewind_delta_t *rewind_ring;
+static int rewind_slots, rewind_head, rewind_count;
+static savestate_snap_t rewind_cur, rewind_new;
+static unsigned char *rewind_work;
+static size_t rewind_work_alloc;
+
+static inline size_t rewind_words(size_t size)
+{
+    return (size + 7) / 8;
+}
+
+/* Zero a snapshot from its end to a whole number of words. */
+static bool rewind_pad(savestate_snap_t *snap, size_t words)
+{
+    if (!snap_grow(snap, words * 8))
+        return false;
+    memset(snap->data + snap->size, 0, words * 8 - snap->size);
+    return true;
+}
+
+static unsigned char *rewind_putvar(unsigned char *dst, size_t var)
+{
+    while (var >= 0x80) {
+        *dst++ = var & 0x7f;
+        var >>= 7;
+    }
+    *dst++ = var | 0x80;
+    return dst;
+}
+
+static const unsigned char *rewind_getvar(const unsigned char *src, size_t *var)
+{
+    size_t value = 0;
+    unsigned shift = 0;
+    unsigned char byte;
+
+    do {
+        byte = *src++;
+        value |= (size_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while (!(byte & 0x80));
+    *var = value;
+    return src;
+}
+
+static size_t rewind_encode(const unsigned char *old, const unsigned char *new, size_t words, unsigned char *dst)
+{
+    unsigned char *start = dst;
+    uint64_t a, b;
+    size_t w = 0, zeros, lits, i;
+
+    while (w < words) {
+        for (zeros = 0; w < words; w++, zeros++) {
+            memcpy(&a, old + w * 8, 8);
+            memcpy(&b, new + w * 8, 8);
+            if (a != b)
+                break;
+        }
+        for (lits = 0; w + lits < words; lits++) {
+            memcpy(&a, old + (w + lits) * 8, 8);
+            memcpy(&b, new + (w + lits) * 8, 8);
+            if (a == b)
+                break;
+        }
+        dst = rewind_putvar(dst, zeros);
+        dst = rewind_putvar(dst, lits);
+        for (i = 0; i < lits; i++, w++) {
+            memcpy(&a, old + w * 8, 8);
+            memcpy(&b, new + w * 8, 8);
+            a ^= b;
+            memcpy(dst, &a, 8);
+            dst += 8;
+        }
+    }
+    return dst - start;
+}
+
+static void rewind_decode(unsigned char *snap, const unsigned char *src, size_t len)
+{
+    const unsigned char *end = src + len;
+    unsigned char *dst = snap;
+    size_t zeros, lits;
+    uint64_t a, b;
+
+    while (src < end) {
+        src = rewind_getvar(src, &zeros);
+        src = rewind_getvar(src, &lits);
+        dst += zeros * 8;
+        while (lits--) {
+            memcpy(&a, dst, 8);
+            memcpy(&b, src, 8);
+            a ^= b;
+            memcpy(dst, &a, 8);
+            dst += 8;
+            src += 8;
+        }
+    }
+}
+
+void savestate_rewind_clear(void)
+{
+    rewind_head = rewind_count = 0;
+    rewind_cur.size = 0;
+}
+
+static void rewind_free(void)
+{
+    int i;
+
+    if (rewind_ring) {
+        for (i = 0; i < rewind_slots; i++)
+            if (rewind_ring[i].data)
+                free(rewind_ring[i].data);
+        free(rewind_ring);
+        rewind_ring = NULL;
+    }
+    rewind_slots = 0;
+    savestate_snap_free(&rewind_cur);
+    savestate_snap_free(&rewind_new);
+    if (rewind_work) {
+        free(rewind_work);
+        rewind_work = NULL;
+        rewind_work_alloc = 0;
+    }
+    savestate_rewind_clear();
+}
+
+void savestate_rewind_capture(void)
+{
+    savestate_snap_t tmp;
+    rewind_delta_t *delta;
+    size_t words, need;
+
+    if (savestate_rewind_frames != rewind_slots) {
+        rewind_free();
+        if (savestate_rewind_frames <= 0)
+            return;
+        if (!(rewind_ring = calloc(savestate_rewind_frames, sizeof(rewind_delta_t)))) {
+            log_error("savestate: out of memory for rewind");
+            savestate_rewind_frames = 0;
+            return;
+        }
+        rewind_slots = savestate_rewind_frames;
+    }
+    if (!savestate_snapshot(&rewind_new)) {
+        savestate_rewind_clear();
+        return;
+    }
+    if (rewind_cur.size && !memcmp(rewind_cur.data, rewind_new.data, SNAP_HDR)) {
+        words = rewind_words(rewind_cur.size > rewind_new.size ? rewind_cur.size : rewind_new.size);
+        need = words * 9 + 16;
+        if (need > rewind_work_alloc) {
+            free(rewind_work);
+            if (!(rewind_work = malloc(need))) {
+                log_error("savestate: out of memory for rewind");
+                rewind_work_alloc = 0;
+                savestate_rewind_clear();
+                return;
+            }
+            rewind_work_alloc = need;
+        }
+        delta = rewind_ring + rewind_head;
+        if (rewind_pad(&rewind_cur, words) && rewind_pad(&rewind_new, words)) {
+            delta->len = rewind_encode(rewind_cur.data, rewind_new.data, words, rewind_work);
+            if (delta->len > delta->alloc) {
+                free(delta->data);
+                if (!(delta->data = malloc(delta->len))) {
+                    delta->alloc = 0;
+                    savestate_rewind_clear();
+                    return;
+                }
+                delta->alloc = delta->len;
+            }
+            memcpy(delta->data, rewind_work, delta->len);
+            delta->size = rewind_cur.size;
+            rewind_head = (rewind_head + 1) % rewind_slots;
+            if (rewind_count < rewind_slots)
+                rewind_count++;
+        }
+    }
+    else
+        rewind_head = rewind_count = 0;
+    tmp = rewind_cur;
+    rewind_cur = rewind_new;
+    rewind_new = tmp;
+}
+
+/* Go back the given number of frames from the newest snapshot, or as
+ * far as the ring goes, and return how many that was. */
+
+int savestate_rewind(int frames)
+{
+    rewind_delta_t *delta;
+    size_t words;
+    int done;
+
+    if (!rewind_cur.size)
+        return -1;
+    for (done = 0; done < frames && rewind_count; done++) {
+        rewind_head = (rewind_head + rewind_slots - 1) % rewind_slots;
+        rewind_count--;
+        delta = rewind_ring + rewind_head;
+        words = rewind_words(rewind_cur.size > delta->size ? rewind_cur.size : delta->size);
+        if (!rewind_pad(&rewind_cur, words)) {
+            savestate_rewind_clear();
+            return -1;
+        }
+        rewind_decode(rewind_cur.data, delta->data, delta->len);
+        rewind_cur.size = delta->size;
+    }
+    if (!savestate_restore(&rewind_cur)) {
+        savestate_rewind_clear();
+        return -1;
+    }
+    log_debug("savestate: rewound %d frames", done);
+    return done;
+}
+
+void savestate_dorewind(void)
+{
+    if (savestate_rewind(savestate_wantrewind) < 0)
+        log_warn("savestate: nothing to rewind to");
+    savestate_wantrewind = 0;
+}
+
 void savestate_save_var(unsigned var, FILE *f) {
     uint8_t byte;
 
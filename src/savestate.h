@@ -1,11 +1,19 @@
 #ifndef __INC_SAVESTATE_H
 #define __INC_SAVESTATE_H
 
+#include <stdbool.h>
 #include <stdio.h>
 
 typedef struct _sszfile ZFILE;
 
-extern int savestate_wantsave, savestate_wantload;
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t alloc;
+} savestate_snap_t;
+
+extern int savestate_wantsave, savestate_wantload, savestate_wantrewind;
+extern int savestate_rewind_frames;
 extern char *savestate_name;
 
 void savestate_save(const char *name);
@@ -13,9 +21,20 @@ void savestate_load(const char *name);
 void savestate_dosave(void);
 void savestate_doload(void);
 
+bool savestate_snapshot(savestate_snap_t *snap);
+bool savestate_restore(const savestate_snap_t *snap);
+void savestate_snap_free(savestate_snap_t *snap);
+
+void savestate_rewind_capture(void);
+void savestate_rewind_clear(void);
+int savestate_rewind(int frames);
+void savestate_dorewind(void);
+
 void savestate_zread(ZFILE *zfp, void *dest, size_t size);
 void savestate_zwrite(ZFILE *zfp, void *src, size_t size);
 
+bool savestate_sect_more(FILE *f);
+
 extern void savestate_save_var(unsigned var, FILE *f);
 extern void savestate_save_str(const char *str, FILE *f);
 extern unsigned savestate_load_var(FILE *f);
@@ -0,0 +1,125 @@
+/*B-em
+  Cycle-stamped event scheduler for host devices*/
+
+#include "b-em.h"
+#include "savestate.h"
+#include "scheduler.h"
+
+int64_t sched_clock;
+int64_t sched_next = INT64_MAX;
+
+/*Pending events, kept in order of deadline.*/
+static sched_event_t *sched_head;
+
+/*Every event seen, so a saved state can find them again by name.*/
+static sched_event_t *sched_all;
+
+static void sched_register(sched_event_t *ev)
+{
+    if (!ev->known) {
+        ev->all_next = sched_all;
+        sched_all = ev;
+        ev->known = true;
+    }
+}
+
+void sched_event_init(sched_event_t *ev, const char *name, void (*callback)(void))
+{
+    sched_register(ev);
+    sched_cancel(ev);
+    ev->when = 0;
+    ev->callback = callback;
+    ev->name = name;
+    ev->next = NULL;
+    ev->pending = false;
+}
+
+static void sched_unlink(sched_event_t *ev)
+{
+    sched_event_t **pp;
+
+    for (pp = &sched_head; *pp; pp = &(*pp)->next) {
+        if (*pp == ev) {
+            *pp = ev->next;
+            break;
+        }
+    }
+    ev->next = NULL;
+    ev->pending = false;
+}
+
+void sched_at(sched_event_t *ev, int64_t when)
+{
+    sched_event_t **pp;
+
+    sched_register(ev);
+    if (ev->pending)
+        sched_unlink(ev);
+    ev->when = when;
+    /*Events due at the same time run in the order they were scheduled.*/
+    for (pp = &sched_head; *pp && (*pp)->when <= when; pp = &(*pp)->next)
+        ;
+    ev->next = *pp;
+    *pp = ev;
+    ev->pending = true;
+    sched_next = sched_head->when;
+}
+
+void sched_cancel(sched_event_t *ev)
+{
+    if (ev->pending) {
+        sched_unlink(ev);
+        sched_next = sched_head ? sched_head->when : INT64_MAX;
+    }
+}
+
+void sched_dispatch(void)
+{
+    sched_event_t *ev;
+
+    while ((ev = sched_head) && ev->when <= sched_clock) {
+        sched_head = ev->next;
+        ev->next = NULL;
+        ev->pending = false;
+        sched_next = sched_head ? sched_head->when : INT64_MAX;
+        ev->callback();
+    }
+}
+
+/*Pending events are saved by name with the time still to go, in the
+  order they are due so ties run in the same order once loaded.  This
+  section is loaded after the devices so it replaces anything they
+  scheduled as they were loaded.*/
+
+void sched_savestate(FILE *f)
+{
+    sched_event_t *ev;
+
+    for (ev = sched_head; ev; ev = ev->next) {
+        savestate_save_str(ev->name, f);
+        savestate_save_var(ev->when > sched_clock ? ev->when - sched_clock : 0, f);
+    }
+    savestate_save_str("", f);
+}
+
+void sched_loadstate(FILE *f)
+{
+    sched_event_t *ev;
+    unsigned delay;
+    char *name;
+
+    for (ev = sched_all; ev; ev = ev->all_next)
+        sched_cancel(ev);
+    while (*(name = savestate_load_str(f))) {
+        delay = savestate_load_var(f);
+        for (ev = sched_all; ev; ev = ev->all_next)
+            if (!strcmp(ev->name, name))
+                break;
+        if (ev)
+            sched_at(ev, sched_clock + delay);
+        else
+            log_warn("scheduler: unknown event '%s' in saved state", name);
+        free(name);
+    }
+    free(name);
+}
@@ -0,0 +1,50 @@
+#ifndef __INC_SCHEDULER_H
+#define __INC_SCHEDULER_H
+
+/*Cycle-stamped event scheduler for host-side devices.
+
+  Time is counted in 2MHz host cycles.  Each device that needs to do
+  something at a particular time registers an event with the cycle at
+  which it is due and the CPU only calls into the scheduler when the
+  clock crosses the earliest deadline, rather than every device being
+  polled on every instruction.*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef struct sched_event sched_event_t;
+
+struct sched_event {
+    int64_t       when;
+    void          (*callback)(void);
+    const char    *name;
+    sched_event_t *next;
+    sched_event_t *all_next;
+    bool          pending;
+    bool          known;
+};
+
+extern int64_t sched_clock;
+extern int64_t sched_next;
+
+void sched_event_init(sched_event_t *ev, const char *name, void (*callback)(void));
+void sched_at(sched_event_t *ev, int64_t when);
+void sched_cancel(sched_event_t *ev);
+void sched_dispatch(void);
+void sched_savestate(FILE *f);
+void sched_loadstate(FILE *f);
+
+static inline void sched_in(sched_event_t *ev, int delay)
+{
+    sched_at(ev, sched_clock + delay);
+}
+
+static inline void sched_advance(int cycles)
+{
+    sched_clock += cycles;
+    if (sched_clock >= sched_next)
+        sched_dispatch();
+}
+
+#endif
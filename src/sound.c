@@ -15,6 +15,7 @@ bool sound_internal = false, sound_beebsid = false, sound_dac = false;
 bool sound_ddnoise = false, sound_tape = false;
 bool sound_music5000 = false, sound_filter = false;
 bool sound_paula = false;
+unsigned sound_underruns = 0;
 
 static ALLEGRO_VOICE *voice;
 static ALLEGRO_MIXER *mixer;
@@ -80,6 +81,10 @@ void sound_poll(void)
         // skip forward 2 mono samples
         sound_pos += 2;
         if (sound_pos == BUFLEN_SO) {
+            // every fragment free means the stream has run dry
+            if (al_get_audio_stream_playing(stream) &&
+                al_get_available_audio_stream_fragments(stream) == al_get_audio_stream_fragments(stream))
+                sound_underruns++;
             if ((buf = al_get_audio_stream_fragment(stream))) {
                 if (sound_filter) {
                     for (c = 0; c < BUFLEN_SO; c++)
@@ -18,6 +18,7 @@ extern size_t buflen_m5;
 extern bool sound_internal, sound_beebsid, sound_dac;
 extern bool sound_ddnoise, sound_tape;
 extern bool sound_music5000, sound_filter, sound_paula;
+extern unsigned sound_underruns;
 
 void sound_init(void);
 void sound_poll(void);
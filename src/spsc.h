@@ -0,0 +1,134 @@
+#ifndef __INC_SPSC_H
+#define __INC_SPSC_H
+
+/*B-em
+  Lock-free single-producer, single-consumer ring buffer.
+
+  One thread may call spsc_put and one other thread spsc_get without any
+  further locking.  The capacity must be a power of two.
+
+  The atomic helpers are also used on their own for flags and counters
+  shared between exactly two threads.*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+
+static inline unsigned spsc_load(volatile unsigned *ptr)
+{
+    unsigned val = *ptr;
+    _ReadWriteBarrier();
+    return val;
+}
+
+static inline void spsc_store(volatile unsigned *ptr, unsigned val)
+{
+    _ReadWriteBarrier();
+    *ptr = val;
+}
+
+static inline unsigned spsc_xchg(volatile unsigned *ptr, unsigned val)
+{
+    return _InterlockedExchange((volatile long *)ptr, val);
+}
+
+static inline void spsc_or8(volatile uint8_t *ptr, uint8_t val)
+{
+    _InterlockedOr8((volatile char *)ptr, val);
+}
+
+static inline void spsc_and8(volatile uint8_t *ptr, uint8_t val)
+{
+    _InterlockedAnd8((volatile char *)ptr, val);
+}
+
+static inline int spsc_add(volatile int *ptr, int val)
+{
+    return _InterlockedExchangeAdd((volatile long *)ptr, val) + val;
+}
+#else
+static inline unsigned spsc_load(volatile unsigned *ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline void spsc_store(volatile unsigned *ptr, unsigned val)
+{
+    __atomic_store_n(ptr, val, __ATOMIC_RELEASE);
+}
+
+static inline unsigned spsc_xchg(volatile unsigned *ptr, unsigned val)
+{
+    return __atomic_exchange_n(ptr, val, __ATOMIC_ACQ_REL);
+}
+
+static inline void spsc_or8(volatile uint8_t *ptr, uint8_t val)
+{
+    __atomic_fetch_or(ptr, val, __ATOMIC_ACQ_REL);
+}
+
+static inline void spsc_and8(volatile uint8_t *ptr, uint8_t val)
+{
+    __atomic_fetch_and(ptr, val, __ATOMIC_ACQ_REL);
+}
+
+static inline int spsc_add(volatile int *ptr, int val)
+{
+    return __atomic_add_fetch(ptr, val, __ATOMIC_ACQ_REL);
+}
+#endif
+
+typedef struct {
+    volatile unsigned head;     /* next slot to write, owned by producer */
+    volatile unsigned tail;     /* next slot to read, owned by consumer */
+    unsigned mask;
+    size_t   size;
+    uint8_t  *data;
+} spsc_t;
+
+static inline bool spsc_init(spsc_t *q, unsigned count, size_t size)
+{
+    q->head = q->tail = 0;
+    q->mask = count - 1;
+    q->size = size;
+    return (q->data = malloc(count * size)) != NULL;
+}
+
+static inline void spsc_close(spsc_t *q)
+{
+    if (q->data) {
+        free(q->data);
+        q->data = NULL;
+    }
+}
+
+static inline bool spsc_empty(spsc_t *q)
+{
+    return spsc_load(&q->head) == spsc_load(&q->tail);
+}
+
+static inline bool spsc_put(spsc_t *q, const void *item)
+{
+    unsigned head = q->head;
+    if (head - spsc_load(&q->tail) > q->mask)
+        return false;
+    memcpy(q->data + (head & q->mask) * q->size, item, q->size);
+    spsc_store(&q->head, head + 1);
+    return true;
+}
+
+static inline bool spsc_get(spsc_t *q, void *item)
+{
+    unsigned tail = q->tail;
+    if (tail == spsc_load(&q->head))
+        return false;
+    memcpy(item, q->data + (tail & q->mask) * q->size, q->size);
+    spsc_store(&q->tail, tail + 1);
+    return true;
+}
+
+#endif
@@ -86,6 +86,9 @@ static void sysvia_write_IC32(uint8_t val)
 {
         uint8_t oldIC32 = IC32;
 
+        if ((val & 7) == 4 || (val & 7) == 5)
+           video_catchup();
+
         if (val & 8)
            IC32 |=  (1 << (val & 7));
         else
@@ -97,6 +100,7 @@ static void sysvia_write_IC32(uint8_t val)
            sn_write(sdbval);
 
         scrsize = ((IC32 & 0x10) ? 2 : 0) | ((IC32 & 0x20) ? 1 : 0);
+        video_scrsize_changed();
 
     log_debug("sysvia: IC32=%02X", IC32);
     led_update(LED_CAPS_LOCK, !(IC32 & 0x40), 0);
@@ -163,9 +167,15 @@ uint8_t sysvia_read(uint16_t addr)
         return temp;
 }
 
+static void sysvia_timer_event(void)
+{
+        via_timer_event(&sysvia);
+}
+
 void sysvia_reset()
 {
         via_reset(&sysvia);
+        sched_event_init(&sysvia.timer_event, "sysvia", sysvia_timer_event);
 
         sysvia.read_portA = sysvia_read_portA;
         sysvia.read_portB = sysvia_read_portB;
@@ -185,6 +195,7 @@ void sysvia_savestate(FILE *f)
         via_savestate(&sysvia, f);
 
         putc(IC32,f);
+        via_save_extra(&sysvia, f);
 }
 
 void sysvia_loadstate(FILE *f)
@@ -193,4 +204,5 @@ void sysvia_loadstate(FILE *f)
 
         IC32=getc(f);
         scrsize=((IC32&16)?2:0)|((IC32&32)?1:0);
+        via_load_extra(&sysvia, f);
 }
@@ -6,6 +6,8 @@
 #include "6502.h"
 #include "model.h"
 #include "tube.h"
+#include "debugger.h"
+#include "spsc.h"
 
 #include "NS32016/32016.h"
 #include "NS32016/mem32016.h"
@@ -24,6 +26,8 @@ int tubecycles = 0;
 
 uint8_t (*tube_readmem)(uint32_t addr);
 void (*tube_writemem)(uint32_t addr, uint8_t byte);
+void (*tube_readblock)(uint32_t addr, uint8_t *buf, uint32_t len);
+void (*tube_writeblock)(uint32_t addr, const uint8_t *buf, uint32_t len);
 void (*tube_exec)(void);
 void (*tube_proc_savestate)(ZFILE *zfp);
 void (*tube_proc_loadstate)(ZFILE *zfp);
@@ -42,12 +46,120 @@ tube_speed_t tube_speeds[NUM_TUBE_SPEEDS] =
     { "800%",   8 },
     { "1600%", 16 },
     { "3200%", 32 },
-    { "6400%", 64 }
+    { "6400%", 64 },
+    { "Auto",   0 }
 };
 
+/*
+ * With the "Auto" speed the parasite clock is adjusted once a frame
+ * from the share of the frame time the host needed to run it.  It is
+ * raised by an eighth while frames take less than TUBE_AUTO_RAISE of
+ * the frame time, cut by a quarter when they take more than
+ * TUBE_AUTO_CUT and halved when a frame is dropped or the sound runs
+ * dry.  It is held while the parasite is idle as the frame time then
+ * says nothing about what running it costs.  The level is in sixteenths
+ * of the 100% speed and runs from 100% to 6400%.
+ */
+
+#define TUBE_AUTO_MIN   16
+#define TUBE_AUTO_MAX   1024
+#define TUBE_AUTO_RAISE 0.70
+#define TUBE_AUTO_CUT   0.90
+
+static int tube_auto_level = TUBE_AUTO_MIN;
+
 int tube_irq=0;
 tubetype tube_type=TUBEX86;
 
+/*
+ * Optionally the parasite runs on a thread of its own.  The host hands
+ * over the cycles it has run every TUBE_SLICE cycles and waits if the
+ * parasite falls more than TUBE_SKEW cycles behind.  Before any host
+ * access other than a status read the parasite is brought level with
+ * the host, so it never sees the host act early and transfers timed by
+ * the host rather than by the status flags still work.  The host polls
+ * the status registers while the parasite is busy so those reads do
+ * not wait.
+ *
+ * Each status flag is set by one side and cleared by the other so each
+ * change is a single atomic operation and the R1 parasite to host FIFO
+ * is a single-producer, single-consumer ring.  Each side updates its own
+ * interrupt lines at once and leaves a flag for the other side to pick
+ * up at the next hand over.
+ */
+
+#define TUBE_SKEW  512
+#define TUBE_SPINS 20000
+
+bool tube_threaded = false;
+bool tube_thread_active = false;
+int tube_thread_cycles, tube_thread_credit;
+
+static volatile unsigned tube_given, tube_done, tube_sleeping;
+static volatile unsigned tube_host_due, tube_para_due;
+static bool tube_stopping, tube_thread_failed;
+static int tube_spins;
+
+static ALLEGRO_THREAD *tube_thread;
+static ALLEGRO_MUTEX *tube_mutex;
+static ALLEGRO_COND *tube_cond;
+
+/*
+ * Parasite client ROMs spend most of their time polling a status
+ * register waiting for the host.  Nothing the parasite can see changes
+ * until the host accesses a Tube data register or writes to the ULA, so
+ * once the parasite has read the same status register and seen the same
+ * value TUBE_IDLE_READS times in a row, at a steady interval of no more
+ * than TUBE_IDLE_LOOP cycles, it is left idle and given no more cycles
+ * until the host does so.  The interval is compared with the one two
+ * reads earlier so loops that poll two registers in turn are caught as
+ * well.  Status reads by the host do not count as they change nothing.
+ */
+
+#define TUBE_IDLE_READS 32
+#define TUBE_IDLE_LOOP  100
+
+bool tube_idle_skip = true;
+volatile unsigned tube_idle;
+unsigned tube_clock;
+
+static struct {
+    unsigned last, gap[2];
+    int addr, count;
+    uint8_t val[4];
+} tube_poll;
+
+static void tube_idle_wake(void)
+{
+    tube_poll.count = 0;
+    if (tube_idle) {
+        spsc_store(&tube_idle, 0);
+        log_debug("tube: parasite woken");
+    }
+}
+
+static void tube_idle_check(uint32_t addr, uint8_t val)
+{
+    unsigned now = tube_clock - tubecycles;
+    unsigned gap = now - tube_poll.last;
+    int reg = (addr >> 1) & 3;
+
+    tube_poll.last = now;
+    if (!tube_idle_skip || debug_tube || !gap || gap > TUBE_IDLE_LOOP ||
+        tube_poll.val[reg] != val || gap != tube_poll.gap[1]) {
+        tube_poll.count = 0;
+        tube_poll.val[reg] = val;
+    }
+    else if (++tube_poll.count >= TUBE_IDLE_READS) {
+        log_debug("tube: parasite idle polling S%d=%02X", reg + 1, val);
+        spsc_store(&tube_idle, 1);
+        tube_poll.count = 0;
+        tubecycles = 0;
+    }
+    tube_poll.gap[1] = tube_poll.gap[0];
+    tube_poll.gap[0] = gap;
+}
+
 #define PH1_SIZE 24
 
 struct
@@ -58,14 +170,17 @@ struct
         int ph1tail,ph1head,ph1count,ph3pos,hp3pos;
 } tubeula;
 
-void tube_updateints()
+static void tube_host_ints(void)
 {
-    int new_irq = 0;
-
     interrupt &= ~8;
 
     if ((tubeula.r1stat & 1) && (tubeula.hstat[3] & 128))
         interrupt |= 8;
+}
+
+static void tube_parasite_ints(void)
+{
+    int new_irq = 0;
 
     if (((tubeula.r1stat & 2) && (tubeula.pstat[0] & 128)) || ((tubeula.r1stat & 4) && (tubeula.pstat[3] & 128))) {
         new_irq |= 1;
@@ -106,10 +221,170 @@ void tube_updateints()
     tube_irq = new_irq;
 }
 
+void tube_updateints()
+{
+    tube_host_ints();
+    tube_parasite_ints();
+}
+
+static void tube_host_changed(void)
+{
+    tube_host_ints();
+    if (tube_thread_active)
+        spsc_store(&tube_para_due, 1);
+    else
+        tube_parasite_ints();
+}
+
+static void tube_parasite_changed(void)
+{
+    if (tube_thread_active)
+        spsc_store(&tube_host_due, 1);
+    else
+        tube_host_ints();
+    tube_parasite_ints();
+}
+
+static void *tube_thread_main(ALLEGRO_THREAD *thread, void *data)
+{
+    ALLEGRO_TIMEOUT timeout;
+    unsigned given, done = tube_done;
+    int spins = 0;
+    bool stopping;
+
+    for (;;) {
+        if ((given = spsc_load(&tube_given)) == done) {
+            /* Spin for a while as more cycles are usually on the way,
+               then sleep.  The timeout covers a wake-up missed between
+               the two threads checking each other's counters. */
+            if (++spins < tube_spins)
+                continue;
+            al_lock_mutex(tube_mutex);
+            spsc_xchg(&tube_sleeping, 1);
+            while (spsc_load(&tube_given) == done && !tube_stopping) {
+                al_init_timeout(&timeout, 0.001);
+                al_wait_cond_until(tube_cond, tube_mutex, &timeout);
+            }
+            spsc_store(&tube_sleeping, 0);
+            stopping = tube_stopping;
+            al_unlock_mutex(tube_mutex);
+            if (stopping && spsc_load(&tube_given) == done)
+                break;
+            continue;
+        }
+        spins = 0;
+        if (spsc_xchg(&tube_para_due, 0))
+            tube_parasite_ints();
+        tube_add_cycles(given - done);
+        if (tubecycles > 3)
+            tube_exec();
+        spsc_store(&tube_done, done = given);
+    }
+    return NULL;
+}
+
+static void tube_thread_give(unsigned skew)
+{
+    unsigned given = tube_given + tube_thread_credit;
+    int spins = 0;
+
+    tube_thread_credit = tube_thread_cycles = 0;
+    spsc_xchg(&tube_given, given);
+    if (spsc_load(&tube_sleeping)) {
+        al_lock_mutex(tube_mutex);
+        al_signal_cond(tube_cond);
+        al_unlock_mutex(tube_mutex);
+    }
+    while (given - spsc_load(&tube_done) > skew)
+        if (++spins > tube_spins)
+            al_rest(0);
+    if (spsc_xchg(&tube_host_due, 0))
+        tube_host_ints();
+}
+
+void tube_thread_handover(void)
+{
+    if (!tube_threaded || debug_tube || !tube_exec)
+        tube_thread_stop();
+    else
+        tube_thread_give((TUBE_SKEW * tube_multipler) >> 1);
+}
+
+void tube_quiesce(void)
+{
+    if (tube_thread_active)
+        tube_thread_give(0);
+}
+
+static void tube_thread_start(void)
+{
+    tube_given = tube_done = tube_sleeping = 0;
+    tube_host_due = tube_para_due = 0;
+    tube_thread_credit = tube_thread_cycles = 0;
+    tube_stopping = false;
+    tube_spins = TUBE_SPINS;
+    if (al_get_cpu_count() < 2) {
+        log_warn("tube: only one CPU, running the parasite on the main thread");
+        tube_thread_failed = true;
+        return;
+    }
+    if ((tube_mutex = al_create_mutex())) {
+        if ((tube_cond = al_create_cond())) {
+            if ((tube_thread = al_create_thread(tube_thread_main, NULL))) {
+                tube_thread_active = true;
+                al_start_thread(tube_thread);
+                log_debug("tube: parasite thread started");
+                return;
+            }
+            al_destroy_cond(tube_cond);
+        }
+        al_destroy_mutex(tube_mutex);
+    }
+    log_error("tube: unable to start parasite thread");
+    tube_thread_failed = true;
+}
+
+void tube_thread_stop(void)
+{
+    if (tube_thread_active) {
+        while (tube_given != spsc_load(&tube_done))
+            al_rest(0);
+        al_lock_mutex(tube_mutex);
+        tube_stopping = true;
+        al_signal_cond(tube_cond);
+        al_unlock_mutex(tube_mutex);
+        al_join_thread(tube_thread, NULL);
+        al_destroy_thread(tube_thread);
+        al_destroy_cond(tube_cond);
+        al_destroy_mutex(tube_mutex);
+        tube_thread_active = false;
+        tube_add_cycles(tube_thread_credit);
+        tube_thread_credit = tube_thread_cycles = 0;
+        tube_updateints();
+        log_debug("tube: parasite thread stopped");
+    }
+}
+
+void tube_thread_update(void)
+{
+    bool want = tube_threaded && !tube_thread_failed && tube_exec && !debug_tube;
+
+    if (want && !tube_thread_active)
+        tube_thread_start();
+    else if (!want && tube_thread_active)
+        tube_thread_stop();
+    if (debug_tube || !tube_idle_skip)
+        tube_idle_wake();
+}
+
 uint8_t tube_host_read(uint16_t addr)
 {
         uint8_t temp = 0;
         if (!tube_exec) return 0xFE;
+        if (addr & 1) {
+            tube_quiesce();
+            tube_idle_wake();
+        }
         switch (addr & 7)
         {
             case 0: /*Reg 1 Stat*/
@@ -119,11 +394,14 @@ uint8_t tube_host_read(uint16_t addr)
                 temp = tubeula.ph1[tubeula.ph1head];
                 log_debug("tube: host read R%c=%02X", '1', temp);
                 if (tubeula.ph1count > 0) {
-                    if (--tubeula.ph1count == 0)
-                        tubeula.hstat[0] &= ~0x80;
                     if (++tubeula.ph1head == PH1_SIZE)
                         tubeula.ph1head = 0;
-                    tubeula.pstat[0] |= 0x40;
+                    if (spsc_add(&tubeula.ph1count, -1) == 0) {
+                        spsc_and8(&tubeula.hstat[0], ~0x80);
+                        if (tubeula.ph1count)
+                            spsc_or8(&tubeula.hstat[0], 0x80);
+                    }
+                    spsc_or8(&tubeula.pstat[0], 0x40);
                 }
                 break;
             case 2: /*Register 2 Stat*/
@@ -134,8 +412,8 @@ uint8_t tube_host_read(uint16_t addr)
                 log_debug("tube: host read R%c=%02X", '2', temp);
                 if (tubeula.hstat[1] & 0x80)
                 {
-                        tubeula.hstat[1] &= ~0x80;
-                        tubeula.pstat[1] |=  0x40;
+                        spsc_and8(&tubeula.hstat[1], ~0x80);
+                        spsc_or8(&tubeula.pstat[1], 0x40);
                 }
                 break;
             case 4: /*Register 3 Stat*/
@@ -147,9 +425,9 @@ uint8_t tube_host_read(uint16_t addr)
                 if (tubeula.ph3pos > 0)
                 {
                         tubeula.ph3[0] = tubeula.ph3[1];
-                        tubeula.ph3pos--;
-                        tubeula.pstat[2] |= 0xc0;
-                        if (!tubeula.ph3pos) tubeula.hstat[2] &= ~0x80;
+                        if (!spsc_add(&tubeula.ph3pos, -1))
+                            spsc_and8(&tubeula.hstat[2], ~0x80);
+                        spsc_or8(&tubeula.pstat[2], 0xc0);
                 }
                 break;
             case 6: /*Register 4 Stat*/
@@ -160,66 +438,72 @@ uint8_t tube_host_read(uint16_t addr)
                 log_debug("tube: host read R%c=%02X", '4', temp);
                 if (tubeula.hstat[3] & 0x80)
                 {
-                        tubeula.hstat[3] &= ~0x80;
-                        tubeula.pstat[3] |=  0x40;
+                        spsc_and8(&tubeula.hstat[3], ~0x80);
+                        spsc_or8(&tubeula.pstat[3], 0x40);
                 }
                 break;
         }
-        tube_updateints();
+        tube_host_changed();
         return temp;
 }
 
 void tube_host_write(uint16_t addr, uint8_t val)
 {
         if (!tube_exec) return;
+        tube_quiesce();
+        tube_idle_wake();
         switch (addr & 7)
         {
             case 0: /*Register 1 stat*/
                 if (val & 0x80) tubeula.r1stat |=  (val&0x3F);
                 else            tubeula.r1stat &= ~(val&0x3F);
                 log_debug("tube: host write S1=%02X->%02X", val, tubeula.r1stat);
-                tubeula.hstat[0] = (tubeula.hstat[0] & 0xC0) | (val & 0x3F);
+                spsc_and8(&tubeula.hstat[0], 0xC0);
+                spsc_or8(&tubeula.hstat[0], val & 0x3F);
                 break;
             case 1: /*Register 1*/
                 log_debug("tube: host write R%c=%02X", '1', val);
                 tubeula.hp1 = val;
-                tubeula.pstat[0] |=  0x80;
-                tubeula.hstat[0] &= ~0x40;
+                spsc_or8(&tubeula.pstat[0], 0x80);
+                spsc_and8(&tubeula.hstat[0], ~0x40);
                 break;
             case 3: /*Register 2*/
                 log_debug("tube: host write R%c=%02X", '2', val);
                 tubeula.hp2 = val;
-                tubeula.pstat[1] |=  0x80;
-                tubeula.hstat[1] &= ~0x40;
+                spsc_or8(&tubeula.pstat[1], 0x80);
+                spsc_and8(&tubeula.hstat[1], ~0x40);
                 break;
             case 5: /*Register 3*/
                 log_debug("tube: host write R%c=%02X", '3', val);
                 if (tubeula.r1stat & 16)
                 {
                         if (tubeula.hp3pos < 2)
-                           tubeula.hp3[tubeula.hp3pos++] = val;
+                        {
+                           tubeula.hp3[tubeula.hp3pos] = val;
+                           spsc_add(&tubeula.hp3pos, 1);
+                        }
                         if (tubeula.hp3pos == 2)
                         {
-                                tubeula.pstat[2] |=  0x80;
-                                tubeula.hstat[2] &= ~0x40;
+                                spsc_or8(&tubeula.pstat[2], 0x80);
+                                spsc_and8(&tubeula.hstat[2], ~0x40);
                         }
                 }
                 else
                 {
                         tubeula.hp3[0] = val;
                         tubeula.hp3pos = 1;
-                        tubeula.pstat[2] |=  0x80;
-                        tubeula.hstat[2] &= ~0x40;
+                        spsc_or8(&tubeula.pstat[2], 0x80);
+                        spsc_and8(&tubeula.hstat[2], ~0x40);
                 }
                 break;
             case 7: /*Register 4*/
                 log_debug("tube: host write R%c=%02X", '4', val);
                 tubeula.hp4 = val;
-                tubeula.pstat[3] |=  0x80;
-                tubeula.hstat[3] &= ~0x40;
+                spsc_or8(&tubeula.pstat[3], 0x80);
+                spsc_and8(&tubeula.hstat[3], ~0x40);
                 break;
         }
-        tube_updateints();
+        tube_host_changed();
 }
 
 uint8_t tube_parasite_read(uint32_t addr)
@@ -236,8 +520,8 @@ uint8_t tube_parasite_read(uint32_t addr)
                 log_debug("tube: parasite read R%c=%02X", '1', temp);
                 if (tubeula.pstat[0] & 0x80)
                 {
-                        tubeula.pstat[0] &= ~0x80;
-                        tubeula.hstat[0] |=  0x40;
+                        spsc_and8(&tubeula.pstat[0], ~0x80);
+                        spsc_or8(&tubeula.hstat[0], 0x40);
                 }
                 break;
             case 2: /*Register 2 stat*/
@@ -248,8 +532,8 @@ uint8_t tube_parasite_read(uint32_t addr)
                 log_debug("tube: parasite read R%c=%02X", '2', temp);
                 if (tubeula.pstat[1] & 0x80)
                 {
-                        tubeula.pstat[1] &= ~0x80;
-                        tubeula.hstat[1] |=  0x40;
+                        spsc_and8(&tubeula.pstat[1], ~0x80);
+                        spsc_or8(&tubeula.hstat[1], 0x40);
                 }
                 break;
             case 4: /*Register 3 stat*/
@@ -261,11 +545,10 @@ uint8_t tube_parasite_read(uint32_t addr)
                 if (tubeula.hp3pos>0)
                 {
                         tubeula.hp3[0] = tubeula.hp3[1];
-                        tubeula.hp3pos--;
-                        if (!tubeula.hp3pos)
+                        if (!spsc_add(&tubeula.hp3pos, -1))
                         {
-                                tubeula.hstat[2] |=  0x40;
-                                tubeula.pstat[2] &= ~0x80;
+                                spsc_and8(&tubeula.pstat[2], ~0x80);
+                                spsc_or8(&tubeula.hstat[2], 0x40);
                         }
                 }
                 break;
@@ -277,69 +560,144 @@ uint8_t tube_parasite_read(uint32_t addr)
                 log_debug("tube: parasite read R%c=%02X", '4', temp);
                 if (tubeula.pstat[3] & 0x80)
                 {
-                        tubeula.pstat[3] &= ~0x80;
-                        tubeula.hstat[3] |=  0x40;
+                        spsc_and8(&tubeula.pstat[3], ~0x80);
+                        spsc_or8(&tubeula.hstat[3], 0x40);
                 }
                 break;
         }
-        tube_updateints();
+        if (addr & 1)
+            tube_poll.count = 0;
+        else
+            tube_idle_check(addr, temp);
+        tube_parasite_changed();
         return temp;
 }
 
 void tube_parasite_write(uint32_t addr, uint8_t val)
 {
+        tube_poll.count = 0;
         switch (addr & 7)
         {
             case 1: /*Register 1*/
                 log_debug("tube: parasite write R%c=%02X", '1', val);
                 if (tubeula.ph1count < PH1_SIZE) {
                     tubeula.ph1[tubeula.ph1tail++] = val;
-                    tubeula.hstat[0] |= 0x80;
                     if (tubeula.ph1tail == PH1_SIZE)
                         tubeula.ph1tail = 0;
-                    if (++tubeula.ph1count == PH1_SIZE)
-                        tubeula.pstat[0] &= ~0x40;
+                    if (spsc_add(&tubeula.ph1count, 1) == PH1_SIZE) {
+                        spsc_and8(&tubeula.pstat[0], ~0x40);
+                        if (tubeula.ph1count < PH1_SIZE)
+                            spsc_or8(&tubeula.pstat[0], 0x40);
+                    }
+                    spsc_or8(&tubeula.hstat[0], 0x80);
                 }
                 break;
             case 3: /*Register 2*/
                 log_debug("tube: parasite write R%c=%02X", '2', val);
                 tubeula.ph2 = val;
-                tubeula.hstat[1] |=  0x80;
-                tubeula.pstat[1] &= ~0x40;
+                spsc_or8(&tubeula.hstat[1], 0x80);
+                spsc_and8(&tubeula.pstat[1], ~0x40);
                 break;
             case 5: /*Register 3*/
                 log_debug("tube: parasite write R%c=%02X", '3', val);
                 if (tubeula.r1stat & 16)
                 {
                         if (tubeula.ph3pos < 2)
-                           tubeula.ph3[tubeula.ph3pos++] = val;
+                        {
+                           tubeula.ph3[tubeula.ph3pos] = val;
+                           spsc_add(&tubeula.ph3pos, 1);
+                        }
                         if (tubeula.ph3pos == 2)
                         {
-                                tubeula.hstat[2] |=  0x80;
-                                tubeula.pstat[2] &= ~0x40;
+                                spsc_or8(&tubeula.hstat[2], 0x80);
+                                spsc_and8(&tubeula.pstat[2], ~0x40);
                         }
                 }
                 else
                 {
                         tubeula.ph3[0] = val;
                         tubeula.ph3pos = 1;
-                        tubeula.hstat[2] |=  0x80;
-                        tubeula.pstat[2] &= ~0xc0;
+                        spsc_or8(&tubeula.hstat[2], 0x80);
+                        spsc_and8(&tubeula.pstat[2], ~0xc0);
                 }
                 break;
             case 7: /*Register 4*/
                 log_debug("tube: parasite write R%c=%02X", '4', val);
                 tubeula.ph4 = val;
-                tubeula.hstat[3] |=  0x80;
-                tubeula.pstat[3] &= ~0x40;
+                spsc_or8(&tubeula.hstat[3], 0x80);
+                spsc_and8(&tubeula.pstat[3], ~0x40);
                 break;
         }
-        tube_updateints();
+        tube_parasite_changed();
+}
+
+/*
+ * Copying a block to or from parasite memory, for VDFS.  Processors
+ * which supply tube_readblock and tube_writeblock copy straight to and
+ * from their RAM, only going a byte at a time for anything else in the
+ * range.  Otherwise, or while the parasite is being debugged so that
+ * watchpoints still trigger, each byte goes through tube_readmem or
+ * tube_writemem.
+ */
+
+void tube_read_block(uint32_t addr, uint8_t *buf, uint32_t len)
+{
+    tube_quiesce();
+    if (tube_readblock && !debug_tube)
+        tube_readblock(addr, buf, len);
+    else
+        while (len--)
+            *buf++ = tube_readmem(addr++);
+}
+
+void tube_write_block(uint32_t addr, const uint8_t *buf, uint32_t len)
+{
+    tube_quiesce();
+    if (tube_writeblock && !debug_tube)
+        tube_writeblock(addr, buf, len);
+    else
+        while (len--)
+            tube_writemem(addr++, *buf++);
 }
 
 void tube_updatespeed()
 {
-    tube_multipler = tube_speeds[tube_speed_num].multipler * tubes[curtube].speed_multiplier;
+    if (tube_speed_num == TUBE_SPEED_AUTO)
+        tube_multipler = (tube_auto_level * tubes[curtube].speed_multiplier) >> 4;
+    else
+        tube_multipler = tube_speeds[tube_speed_num].multipler * tubes[curtube].speed_multiplier;
+}
+
+void tube_auto_frame(double load, bool late)
+{
+    int level = tube_auto_level;
+
+    if (tube_speed_num != TUBE_SPEED_AUTO || !tube_exec)
+        return;
+    if (late)
+        level >>= 1;
+    else if (load > TUBE_AUTO_CUT)
+        level -= level >> 2;
+    else if (load < TUBE_AUTO_RAISE && !tube_idle)
+        level += level >> 3;
+    if (level < TUBE_AUTO_MIN)
+        level = TUBE_AUTO_MIN;
+    else if (level > TUBE_AUTO_MAX)
+        level = TUBE_AUTO_MAX;
+    if (level != tube_auto_level) {
+        tube_auto_level = level;
+        tube_updatespeed();
+    }
+}
+
+static void n32016_readblock(uint32_t addr, uint8_t *buf, uint32_t len)
+{
+        read_Arbitary(addr, buf, len);
+}
+
+static void n32016_writeblock(uint32_t addr, const uint8_t *buf, uint32_t len)
+{
+        write_Arbitary(addr, (void *)buf, len);
 }
 
 bool tube_32016_init(void *rom)
@@ -349,6 +707,8 @@ bool tube_32016_init(void *rom)
         n32016_reset();
         tube_readmem = read_x8;
         tube_writemem = write_x8;
+        tube_readblock = n32016_readblock;
+        tube_writeblock = n32016_writeblock;
         tube_exec  = n32016_exec;
         tube_proc_savestate = NULL;
         tube_proc_loadstate = NULL;
@@ -364,6 +724,7 @@ void tube_reset(void)
         tubeula.pstat[0] = 0x40;
         tubeula.pstat[1] = tubeula.pstat[2] = tubeula.pstat[3] = 0x7f;
         tubeula.hstat[2] = 0xC0;
+        tube_idle_wake();
 }
 
 void tube_ula_savestate(FILE *f)
@@ -376,5 +737,6 @@ void tube_ula_loadstate(FILE *f)
 {
     tube_6502_rom_in = getc(f);
     fread(&tubeula, sizeof tubeula, 1, f);
+    tube_idle_wake();
     tube_updateints();
 }
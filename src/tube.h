@@ -23,14 +23,19 @@ typedef struct {
     float multipler;
 } tube_speed_t;
 
-#define NUM_TUBE_SPEEDS 7
+#define NUM_TUBE_SPEEDS 8
+#define TUBE_SPEED_AUTO (NUM_TUBE_SPEEDS-1)
 extern tube_speed_t tube_speeds[NUM_TUBE_SPEEDS];
 extern int tube_speed_num, tube_multipler;
 
+void tube_auto_frame(double load, bool late);
+
 bool tube_32016_init(void *rom);
 
 extern uint8_t (*tube_readmem)(uint32_t addr);
 extern void (*tube_writemem)(uint32_t addr, uint8_t byte);
+extern void (*tube_readblock)(uint32_t addr, uint8_t *buf, uint32_t len);
+extern void (*tube_writeblock)(uint32_t addr, const uint8_t *buf, uint32_t len);
 extern void (*tube_exec)(void);
 extern void (*tube_proc_savestate)(ZFILE *zfp);
 extern void (*tube_proc_loadstate)(ZFILE *zfp);
@@ -39,6 +44,9 @@ extern int tubecycles;
 static inline void tubeUseCycles(int c) {tubecycles -= c;}
 static inline int tubeContinueRunning(void) {return tubecycles > 0;}
 
+void tube_read_block(uint32_t addr, uint8_t *buf, uint32_t len);
+void tube_write_block(uint32_t addr, const uint8_t *buf, uint32_t len);
+
 uint8_t tube_host_read(uint16_t addr);
 void    tube_host_write(uint16_t addr, uint8_t val);
 uint8_t tube_parasite_read(uint32_t addr);
@@ -46,6 +54,51 @@ void    tube_parasite_write(uint32_t addr, uint8_t val);
 
 extern int tube_irq;
 
+/*Running the parasite on its own thread, see tube.c.*/
+
+#define TUBE_SLICE 32
+
+extern bool tube_threaded, tube_thread_active;
+extern int tube_thread_cycles, tube_thread_credit;
+
+void tube_thread_update(void);
+void tube_thread_handover(void);
+void tube_thread_stop(void);
+void tube_quiesce(void);
+
+static inline void tube_thread_run(int cycles)
+{
+    tube_thread_credit += (cycles * tube_multipler) >> 1;
+    if ((tube_thread_cycles += cycles) >= TUBE_SLICE)
+        tube_thread_handover();
+}
+
+/*Skipping parasite idle loops, see tube.c.*/
+
+extern bool tube_idle_skip;
+extern volatile unsigned tube_idle;
+extern unsigned tube_clock;
+
+static inline void tube_add_cycles(int cycles)
+{
+    tubecycles += cycles;
+    tube_clock += cycles;
+}
+
+/*Run the parasite for the host cycles just executed.*/
+static inline void tube_run(int cycles)
+{
+    if (tube_idle)
+        return;
+    if (tube_thread_active)
+        tube_thread_run(cycles);
+    else {
+        tube_add_cycles((cycles * tube_multipler) >> 1);
+        if (tubecycles > 3)
+            tube_exec();
+    }
+}
+
 void tube_reset(void);
 void tube_updatespeed(void);
 
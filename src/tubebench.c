@@ -0,0 +1,201 @@
+/*
+ * Time the Z80 and 6809 second processor interpreters.
+ *
+ * Each runs a fixed loop for a fixed number of cycles: on the Z80 a
+ * checksum over a block of memory and a block copy, using the CB, DD and
+ * ED prefixed opcodes, and on the 6809 a checksum using page 2 opcodes.
+ * The speed given is the best of a number of runs, in millions of
+ * emulated cycles per second.
+ *
+ * "make tubebench tubebench-switch" builds it twice, with the threaded
+ * dispatch and with the plain switch.  It uses only z80_init(),
+ * tube_exec, mc6809nc_reset() and mc6809nc_execute() so can also be
+ * built against the interpreters of an older tree for comparison.
+ *
+ * tubebench [runs] [cycles]     default 25 runs of 200000000 cycles
+ */
+
+#include <stdarg.h>
+#include <time.h>
+#include "b-em.h"
+
+#include "cpu_debug.h"
+#include "savestate.h"
+#include "tube.h"
+#include "z80.h"
+#include "z80dis.h"
+#include "6809tube.h"
+#include "mc6809nc/mc6809_debug.h"
+
+extern void mc6809nc_reset(void);
+extern void mc6809nc_execute(void);
+
+/*The parts of the rest of the emulator the interpreters call on.*/
+
+tubetype tube_type;
+uint8_t (*tube_readmem)(uint32_t addr);
+void (*tube_writemem)(uint32_t addr, uint8_t byte);
+void (*tube_readblock)(uint32_t addr, uint8_t *buf, uint32_t len);
+void (*tube_writeblock)(uint32_t addr, const uint8_t *buf, uint32_t len);
+void (*tube_exec)(void);
+void (*tube_proc_savestate)(ZFILE *zfp);
+void (*tube_proc_loadstate)(ZFILE *zfp);
+int tubecycles;
+int tube_irq;
+
+int mc6809nc_debug_enabled;
+cpu_debug_t mc6809nc_cpu_debug;
+
+uint8_t tube_parasite_read(uint32_t addr) { return 0; }
+void tube_parasite_write(uint32_t addr, uint8_t val) {}
+
+void debug_memread (cpu_debug_t *cpu, uint32_t addr, uint32_t value, uint8_t size) {}
+void debug_memwrite(cpu_debug_t *cpu, uint32_t addr, uint32_t value, uint8_t size) {}
+void debug_preexec (cpu_debug_t *cpu, uint32_t addr) {}
+size_t debug_print_addr16(cpu_debug_t *cpu, uint32_t addr, char *buf, size_t bufsize, bool include_symbol) { return 0; }
+uint32_t z80_disassemble(cpu_debug_t *cpu, uint32_t addr, char *buf, size_t bufsize) { return addr; }
+
+void savestate_zread(ZFILE *zfp, void *dest, size_t size) {}
+void savestate_zwrite(ZFILE *zfp, void *src, size_t size) {}
+FILE *x_fopen(const char *path, const char *mode) { return NULL; }
+
+void log_error(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    putc('\n', stderr);
+}
+
+void log_warn(const char *fmt, ...) {}
+#ifdef _DEBUG
+void log_debug(const char *fmt, ...) {}
+#endif
+
+static uint8_t mem6809[0x10000];
+
+uint8_t copro_mc6809nc_read(uint16_t addr) { return mem6809[addr]; }
+void copro_mc6809nc_write(uint16_t addr, uint8_t data) { mem6809[addr] = data; }
+
+/*Z80, at 0000:
+        LD   SP,F000
+        LD   IX,9000
+  loop: LD   HL,8000
+        LD   DE,0000
+        LD   B,00
+  sum:  LD   A,(HL)
+        XOR  E
+        LD   E,A
+        SRL  A
+        RL   E
+        LD   A,D
+        ADC  A,A
+        LD   D,A
+        LD   (IX+0),A
+        INC  IX
+        INC  HL
+        DJNZ sum
+        LD   HL,8000
+        LD   DE,A000
+        LD   BC,0100
+        LDIR
+        LD   IX,9000
+        JP   loop*/
+static const uint8_t z80_prog[] = {
+    0x31, 0x00, 0xf0, 0xdd, 0x21, 0x00, 0x90, 0x21, 0x00, 0x80, 0x11, 0x00,
+    0x00, 0x06, 0x00, 0x7e, 0xab, 0x5f, 0xcb, 0x3f, 0xcb, 0x13, 0x7a, 0x8f,
+    0x57, 0xdd, 0x77, 0x00, 0xdd, 0x23, 0x23, 0x10, 0xee, 0x21, 0x00, 0x80,
+    0x11, 0x00, 0xa0, 0x01, 0x00, 0x01, 0xed, 0xb0, 0xdd, 0x21, 0x00, 0x90,
+    0xc3, 0x07, 0x00
+};
+
+/*6809, at 1000:
+        LDS  #8000
+        LDX  #2000
+        LDY  #3000
+        LDD  #0000
+  sum:  EORB ,X+
+        ASLB
+        ROLA
+        STD  ,Y++
+        CMPY #3200
+        BNE  sum
+        LDY  #3000
+        LDX  #2000
+        BRA  sum*/
+static const uint8_t m6809_prog[] = {
+    0x10, 0xce, 0x80, 0x00, 0x8e, 0x20, 0x00, 0x10, 0x8e, 0x30, 0x00, 0xcc,
+    0x00, 0x00, 0xe8, 0x80, 0x58, 0x49, 0xed, 0xa1, 0x10, 0x8c, 0x32, 0x00,
+    0x26, 0xf4, 0x10, 0x8e, 0x30, 0x00, 0x8e, 0x20, 0x00, 0x20, 0xeb
+};
+
+/*The data the checksums run over.*/
+static uint8_t pattern(int c)
+{
+    return (uint8_t)(c * 37 + (c >> 3));
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double run_z80(uint8_t *rom, long cycles)
+{
+    double start;
+
+    z80_init(rom);
+    for (size_t c = 0; c < sizeof(z80_prog); c++)
+        tube_writemem(c, z80_prog[c]);
+    for (int c = 0; c < 0x100; c++)
+        tube_writemem(0x8000 + c, pattern(c));
+    start = now();
+    for (long done = 0; done < cycles; done += 100000) {
+        tubecycles = 100000;
+        tube_exec();
+    }
+    return cycles / (now() - start) / 1e6;
+}
+
+static double run_6809(long cycles)
+{
+    double start;
+
+    memset(mem6809, 0, sizeof(mem6809));
+    memcpy(mem6809 + 0x1000, m6809_prog, sizeof(m6809_prog));
+    for (int c = 0; c < 0x100; c++)
+        mem6809[0x2000 + c] = pattern(c);
+    mem6809[0xfffe] = 0x10;
+    mem6809[0xffff] = 0x00;
+    mc6809nc_reset();
+    start = now();
+    for (long done = 0; done < cycles; done += 100000) {
+        tubecycles = 100000;
+        mc6809nc_execute();
+    }
+    return cycles / (now() - start) / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t z80_rom[0x1000];
+    int runs = argc > 1 ? atoi(argv[1]) : 25;
+    long cycles = argc > 2 ? atol(argv[2]) : 200000000;
+    double z80_best = 0, m6809_best = 0;
+
+    memcpy(z80_rom, z80_prog, sizeof(z80_prog));
+    for (int run = 0; run < runs; run++) {
+        double z80_mhz = run_z80(z80_rom, cycles);
+        double m6809_mhz = run_6809(cycles);
+        if (z80_mhz > z80_best)
+            z80_best = z80_mhz;
+        if (m6809_mhz > m6809_best)
+            m6809_best = m6809_mhz;
+    }
+    printf("tubebench: best of %d runs of %ld cycles\n", runs, cycles);
+    printf("  Z80:  %.1f MHz\n  6809: %.1f MHz\n", z80_best, m6809_best);
+    return 0;
+}
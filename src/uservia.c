@@ -91,9 +91,15 @@ uint8_t uservia_read(uint16_t addr)
     return via_read(&uservia, addr);
 }
 
+static void uservia_timer_event(void)
+{
+        via_timer_event(&uservia);
+}
+
 void uservia_reset()
 {
         via_reset(&uservia);
+        sched_event_init(&uservia.timer_event, "uservia", uservia_timer_event);
 
         uservia.read_portA = uservia_read_portA;
         uservia.read_portB = uservia_read_portB;
@@ -109,6 +115,7 @@ void uservia_reset()
 
 void dumpuservia()
 {
+        via_sync(&uservia);
         log_debug("T1 = %04X %04X T2 = %04X %04X\n",uservia.t1c,uservia.t1l,uservia.t2c,uservia.t2l);
         log_debug("%02X %02X  %02X %02X\n",uservia.ifr,uservia.ier,uservia.pcr,uservia.acr);
 }
@@ -116,9 +123,11 @@ void dumpuservia()
 void uservia_savestate(FILE *f)
 {
         via_savestate(&uservia, f);
+        via_save_extra(&uservia, f);
 }
 
 void uservia_loadstate(FILE *f)
 {
         via_loadstate(&uservia, f);
+        via_load_extra(&uservia, f);
 }
@@ -1301,19 +1301,15 @@ static void exec_swr_ram(uint8_t flags, uint32_t ram_start, uint16_t len, uint32
         rom_ptr = rom + romid * 0x4000 + sw_start;
         if (ram_start > 0xffff0000 || curtube == -1) {
             if (flags & 0x80)
-                while (len--)
-                    *rom_ptr++ = readmem(ram_start++);
+                readmem_block(ram_start, rom_ptr, len);
             else
-                while (len--)
-                    writemem(ram_start++, *rom_ptr++);
+                writemem_block(ram_start, rom_ptr, len);
         }
         else {
             if (flags & 0x80)
-                while (len--)
-                    *rom_ptr++ = tube_readmem(ram_start++);
+                tube_read_block(ram_start, rom_ptr, len);
             else
-                while (len--)
-                    tube_writemem(ram_start++, *rom_ptr++);
+                tube_write_block(ram_start, rom_ptr, len);
         }
     }
 }
@@ -1556,36 +1552,28 @@ static uint32_t write_bytes(FILE *fp, uint32_t addr, size_t bytes)
 
     if (addr > 0xffff0000 || curtube == -1) {
         while (bytes >= sizeof buffer) {
-            char *ptr = buffer;
-            size_t chunk = sizeof buffer;
-            while (chunk--)
-                *ptr++ = readmem(addr++);
+            readmem_block(addr, (uint8_t *)buffer, sizeof buffer);
             fwrite(buffer, sizeof buffer, 1, fp);
+            addr += sizeof buffer;
             bytes -= sizeof buffer;
         }
         if (bytes > 0) {
-            char *ptr = buffer;
-            size_t chunk = bytes;
-            while (chunk--)
-                *ptr++ = readmem(addr++);
+            readmem_block(addr, (uint8_t *)buffer, bytes);
             fwrite(buffer, bytes, 1, fp);
+            addr += bytes;
         }
     }
     else {
         while (bytes >= sizeof buffer) {
-            char *ptr = buffer;
-            size_t chunk = sizeof buffer;
-            while (chunk--)
-                *ptr++ = tube_readmem(addr++);
+            tube_read_block(addr, (uint8_t *)buffer, sizeof buffer);
             fwrite(buffer, sizeof buffer, 1, fp);
+            addr += sizeof buffer;
             bytes -= sizeof buffer;
         }
         if (bytes > 0) {
-            char *ptr = buffer;
-            size_t chunk = bytes;
-            while (chunk--)
-                *ptr++ = tube_readmem(addr++);
+            tube_read_block(addr, (uint8_t *)buffer, bytes);
             fwrite(buffer, bytes, 1, fp);
+            addr += bytes;
         }
     }
     return addr;
@@ -1800,9 +1788,8 @@ static void read_file_io(FILE *fp, uint32_t addr)
     size_t nbytes;
 
     while ((nbytes = fread(buffer, 1, sizeof buffer, fp)) > 0) {
-        char *ptr = buffer;
-        while (nbytes--)
-            writemem(addr++, *ptr++);
+        writemem_block(addr, (uint8_t *)buffer, nbytes);
+        addr += nbytes;
     }
 }
 
@@ -1812,9 +1799,8 @@ static void read_file_tube(FILE *fp, uint32_t addr)
     size_t nbytes;
 
     while ((nbytes = fread(buffer, 1, sizeof buffer, fp)) > 0) {
-        char *ptr = buffer;
-        while (nbytes--)
-            tube_writemem(addr++, *ptr++);
+        tube_write_block(addr, (uint8_t *)buffer, nbytes);
+        addr += nbytes;
     }
 }
 
@@ -2094,32 +2080,24 @@ static size_t read_bytes(FILE *fp, uint32_t addr, size_t bytes)
     size_t nbytes;
 
     while (bytes >= sizeof buffer) {
-        char *ptr = buffer;
         if ((nbytes = fread(buffer, 1, sizeof buffer, fp)) <= 0)
             return bytes;
         bytes -= nbytes;
-        if (addr > 0xffff0000 || curtube == -1) {
-            while (nbytes--)
-                writemem(addr++, *ptr++);
-        }
-        else {
-            while (nbytes--)
-                tube_writemem(addr++, *ptr++);
-        }
+        if (addr > 0xffff0000 || curtube == -1)
+            writemem_block(addr, (uint8_t *)buffer, nbytes);
+        else
+            tube_write_block(addr, (uint8_t *)buffer, nbytes);
+        addr += nbytes;
     }
     while (bytes > 0) {
-        char *ptr = buffer;
         if ((nbytes = fread(buffer, 1, bytes, fp)) <= 0)
             return bytes;
         bytes -= nbytes;
-        if (addr > 0xffff0000 || curtube == -1) {
-            while (nbytes--)
-                writemem(addr++, *ptr++);
-        }
-        else {
-            while (nbytes--)
-                tube_writemem(addr++, *ptr++);
-        }
+        if (addr > 0xffff0000 || curtube == -1)
+            writemem_block(addr, (uint8_t *)buffer, nbytes);
+        else
+            tube_write_block(addr, (uint8_t *)buffer, nbytes);
+        addr += nbytes;
     }
     return 0;
 }
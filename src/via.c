@@ -1,5 +1,7 @@
 #include "b-em.h"
+#include <limits.h>
 #include "6502.h"
+#include "savestate.h"
 #include "via.h"
 
 #define INT_CA1    0x02
@@ -42,12 +44,12 @@ static void via_updateIFR(VIA *v)
         }
 }
 
-void via_poll(VIA *v, int cycles)
+static void via_advance(VIA *v, int cycles)
 {
     v->t1c -= cycles;
     if (v->t1c < TLIMIT) {
-        while (v->t1c < TLIMIT)
-              v->t1c+=v->t1l+4;
+        int period = v->t1l + 4;
+        v->t1c += ((TLIMIT - v->t1c + period - 1) / period) * period;
         if (!v->t1hit) {
             v->ifr |= INT_TIMER1;
             via_updateIFR(v);
@@ -71,8 +73,47 @@ void via_poll(VIA *v, int cycles)
         via_shift(v, cycles);
 }
 
+/*Bring the timers and shift register up to the current cycle.*/
+void via_sync(VIA *v)
+{
+    int64_t elapsed = sched_clock - v->synced;
+
+    v->synced = sched_clock;
+    while (elapsed > 0) {
+        int cycles = elapsed > 0x10000000 ? 0x10000000 : elapsed;
+        via_advance(v, cycles);
+        elapsed -= cycles;
+    }
+}
+
+/*Arrange for timer_event to fire on the cycle the next timer interrupt
+  would be raised.  While shifting out under the system clock the shift
+  register drives CB1/CB2 every cycle so the VIA is kept in step.*/
+static void via_schedule(VIA *v)
+{
+    int delay = INT_MAX;
+
+    if (!v->t1hit)
+        delay = v->t1c - TLIMIT + 1;
+    if (!(v->acr & 0x20) && !v->t2hit && v->t2c - TLIMIT + 1 < delay)
+        delay = v->t2c - TLIMIT + 1;
+    if ((v->acr & 0x1c) == 0x18)
+        delay = 1;
+    if (delay == INT_MAX)
+        sched_cancel(&v->timer_event);
+    else
+        sched_at(&v->timer_event, v->synced + delay);
+}
+
+void via_timer_event(VIA *v)
+{
+    via_sync(v);
+    via_schedule(v);
+}
+
 void via_write(VIA *v, uint16_t addr, uint8_t val)
 {
+        via_sync(v);
         switch (addr&0xF)
         {
             case ORA:
@@ -220,11 +261,13 @@ void via_write(VIA *v, uint16_t addr, uint8_t val)
                 via_updateIFR(v);
                 break;
         }
+        via_schedule(v);
 }
 
 uint8_t via_read(VIA *v, uint16_t addr)
 {
         uint8_t temp;
+        via_sync(v);
         switch (addr&0xF)
         {
             case ORA:
@@ -412,6 +455,8 @@ void via_reset(VIA *v)
         v->t2c   = v->t2l   = 0x1FFFE;
         v->t1hit = v->t2hit = 1;
         v->acr   = v->pcr   = 0;
+        v->synced           = sched_clock;
+        sched_cancel(&v->timer_event);
 
         v->read_portA  = v->read_portB  = via_read_null;
         v->write_portA = v->write_portB = via_write_null;
@@ -421,6 +466,7 @@ void via_reset(VIA *v)
 
 void via_savestate(VIA *v, FILE *f)
 {
+        via_sync(v);
         putc(v->ora,f);
         putc(v->orb,f);
         putc(v->ira,f);
@@ -444,6 +490,17 @@ void via_savestate(VIA *v, FILE *f)
         putc(v->ca2,f);
 }
 
+/*State added since the above was first saved and so put at the end of
+  the section, after anything the owner of the VIA saves.*/
+
+void via_save_extra(VIA *v, FILE *f)
+{
+        putc(v->cb1,f);
+        putc(v->cb2,f);
+        putc(v->t1pb7,f);
+        putc(v->sr_count,f);
+}
+
 void via_loadstate(VIA *v, FILE *f)
 {
         v->ora=getc(f);
@@ -467,4 +524,17 @@ void via_loadstate(VIA *v, FILE *f)
         v->t2hit=getc(f);
         v->ca1=getc(f);
         v->ca2=getc(f);
+        v->synced = sched_clock;
+        via_schedule(v);
+}
+
+void via_load_extra(VIA *v, FILE *f)
+{
+        if (savestate_sect_more(f)) {
+                v->cb1=getc(f);
+                v->cb2=getc(f);
+                v->t1pb7=getc(f);
+                v->sr_count=getc(f);
+                via_schedule(v);
+        }
 }
@@ -1,6 +1,8 @@
 #ifndef __INC_VIA_H
 #define __INC_VIA_H
 
+#include "scheduler.h"
+
 typedef struct VIA
 {
         uint8_t  ora,   orb,   ira,   irb;
@@ -25,6 +27,12 @@ typedef struct VIA
         void     (*set_cb1)(int level);
         void     (*set_cb2)(int level);
         void     (*timer_expire1)(void);
+
+        /*The timers and shift register are only brought up to date
+          when the VIA is accessed or when timer_event fires, which is
+          scheduled for the cycle the next interrupt is due.*/
+        int64_t       synced;
+        sched_event_t timer_event;
 } VIA;
 
 uint8_t via_read(VIA *v, uint16_t addr);
@@ -39,7 +47,10 @@ void via_set_cb2(VIA *v, int level);
 
 void via_savestate(VIA *v, FILE *f);
 void via_loadstate(VIA *v, FILE *f);
+void via_save_extra(VIA *v, FILE *f);
+void via_load_extra(VIA *v, FILE *f);
 
-void via_poll(VIA *v, int cycles);
+void via_sync(VIA *v);
+void via_timer_event(VIA *v);
 
 #endif
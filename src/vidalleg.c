@@ -2,10 +2,12 @@
   Allegro video code*/
 #include <allegro5/allegro_primitives.h>
 #include "b-em.h"
+#include "capture.h"
 #include "led.h"
 #include "main.h"
 #include "pal.h"
 #include "serial.h"
+#include "spsc.h"
 #include "tape.h"
 #include "video.h"
 #include "video_render.h"
@@ -28,8 +30,42 @@ int scr_x_start, scr_x_size, scr_y_start, scr_y_size;
 
 bool vid_print_mode = false;
 
+#define FRAME_WIDTH  1280
+#define FRAME_HEIGHT 800
+#define FRAME_PIXELS (FRAME_WIDTH * FRAME_HEIGHT)
+
+#define FRAME_CLEAR     1
+#define FRAME_CLEAR_PAL 2
+
+typedef struct {
+    uint32_t *pixels;
+    uint32_t row_ver[FRAME_HEIGHT];         /* version of each row held in pixels */
+    int row_x1, row_x2;                     /* columns those rows were copied for */
+    int x1, y1, x2, y2;                     /* area copied from the render buffer */
+    int firstx, firsty, lastx, lasty;       /* area to display */
+    int shot_x1, shot_y1, shot_x2, shot_y2; /* area to save as a screenshot */
+    enum vid_disptype dtype;
+    bool blit, screenshot, clear, clear_pal;
+    char shot_name[260];
+} vid_frame_t;
+
+/*Emulation thread: the buffer the CRTC draws into.*/
+ALLEGRO_LOCKED_REGION *region;
+static ALLEGRO_LOCKED_REGION render_region;
+static uint32_t *render_buf;
+
+/*Display thread: the locked bitmap frames are copied into.*/
+static ALLEGRO_LOCKED_REGION *b_region;
+
+/*Display thread: set when the window needs redrawing even if the
+  emulated screen has not changed.*/
+static bool vid_redraw = true;
+
 void video_close()
 {
+    capture_close();
+    pal_close();
+    video_frames_close();
     al_destroy_bitmap(b32);
     al_destroy_bitmap(b16);
     al_destroy_bitmap(b);
@@ -88,6 +124,7 @@ void video_enterfullscreen()
         log_error("vidalleg: could not set graphics mode to full-screen");
         fullscreen = 0;
     }
+    vid_redraw = true;
 }
 
 void video_set_window_size(bool fudge)
@@ -120,6 +157,7 @@ void video_set_borders(int borders)
     vid_fullborders = borders;
     video_set_window_size(false);
     al_resize_display(al_get_current_display(), winsizex, winsizey);
+    vid_redraw = true;
 }
 
 void video_set_led_location(int location)
@@ -127,6 +165,7 @@ void video_set_led_location(int location)
     vid_ledlocation = location;
     video_set_window_size(false);
     al_resize_display(al_get_current_display(), winsizex, winsizey);
+    vid_redraw = true;
 }
 
 void video_set_led_visibility(int visibility)
@@ -135,6 +174,7 @@ void video_set_led_visibility(int visibility)
         last_led_update_at = framesrun;
 
     vid_ledvisibility = visibility;
+    vid_redraw = true;
 }
 
 static int video_led_height(void)
@@ -153,6 +193,7 @@ void video_update_window_size(ALLEGRO_EVENT *event)
         log_debug("vidalleg: video_update_window_size, scr_x_size=%d, scr_y_size=%d", scr_x_size, scr_y_size);
     }
     al_acknowledge_resize(event->display.source);
+    vid_redraw = true;
 }
 
 void video_leavefullscreen(void)
@@ -170,6 +211,7 @@ void video_leavefullscreen(void)
     scr_y_start = 0;
     winsizey = al_get_display_height(display);
     scr_y_size = winsizey - video_led_height();
+    vid_redraw = true;
 }
 
 void video_toggle_fullscreen(void)
@@ -197,169 +239,180 @@ static void upscale_only(ALLEGRO_BITMAP *src, int sx, int sy, int sw, int sh, in
     }
 }
 
-static void line_double(void)
+static void line_double(int y1, int y2)
 {
-    char *yptr1 = (char *)region->data + region->pitch * firsty * 2;
-    char *yptr2 = yptr1 + region->pitch;
-    size_t linesize = abs(region->pitch);
+    char *yptr1 = (char *)b_region->data + b_region->pitch * y1 * 2;
+    char *yptr2 = yptr1 + b_region->pitch;
+    size_t linesize = abs(b_region->pitch);
 
-    for (int y = firsty; y < lasty; y++) {
+    for (int y = y1; y < y2; y++) {
         memcpy(yptr2, yptr1, linesize);
-        yptr1 = yptr2 + region->pitch;
-        yptr2 = yptr1 + region->pitch;
+        yptr1 = yptr2 + b_region->pitch;
+        yptr2 = yptr1 + b_region->pitch;
     }
 }
 
-static inline void save_screenshot(void)
+/*Lay out the displayed part of a frame as the window shows it, two rows
+  of output for each scanline, for saving.  With the PAL filter on the
+  source is the filtered bitmap, which already holds both rows of a
+  line doubled scanline.*/
+static void capture_rows(uint32_t *dst, const ALLEGRO_LOCKED_REGION *src, enum vid_disptype dtype, bool pal, int x1, int y1, int x2, int y2)
 {
-    vid_savescrshot--;
-    if (!vid_savescrshot) {
-        int xsize = lastx - firstx;
-        int ysize = lasty - firsty;
-        ALLEGRO_BITMAP *scrshotb  = al_create_bitmap(xsize, ysize << 1);
-        int c;
-
-        if (vid_pal) {
-            switch(vid_dtype_intern) {
-                case VDT_SCALE:
-                    pal_convert(firstx, firsty, lastx, lasty, 1);
-                    al_set_target_bitmap(scrshotb);
-                    al_draw_scaled_bitmap(b32, firstx, firsty, xsize, ysize, 0, 0, xsize, ysize << 1, 0);
-                    break;
-                case VDT_INTERLACE:
-                    pal_convert(firstx, firsty << 1, lastx, lasty << 1, 1);
-                    al_set_target_bitmap(scrshotb);
-                    al_draw_bitmap_region(b32, firstx, firsty << 1, xsize, ysize << 1, 0, 0, 0);
-                    break;
-                case VDT_SCANLINES:
-                    pal_convert(firstx, firsty, lastx, lasty, 1);
-                    al_set_target_bitmap(scrshotb);
-                    c = 0;
-                    for (int y = firsty; y < lasty; y++) {
-                        al_draw_bitmap_region(b32, firstx, y, xsize, 1, 0, c, 0);
-                        c += 2;
-                    }
-                    break;
-                case VDT_LINEDOUBLE:
-                    line_double();
-                    pal_convert(firstx, firsty << 1, lastx, lasty << 1, 1);
-                    al_set_target_bitmap(scrshotb);
-                    al_draw_bitmap_region(b32, firstx, firsty << 1, xsize, ysize << 1, 0, 0, 0);
-                    break;
-            }
+    int width = x2 - x1;
+    size_t len = width * sizeof(uint32_t);
+    const char *base = (const char *)src->data + x1 * sizeof(uint32_t);
+
+    for (int y = y1; y < y2; y++) {
+        uint32_t *d0 = dst + (y - y1) * 2 * width;
+        uint32_t *d1 = d0 + width;
+        switch(dtype) {
+            case VDT_SCALE:
+                memcpy(d0, base + src->pitch * y, len);
+                memcpy(d1, d0, len);
+                break;
+            case VDT_INTERLACE:
+                memcpy(d0, base + src->pitch * (y << 1), len);
+                memcpy(d1, base + src->pitch * ((y << 1) + 1), len);
+                break;
+            case VDT_SCANLINES:
+                memcpy(d0, base + src->pitch * y, len);
+                for (int x = 0; x < width; x++)
+                    d1[x] = 0xff000000;
+                break;
+            case VDT_LINEDOUBLE:
+                memcpy(d0, base + src->pitch * (y << 1), len);
+                memcpy(d1, base + src->pitch * ((y << 1) + pal), len);
+                break;
         }
-        else {
-            al_set_target_bitmap(scrshotb);
-            switch(vid_dtype_intern) {
-                case VDT_SCALE:
-                    al_unlock_bitmap(b);
-                    al_set_target_bitmap(scrshotb);
-                    al_draw_scaled_bitmap(b, firstx, firsty, xsize, ysize, 0, 0, xsize, ysize << 1, 0);
-                    break;
-                case VDT_INTERLACE:
-                    al_unlock_bitmap(b);
-                    al_set_target_bitmap(scrshotb);
-                    al_draw_bitmap_region(b, firstx, firsty << 1, xsize, ysize << 1, 0, 0, 0);
-                    break;
-                case VDT_SCANLINES:
-                    al_unlock_bitmap(b);
-                    al_set_target_bitmap(scrshotb);
-                    c = 0;
-                    for (int y = firsty; y < lasty; y++) {
-                        al_draw_bitmap_region(b, firstx, y, xsize, 1, 0, c, 0);
-                        c += 2;
-                    }
-                    break;
-                case VDT_LINEDOUBLE:
-                    line_double();
-                    al_unlock_bitmap(b);
-                    al_draw_scaled_bitmap(b, firstx, firsty << 1, xsize, ysize << 1, 0, 0, xsize, ysize << 1, 0);
-                    break;
-            }
-            region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READWRITE);
+    }
+}
+
+static inline void save_screenshot(const vid_frame_t *f)
+{
+    int firstx = f->shot_x1, firsty = f->shot_y1;
+    int lastx = f->shot_x2, lasty = f->shot_y2;
+    uint32_t *pixels;
+
+    if (firstx < 0)
+        firstx = 0;
+    if (lastx > FRAME_WIDTH)
+        lastx = FRAME_WIDTH;
+    if (lasty > FRAME_HEIGHT / 2)
+        lasty = FRAME_HEIGHT / 2;
+    if (firstx >= lastx || firsty >= lasty)
+        return;
+
+    if (vid_pal) {
+        ALLEGRO_LOCKED_REGION *pal_region;
+
+        switch(f->dtype) {
+            case VDT_SCALE:
+            case VDT_SCANLINES:
+                pal_convert(b_region, firstx, firsty, lastx, lasty, 1);
+                break;
+            case VDT_LINEDOUBLE:
+                line_double(firsty, lasty);
+                // fall through
+            case VDT_INTERLACE:
+                pal_convert(b_region, firstx, firsty << 1, lastx, lasty << 1, 1);
+                break;
+        }
+        if (!(pal_region = al_lock_bitmap(b32, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READONLY))) {
+            log_error("vidalleg: unable to read back the PAL bitmap for screenshot %s", f->shot_name);
+            return;
         }
-        al_save_bitmap(vid_scrshotname, scrshotb);
-        al_destroy_bitmap(scrshotb);
+        if ((pixels = capture_buffer()))
+            capture_rows(pixels, pal_region, f->dtype, true, firstx, firsty, lastx, lasty);
+        al_unlock_bitmap(b32);
     }
+    else if ((pixels = capture_buffer()))
+        capture_rows(pixels, b_region, f->dtype, false, firstx, firsty, lastx, lasty);
+    if (!pixels) {
+        log_error("vidalleg: no buffer free to save screenshot %s", f->shot_name);
+        return;
+    }
+    capture_shot(pixels, lastx - firstx, (lasty - firsty) << 1, f->shot_name);
 }
 
-static inline void calc_limits(bool non_ttx, uint8_t vtotal)
+static inline void calc_limits(vid_frame_t *f, bool non_ttx, uint8_t vtotal)
 {
     switch(vid_fullborders) {
         case 0:
             if (non_ttx) {
-                firstx = BORDER_NONE_X_START_GRA;
-                lastx  = BORDER_NONE_X_END_GRA;
+                f->firstx = BORDER_NONE_X_START_GRA;
+                f->lastx  = BORDER_NONE_X_END_GRA;
             }
             else {
-                firstx = BORDER_NONE_X_START_TTX;
-                lastx  = BORDER_NONE_X_END_TTX;
+                f->firstx = BORDER_NONE_X_START_TTX;
+                f->lastx  = BORDER_NONE_X_END_TTX;
             }
             if (vtotal > 30) {
-                firsty = BORDER_NONE_Y_START_GRA;
-                lasty  = BORDER_NONE_Y_END_GRA;
+                f->firsty = BORDER_NONE_Y_START_GRA;
+                f->lasty  = BORDER_NONE_Y_END_GRA;
             }
             else {
-                firsty = BORDER_NONE_Y_START_TXT;
-                lasty  = BORDER_NONE_Y_END_TXT;
+                f->firsty = BORDER_NONE_Y_START_TXT;
+                f->lasty  = BORDER_NONE_Y_END_TXT;
             }
             break;
         case 1:
             if (non_ttx) {
-                firstx = BORDER_MED_X_START_GRA;
-                lastx  = BORDER_MED_X_END_GRA;
+                f->firstx = BORDER_MED_X_START_GRA;
+                f->lastx  = BORDER_MED_X_END_GRA;
             }
             else {
-                firstx = BORDER_MED_X_START_TTX;
-                lastx  = BORDER_MED_X_END_TTX;
+                f->firstx = BORDER_MED_X_START_TTX;
+                f->lastx  = BORDER_MED_X_END_TTX;
             }
             if (vtotal > 30) {
-                firsty = BORDER_MED_Y_START_GRA;
-                lasty  = BORDER_MED_Y_END_GRA;
+                f->firsty = BORDER_MED_Y_START_GRA;
+                f->lasty  = BORDER_MED_Y_END_GRA;
             }
             else {
-                firsty = BORDER_MED_Y_START_TXT;
-                lasty  = BORDER_MED_Y_END_TXT;
+                f->firsty = BORDER_MED_Y_START_TXT;
+                f->lasty  = BORDER_MED_Y_END_TXT;
             }
             break;
         case 2:
             if (non_ttx) {
-                firstx = BORDER_FULL_X_START_GRA;
-                lastx  = BORDER_FULL_X_END_GRA;
+                f->firstx = BORDER_FULL_X_START_GRA;
+                f->lastx  = BORDER_FULL_X_END_GRA;
             }
             else {
-                firstx = BORDER_FULL_X_START_TTX;
-                lastx  = BORDER_FULL_X_END_TTX;
+                f->firstx = BORDER_FULL_X_START_TTX;
+                f->lastx  = BORDER_FULL_X_END_TTX;
             }
             if (vtotal > 30) {
-                firsty = BORDER_FULL_Y_START_GRA;
-                lasty  = BORDER_FULL_Y_END_GRA;
+                f->firsty = BORDER_FULL_Y_START_GRA;
+                f->lasty  = BORDER_FULL_Y_END_GRA;
             }
             else {
-                firsty = BORDER_FULL_Y_START_TXT;
-                lasty  = BORDER_FULL_Y_END_TXT;
+                f->firsty = BORDER_FULL_Y_START_TXT;
+                f->lasty  = BORDER_FULL_Y_END_TXT;
             }
     }
 }
 
-static inline void blit_screen(void)
+static inline void blit_screen(const vid_frame_t *f)
 {
+    int firstx = f->firstx, firsty = f->firsty;
+    int lastx = f->lastx, lasty = f->lasty;
     int xsize = lastx - firstx;
     int ysize = lasty - firsty + 1;
 
     if (vid_pal) {
-        switch(vid_dtype_intern) {
+        switch(f->dtype) {
             case VDT_SCALE:
-                pal_convert(firstx, firsty, lastx, lasty, 1);
+                pal_convert(b_region, firstx, firsty, lastx, lasty, 1);
                 al_set_target_backbuffer(al_get_current_display());
                 al_draw_scaled_bitmap(b32, firstx, firsty, xsize, ysize, scr_x_start, scr_y_start, scr_x_size, scr_y_size, 0);
                 break;
             case VDT_INTERLACE:
-                pal_convert(firstx, firsty << 1, lastx, lasty << 1, 1);
+                pal_convert(b_region, firstx, firsty << 1, lastx, lasty << 1, 1);
                 upscale_only(b32, firstx, firsty << 1, xsize, ysize << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
                 break;
             case VDT_SCANLINES:
-                pal_convert(firstx, firsty, lastx, lasty, 1);
+                pal_convert(b_region, firstx, firsty, lastx, lasty, 1);
                 al_set_target_bitmap(b16);
                 al_clear_to_color(al_map_rgb(0, 0,0));
                 for (int c = firsty; c < lasty; c++)
@@ -367,14 +420,14 @@ static inline void blit_screen(void)
                 upscale_only(b16, 0, firsty << 1, xsize, ysize << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
                 break;
             case VDT_LINEDOUBLE:
-                line_double();
-                pal_convert(firstx, firsty << 1, lastx, lasty << 1, 1);
+                line_double(firsty, lasty);
+                pal_convert(b_region, firstx, firsty << 1, lastx, lasty << 1, 1);
                 upscale_only(b32, firstx, firsty << 1, xsize, ysize << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
                 break;
         }
     }
     else {
-        switch(vid_dtype_intern) {
+        switch(f->dtype) {
             case VDT_SCALE:
                 al_unlock_bitmap(b);
                 al_set_target_backbuffer(al_get_current_display());
@@ -393,11 +446,11 @@ static inline void blit_screen(void)
                 upscale_only(b16, 0, firsty << 1, lastx - firstx, (lasty - firsty) << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
                 break;
             case VDT_LINEDOUBLE:
-                line_double();
+                line_double(firsty, lasty);
                 al_unlock_bitmap(b);
                 upscale_only(b, firstx, firsty << 1, xsize, ysize  << 1, scr_x_start, scr_y_start, scr_x_size, scr_y_size);
         }
-        region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READWRITE);
+        b_region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READWRITE);
     }
 }
 
@@ -417,6 +470,15 @@ static inline void fill_letterbox(void)
     al_draw_filled_rectangle(0, scr_y_start + scr_y_size, winsizex, winsizey, border_col);
 }
 
+static const int led_visible_for_frames = 50;
+static const int led_fade_frames = 25;
+
+static bool leds_fading(void)
+{
+    return vid_ledlocation > LED_LOC_NONE && vid_ledvisibility == LED_VIS_TRANSIENT &&
+        framesrun - last_led_update_at <= led_visible_for_frames;
+}
+
 static void render_leds(void)
 {
     if (vid_ledlocation > LED_LOC_NONE) {
@@ -428,9 +490,6 @@ static void render_leds(void)
         }
         else {
             ALLEGRO_COLOR led_tint;
-            const int led_visible_for_frames = 50;
-            const int led_fade_frames = 25;
-
             int led_visible_frames_left = led_visible_for_frames - (framesrun - last_led_update_at);
             if (led_visible_frames_left > 0) {
                 log_debug("led: visible frames left=%d", led_visible_frames_left);
@@ -449,16 +508,261 @@ static void render_leds(void)
     }
 }
 
+/*Frame hand-over between the emulation and display threads.
+
+  The CRTC draws into a private render buffer on the emulation thread.
+  When a frame is due to be shown the part of it that will be used is
+  copied into one of three frame slots which is then swapped with the
+  "ready" slot; the display thread swaps that with the slot it is
+  presenting from.  Neither side ever waits for the other and if the
+  display falls behind intermediate frames are simply dropped.
+
+  Only rows the CRTC has changed are copied.  Each time a frame is
+  published the version of every row flagged in vid_row_dirty is
+  bumped; a slot, and the bitmap on the display side, remember the
+  version of each row they hold and copy only the rows that differ.
+  A frame in which nothing changed is not uploaded or flipped at all.*/
+
+static vid_frame_t frames[3];
+static volatile unsigned frame_ready = 1;
+static unsigned frame_emu = 0;
+static unsigned frame_present = 2;
+static int clear_pending;
+static bool shot_pending;
+static char shot_name[260];
+static uint32_t row_ver[FRAME_HEIGHT];
+
+/*Display thread: what the bitmap b holds and how it was last shown.*/
+static uint32_t b_row_ver[FRAME_HEIGHT];
+static int b_x1, b_x2;
+static int shown_x1, shown_y1, shown_x2, shown_y2;
+static enum vid_disptype shown_dtype;
+static bool shown_pal;
+static int unchanged_frames;
+static bool b_unshown;     /* rows copied into b not yet flipped */
+
+#define FRAME_NEW 4
+#define FRAME_REFRESH 50
+
+void video_frames_init(void)
+{
+    for (int c = 0; c < 3; c++) {
+        if (!(frames[c].pixels = malloc(FRAME_PIXELS * sizeof(uint32_t)))) {
+            log_fatal("vidalleg: out of memory allocating frame buffers");
+            exit(1);
+        }
+    }
+    if (!(render_buf = malloc(FRAME_PIXELS * sizeof(uint32_t)))) {
+        log_fatal("vidalleg: out of memory allocating render buffer");
+        exit(1);
+    }
+    for (int c = 0; c < FRAME_PIXELS; c++)
+        render_buf[c] = 0xff000000;
+    for (int y = 0; y < FRAME_HEIGHT; y++)
+        row_ver[y] = 1;
+    render_region.data = render_buf;
+    render_region.format = ALLEGRO_PIXEL_FORMAT_ARGB_8888;
+    render_region.pitch = FRAME_WIDTH * sizeof(uint32_t);
+    render_region.pixel_size = sizeof(uint32_t);
+    region = &render_region;
+
+    b_region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READWRITE);
+    capture_init();
+}
+
+void video_frames_close(void)
+{
+    for (int c = 0; c < 3; c++)
+        free(frames[c].pixels);
+    free(render_buf);
+}
+
+void video_clear_frame(bool pal_too)
+{
+    for (int c = 0; c < FRAME_PIXELS; c++)
+        render_buf[c] = 0xff000000;
+    memset(vid_row_dirty, 1, sizeof(vid_row_dirty));
+    clear_pending |= pal_too ? FRAME_CLEAR_PAL|FRAME_CLEAR : FRAME_CLEAR;
+}
+
+/*Copy the rows whose version in dst_ver differs from src_ver, returning
+  whether there were any.*/
+static bool frame_copy(void *dst, int dpitch, uint32_t *dst_ver, const void *src, int spitch, const uint32_t *src_ver, int x1, int y1, int x2, int y2)
+{
+    size_t offset, len;
+    bool copied = false;
+
+    if (x1 < 0)
+        x1 = 0;
+    if (x2 > FRAME_WIDTH)
+        x2 = FRAME_WIDTH;
+    if (y1 < 0)
+        y1 = 0;
+    if (y2 > FRAME_HEIGHT)
+        y2 = FRAME_HEIGHT;
+    if (x1 >= x2 || y1 >= y2)
+        return false;
+    offset = x1 * sizeof(uint32_t);
+    len = (x2 - x1) * sizeof(uint32_t);
+    for (int y = y1; y < y2; y++) {
+        if (dst_ver[y] != src_ver[y]) {
+            memcpy((char *)dst + y * dpitch + offset, (const char *)src + y * spitch + offset, len);
+            dst_ver[y] = src_ver[y];
+            copied = true;
+        }
+    }
+    return copied;
+}
+
+static void frame_publish(vid_frame_t *f)
+{
+    int x1 = 65535, y1 = 65535, x2 = 0, y2 = 0;
+    int yscale = (f->dtype == VDT_INTERLACE || f->dtype == VDT_LINEDOUBLE) ? 2 : 1;
+
+    if (f->clear) {
+        x1 = y1 = 0;
+        x2 = FRAME_WIDTH;
+        y2 = FRAME_HEIGHT;
+    }
+    if (f->blit) {
+        if (f->firstx < x1) x1 = f->firstx;
+        if (f->lastx > x2)  x2 = f->lastx;
+        if (f->firsty < y1) y1 = f->firsty;
+        if (f->lasty > y2)  y2 = f->lasty;
+    }
+    if (f->screenshot) {
+        if (f->shot_x1 < x1) x1 = f->shot_x1;
+        if (f->shot_x2 > x2) x2 = f->shot_x2;
+        if (f->shot_y1 < y1) y1 = f->shot_y1;
+        if (f->shot_y2 > y2) y2 = f->shot_y2;
+    }
+    f->x1 = x1;
+    f->x2 = x2 + 16;
+    f->y1 = y1 * yscale;
+    f->y2 = (y2 + 1) * yscale + 1;
+
+    for (int y = 0; y < FRAME_HEIGHT; y++) {
+        if (vid_row_dirty[y]) {
+            row_ver[y]++;
+            vid_row_dirty[y] = 0;
+        }
+    }
+    if (f->row_x1 != f->x1 || f->row_x2 != f->x2) {
+        memset(f->row_ver, 0, sizeof(f->row_ver));
+        f->row_x1 = f->x1;
+        f->row_x2 = f->x2;
+    }
+    frame_copy(f->pixels, render_region.pitch, f->row_ver, render_buf, render_region.pitch, row_ver, f->x1, f->y1, f->x2, f->y2);
+
+    unsigned prev = spsc_xchg(&frame_ready, frame_emu | FRAME_NEW);
+    frame_emu = prev & 3;
+    if (prev & FRAME_NEW) {
+        /* The display never took the slot we got back so anything it
+           was asked to do with it is carried to the next frame. */
+        vid_frame_t *lost = &frames[frame_emu];
+        if (lost->clear)
+            clear_pending |= lost->clear_pal ? FRAME_CLEAR_PAL|FRAME_CLEAR : FRAME_CLEAR;
+        if (lost->screenshot && !shot_pending) {
+            shot_pending = true;
+            memcpy(shot_name, lost->shot_name, sizeof(shot_name));
+        }
+        lost->clear = lost->clear_pal = lost->screenshot = false;
+    }
+    else
+        main_display_event(BEM_EVENT_FRAME, 0);
+}
+
 void video_doblit(bool non_ttx, uint8_t vtotal)
 {
-    if (vid_savescrshot)
-        save_screenshot();
+    vid_frame_t *f = &frames[frame_emu];
+
+    if (vid_savescrshot) {
+        vid_savescrshot--;
+        if (!vid_savescrshot) {
+            shot_pending = true;
+            strncpy(shot_name, vid_scrshotname, sizeof(shot_name) - 1);
+            shot_name[sizeof(shot_name) - 1] = 0;
+        }
+    }
+    f->screenshot = shot_pending;
+    if (shot_pending) {
+        f->shot_x1 = firstx;
+        f->shot_y1 = firsty;
+        f->shot_x2 = lastx;
+        f->shot_y2 = lasty;
+        memcpy(f->shot_name, shot_name, sizeof(f->shot_name));
+    }
 
+    f->blit = false;
     if (++fskipcount >= ((motor && fasttape) ? 5 : vid_fskipmax)) {
-        lasty++;
-        calc_limits(non_ttx, vtotal);
+        calc_limits(f, non_ttx, vtotal);
         fskipcount = 0;
-        blit_screen();
+        f->blit = true;
+    }
+
+    if (f->blit || f->screenshot) {
+        f->dtype = vid_dtype_intern;
+        f->clear = clear_pending & FRAME_CLEAR;
+        f->clear_pal = clear_pending & FRAME_CLEAR_PAL;
+        clear_pending = 0;
+        shot_pending = false;
+        frame_publish(f);
+    }
+
+    // Recordings are taken here, before any frame can be dropped on the way to the display.
+    if (capture_recording) {
+        uint32_t *pixels = capture_frame_buffer();
+        if (pixels) {
+            static vid_frame_t rec;
+            calc_limits(&rec, non_ttx, vtotal);
+            capture_rows(pixels, &render_region, vid_dtype_intern, false, rec.firstx, rec.firsty, rec.lastx, rec.lasty);
+            capture_frame(pixels, rec.lastx - rec.firstx, (rec.lasty - rec.firsty) << 1);
+        }
+    }
+    firstx = firsty = 65535;
+    lastx  = lasty  = 0;
+}
+
+void video_present(void)
+{
+    vid_frame_t *f;
+
+    if (!(spsc_load(&frame_ready) & FRAME_NEW))
+        return;
+    frame_present = spsc_xchg(&frame_ready, frame_present) & 3;
+    f = &frames[frame_present];
+
+    if (f->clear || b_x1 != f->x1 || b_x2 != f->x2) {
+        memset(b_row_ver, 0, sizeof(b_row_ver));
+        b_x1 = f->x1;
+        b_x2 = f->x2;
+    }
+    if (f->clear) {
+        ALLEGRO_COLOR black = al_map_rgb(0, 0, 0);
+        if (f->clear_pal) {
+            al_set_target_bitmap(b32);
+            al_clear_to_color(black);
+        }
+        al_unlock_bitmap(b);
+        al_set_target_bitmap(b);
+        al_clear_to_color(black);
+        b_region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READWRITE);
+    }
+    if (frame_copy(b_region->data, b_region->pitch, b_row_ver, f->pixels, FRAME_WIDTH * sizeof(uint32_t), f->row_ver, f->x1, f->y1, f->x2, f->y2))
+        b_unshown = true;
+
+    if (f->screenshot)
+        save_screenshot(f);
+
+    if (f->blit) {
+        if (f->clear || f->firstx != shown_x1 || f->firsty != shown_y1 || f->lastx != shown_x2 || f->lasty != shown_y2 ||
+            f->dtype != shown_dtype || vid_pal != shown_pal || leds_fading() || ++unchanged_frames >= FRAME_REFRESH)
+            vid_redraw = true;
+        if (led_draw_changes())
+            vid_redraw = true;
+        if (!b_unshown && !vid_redraw)
+            return;
+        blit_screen(f);
         if (scr_x_start > 0)
             fill_pillarbox();
         else if (scr_y_start > 0)
@@ -466,7 +770,14 @@ void video_doblit(bool non_ttx, uint8_t vtotal)
 
         render_leds();
         al_flip_display();
+        b_unshown = false;
+        shown_x1 = f->firstx;
+        shown_y1 = f->firsty;
+        shown_x2 = f->lastx;
+        shown_y2 = f->lasty;
+        shown_dtype = f->dtype;
+        shown_pal = vid_pal;
+        unchanged_frames = 0;
+        vid_redraw = false;
     }
-    firstx = firsty = 65535;
-    lastx  = lasty  = 0;
 }
@@ -9,6 +9,8 @@
 #include "bbctext.h"
 #include "mem.h"
 #include "model.h"
+#include "savestate.h"
+#include "scheduler.h"
 #include "serial.h"
 #include "tape.h"
 #include "via.h"
@@ -16,6 +18,12 @@
 #include "video.h"
 #include "video_render.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
 int fullscreen = 0;
 
 static int scrx, scry;
@@ -37,6 +45,19 @@ static uint16_t maback;
 static int vdispen, dispen;
 static int crtc_mode;
 
+/*Catch-up rendering: the CRTC is only run forward to the current host
+  cycle when something could observe or change what it draws, i.e.
+  CRTC/ULA writes, writes into the part of RAM being displayed and the
+  end of each scanline where VSYNC can change CA1.*/
+static int64_t video_synced;
+static sched_event_t video_event;
+static uint16_t frame_ma;
+uint16_t video_ram_lo;
+
+static void video_update_ram_lo(void);
+static void video_schedule(void);
+static void video_forget_line(void);
+
 void crtc_reset()
 {
     hc = vc = sc = vadj = 0;
@@ -62,15 +83,21 @@ static void crtc_setreg(int reg, uint8_t val)
         set_intern_dtype(vid_dtype_user);
     else if (reg == 12)
         ttxbank = (MASTER|BPLUS) ? 0x7c00 : 0x3C00 | ((val & 0x8) << 11);
+    if (reg == 1 || reg == 4 || reg == 12 || reg == 13)
+        video_update_ram_lo();
 }
 
 void crtc_write(uint16_t addr, uint8_t val)
 {
 //        log_debug("Write CRTC %04X %02X %04X\n",addr,val,pc);
+    video_catchup();
     if (!(addr & 1))
         crtc_i = val & 31;
-    else
+    else {
+        video_forget_line();
         crtc_setreg(crtc_i, val);
+        video_schedule();
+    }
 }
 
 uint8_t crtc_read(uint16_t addr)
@@ -82,6 +109,7 @@ uint8_t crtc_read(uint16_t addr)
 
 void crtc_latchpen()
 {
+    video_catchup();
     crtc[0x10] = (ma >> 8) & 0x3F;
     crtc[0x11] = ma & 0xFF;
 }
@@ -89,6 +117,7 @@ void crtc_latchpen()
 void crtc_savestate(FILE * f)
 {
     uint8_t bytes[25];
+    video_catchup();
     for (int c = 0; c < 18; c++)
         bytes[c] = crtc[c];
     bytes[18] = vc;
@@ -112,6 +141,7 @@ void crtc_loadstate(FILE * f)
     maback = bytes[23] | (bytes[24] << 8);
     for (int c = 0; c < 18; c++)
         crtc_setreg(c, bytes[c]);
+    video_ram_lo = 0;
 }
 
 
@@ -124,6 +154,60 @@ int nula_collook[16];           // maps palette (logical) colours to 12-bit RGB
 
 static uint8_t table4bpp[4][256][16];
 
+/*
+ * NULA attribute modes as logical colours, in the same layout as
+ * table4bpp, for the high and low frequency clocks.
+ */
+
+#define NULA_ATTR_TEXT 0
+#define NULA_ATTR_1BPP 1
+#define NULA_ATTR_2BPP 2
+
+static uint8_t nula_attr_tab[2][3][256][16];
+
+/*
+ * The pixels each screen byte becomes in the current mode and palette,
+ * built from pix_idx and pix_pal the first time the byte is drawn after
+ * either changes.  A byte whose pix_gen differs from pix_cur_gen is out
+ * of date.
+ */
+
+static uint32_t pix_cache[256][16];
+static unsigned pix_gen[256], pix_cur_gen;
+static uint8_t (*pix_idx)[16];
+static uint32_t pix_pal[16];
+
+/*
+ * Rows of the render buffer whose pixels have changed since the last
+ * frame was published, so only those need copying and uploading.  Each
+ * write compares with what is already there so borders and text drawn
+ * the same way every frame do not count.
+ *
+ * Bitmap mode character cells are not drawn at all when the same byte
+ * was last drawn in that cell of that row with the same row_key, which
+ * holds everything else the pixels depend on.  cell_dat holds the byte
+ * last drawn in each cell with CELL_VALID set.  A row is forgotten when
+ * anything else may have drawn over it or the state changes part way
+ * along it.
+ */
+
+uint8_t vid_row_dirty[VID_ROWS];
+
+#define CELL_COLS  160
+#define CELL_VALID 0x100
+
+typedef struct {
+    int scrx, ula_ctrl, crtc1, gap;
+    int left_cut, left_edge, offset, blank;
+    unsigned pix_gen;
+} row_key_t;
+
+static row_key_t row_key[VID_ROWS];
+static bool row_valid[VID_ROWS];
+static uint16_t cell_dat[VID_ROWS][CELL_COLS];
+static int line_row = -1;
+static bool line_cells, line_skip;
+
 static int nula_pal_write_flag = 0;
 static uint8_t nula_pal_first_byte;
 uint8_t nula_flash[8];
@@ -144,9 +228,32 @@ static inline uint32_t makecol(int red, int green, int blue)
     return 0xff000000 | (red << 16) | (green << 8) | blue;
 }
 
+static inline uint32_t *pixel_row(ALLEGRO_LOCKED_REGION *region, int y)
+{
+    return (uint32_t *)((char *)region->data + region->pitch * y);
+}
+
 static inline int get_pixel(ALLEGRO_LOCKED_REGION *region, int x, int y)
 {
-    return *((uint32_t *)((char *)region->data + region->pitch * y + x * region->pixel_size));
+    return pixel_row(region, y)[x];
+}
+
+static inline void set_pixel(ALLEGRO_LOCKED_REGION *region, int x, int y, uint32_t colour)
+{
+    uint32_t *ptr = pixel_row(region, y) + x;
+    vid_row_dirty[y] |= *ptr != colour;
+    *ptr = colour;
+}
+
+static inline void set_pixels(ALLEGRO_LOCKED_REGION *region, int x, int y, int count, uint32_t colour)
+{
+    uint32_t *ptr = pixel_row(region, y) + x;
+    uint32_t diff = 0;
+    while (count--) {
+        diff |= *ptr ^ colour;
+        *ptr++ = colour;
+    }
+    vid_row_dirty[y] |= diff != 0;
 }
 
 #ifdef PIXEL_BOUNDS_CHECK
@@ -157,20 +264,16 @@ static inline void put_pixel_checked(ALLEGRO_LOCKED_REGION *region, int x, int y
         log_debug("video: pixel out of bounds, x=%d at %d", x, line);
     if (y < 0 || y > 800)
         log_debug("video: pixel out of bounds, y=%d at %d", y, line);
-    *((uint32_t *)((char *)region->data + region->pitch * y + x * region->pixel_size)) = colour;
+    set_pixel(region, x, y, colour);
 }
 
 static inline void put_pixels_checked(ALLEGRO_LOCKED_REGION *region, int x, int y, int count, uint32_t colour, int line)
 {
-    char *ptr = (char *)region->data + region->pitch * y + x * region->pixel_size;
     if (x < 0 || (x + count) > 1280)
         log_debug("video: pixel out of bounds, x=%d at %d", x, line);
     if (y < 0 || y > 800)
         log_debug("video: pixel out of bounds, y=%d at %d", y, line);
-    while (count--) {
-        *(uint32_t *)ptr = colour;
-        ptr += region->pixel_size;
-    }
+    set_pixels(region, x, y, count, colour);
 }
 
 static inline void nula_putpixel_checked(ALLEGRO_LOCKED_REGION *region, int x, int y, uint32_t colour, int line)
@@ -189,16 +292,12 @@ static inline void nula_putpixel_checked(ALLEGRO_LOCKED_REGION *region, int x, i
 
 static inline void put_pixel(ALLEGRO_LOCKED_REGION *region, int x, int y, uint32_t colour)
 {
-    *((uint32_t *)((char *)region->data + region->pitch * y + x * region->pixel_size)) = colour;
+    set_pixel(region, x, y, colour);
 }
 
 static inline void put_pixels(ALLEGRO_LOCKED_REGION *region, int x, int y, int count, uint32_t colour)
 {
-    char *ptr = (char *)region->data + region->pitch * y + x * region->pixel_size;
-    while (count--) {
-        *(uint32_t *)ptr = colour;
-        ptr += region->pixel_size;
-    }
+    set_pixels(region, x, y, count, colour);
 }
 
 static inline void nula_putpixel(ALLEGRO_LOCKED_REGION *region, int x, int y, uint32_t colour)
@@ -211,6 +310,146 @@ static inline void nula_putpixel(ALLEGRO_LOCKED_REGION *region, int x, int y, ui
 
 #endif
 
+/*Copy a span of 8 or 16 pixels, returning whether any changed.*/
+static inline bool copy_span(uint32_t *dst, const uint32_t *src, int count)
+{
+#if defined(__AVX2__)
+    __m256i diff = _mm256_setzero_si256();
+    for (int c = 0; c < count; c += 8) {
+        __m256i pix = _mm256_loadu_si256((const __m256i *)(src + c));
+        diff = _mm256_or_si256(diff, _mm256_xor_si256(pix, _mm256_loadu_si256((const __m256i *)(dst + c))));
+        _mm256_storeu_si256((__m256i *)(dst + c), pix);
+    }
+    return !_mm256_testz_si256(diff, diff);
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128i diff = _mm_setzero_si128();
+    for (int c = 0; c < count; c += 4) {
+        __m128i pix = _mm_loadu_si128((const __m128i *)(src + c));
+        diff = _mm_or_si128(diff, _mm_xor_si128(pix, _mm_loadu_si128((const __m128i *)(dst + c))));
+        _mm_storeu_si128((__m128i *)(dst + c), pix);
+    }
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(diff, _mm_setzero_si128())) != 0xffff;
+#else
+    if (!memcmp(dst, src, count * sizeof(uint32_t)))
+        return false;
+    memcpy(dst, src, count * sizeof(uint32_t));
+    return true;
+#endif
+}
+
+/*Write a character cell of 8 or 16 pixels, whole unless NULA blanks part of it.*/
+static inline void nula_putspan(ALLEGRO_LOCKED_REGION *region, int x, int y, const uint32_t *pix, int count)
+{
+    if (crtc_mode && (nula_horizontal_offset || nula_left_blank) && (x < nula_left_cut || x + count > nula_left_edge + (crtc[1] * crtc_mode * 8))) {
+        for (int c = 0; c < count; c++)
+            nula_putpixel(region, x + c, y, pix[c]);
+    }
+    else if (copy_span(pixel_row(region, y) + x, pix, count))
+        vid_row_dirty[y] = 1;
+}
+
+static void video_forget_rows(void)
+{
+    memset(row_valid, 0, sizeof(row_valid));
+    line_cells = line_skip = false;
+}
+
+static void pixel_lookup_changed(void)
+{
+    uint8_t (*idx)[16];
+    const int *pal;
+
+    if (nula_attribute_mode && ula_mode > 1 && crtc_mode) {
+        int kind;
+        // In low frequency clock can only have 1bpp modes
+        if (crtc_mode == 1 && ula_mode == 2)
+            kind = NULA_ATTR_2BPP;
+        else
+            kind = nula_attribute_text ? NULA_ATTR_TEXT : NULA_ATTR_1BPP;
+        idx = nula_attr_tab[crtc_mode - 1][kind];
+        pal = ula_pal;
+    } else {
+        idx = table4bpp[ula_mode];
+        pal = nula_palette_mode ? nula_collook : ula_pal;
+    }
+    if (idx == pix_idx && pix_cur_gen) {
+        int c;
+        for (c = 0; c < 16; c++)
+            if (pix_pal[c] != (uint32_t)pal[c])
+                break;
+        if (c == 16)
+            return;
+    }
+    pix_idx = idx;
+    for (int c = 0; c < 16; c++)
+        pix_pal[c] = pal[c];
+    if (!++pix_cur_gen) {
+        memset(pix_gen, 0, sizeof(pix_gen));
+        pix_cur_gen = 1;
+        video_forget_rows();
+    }
+}
+
+static inline const uint32_t *pixel_lookup(uint8_t dat)
+{
+    uint32_t *pix = pix_cache[dat];
+
+    if (pix_gen[dat] != pix_cur_gen) {
+        for (int c = 0; c < 16; c++)
+            pix[c] = pix_pal[pix_idx[dat][c]];
+        pix_gen[dat] = pix_cur_gen;
+    }
+    return pix;
+}
+
+static inline int video_row(int y)
+{
+    switch(vid_dtype_intern) {
+        case VDT_INTERLACE:
+            return (y << 1) + interlline;
+        case VDT_LINEDOUBLE:
+            return y << 1;
+        default:
+            return y;
+    }
+}
+
+static void video_forget_line(void)
+{
+    if (line_row >= 0)
+        row_valid[line_row] = false;
+    line_cells = line_skip = false;
+}
+
+static void video_line_start(void)
+{
+    int row = video_row(scry);
+
+    line_cells = line_skip = false;
+    line_row = -1;
+    if (row < 0 || row >= VID_ROWS)
+        return;
+    line_row = row;
+    if (dispen && crtc_mode) {
+        row_key_t key;
+        key.scrx = scrx;
+        key.ula_ctrl = ula_ctrl;
+        key.crtc1 = crtc[1];
+        key.gap = (crtc[8] & 0x30) == 0x30 || ((sc & 8) && !(ula_ctrl & 2));
+        key.left_cut = nula_left_cut;
+        key.left_edge = nula_left_edge;
+        key.offset = nula_horizontal_offset;
+        key.blank = nula_left_blank;
+        key.pix_gen = pix_cur_gen;
+        line_skip = row_valid[row] && !memcmp(&key, &row_key[row], sizeof(key));
+        row_key[row] = key;
+        row_valid[row] = true;
+        line_cells = true;
+    }
+    else
+        row_valid[row] = false;
+}
+
 static void nula_default_palette(void)
 {
     nula_collook[0]  = 0xff000000; // black
@@ -248,11 +487,14 @@ void nula_reset(void)
     // Reset flash
     for (int c = 0; c < 8; c++)
         nula_flash[c] = 1;
+
+    pixel_lookup_changed();
 }
 
 void videoula_write(uint16_t addr, uint8_t val)
 {
     int c;
+    video_catchup();
     if (nula_disable)
         addr &= ~2;             // nuke additional NULA addresses
 
@@ -384,6 +626,9 @@ void videoula_write(uint16_t addr, uint8_t val)
         break;
 
     }
+    pixel_lookup_changed();
+    video_forget_line();
+    video_schedule();
 }
 
 void videoula_savestate(FILE * f)
@@ -433,6 +678,7 @@ void videoula_loadstate(FILE * f)
     nula_disable = *ptr++;
     nula_attribute_mode = *ptr++;
     nula_attribute_text = *ptr++;
+    pixel_lookup_changed();
 }
 
 /*Mode 7 (SAA5050)*/
@@ -450,6 +696,51 @@ static uint8_t *mode7_p[2] = { mode7_chars, mode7_charsi };
 static uint8_t mode7_heldchar, mode7_holdchar;
 static uint8_t *mode7_heldp[2];
 
+/*
+ * Cache of rendered glyph rows.  Each entry holds the 16 pixels of one
+ * row of one glyph table (normal or interlaced, alphanumeric, contiguous
+ * or separated graphics, which also fixes the double height phase) in
+ * one foreground/background pair.  Entries are direct mapped by a hash
+ * of the row and colours and tagged with the palette generation, which
+ * moves on whenever mode7_lookup is rebuilt.
+ */
+
+#define MODE7_CACHE_BITS 10
+#define MODE7_CACHE_GEN_MAX (1 << 26)
+
+typedef struct {
+    uint32_t pix[16];
+    const uint8_t *row;
+    uint32_t colours;
+} mode7_cache_t;
+
+static mode7_cache_t mode7_cache[1 << MODE7_CACHE_BITS];
+static uint32_t mode7_cache_gen;
+
+static void mode7_forget_glyphs(void)
+{
+    if (++mode7_cache_gen == MODE7_CACHE_GEN_MAX) {
+        memset(mode7_cache, 0, sizeof(mode7_cache));
+        mode7_cache_gen = 0;
+    }
+}
+
+static inline const uint32_t *mode7_glyph_row(const uint8_t *row, int fg, int bg)
+{
+    uint32_t colours = fg | (bg << 3) | (mode7_cache_gen << 6);
+    uint32_t hash = ((uint32_t)((uintptr_t)row >> 4) << 6 | (fg | (bg << 3))) * 2654435761u;
+    mode7_cache_t *ent = &mode7_cache[hash >> (32 - MODE7_CACHE_BITS)];
+
+    if (ent->row != row || ent->colours != colours) {
+        const int *on = mode7_lookup[fg][bg];
+        for (int c = 0; c < 16; c++)
+            ent->pix[c] = on[row[c] & 15];
+        ent->row = row;
+        ent->colours = colours;
+    }
+    return ent->pix;
+}
+
 void mode7_makechars()
 {
     int c, d, y;
@@ -535,6 +826,7 @@ void mode7_makechars()
         offs1 += 12;
         offs2 += 16;
     }
+    mode7_forget_glyphs();
 }
 
 static void mode7_gen_nula_lookup(void)
@@ -561,18 +853,17 @@ static void mode7_gen_nula_lookup(void)
             }
         }
     }
+    mode7_forget_glyphs();
     mode7_need_new_lookup = 0;
 }
 
 static inline void mode7_render(ALLEGRO_LOCKED_REGION *region, uint8_t dat)
 {
-    int t, c;
-    int off;
+    int t;
     int mcolx = mode7_col;
     int holdoff = 0, holdclear = 0;
     uint8_t *mode7_px[2];
     int mode7_flashx = mode7_flash, mode7_dblx = mode7_dbl;
-    int *on;
 
     if (scrx < (1280-32)) {
         if (mode7_need_new_lookup)
@@ -585,11 +876,8 @@ static inline void mode7_render(ALLEGRO_LOCKED_REGION *region, uint8_t dat)
         mode7_px[0] = mode7_p[0];
         mode7_px[1] = mode7_p[1];
 
-        if (!mode7_dbl && mode7_nextdbl)
-            on = mode7_lookup[mode7_bg & 7][mode7_bg & 7];
         if (dat == 255) {
-            for (c = 0; c < 16; c++)
-                put_pixel(region, scrx + c + 16, scry, colblack);
+            put_pixels(region, scrx + 16, scry, 16, colblack);
             return;
         }
 
@@ -690,21 +978,14 @@ static inline void mode7_render(ALLEGRO_LOCKED_REGION *region, uint8_t dat)
         else
             t = ((dat - 0x20) * 160) + (sc * 16);
 
-        off = mode7_lookup[0][mode7_bg & 7][0];
-        if (!mode7_dbl && mode7_nextdbl)
-            on = mode7_lookup[mode7_bg & 7][mode7_bg & 7];
-        else
-            on = mode7_lookup[mcolx & 7][mode7_bg & 7];
-
-        int interindex = (vid_dtype_intern == VDT_INTERLACE) && interlline;
-        for (c = 0; c < 16; c++) {
-            if (mode7_flashx && !mode7_flashon)
-                put_pixel(region, scrx + c + 16, scry, off);
-            else if (mode7_dblx)
-                put_pixel(region, scrx + c + 16, scry, on[mode7_px[sc & 1][t] & 15]);
-            else
-                put_pixel(region, scrx + c + 16, scry, on[mode7_px[interindex][t] & 15]);
-            t++;
+        if (mode7_flashx && !mode7_flashon)
+            put_pixels(region, scrx + 16, scry, 16, mode7_lookup[0][mode7_bg & 7][0]);
+        else {
+            int fg = (!mode7_dbl && mode7_nextdbl) ? mode7_bg & 7 : mcolx & 7;
+            int interindex = (vid_dtype_intern == VDT_INTERLACE) && interlline;
+            const uint8_t *row = mode7_px[mode7_dblx ? sc & 1 : interindex] + t;
+            if (copy_span(pixel_row(region, scry) + scrx + 16, mode7_glyph_row(row, fg, mode7_bg & 7), 16))
+                vid_row_dirty[scry] = 1;
         }
 
         if ((scrx + 16) < firstx)
@@ -739,13 +1020,82 @@ static int vidbytes = 0;
 
 static int oldr8;
 
+/*Lowest RAM offset the CRTC can fetch from in a frame that starts at
+  address start.  This errs on the low side: catching up on a write the
+  CRTC will never see only costs a little time.*/
+static uint16_t video_fetch_lo(uint16_t start)
+{
+    unsigned end = start + crtc[1] * (crtc[4] + 2);
+    unsigned lo = 0x8000, a;
+
+    if (end > 0x4000)
+        return 0;
+    if ((start & 0x2000) || end > 0x2000)
+        lo = ttxbank;
+    if (!(start & 0x2000)) {
+        a = start << 3;
+        if (a & 0x8000)
+            a -= screenlen[scrsize];
+        a &= 0x7FFF;
+        if (a < lo)
+            lo = a;
+        a = 0x8000 - screenlen[scrsize];
+        if (a < lo)
+            lo = a;
+    }
+    return lo;
+}
+
+static void video_update_ram_lo(void)
+{
+    uint16_t lo = video_fetch_lo(frame_ma);
+    if (lo < video_ram_lo)
+        video_ram_lo = lo;
+    lo = video_fetch_lo((crtc[13] | (crtc[12] << 8)) & 0x3FFF);
+    if (lo < video_ram_lo)
+        video_ram_lo = lo;
+}
+
+/*Schedule the next catch-up for the end of the current scanline, or
+  the next character if CA1 is about to go low.*/
+static void video_schedule(void)
+{
+    int steps, delay;
+
+    if (hvblcount)
+        steps = 1;
+    else {
+        steps = ((crtc[0] - hc) & 255) + 1;
+        if (interline && ((((crtc[0] >> 1) - hc) & 255) + 1) < steps)
+            steps = (((crtc[0] >> 1) - hc) & 255) + 1;
+    }
+    if (ula_ctrl & 0x10)
+        delay = steps;
+    else
+        delay = steps * 2 - !oddclock;
+    sched_at(&video_event, video_synced + delay);
+}
+
+void video_catchup(void)
+{
+    int clocks = sched_clock - video_synced;
+    if (clocks > 0) {
+        video_synced = sched_clock;
+        video_poll(clocks, 1);
+    }
+    video_schedule();
+}
+
+void video_scrsize_changed(void)
+{
+    video_update_ram_lo();
+}
+
 int firstx, firsty, lastx, lasty;
 
 static ALLEGRO_DISPLAY *display;
 ALLEGRO_BITMAP *b, *b16, *b32;
 
-ALLEGRO_LOCKED_REGION *region;
-
 ALLEGRO_COLOR border_col;
 
 ALLEGRO_DISPLAY *video_init(void)
@@ -753,6 +1103,7 @@ ALLEGRO_DISPLAY *video_init(void)
     int c;
     int temp, temp2, left;
 
+#ifndef HEADLESS
 #ifdef ALLEGRO_GTK_TOPLEVEL
     al_set_new_display_flags(ALLEGRO_WINDOWED | ALLEGRO_GTK_TOPLEVEL | ALLEGRO_RESIZABLE);
 #else
@@ -772,6 +1123,7 @@ ALLEGRO_DISPLAY *video_init(void)
     al_set_new_bitmap_flags(ALLEGRO_VIDEO_BITMAP);
     b16 = al_create_bitmap(832, 614);
     b32 = al_create_bitmap(1536, 800);
+#endif
 
     colblack = 0xff000000;
     colwhite = 0xffffffff;
@@ -802,11 +1154,34 @@ ALLEGRO_DISPLAY *video_init(void)
             table4bpp[1][temp][c] = table4bpp[3][temp][c >> 2];
             table4bpp[0][temp][c] = table4bpp[3][temp][c >> 3];
         }
+
+        // NULA attribute modes: pixels spread over the cell 0.75 or 0.375 bits apart.
+        int text = (temp & 7) << 1;
+        int onebpp = (temp & 3) << 2;
+        int twobpp = ((temp & 16) >> 1) | ((temp & 1) << 2);
+        float pc = 0.0f;
+        for (c = 0; c < 8; c++, pc += 0.75f) {
+            int bit = (temp >> (7 - (int) pc)) & 1;
+            int a = 3 - ((int) pc) / 2;
+            // Very loose approximation of the text attribute mode
+            nula_attr_tab[0][NULA_ATTR_TEXT][temp][c] = (c < 7) ? text | bit : text;
+            nula_attr_tab[0][NULA_ATTR_1BPP][temp][c] = onebpp | bit;
+            nula_attr_tab[0][NULA_ATTR_2BPP][temp][c] = twobpp | ((temp >> (a + 3)) & 2) | ((temp >> a) & 1);
+        }
+        pc = 0.0f;
+        for (c = 0; c < 16; c++, pc += 0.375f) {
+            int bit = (temp >> (7 - (int) pc)) & 1;
+            nula_attr_tab[1][NULA_ATTR_TEXT][temp][c] = (c < 14) ? text | bit : text;
+            nula_attr_tab[1][NULA_ATTR_1BPP][temp][c] = onebpp | bit;
+        }
     }
+    pixel_lookup_changed();
+#ifndef HEADLESS
     b = al_create_bitmap(1280, 800);
     al_set_target_bitmap(b);
     al_clear_to_color(al_map_rgb(0, 0,0));
-    region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READWRITE);
+#endif
+    video_frames_init();
     return display;
 }
 
@@ -838,12 +1213,16 @@ void video_reset()
     cursoron = 0;
     charsleft = 0;
     vidbank = 0;
+    video_ram_lo = 0;
+    video_synced = sched_clock;
+    sched_event_init(&video_event, "video", video_catchup);
+    video_schedule();
 
     nula_left_cut = 0;
     nula_left_edge = 0;
     nula_left_blank = 0;
     nula_horizontal_offset = 0;
-
+    video_forget_rows();
 }
 
 #if 0
@@ -879,6 +1258,8 @@ void video_poll(int clocks, int timer_enable)
             dispen = 0;
         }
         if (hc == crtc[2]) { // reached horizontal sync position.
+            if (dispen)
+                video_forget_line();
             if (ula_ctrl & 0x10)
                 scrx = 128 - ((crtc[3] & 15) * 4);
             else
@@ -888,6 +1269,8 @@ void video_poll(int clocks, int timer_enable)
                 scry = 0;
                 video_doblit(crtc_mode, crtc[4]);
             }
+            if (dispen && video_row(scry) < VID_ROWS)
+                row_valid[video_row(scry)] = false;
         }
 
         switch(vid_dtype_intern) {
@@ -917,7 +1300,17 @@ void video_poll(int clocks, int timer_enable)
             }
 
             if (scrx < (1280-16)) {
-                if ((crtc[8] & 0x30) == 0x30 || ((sc & 8) && !(ula_ctrl & 2))) {
+                uint16_t *cell = (line_cells && scry == line_row && hc < CELL_COLS) ? &cell_dat[scry][hc] : NULL;
+                bool gap = (crtc[8] & 0x30) == 0x30 || ((sc & 8) && !(ula_ctrl & 2));
+                if (cell && line_skip && *cell == (dat | CELL_VALID)) {
+                    // Unchanged since last drawn.
+                    if (!gap) {
+                        if (scrx < firstx)
+                            firstx = scrx;
+                        if ((scrx + crtc_mode * 8) > lastx)
+                            lastx = scrx + crtc_mode * 8;
+                    }
+                } else if (gap) {
                     // Gaps between lines in modes 3 & 6.
                     put_pixels(region, scrx, scry, (ula_ctrl & 0x10) ? 8 : 16, colblack);
                 } else
@@ -926,87 +1319,33 @@ void video_poll(int clocks, int timer_enable)
                         mode7_render(region, dat & 0x7F);
                         break;
                     case 1:
-                        {
-                            if (scrx < firstx)
-                                firstx = scrx;
-                            if ((scrx + 8) > lastx)
-                                lastx = scrx + 8;
-                            if (nula_attribute_mode && ula_mode > 1) {
-                                if (ula_mode == 3) {
-                                    // 1bpp
-                                    if (nula_attribute_text) {
-                                        int attribute = ((dat & 7) << 1);
-                                        float pc = 0.0f;
-                                        for (c = 0; c < 7; c++, pc += 0.75f) {
-                                            int output = ula_pal[attribute | (dat >> (7 - (int) pc) & 1)];
-                                            nula_putpixel(region, scrx + c, scry, output);
-                                        }
-                                        // Very loose approximation of the text attribute mode
-                                        nula_putpixel(region, scrx + 7, scry, ula_pal[attribute]);
-                                    } else {
-                                        int attribute = ((dat & 3) << 2);
-                                        float pc = 0.0f;
-                                        for (c = 0; c < 8; c++, pc += 0.75f) {
-                                            int output = ula_pal[attribute | (dat >> (7 - (int) pc) & 1)];
-                                            nula_putpixel(region, scrx + c, scry, output);
-                                        }
-                                    }
-                                } else {
-                                    int attribute = (((dat & 16) >> 1) | ((dat & 1) << 2));
-                                    float pc = 0.0f;
-                                    for (c = 0; c < 8; c++, pc += 0.75f) {
-                                        int a = 3 - ((int) pc) / 2;
-                                        int output = ula_pal[attribute | ((dat >> (a + 3)) & 2) | ((dat >> a) & 1)];
-                                        nula_putpixel(region, scrx + c, scry, output);
-                                    }
-                                }
-                            } else {
-                                for (c = 0; c < 8; c++) {
-                                    nula_putpixel(region, scrx + c, scry, nula_palette_mode ? nula_collook[table4bpp[ula_mode][dat][c]] : ula_pal[table4bpp[ula_mode][dat][c]]);
-                                }
-                            }
-                        }
+                        if (scrx < firstx)
+                            firstx = scrx;
+                        if ((scrx + 8) > lastx)
+                            lastx = scrx + 8;
+                        nula_putspan(region, scrx, scry, pixel_lookup(dat), 8);
                         break;
                     case 2:
-                        {
-                            if (scrx < firstx)
-                                firstx = scrx;
-                            if ((scrx + 16) > lastx)
-                                lastx = scrx + 16;
-                            if (nula_attribute_mode && ula_mode > 1) {
-                                // In low frequency clock can only have 1bpp modes
-                                if (nula_attribute_text) {
-                                    int attribute = ((dat & 7) << 1);
-                                    float pc = 0.0f;
-                                    for (c = 0; c < 14; c++, pc += 0.375f) {
-                                        int output = ula_pal[attribute | (dat >> (7 - (int) pc) & 1)];
-                                        nula_putpixel(region, scrx + c, scry, output);
-                                    }
-
-                                    // Very loose approximation of the text attribute mode
-                                    nula_putpixel(region, scrx + 14, scry, ula_pal[attribute]);
-                                    nula_putpixel(region, scrx + 15, scry, ula_pal[attribute]);
-                                } else {
-                                    int attribute = ((dat & 3) << 2);
-                                    float pc = 0.0f;
-                                    for (c = 0; c < 16; c++, pc += 0.375f) {
-                                        int output = ula_pal[attribute | (dat >> (7 - (int) pc) & 1)];
-                                        nula_putpixel(region, scrx + c, scry, output);
-                                    }
-                                }
-                            } else {
-                                for (c = 0; c < 16; c++) {
-                                    nula_putpixel(region, scrx + c, scry, nula_palette_mode ? nula_collook[table4bpp[ula_mode][dat][c]] : ula_pal[table4bpp[ula_mode][dat][c]]);
-                                }
-                            }
-                        }
+                        if (scrx < firstx)
+                            firstx = scrx;
+                        if ((scrx + 16) > lastx)
+                            lastx = scrx + 16;
+                        nula_putspan(region, scrx, scry, pixel_lookup(dat), 16);
                         break;
                     }
+                if (cell)
+                    *cell = dat | CELL_VALID;
                 if (cdraw) {
                     if (cursoron && (ula_ctrl & cursorlook[cdraw])) {
                         for (c = ((ula_ctrl & 0x10) ? 8 : 16); c >= 0; c--) {
                             nula_putpixel(region, scrx + c, scry, get_pixel(region, scrx + c, scry) ^ 0x00ffffff);
                         }
+                        // The cursor also covers the first pixel of the next cell.
+                        if (cell) {
+                            cell[0] = 0;
+                            if (hc + 1 < CELL_COLS)
+                                cell[1] = 0;
+                        }
                     }
                     cdraw++;
                     if (cdraw == 7)
@@ -1054,6 +1393,7 @@ void video_poll(int clocks, int timer_enable)
         if (interline && hc == (crtc[0] >> 1)) {
             hc = interline = 0;
             lasthc0 = 1;
+            video_forget_line();
 
             if (ula_ctrl & 0x10)
                 scrx = 128 - ((crtc[3] & 15) * 4);
@@ -1098,7 +1438,9 @@ void video_poll(int clocks, int timer_enable)
                 vadj--;
                 if (!vadj) {
                     vdispen = 1;
-                    ma = maback = (crtc[13] | (crtc[12] << 8)) & 0x3FFF;
+                    ma = maback = frame_ma = (crtc[13] | (crtc[12] << 8)) & 0x3FFF;
+                    video_ram_lo = 0x8000;
+                    video_update_ram_lo();
                     sc = 0;
                 }
             } else if (sc == crtc[9] || ((crtc[8] & 3) == 3 && sc == (crtc[9] >> 1))) {
@@ -1122,7 +1464,9 @@ void video_poll(int clocks, int timer_enable)
                     vadj = crtc[5];
                     if (!vadj) {
                         vdispen = 1;
-                        ma = maback = (crtc[13] | (crtc[12] << 8)) & 0x3FFF;
+                        ma = maback = frame_ma = (crtc[13] | (crtc[12] << 8)) & 0x3FFF;
+                        video_ram_lo = 0x8000;
+                        video_update_ram_lo();
                     }
                     frcount++;
                     if (!(crtc[10] & 0x60))
@@ -1134,13 +1478,8 @@ void video_poll(int clocks, int timer_enable)
                     // Reached vertical sync position.
                     int intsync = crtc[8] & 1;
                     if (!intsync && oldr8) {
-                        ALLEGRO_COLOR black = al_map_rgb(0, 0, 0);
-                        al_set_target_bitmap(b32);
-                        al_clear_to_color(black);
-                        al_unlock_bitmap(b);
-                        al_set_target_bitmap(b);
-                        al_clear_to_color(black);
-                        region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READWRITE);
+                        video_clear_frame(true);
+                        video_forget_rows();
                     }
                     frameodd ^= 1;
                     if (frameodd)
@@ -1152,10 +1491,8 @@ void video_poll(int clocks, int timer_enable)
                         vid_cleared = 0;
                     } else if (vidclocks <= 1024 && !vid_cleared) {
                         vid_cleared = 1;
-                        al_unlock_bitmap(b);
-                        al_set_target_bitmap(b);
-                        al_clear_to_color(al_map_rgb(0, 0, 0));
-                        region = al_lock_bitmap(b, ALLEGRO_PIXEL_FORMAT_ARGB_8888, ALLEGRO_LOCK_READWRITE);
+                        video_clear_frame(false);
+                        video_forget_rows();
                         video_doblit(crtc_mode, crtc[4]);
                     }
                     ccount++;
@@ -1203,6 +1540,7 @@ void video_poll(int clocks, int timer_enable)
                 if ((scry + 1) > lasty)
                     lasty = scry;
             }
+            video_line_start();
 
             firstdispen = 1;
             lasthc0 = 1;
@@ -1217,6 +1555,7 @@ void video_poll(int clocks, int timer_enable)
 void video_savestate(FILE * f)
 {
     unsigned char bytes[9];
+    video_catchup();
     bytes[0] = scrx;
     bytes[1] = scrx >> 8;
     bytes[2] = scry;
@@ -1227,6 +1566,25 @@ void video_savestate(FILE * f)
     bytes[7] = vidclocks >> 16;
     bytes[8] = vidclocks >> 24;
     fwrite(bytes, sizeof(bytes), 1, f);
+
+    /* Beam and cursor timing, added later. */
+    savestate_save_var(vadj, f);
+    savestate_save_var(vdispen, f);
+    savestate_save_var(dispen, f);
+    savestate_save_var(vsynctime, f);
+    savestate_save_var(interline, f);
+    savestate_save_var(interlline, f);
+    savestate_save_var(hvblcount, f);
+    savestate_save_var(frameodd, f);
+    savestate_save_var(con, f);
+    savestate_save_var(cdraw, f);
+    savestate_save_var(coff, f);
+    savestate_save_var(cursoron, f);
+    savestate_save_var(frcount, f);
+    savestate_save_var(charsleft, f);
+    savestate_save_var(vidbytes, f);
+    savestate_save_var(mode7_flashon, f);
+    savestate_save_var(mode7_flashtime, f);
 }
 
 void video_loadstate(FILE * f)
@@ -1237,4 +1595,27 @@ void video_loadstate(FILE * f)
     scry = bytes[2] | (bytes[3] << 8);
     oddclock = bytes[4];
     vidclocks = bytes[5] | (bytes[6] << 8) | (bytes[7] << 16) | (bytes[8] << 24);
+    if (savestate_sect_more(f)) {
+        vadj = savestate_load_var(f);
+        vdispen = savestate_load_var(f);
+        dispen = savestate_load_var(f);
+        vsynctime = savestate_load_var(f);
+        interline = savestate_load_var(f);
+        interlline = savestate_load_var(f);
+        hvblcount = savestate_load_var(f);
+        frameodd = savestate_load_var(f);
+        con = savestate_load_var(f);
+        cdraw = savestate_load_var(f);
+        coff = savestate_load_var(f);
+        cursoron = savestate_load_var(f);
+        frcount = savestate_load_var(f);
+        charsleft = savestate_load_var(f);
+        vidbytes = savestate_load_var(f);
+        mode7_flashon = savestate_load_var(f);
+        mode7_flashtime = savestate_load_var(f);
+    }
+    video_ram_lo = 0;
+    video_synced = sched_clock;
+    video_forget_rows();
+    video_schedule();
 }
@@ -37,12 +37,15 @@ extern uint8_t nula_attribute_text;
 ALLEGRO_DISPLAY *video_init(void);
 void video_reset(void);
 void video_poll(int clocks, int timer_enable);
+void video_catchup(void);
+void video_scrsize_changed(void);
 void video_savestate(FILE *f);
 void video_loadstate(FILE *f);
 
 void nula_reset(void);
 
 extern uint16_t vidbank;
+extern uint16_t video_ram_lo;
 
 void mode7_makechars(void);
 extern int interlline;
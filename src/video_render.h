@@ -33,6 +33,9 @@ extern ALLEGRO_COLOR border_col;
 #define BORDER_FULL_Y_END_TXT   308
 
 extern int firstx, firsty, lastx, lasty;
+
+#define VID_ROWS 800
+extern uint8_t vid_row_dirty[VID_ROWS];
 extern int scr_x_start, scr_x_size, scr_y_start, scr_y_size;
 extern int winsizex, winsizey;
 
@@ -53,7 +56,11 @@ extern bool vid_print_mode;
 extern int vid_savescrshot;
 extern char vid_scrshotname[260];
 
+void video_frames_init(void);
+void video_frames_close(void);
+void video_clear_frame(bool pal_too);
 void video_doblit(bool non_ttx, uint8_t vtotal);
+void video_present(void);
 void video_enterfullscreen(void);
 void video_leavefullscreen(void);
 void video_toggle_fullscreen(void);
@@ -397,6 +397,26 @@ void x86_writemem(uint32_t addr, uint8_t byte) {
     writemembl(addr, byte);
 }
 
+/*Block copies for VDFS.  Writes wrap at 1MB as writemembl does.*/
+
+static void x86_readblock(uint32_t addr, uint8_t *buf, uint32_t len)
+{
+    if (addr < 0xE0000 && len <= 0xE0000 - addr)
+        memcpy(buf, x86ram + addr, len);
+    else
+        while (len--)
+            *buf++ = readmemblx86(addr++);
+}
+
+static void x86_writeblock(uint32_t addr, const uint8_t *buf, uint32_t len)
+{
+    if (addr < 0x100000 && len <= 0x100000 - addr)
+        memcpy(x86ram + addr, buf, len);
+    else
+        while (len--)
+            writememblx86(addr++, *buf++);
+}
+
 /*EA calculation*/
 
 /*R/M - bits 0-2 - R/M   bits 3-5 - Reg   bits 6-7 - mod
@@ -750,6 +770,8 @@ bool x86_init(void *rom)
     tube_type = TUBEX86;
     tube_readmem = x86_readmem;
     tube_writemem = x86_writemem;
+    tube_readblock = x86_readblock;
+    tube_writeblock = x86_writeblock;
     tube_exec  = x86_exec;
     tube_proc_savestate = x86_savestate;
     tube_proc_loadstate = x86_loadstate;
@@ -757,6 +779,85 @@ bool x86_init(void *rom)
     return true;
 }
 
+/*Pending flag updates.  Carry is always set straight away as ADC, SBB
+  and the rotates need it, everything else waits for x86_flags_eval.*/
+enum {
+        FLAGS_NONE,
+        FLAGS_ADD8,
+        FLAGS_ADD16,
+        FLAGS_SUB8,
+        FLAGS_SUB16,
+        FLAGS_LOGIC8,
+        FLAGS_LOGIC16
+};
+
+static void x86_flags_eval(void)
+{
+        uint32_t a=flags_a, b=flags_b, c=flags_res;
+        uint16_t f=flags_real&~0x8D4;
+
+        switch (flags_op)
+        {
+                case FLAGS_ADD8:
+                f|=znptable8[c&0xFF];
+                if (!((a^b)&0x80)&&((a^c)&0x80)) f|=V_FLAG;
+                if (((a&0xF)+(b&0xF))&0x10)      f|=A_FLAG;
+                break;
+                case FLAGS_ADD16:
+                f|=znptable16[c&0xFFFF];
+                if (!((a^b)&0x8000)&&((a^c)&0x8000)) f|=V_FLAG;
+                if (((a&0xF)+(b&0xF))&0x10)      f|=A_FLAG;
+                break;
+                case FLAGS_SUB8:
+                f|=znptable8[c&0xFF];
+                if ((a^b)&(a^c)&0x80) f|=V_FLAG;
+                if (((a&0xF)-(b&0xF))&0x10)      f|=A_FLAG;
+                break;
+                case FLAGS_SUB16:
+                f|=znptable16[c&0xFFFF];
+                if ((a^b)&(a^c)&0x8000) f|=V_FLAG;
+                if (((a&0xF)-(b&0xF))&0x10)      f|=A_FLAG;
+                break;
+                case FLAGS_LOGIC8:
+                f|=znptable8[c&0xFF];
+                break;
+                case FLAGS_LOGIC16:
+                f|=znptable16[c&0xFFFF];
+                break;
+        }
+        flags_real=f;
+        flags_op=FLAGS_NONE;
+}
+
+static inline uint16_t *x86_flags_ref(void)
+{
+        if (flags_op)
+           x86_flags_eval();
+        return &flags_real;
+}
+
+/*Zero flag without bringing the others up to date.*/
+static inline int x86_zf(void)
+{
+        switch (flags_op)
+        {
+                case FLAGS_NONE:
+                return flags_real&Z_FLAG;
+                case FLAGS_ADD8: case FLAGS_SUB8: case FLAGS_LOGIC8:
+                return !(flags_res&0xFF);
+                default:
+                return !(flags_res&0xFFFF);
+        }
+}
+
+static inline void setflags(int op, uint32_t a, uint32_t b, uint32_t c)
+{
+        flags_op=op;
+        flags_a=a;
+        flags_b=b;
+        flags_res=c;
+}
+
 static void setznp8(uint8_t val)
 {
         flags&=~0xC4;
@@ -778,113 +879,86 @@ static void setznp16(uint16_t val)
         flags|=(znptable16[val]&0xC0)|(znptable8[val&0xFF]&4);
 }*/
 
-static void setadd8(uint8_t a, uint8_t b)
+/*Result of AND, OR, XOR and TEST: C, V and A cleared.*/
+static inline void setlogic8(uint8_t val)
+{
+        flags_real&=~C_FLAG;
+        setflags(FLAGS_LOGIC8,0,0,val);
+}
+static inline void setlogic16(uint16_t val)
+{
+        flags_real&=~C_FLAG;
+        setflags(FLAGS_LOGIC16,0,0,val);
+}
+
+static inline void setadd8(uint8_t a, uint8_t b)
 {
         uint16_t c=(uint16_t)a+(uint16_t)b;
-        flags&=~0x8D5;
-        flags|=znptable8[c&0xFF];
-        if (c&0x100) flags|=C_FLAG;
-        if (!((a^b)&0x80)&&((a^c)&0x80)) flags|=V_FLAG;
-        if (((a&0xF)+(b&0xF))&0x10)      flags|=A_FLAG;
+        flags_real=(flags_real&~C_FLAG)|((c>>8)&C_FLAG);
+        setflags(FLAGS_ADD8,a,b,c);
 }
-static void setadd8nc(uint8_t a, uint8_t b)
+static inline void setadd8nc(uint8_t a, uint8_t b)
 {
         uint16_t c=(uint16_t)a+(uint16_t)b;
-        flags&=~0x8D4;
-        flags|=znptable8[c&0xFF];
-        if (!((a^b)&0x80)&&((a^c)&0x80)) flags|=V_FLAG;
-        if (((a&0xF)+(b&0xF))&0x10)      flags|=A_FLAG;
+        setflags(FLAGS_ADD8,a,b,c);
 }
-static void setadc8(uint8_t a, uint8_t b)
+static inline void setadc8(uint8_t a, uint8_t b)
 {
         uint16_t c=(uint16_t)a+(uint16_t)b+tempc;
-        flags&=~0x8D5;
-        flags|=znptable8[c&0xFF];
-        if (c&0x100) flags|=C_FLAG;
-        if (!((a^b)&0x80)&&((a^c)&0x80)) flags|=V_FLAG;
-        if (((a&0xF)+(b&0xF))&0x10)      flags|=A_FLAG;
+        flags_real=(flags_real&~C_FLAG)|((c>>8)&C_FLAG);
+        setflags(FLAGS_ADD8,a,b,c);
 }
-static void setadd16(uint16_t a, uint16_t b)
+static inline void setadd16(uint16_t a, uint16_t b)
 {
         uint32_t c=(uint32_t)a+(uint32_t)b;
-        flags&=~0x8D5;
-        flags|=znptable16[c&0xFFFF];
-        if (c&0x10000) flags|=C_FLAG;
-        if (!((a^b)&0x8000)&&((a^c)&0x8000)) flags|=V_FLAG;
-        if (((a&0xF)+(b&0xF))&0x10)      flags|=A_FLAG;
+        flags_real=(flags_real&~C_FLAG)|((c>>16)&C_FLAG);
+        setflags(FLAGS_ADD16,a,b,c);
 }
-static void setadd16nc(uint16_t a, uint16_t b)
+static inline void setadd16nc(uint16_t a, uint16_t b)
 {
         uint32_t c=(uint32_t)a+(uint32_t)b;
-        flags&=~0x8D4;
-        flags|=znptable16[c&0xFFFF];
-        if (!((a^b)&0x8000)&&((a^c)&0x8000)) flags|=V_FLAG;
-        if (((a&0xF)+(b&0xF))&0x10)      flags|=A_FLAG;
+        setflags(FLAGS_ADD16,a,b,c);
 }
-static void x86setadc16(uint16_t a, uint16_t b)
+static inline void x86setadc16(uint16_t a, uint16_t b)
 {
         uint32_t c=(uint32_t)a+(uint32_t)b+tempc;
-        flags&=~0x8D5;
-        flags|=znptable16[c&0xFFFF];
-        if (c&0x10000) flags|=C_FLAG;
-        if (!((a^b)&0x8000)&&((a^c)&0x8000)) flags|=V_FLAG;
-        if (((a&0xF)+(b&0xF))&0x10)      flags|=A_FLAG;
+        flags_real=(flags_real&~C_FLAG)|((c>>16)&C_FLAG);
+        setflags(FLAGS_ADD16,a,b,c);
 }
 
-static void setsub8(uint8_t a, uint8_t b)
+static inline void setsub8(uint8_t a, uint8_t b)
 {
         uint16_t c=(uint16_t)a-(uint16_t)b;
-        flags&=~0x8D5;
-        flags|=znptable8[c&0xFF];
-        if (c&0x100) flags|=C_FLAG;
-        if ((a^b)&(a^c)&0x80) flags|=V_FLAG;
-        if (((a&0xF)-(b&0xF))&0x10)      flags|=A_FLAG;
+        flags_real=(flags_real&~C_FLAG)|((c>>8)&C_FLAG);
+        setflags(FLAGS_SUB8,a,b,c);
 }
-static void setsub8nc(uint8_t a, uint8_t b)
+static inline void setsub8nc(uint8_t a, uint8_t b)
 {
         uint16_t c=(uint16_t)a-(uint16_t)b;
-        flags&=~0x8D4;
-        flags|=znptable8[c&0xFF];
-        if ((a^b)&(a^c)&0x80) flags|=V_FLAG;
-        if (((a&0xF)-(b&0xF))&0x10)      flags|=A_FLAG;
+        setflags(FLAGS_SUB8,a,b,c);
 }
-static void setsbc8(uint8_t a, uint8_t b)
+static inline void setsbc8(uint8_t a, uint8_t b)
 {
         uint16_t c=(uint16_t)a-(((uint16_t)b)+tempc);
-        flags&=~0x8D5;
-        flags|=znptable8[c&0xFF];
-        if (c&0x100) flags|=C_FLAG;
-        if ((a^b)&(a^c)&0x80) flags|=V_FLAG;
-        if (((a&0xF)-(b&0xF))&0x10)      flags|=A_FLAG;
+        flags_real=(flags_real&~C_FLAG)|((c>>8)&C_FLAG);
+        setflags(FLAGS_SUB8,a,b,c);
 }
-static void setsub16(uint16_t a, uint16_t b)
+static inline void setsub16(uint16_t a, uint16_t b)
 {
         uint32_t c=(uint32_t)a-(uint32_t)b;
-        flags&=~0x8D5;
-        flags|=znptable16[c&0xFFFF];
-        if (c&0x10000) flags|=C_FLAG;
-        if ((a^b)&(a^c)&0x8000) flags|=V_FLAG;
-//        if (x86output) printf("%04X %04X %i\n",a^b,a^c,flags&V_FLAG);
-        if (((a&0xF)-(b&0xF))&0x10)      flags|=A_FLAG;
+        flags_real=(flags_real&~C_FLAG)|((c>>16)&C_FLAG);
+        setflags(FLAGS_SUB16,a,b,c);
 }
-static void setsub16nc(uint16_t a, uint16_t b)
+static inline void setsub16nc(uint16_t a, uint16_t b)
 {
         uint32_t c=(uint32_t)a-(uint32_t)b;
-        flags&=~0x8D4;
-        flags|=(znptable16[c&0xFFFF]&~4);
-        flags|=(znptable8[c&0xFF]&4);
-        if ((a^b)&(a^c)&0x8000) flags|=V_FLAG;
-        if (((a&0xF)-(b&0xF))&0x10)      flags|=A_FLAG;
+        setflags(FLAGS_SUB16,a,b,c);
 }
-static void x86setsbc16(uint16_t a, uint16_t b)
+static inline void x86setsbc16(uint16_t a, uint16_t b)
 {
         uint32_t c=(uint32_t)a-(((uint32_t)b)+tempc);
-        flags&=~0x8D5;
-        flags|=(znptable16[c&0xFFFF]&~4);
-        flags|=(znptable8[c&0xFF]&4);
-        if (c&0x10000) flags|=C_FLAG;
-        if ((a^b)&(a^c)&0x8000) flags|=V_FLAG;
-        if (((a&0xF)-(b&0xF))&0x10)      flags|=A_FLAG;
+        flags_real=(flags_real&~C_FLAG)|((c>>16)&C_FLAG);
+        setflags(FLAGS_SUB16,a,b,c);
 }
 
 static uint8_t inb(uint16_t port)
@@ -969,7 +1043,7 @@ static void rep(int fv)
                 {
                         temp2=readmembl(ds+SI);
                         outb(DX,temp2);
-                        if (flags&D_FLAG) SI--;
+                        if (flags_real&D_FLAG) SI--;
                         else              SI++;
                         c--;
                         cycles-=5;
@@ -983,7 +1057,7 @@ static void rep(int fv)
                         temp2=readmembl(ds+SI);
                         writemembl(es+DI,temp2);
 //                        if (x86output) printf("Moved %02X from %04X:%04X to %04X:%04X\n",temp2,ds>>4,SI,es>>4,DI);
-                        if (flags&D_FLAG) { DI--; SI--; }
+                        if (flags_real&D_FLAG) { DI--; SI--; }
                         else              { DI++; SI++; }
                         c--;
                         cycles-=8;
@@ -997,7 +1071,7 @@ static void rep(int fv)
                 {
                         tempw=readmemwl(ds,SI);
                         writememwl(es,DI,tempw);
-                        if (flags&D_FLAG) { DI-=2; SI-=2; }
+                        if (flags_real&D_FLAG) { DI-=2; SI-=2; }
                         else              { DI+=2; SI+=2; }
                         c--;
                         cycles-=8;
@@ -1014,7 +1088,7 @@ static void rep(int fv)
                         temp=readmembl(ds+SI);
                         temp2=readmembl(es+DI);
 //                        printf("CMPSB %c %c %i %05X %05X %04X:%04X\n",temp,temp2,c,ds+SI,es+DI,cs>>4,pc);
-                        if (flags&D_FLAG) { DI--; SI--; }
+                        if (flags_real&D_FLAG) { DI--; SI--; }
                         else              { DI++; SI++; }
                         c--;
                         cycles-=22;
@@ -1030,7 +1104,7 @@ static void rep(int fv)
                 {
                         tempw=readmemwl(ds,SI);
                         tempw2=readmemwl(es,DI);
-                        if (flags&D_FLAG) { DI-=2; SI-=2; }
+                        if (flags_real&D_FLAG) { DI-=2; SI-=2; }
                         else              { DI+=2; SI+=2; }
                         c--;
                         cycles-=22;
@@ -1043,7 +1117,7 @@ static void rep(int fv)
                 if (c>0)
                 {
                         writemembl(es+DI,AL);
-                        if (flags&D_FLAG) DI--;
+                        if (flags_real&D_FLAG) DI--;
                         else              DI++;
                         c--;
                         cycles-=9;
@@ -1055,7 +1129,7 @@ static void rep(int fv)
                 if (c>0)
                 {
                         writememwl(es,DI,AX);
-                        if (flags&D_FLAG) DI-=2;
+                        if (flags_real&D_FLAG) DI-=2;
                         else              DI+=2;
                         c--;
                         cycles-=9;
@@ -1068,7 +1142,7 @@ static void rep(int fv)
                 if (c>0)
                 {
                         temp2=readmembl(ds+SI);
-                        if (flags&D_FLAG) SI--;
+                        if (flags_real&D_FLAG) SI--;
                         else              SI++;
                         c--;
                         cycles-=4;
@@ -1080,7 +1154,7 @@ static void rep(int fv)
                 if (c>0)
                 {
                         tempw2=readmemwl(ds,SI);
-                        if (flags&D_FLAG) SI-=2;
+                        if (flags_real&D_FLAG) SI-=2;
                         else              SI+=2;
                         c--;
                         cycles-=4;
@@ -1097,7 +1171,7 @@ static void rep(int fv)
 //                        if (x86output) printf("SCASB %02X %c %02X %05X  ",temp2,temp2,AL,es+DI);
                         setsub8(AL,temp2);
 //                        if (x86output && flags&Z_FLAG) printf("Match %02X %02X\n",AL,temp2);
-                        if (flags&D_FLAG) DI--;
+                        if (flags_real&D_FLAG) DI--;
                         else              DI++;
                         c--;
                         cycles-=15;
@@ -1114,7 +1188,7 @@ static void rep(int fv)
                 {
                         tempw=readmemwl(es,DI);
                         setsub16(AX,tempw);
-                        if (flags&D_FLAG) DI-=2;
+                        if (flags_real&D_FLAG) DI-=2;
                         else              DI+=2;
                         c--;
                         cycles-=15;
@@ -1161,7 +1235,7 @@ void x86_exec()
                 if (dbg_x86)
                     debug_preexec(&tubex86_cpu_debug, ea);
                 opcode=readmembl(ea);
-                tempc=flags&C_FLAG;
+                tempc=flags_real&C_FLAG;
 #if 0
                 if (x86output && /*cs<0xF0000 && */!ssegs)//opcode!=0x26 && opcode!=0x36 && opcode!=0x2E && opcode!=0x3E)
                 {
@@ -1249,8 +1323,7 @@ void x86_exec()
                         fetchea();
                         temp=geteab();
                         temp|=getr8(reg);
-                        setznp8(temp);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic8(temp);
                         seteab(temp);
                         tubecycles-=((mod==3)?3:10);
                         break;
@@ -1258,8 +1331,7 @@ void x86_exec()
                         fetchea();
                         tempw=geteaw();
                         tempw|=regs[reg].w;
-                        setznp16(tempw);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic16(tempw);
                         seteaw(tempw);
                         tubecycles-=((mod==3)?3:10);
                         break;
@@ -1267,8 +1339,7 @@ void x86_exec()
                         fetchea();
                         temp=geteab();
                         temp|=getr8(reg);
-                        setznp8(temp);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic8(temp);
                         setr8(reg,temp);
                         tubecycles-=((mod==3)?3:10);
                         break;
@@ -1276,21 +1347,18 @@ void x86_exec()
                         fetchea();
                         tempw=geteaw();
                         tempw|=regs[reg].w;
-                        setznp16(tempw);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic16(tempw);
                         regs[reg].w=tempw;
                         tubecycles-=((mod==3)?3:10);
                         break;
                         case 0x0C: /*OR AL,#8*/
                         AL|=readmembl(cs+pc); pc++;
-                        setznp8(AL);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic8(AL);
                         tubecycles-=4;
                         break;
                         case 0x0D: /*OR AX,#16*/
                         AX|=getword();
-                        setznp16(AX);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic16(AX);
                         tubecycles-=4;
                         break;
 
@@ -1472,8 +1540,7 @@ void x86_exec()
                         fetchea();
                         temp=geteab();
                         temp&=getr8(reg);
-                        setznp8(temp);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic8(temp);
                         seteab(temp);
                         tubecycles-=((mod==3)?3:10);
                         break;
@@ -1481,8 +1548,7 @@ void x86_exec()
                         fetchea();
                         tempw=geteaw();
                         tempw&=regs[reg].w;
-                        setznp16(tempw);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic16(tempw);
                         seteaw(tempw);
                         tubecycles-=((mod==3)?3:10);
                         break;
@@ -1490,8 +1556,7 @@ void x86_exec()
                         fetchea();
                         temp=geteab();
                         temp&=getr8(reg);
-                        setznp8(temp);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic8(temp);
                         setr8(reg,temp);
                         tubecycles-=((mod==3)?3:10);
                         break;
@@ -1499,21 +1564,18 @@ void x86_exec()
                         fetchea();
                         tempw=geteaw();
                         tempw&=regs[reg].w;
-                        setznp16(tempw);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic16(tempw);
                         regs[reg].w=tempw;
                         tubecycles-=((mod==3)?3:10);
                         break;
                         case 0x24: /*AND AL,#8*/
                         AL&=readmembl(cs+pc); pc++;
-                        setznp8(AL);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic8(AL);
                         tubecycles-=4;
                         break;
                         case 0x25: /*AND AX,#16*/
                         AX&=getword();
-                        setznp16(AX);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic16(AX);
                         tubecycles-=4;
                         break;
 
@@ -1612,8 +1674,7 @@ void x86_exec()
                         fetchea();
                         temp=geteab();
                         temp^=getr8(reg);
-                        setznp8(temp);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic8(temp);
                         seteab(temp);
                         tubecycles-=((mod==3)?3:10);
                         break;
@@ -1621,8 +1682,7 @@ void x86_exec()
                         fetchea();
                         tempw=geteaw();
                         tempw^=regs[reg].w;
-                        setznp16(tempw);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic16(tempw);
                         seteaw(tempw);
                         tubecycles-=((mod==3)?3:10);
                         break;
@@ -1630,8 +1690,7 @@ void x86_exec()
                         fetchea();
                         temp=geteab();
                         temp^=getr8(reg);
-                        setznp8(temp);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic8(temp);
                         setr8(reg,temp);
                         tubecycles-=((mod==3)?3:10);
                         break;
@@ -1639,21 +1698,18 @@ void x86_exec()
                         fetchea();
                         tempw=geteaw();
                         tempw^=regs[reg].w;
-                        setznp16(tempw);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic16(tempw);
                         regs[reg].w=tempw;
                         tubecycles-=((mod==3)?3:10);
                         break;
                         case 0x34: /*XOR AL,#8*/
                         AL^=readmembl(cs+pc); pc++;
-                        setznp8(AL);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic8(AL);
                         tubecycles-=4;
                         break;
                         case 0x35: /*XOR AX,#16*/
                         AX^=getword();
-                        setznp16(AX);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic16(AX);
                         tubecycles-=4;
                         break;
 
@@ -1836,13 +1892,13 @@ void x86_exec()
                         case 0x6C: /*INSB*/
                         temp=inb(DX);
                         writemembl(es+DI,temp);
-                        if (flags&D_FLAG) DI--;
+                        if (flags_real&D_FLAG) DI--;
                         else              DI++;
                         tubecycles-=14;
                         break;
                         case 0x6E: /*OUTSB*/
                         temp=readmembl(ds+SI);
-                        if (flags&D_FLAG) SI--;
+                        if (flags_real&D_FLAG) SI--;
                         else              SI++;
                         outb(DX,temp);
                         tubecycles-=14;
@@ -1861,22 +1917,22 @@ void x86_exec()
                         break;
                         case 0x72: /*JB*/
                         offset=(signed char)readmembl(cs+pc); pc++;
-                        if (flags&C_FLAG) { pc+=offset; tubecycles-=9; }
+                        if (flags_real&C_FLAG) { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x73: /*JNB*/
                         offset=(signed char)readmembl(cs+pc); pc++;
-                        if (!(flags&C_FLAG)) { pc+=offset; tubecycles-=9; }
+                        if (!(flags_real&C_FLAG)) { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x74: /*JZ*/
                         offset=(signed char)readmembl(cs+pc); pc++;
-                        if (flags&Z_FLAG) { pc+=offset; tubecycles-=9; }
+                        if (x86_zf()) { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x75: /*JNZ*/
                         offset=(signed char)readmembl(cs+pc); pc++;
-                        if (!(flags&Z_FLAG)) { pc+=offset; tubecycles-=9; }
+                        if (!x86_zf()) { pc+=offset; tubecycles-=9; }
                         tubecycles-=4;
                         break;
                         case 0x76: /*JBE*/
@@ -1951,8 +2007,7 @@ void x86_exec()
                                 break;
                                 case 0x08: /*OR b,#8*/
                                 temp|=temp2;
-                                setznp8(temp);
-                                flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                                setlogic8(temp);
                                 seteab(temp);
                                 tubecycles-=((mod==3)?4:16);
                                 break;
@@ -1970,8 +2025,7 @@ void x86_exec()
                                 break;
                                 case 0x20: /*AND b,#8*/
                                 temp&=temp2;
-                                setznp8(temp);
-                                flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                                setlogic8(temp);
                                 seteab(temp);
                                 tubecycles-=((mod==3)?4:16);
                                 break;
@@ -1982,8 +2036,7 @@ void x86_exec()
                                 break;
                                 case 0x30: /*XOR b,#8*/
                                 temp^=temp2;
-                                setznp8(temp);
-                                flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                                setlogic8(temp);
                                 seteab(temp);
                                 tubecycles-=((mod==3)?4:16);
                                 break;
@@ -2013,8 +2066,7 @@ void x86_exec()
                                 break;
                                 case 0x08: /*OR w,#16*/
                                 tempw|=tempw2;
-                                setznp16(tempw);
-                                flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                                setlogic16(tempw);
                                 seteaw(tempw);
                                 tubecycles-=((mod==3)?4:16);
                                 break;
@@ -2027,8 +2079,7 @@ void x86_exec()
                                 break;
                                 case 0x20: /*AND w,#16*/
                                 tempw&=tempw2;
-                                setznp16(tempw);
-                                flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                                setlogic16(tempw);
                                 seteaw(tempw);
                                 tubecycles-=((mod==3)?4:16);
                                 break;
@@ -2046,8 +2097,7 @@ void x86_exec()
                                 break;
                                 case 0x30: /*XOR w,#16*/
                                 tempw^=tempw2;
-                                setznp16(tempw);
-                                flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                                setlogic16(tempw);
                                 seteaw(tempw);
                                 tubecycles-=((mod==3)?4:16);
                                 break;
@@ -2133,16 +2183,14 @@ void x86_exec()
                         fetchea();
                         temp=geteab();
                         temp2=getr8(reg);
-                        setznp8(temp&temp2);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic8(temp&temp2);
                         tubecycles-=((mod==3)?3:10);
                         break;
                         case 0x85: /*TEST w,reg*/
                         fetchea();
                         tempw=geteaw();
                         tempw2=regs[reg].w;
-                        setznp16(tempw&tempw2);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic16(tempw&tempw2);
                         tubecycles-=((mod==3)?3:10);
                         break;
                         case 0x86: /*XCHG b,reg*/
@@ -2345,14 +2393,14 @@ void x86_exec()
                         case 0xA4: /*MOVSB*/
                         temp=readmembl(ds+SI);
                         writemembl(es+DI,temp);
-                        if (flags&D_FLAG) { DI--; SI--; }
+                        if (flags_real&D_FLAG) { DI--; SI--; }
                         else              { DI++; SI++; }
                         tubecycles-=9;
                         break;
                         case 0xA5: /*MOVSW*/
                         tempw=readmemwl(ds,SI);
                         writememwl(es,DI,tempw);
-                        if (flags&D_FLAG) { DI-=2; SI-=2; }
+                        if (flags_real&D_FLAG) { DI-=2; SI-=2; }
                         else              { DI+=2; SI+=2; }
                         tubecycles-=9;
                         break;
@@ -2360,7 +2408,7 @@ void x86_exec()
                         temp =readmembl(ds+SI);
                         temp2=readmembl(es+DI);
                         setsub8(temp,temp2);
-                        if (flags&D_FLAG) { DI--; SI--; }
+                        if (flags_real&D_FLAG) { DI--; SI--; }
                         else              { DI++; SI++; }
                         tubecycles-=22;
                         break;
@@ -2368,59 +2416,57 @@ void x86_exec()
                         tempw =readmemwl(ds,SI);
                         tempw2=readmemwl(es,DI);
                         setsub16(tempw,tempw2);
-                        if (flags&D_FLAG) { DI-=2; SI-=2; }
+                        if (flags_real&D_FLAG) { DI-=2; SI-=2; }
                         else              { DI+=2; SI+=2; }
                         tubecycles-=22;
                         break;
                         case 0xA8: /*TEST AL,#8*/
                         temp=readmembl(cs+pc); pc++;
-                        setznp8(AL&temp);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic8(AL&temp);
                         tubecycles-=4;
                         break;
                         case 0xA9: /*TEST AX,#16*/
                         tempw=getword();
-                        setznp16(AX&tempw);
-                        flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                        setlogic16(AX&tempw);
                         tubecycles-=4;
                         break;
                         case 0xAA: /*STOSB*/
                         writemembl(es+DI,AL);
-                        if (flags&D_FLAG) DI--;
+                        if (flags_real&D_FLAG) DI--;
                         else              DI++;
                         tubecycles-=10;
                         break;
                         case 0xAB: /*STOSW*/
                         writememwl(es,DI,AX);
-                        if (flags&D_FLAG) DI-=2;
+                        if (flags_real&D_FLAG) DI-=2;
                         else              DI+=2;
                         tubecycles-=10;
                         break;
                         case 0xAC: /*LODSB*/
                         AL=readmembl(ds+SI);
 //                        printf("LODSB %04X:%04X %02X %04X:%04X\n",cs>>4,pc,AL,ds>>4,SI);
-                        if (flags&D_FLAG) SI--;
+                        if (flags_real&D_FLAG) SI--;
                         else              SI++;
                         tubecycles-=10;
                         break;
                         case 0xAD: /*LODSW*/
 //                        if (times) printf("LODSW %04X:%04X\n",cs>>4,pc);
                         AX=readmemwl(ds,SI);
-                        if (flags&D_FLAG) SI-=2;
+                        if (flags_real&D_FLAG) SI-=2;
                         else              SI+=2;
                         tubecycles-=10;
                         break;
                         case 0xAE: /*SCASB*/
                         temp=readmembl(es+DI);
                         setsub8(AL,temp);
-                        if (flags&D_FLAG) DI--;
+                        if (flags_real&D_FLAG) DI--;
                         else              DI++;
                         tubecycles-=15;
                         break;
                         case 0xAF: /*SCASW*/
                         tempw=readmemwl(es,DI);
                         setsub16(AX,tempw);
-                        if (flags&D_FLAG) DI-=2;
+                        if (flags_real&D_FLAG) DI-=2;
                         else              DI+=2;
                         tubecycles-=15;
                         break;
@@ -3459,8 +3505,7 @@ void x86_exec()
                                 case 0x00: /*TEST b,#8*/
                                 temp2=readmembl(cs+pc); pc++;
                                 temp&=temp2;
-                                setznp8(temp);
-                                flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                                setlogic8(temp);
                                 tubecycles-=((mod==3)?4:10);
                                 break;
                                 case 0x10: /*NOT b*/
@@ -3590,8 +3635,7 @@ void x86_exec()
                         {
                                 case 0x00: /*TEST w*/
                                 tempw2=getword();
-                                setznp16(tempw&tempw2);
-                                flags&=~(C_FLAG|V_FLAG|A_FLAG);
+                                setlogic16(tempw&tempw2);
                                 tubecycles-=((mod==3)?4:10);
                                 break;
                                 case 0x10: /*NOT w*/
@@ -3884,7 +3928,7 @@ void x86_exec()
 
 x86ins++;
 //if (x86ins==65300000) x86output=1;
-                if ((flags&I_FLAG) && !ssegs && (tube_irq&1))
+                if ((flags_real&I_FLAG) && !ssegs && (tube_irq&1))
                 {
                         if (inhlt) pc++;
                         writememwl(ss,(SP-2)&0xFFFF,flags|0xF000);
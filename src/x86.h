@@ -57,7 +57,14 @@ typedef union
 } x86reg;
 
 static x86reg regs[8];
-static uint16_t flags;
+/*All flags but carry are worked out lazily.  Arithmetic and logical
+  operations record their operands and result and flags is only brought
+  up to date when something reads it, see x86_flags_ref in x86.c.*/
+static uint16_t flags_real;
+static uint8_t flags_op;
+static uint32_t flags_a, flags_b, flags_res;
+static uint16_t *x86_flags_ref(void);
+#define flags (*x86_flags_ref())
 static uint32_t oldds,oldss,x86pc;
 
 typedef struct
@@ -0,0 +1,2837 @@
+/*B-em v2.2 by Tom Walker
+  Z80 execution loop.
+
+  Not a normal header: z80.c includes this once with CORE_DEBUG set to
+  1 and once with it set to 0, CORE_NAME giving each copy its own names.
+  With CORE_DEBUG at 0 the debugger hooks are compiled out altogether.
+  See dispatch.h for how the opcode switches are entered.*/
+
+#define z80_readmem  CORE_NAME(z80_readmem)
+#define z80_writemem CORE_NAME(z80_writemem)
+#define z80_fetch    CORE_NAME(z80_fetch)
+#define z80_exec     CORE_NAME(z80_exec)
+
+static inline uint8_t z80_readmem(uint16_t a)
+{
+        uint8_t v = z80_do_readmem(a);
+#if CORE_DEBUG
+        if (dbg_tube_z80)
+                debug_memread(&tubez80_cpu_debug, a, v, 1);
+#endif
+        return v;
+}
+
+static inline void z80_writemem(uint16_t a, uint8_t v)
+{
+#if CORE_DEBUG
+        if (dbg_tube_z80)
+                debug_memwrite(&tubez80_cpu_debug, a, v, 1);
+#endif
+        z80_do_writemem(a, v);
+}
+
+static inline uint8_t z80_fetch(void)
+{
+        oopc=opc;
+        opc=pc;
+        cycles=0;
+#if CORE_DEBUG
+        if (dbg_tube_z80)
+                debug_preexec(&tubez80_cpu_debug, pc);
+#endif
+        tempc=af.b.l&C_FLAG;
+        ir.b.l=((ir.b.l+1)&0x7F)|(ir.b.l&0x80);
+        return z80_readmem(pc++);
+}
+
+/*Finishes an instruction in the main opcode switch.  Threaded, unless
+  an interrupt, NMI or trace output needs the tail at the bottom of the
+  loop, the next instruction is fetched and dispatched from here.*/
+
+#ifdef THREADED_DISPATCH
+#define NEXT \
+        if (enterint || output || (tube_irq&2)) \
+                break; \
+        ins++; \
+        z80_oldnmi=0; \
+        tubecycles-=cycles; \
+        if (tubecycles<=0) \
+                return; \
+        if ((tube_irq&1) && iff1) enterint=1; \
+        opcode=z80_fetch(); \
+        goto *main_tbl[opcode]
+#else
+#define NEXT break
+#endif
+
+static void z80_exec(void)
+{
+        uint8_t opcode,temp;
+        uint16_t addr=0;
+        int enterint=0;
+#ifdef THREADED_DISPATCH
+        static const void *const main_tbl[256] = {
+            &&main_0x00, &&main_0x01, &&main_0x02, &&main_0x03, &&main_0x04, &&main_0x05, &&main_0x06, &&main_0x07,
+            &&main_0x08, &&main_0x09, &&main_0x0A, &&main_0x0B, &&main_0x0C, &&main_0x0D, &&main_0x0E, &&main_0x0F,
+            &&main_0x10, &&main_0x11, &&main_0x12, &&main_0x13, &&main_0x14, &&main_0x15, &&main_0x16, &&main_0x17,
+            &&main_0x18, &&main_0x19, &&main_0x1A, &&main_0x1B, &&main_0x1C, &&main_0x1D, &&main_0x1E, &&main_0x1F,
+            &&main_0x20, &&main_0x21, &&main_0x22, &&main_0x23, &&main_0x24, &&main_0x25, &&main_0x26, &&main_0x27,
+            &&main_0x28, &&main_0x29, &&main_0x2A, &&main_0x2B, &&main_0x2C, &&main_0x2D, &&main_0x2E, &&main_0x2F,
+            &&main_0x30, &&main_0x31, &&main_0x32, &&main_0x33, &&main_0x34, &&main_0x35, &&main_0x36, &&main_0x37,
+            &&main_0x38, &&main_0x39, &&main_0x3A, &&main_0x3B, &&main_0x3C, &&main_0x3D, &&main_0x3E, &&main_0x3F,
+            &&main_0x40, &&main_0x41, &&main_0x42, &&main_0x43, &&main_0x44, &&main_0x45, &&main_0x46, &&main_0x47,
+            &&main_0x48, &&main_0x49, &&main_0x4A, &&main_0x4B, &&main_0x4C, &&main_0x4D, &&main_0x4E, &&main_0x4F,
+            &&main_0x50, &&main_0x51, &&main_0x52, &&main_0x53, &&main_0x54, &&main_0x55, &&main_0x56, &&main_0x57,
+            &&main_0x58, &&main_0x59, &&main_0x5A, &&main_0x5B, &&main_0x5C, &&main_0x5D, &&main_0x5E, &&main_0x5F,
+            &&main_0x60, &&main_0x61, &&main_0x62, &&main_0x63, &&main_0x64, &&main_0x65, &&main_0x66, &&main_0x67,
+            &&main_0x68, &&main_0x69, &&main_0x6A, &&main_0x6B, &&main_0x6C, &&main_0x6D, &&main_0x6E, &&main_0x6F,
+            &&main_0x70, &&main_0x71, &&main_0x72, &&main_0x73, &&main_0x74, &&main_0x75, &&main_0x76, &&main_0x77,
+            &&main_0x78, &&main_0x79, &&main_0x7A, &&main_0x7B, &&main_0x7C, &&main_0x7D, &&main_0x7E, &&main_0x7F,
+            &&main_0x80, &&main_0x81, &&main_0x82, &&main_0x83, &&main_0x84, &&main_0x85, &&main_0x86, &&main_0x87,
+            &&main_0x88, &&main_0x89, &&main_0x8A, &&main_0x8B, &&main_0x8C, &&main_0x8D, &&main_0x8E, &&main_0x8F,
+            &&main_0x90, &&main_0x91, &&main_0x92, &&main_0x93, &&main_0x94, &&main_0x95, &&main_0x96, &&main_0x97,
+            &&main_0x98, &&main_0x99, &&main_0x9A, &&main_0x9B, &&main_0x9C, &&main_0x9D, &&main_0x9E, &&main_0x9F,
+            &&main_0xA0, &&main_0xA1, &&main_0xA2, &&main_0xA3, &&main_0xA4, &&main_0xA5, &&main_0xA6, &&main_0xA7,
+            &&main_0xA8, &&main_0xA9, &&main_0xAA, &&main_0xAB, &&main_0xAC, &&main_0xAD, &&main_0xAE, &&main_0xAF,
+            &&main_0xB0, &&main_0xB1, &&main_0xB2, &&main_0xB3, &&main_0xB4, &&main_0xB5, &&main_0xB6, &&main_0xB7,
+            &&main_0xB8, &&main_0xB9, &&main_0xBA, &&main_0xBB, &&main_0xBC, &&main_0xBD, &&main_0xBE, &&main_0xBF,
+            &&main_0xC0, &&main_0xC1, &&main_0xC2, &&main_0xC3, &&main_0xC4, &&main_0xC5, &&main_0xC6, &&main_0xC7,
+            &&main_0xC8, &&main_0xC9, &&main_0xCA, &&main_0xCB, &&main_0xCC, &&main_0xCD, &&main_0xCE, &&main_0xCF,
+            &&main_0xD0, &&main_0xD1, &&main_0xD2, &&main_0xD3, &&main_0xD4, &&main_0xD5, &&main_0xD6, &&main_0xD7,
+            &&main_0xD8, &&main_0xD9, &&main_0xDA, &&main_0xDB, &&main_0xDC, &&main_0xDD, &&main_0xDE, &&main_0xDF,
+            &&main_0xE0, &&main_0xE1, &&main_0xE2, &&main_0xE3, &&main_0xE4, &&main_0xE5, &&main_0xE6, &&main_0xE7,
+            &&main_0xE8, &&main_0xE9, &&main_0xEA, &&main_0xEB, &&main_0xEC, &&main_0xED, &&main_0xEE, &&main_0xEF,
+            &&main_0xF0, &&main_0xF1, &&main_0xF2, &&main_0xF3, &&main_0xF4, &&main_0xF5, &&main_0xF6, &&main_0xF7,
+            &&main_0xF8, &&main_0xF9, &&main_0xFA, &&main_0xFB, &&main_0xFC, &&main_0xFD, &&main_0xFE, &&main_0xFF
+        };
+        static const void *const cb_tbl[256] = {
+            &&cb_0x00, &&cb_0x01, &&cb_0x02, &&cb_0x03, &&cb_0x04, &&cb_0x05, &&cb_0x06, &&cb_0x07,
+            &&cb_0x08, &&cb_0x09, &&cb_0x0A, &&cb_0x0B, &&cb_0x0C, &&cb_0x0D, &&cb_0x0E, &&cb_0x0F,
+            &&cb_0x10, &&cb_0x11, &&cb_0x12, &&cb_0x13, &&cb_0x14, &&cb_0x15, &&cb_0x16, &&cb_0x17,
+            &&cb_0x18, &&cb_0x19, &&cb_0x1A, &&cb_0x1B, &&cb_0x1C, &&cb_0x1D, &&cb_0x1E, &&cb_0x1F,
+            &&cb_0x20, &&cb_0x21, &&cb_0x22, &&cb_0x23, &&cb_0x24, &&cb_0x25, &&cb_0x26, &&cb_0x27,
+            &&cb_0x28, &&cb_0x29, &&cb_0x2A, &&cb_0x2B, &&cb_0x2C, &&cb_0x2D, &&cb_0x2E, &&cb_0x2F,
+            &&cb_0x30, &&cb_0x31, &&cb_0x32, &&cb_0x33, &&cb_0x34, &&cb_0x35, &&cb_0x36, &&cb_0x37,
+            &&cb_0x38, &&cb_0x39, &&cb_0x3A, &&cb_0x3B, &&cb_0x3C, &&cb_0x3D, &&cb_0x3E, &&cb_0x3F,
+            &&cb_0x40, &&cb_0x41, &&cb_0x42, &&cb_0x43, &&cb_0x44, &&cb_0x45, &&cb_0x46, &&cb_0x47,
+            &&cb_0x48, &&cb_0x49, &&cb_0x4A, &&cb_0x4B, &&cb_0x4C, &&cb_0x4D, &&cb_0x4E, &&cb_0x4F,
+            &&cb_0x50, &&cb_0x51, &&cb_0x52, &&cb_0x53, &&cb_0x54, &&cb_0x55, &&cb_0x56, &&cb_0x57,
+            &&cb_0x58, &&cb_0x59, &&cb_0x5A, &&cb_0x5B, &&cb_0x5C, &&cb_0x5D, &&cb_0x5E, &&cb_0x5F,
+            &&cb_0x60, &&cb_0x61, &&cb_0x62, &&cb_0x63, &&cb_0x64, &&cb_0x65, &&cb_0x66, &&cb_0x67,
+            &&cb_0x68, &&cb_0x69, &&cb_0x6A, &&cb_0x6B, &&cb_0x6C, &&cb_0x6D, &&cb_0x6E, &&cb_0x6F,
+            &&cb_0x70, &&cb_0x71, &&cb_0x72, &&cb_0x73, &&cb_0x74, &&cb_0x75, &&cb_0x76, &&cb_0x77,
+            &&cb_0x78, &&cb_0x79, &&cb_0x7A, &&cb_0x7B, &&cb_0x7C, &&cb_0x7D, &&cb_0x7E, &&cb_0x7F,
+            &&cb_0x80, &&cb_0x81, &&cb_0x82, &&cb_0x83, &&cb_0x84, &&cb_0x85, &&cb_0x86, &&cb_0x87,
+            &&cb_0x88, &&cb_0x89, &&cb_0x8A, &&cb_0x8B, &&cb_0x8C, &&cb_0x8D, &&cb_0x8E, &&cb_0x8F,
+            &&cb_0x90, &&cb_0x91, &&cb_0x92, &&cb_0x93, &&cb_0x94, &&cb_0x95, &&cb_0x96, &&cb_0x97,
+            &&cb_0x98, &&cb_0x99, &&cb_0x9A, &&cb_0x9B, &&cb_0x9C, &&cb_0x9D, &&cb_0x9E, &&cb_0x9F,
+            &&cb_0xA0, &&cb_0xA1, &&cb_0xA2, &&cb_0xA3, &&cb_0xA4, &&cb_0xA5, &&cb_0xA6, &&cb_0xA7,
+            &&cb_0xA8, &&cb_0xA9, &&cb_0xAA, &&cb_0xAB, &&cb_0xAC, &&cb_0xAD, &&cb_0xAE, &&cb_0xAF,
+            &&cb_0xB0, &&cb_0xB1, &&cb_0xB2, &&cb_0xB3, &&cb_0xB4, &&cb_0xB5, &&cb_0xB6, &&cb_0xB7,
+            &&cb_0xB8, &&cb_0xB9, &&cb_0xBA, &&cb_0xBB, &&cb_0xBC, &&cb_0xBD, &&cb_0xBE, &&cb_0xBF,
+            &&cb_0xC0, &&cb_0xC1, &&cb_0xC2, &&cb_0xC3, &&cb_0xC4, &&cb_0xC5, &&cb_0xC6, &&cb_0xC7,
+            &&cb_0xC8, &&cb_0xC9, &&cb_0xCA, &&cb_0xCB, &&cb_0xCC, &&cb_0xCD, &&cb_0xCE, &&cb_0xCF,
+            &&cb_0xD0, &&cb_0xD1, &&cb_0xD2, &&cb_0xD3, &&cb_0xD4, &&cb_0xD5, &&cb_0xD6, &&cb_0xD7,
+            &&cb_0xD8, &&cb_0xD9, &&cb_0xDA, &&cb_0xDB, &&cb_0xDC, &&cb_0xDD, &&cb_0xDE, &&cb_0xDF,
+            &&cb_0xE0, &&cb_0xE1, &&cb_0xE2, &&cb_0xE3, &&cb_0xE4, &&cb_0xE5, &&cb_0xE6, &&cb_0xE7,
+            &&cb_0xE8, &&cb_0xE9, &&cb_0xEA, &&cb_0xEB, &&cb_0xEC, &&cb_0xED, &&cb_0xEE, &&cb_0xEF,
+            &&cb_0xF0, &&cb_0xF1, &&cb_0xF2, &&cb_0xF3, &&cb_0xF4, &&cb_0xF5, &&cb_0xF6, &&cb_0xF7,
+            &&cb_0xF8, &&cb_0xF9, &&cb_0xFA, &&cb_0xFB, &&cb_0xFC, &&cb_0xFD, &&cb_0xFE, &&cb_0xFF
+        };
+        static const void *const dd_tbl[256] = {
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+            &&dd_default, &&dd_0x09, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+            &&dd_default, &&dd_0x19, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+            &&dd_default, &&dd_0x21, &&dd_0x22, &&dd_0x23, &&dd_0x24, &&dd_0x25, &&dd_0x26, &&dd_default,
+            &&dd_default, &&dd_0x29, &&dd_0x2A, &&dd_0x2B, &&dd_0x2C, &&dd_0x2D, &&dd_0x2E, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x34, &&dd_0x35, &&dd_0x36, &&dd_default,
+            &&dd_default, &&dd_0x39, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x44, &&dd_0x45, &&dd_0x46, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x4E, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x54, &&dd_0x55, &&dd_0x56, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x5C, &&dd_0x5D, &&dd_0x5E, &&dd_default,
+            &&dd_0x60, &&dd_0x61, &&dd_0x62, &&dd_0x63, &&dd_0x64, &&dd_0x65, &&dd_0x66, &&dd_0x67,
+            &&dd_0x68, &&dd_0x69, &&dd_0x6A, &&dd_0x6B, &&dd_0x6C, &&dd_0x6D, &&dd_0x6E, &&dd_0x6F,
+            &&dd_0x70, &&dd_0x71, &&dd_0x72, &&dd_0x73, &&dd_0x74, &&dd_0x75, &&dd_default, &&dd_0x77,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x7C, &&dd_0x7D, &&dd_0x7E, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x84, &&dd_0x85, &&dd_0x86, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x8C, &&dd_0x8D, &&dd_0x8E, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x94, &&dd_0x95, &&dd_0x96, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0x9C, &&dd_0x9D, &&dd_0x9E, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0xA4, &&dd_0xA5, &&dd_0xA6, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0xAC, &&dd_0xAD, &&dd_0xAE, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0xB4, &&dd_0xB5, &&dd_0xB6, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_0xBC, &&dd_0xBD, &&dd_0xBE, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_0xCB, &&dd_default, &&dd_0xCD, &&dd_default, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+            &&dd_default, &&dd_0xE1, &&dd_default, &&dd_0xE3, &&dd_default, &&dd_0xE5, &&dd_default, &&dd_default,
+            &&dd_default, &&dd_0xE9, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+            &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+            &&dd_default, &&dd_0xF9, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default, &&dd_default
+        };
+        static const void *const ddcb_tbl[256] = {
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x06, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x0E, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x16, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x1E, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x26, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x2E, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x3E, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x46, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x4E, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x56, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x5E, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x66, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x6E, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x76, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x7E, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x86, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x8E, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x96, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0x9E, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0xA6, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0xAE, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0xB6, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0xBE, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0xC6, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0xCE, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0xD6, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0xDE, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0xE6, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0xEE, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0xF6, &&ddcb_default,
+            &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_default, &&ddcb_0xFE, &&ddcb_default
+        };
+        static const void *const ed_tbl[256] = {
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_0x40, &&ed_default, &&ed_0x42, &&ed_0x43, &&ed_0x44, &&ed_0x45, &&ed_default, &&ed_0x47,
+            &&ed_default, &&ed_default, &&ed_0x4A, &&ed_0x4B, &&ed_default, &&ed_0x4D, &&ed_default, &&ed_0x4F,
+            &&ed_0x50, &&ed_0x51, &&ed_0x52, &&ed_0x53, &&ed_default, &&ed_default, &&ed_0x56, &&ed_0x57,
+            &&ed_0x58, &&ed_0x59, &&ed_0x5A, &&ed_0x5B, &&ed_default, &&ed_default, &&ed_0x5E, &&ed_0x5F,
+            &&ed_0x60, &&ed_0x61, &&ed_0x62, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_0x67,
+            &&ed_default, &&ed_0x69, &&ed_0x6A, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_0x6F,
+            &&ed_default, &&ed_default, &&ed_0x72, &&ed_0x73, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_0x78, &&ed_0x79, &&ed_0x7A, &&ed_0x7B, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_0xA0, &&ed_0xA1, &&ed_0xA2, &&ed_0xA3, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_0xA8, &&ed_default, &&ed_default, &&ed_0xAB, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_0xB0, &&ed_0xB1, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_0xB8, &&ed_0xB9, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+            &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default, &&ed_default
+        };
+        static const void *const fd_tbl[256] = {
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+            &&fd_default, &&fd_0x09, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+            &&fd_default, &&fd_0x19, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+            &&fd_default, &&fd_0x21, &&fd_0x22, &&fd_0x23, &&fd_0x24, &&fd_0x25, &&fd_0x26, &&fd_default,
+            &&fd_default, &&fd_0x29, &&fd_0x2A, &&fd_0x2B, &&fd_0x2C, &&fd_0x2D, &&fd_0x2E, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x34, &&fd_0x35, &&fd_0x36, &&fd_default,
+            &&fd_default, &&fd_0x39, &&fd_0x3A, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x44, &&fd_0x45, &&fd_0x46, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x4C, &&fd_0x4D, &&fd_0x4E, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x54, &&fd_0x55, &&fd_0x56, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x5C, &&fd_0x5D, &&fd_0x5E, &&fd_default,
+            &&fd_0x60, &&fd_0x61, &&fd_0x62, &&fd_0x63, &&fd_0x64, &&fd_0x65, &&fd_0x66, &&fd_0x67,
+            &&fd_0x68, &&fd_0x69, &&fd_0x6A, &&fd_0x6B, &&fd_0x6C, &&fd_0x6D, &&fd_0x6E, &&fd_0x6F,
+            &&fd_0x70, &&fd_0x71, &&fd_0x72, &&fd_0x73, &&fd_0x74, &&fd_0x75, &&fd_default, &&fd_0x77,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x7C, &&fd_0x7D, &&fd_0x7E, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x84, &&fd_0x85, &&fd_0x86, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x8C, &&fd_0x8D, &&fd_0x8E, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x94, &&fd_0x95, &&fd_0x96, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0x9C, &&fd_0x9D, &&fd_0x9E, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0xA4, &&fd_0xA5, &&fd_0xA6, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0xAC, &&fd_0xAD, &&fd_0xAE, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0xB4, &&fd_0xB5, &&fd_0xB6, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_0xBC, &&fd_0xBD, &&fd_0xBE, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_0xCB, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+            &&fd_default, &&fd_0xE1, &&fd_default, &&fd_0xE3, &&fd_default, &&fd_0xE5, &&fd_default, &&fd_default,
+            &&fd_default, &&fd_0xE9, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+            &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+            &&fd_default, &&fd_0xF9, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default, &&fd_default
+        };
+        static const void *const fdcb_tbl[256] = {
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x06, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x0E, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x16, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x1E, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x2E, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x46, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x4E, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x56, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x5E, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x66, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x6E, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x76, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x7E, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x86, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x8E, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x96, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0x9E, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0xA6, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0xAE, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0xB6, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0xBE, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0xC6, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0xCE, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0xD6, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0xDE, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0xE6, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0xEE, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0xF6, &&fdcb_default,
+            &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_default, &&fdcb_0xFE, &&fdcb_default
+        };
+#endif
+//        tubecycles+=(cy<<1);
+        while (tubecycles>0)
+        {
+                if ((tube_irq&1) && iff1) enterint=1;
+                opcode=z80_fetch();
+                DISPATCH(main, opcode)
+                {
+                        OP(main, 0x00): /*NOP*/
+                        cycles+=4;
+//                        printf("NOP!\n");
+//                        z80_dumpregs();
+//                        exit(-1);
+                        NEXT;
+                        OP(main, 0x01): /*LD BC,nn*/
+                        cycles+=4; bc.b.l=z80_readmem(pc++);
+                        cycles+=3; bc.b.h=z80_readmem(pc++);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x02): /*LD (BC),A*/
+                        cycles+=4; z80_writemem(bc.w,af.b.h);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x03): /*INC BC*/
+                        bc.w++;
+                        cycles+=6;
+                        NEXT;
+                        OP(main, 0x04): /*INC B*/
+                        setinc(bc.b.h);
+                        bc.b.h++;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x05): /*DEC B*/
+                        setdec(bc.b.h);
+                        bc.b.h--;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x06): /*LD B,nn*/
+                        cycles+=4; bc.b.h=z80_readmem(pc++);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x07): /*RLCA*/
+                        temp=af.b.h&0x80;
+                        af.b.h<<=1;
+                        if (temp) af.b.h|=1;
+//                        setzn(af.b.h);
+                        if (temp) flags|=C_FLAG;
+                        else      flags&=~C_FLAG;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x08): /*EX AF,AF'*/
+                        z80_flags_ref();
+                        addr=af.w; af.w=saf.w; saf.w=addr;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x09): /*ADD HL,BC*/
+                        intreg=hl.b.h;
+                        z80_setadd16(hl.w,bc.w);
+                        hl.w+=bc.w;
+                        cycles+=11;
+                        NEXT;
+                        OP(main, 0x0A): /*LD A,(BC)*/
+                        cycles+=4; af.b.h=z80_readmem(bc.w);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x0B): /*DEC BC*/
+                        bc.w--;
+                        cycles+=6;
+                        NEXT;
+                        OP(main, 0x0C): /*INC C*/
+                        setinc(bc.b.l);
+                        bc.b.l++;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x0D): /*DEC C*/
+                        setdec(bc.b.l);
+                        bc.b.l--;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x0E): /*LD C,nn*/
+                        cycles+=4; bc.b.l=z80_readmem(pc++);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x0F): /*RRCA*/
+                        temp=af.b.h&1;
+                        af.b.h>>=1;
+                        if (temp) af.b.h|=0x80;
+//                        setzn(af.b.h);
+                        if (temp) flags|=C_FLAG;
+                        else      flags&=~C_FLAG;
+                        cycles+=4;
+                        NEXT;
+
+                        OP(main, 0x10): /*DJNZ*/
+                        cycles+=5; addr=z80_readmem(pc++);
+                        if (addr&0x80) addr|=0xFF00;
+                        if (--bc.b.h)
+                        {
+                                pc+=addr;
+                                cycles+=8;
+                        }
+                        else
+                           cycles+=3;
+                        NEXT;
+                        OP(main, 0x11): /*LD DE,nn*/
+                        cycles+=4; de.b.l=z80_readmem(pc++);
+                        cycles+=3; de.b.h=z80_readmem(pc++);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x12): /*LD (DE),A*/
+                        cycles+=4; z80_writemem(de.w,af.b.h);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x13): /*INC DE*/
+                        de.w++;
+                        cycles+=6;
+                        NEXT;
+                        OP(main, 0x14): /*INC D*/
+                        setinc(de.b.h);
+                        de.b.h++;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x15): /*DEC D*/
+                        setdec(de.b.h);
+                        de.b.h--;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x16): /*LD D,nn*/
+                        cycles+=4; de.b.h=z80_readmem(pc++);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x17): /*RLA*/
+                        temp=af.b.h&0x80;
+                        af.b.h<<=1;
+                        if (tempc) af.b.h|=1;
+//                        setzn(af.b.h);
+                        if (temp) flags|=C_FLAG;
+                        else      flags&=~C_FLAG;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x18): /*JR*/
+                        cycles+=4; addr=z80_readmem(pc++);
+                        if (addr&0x80) addr|=0xFF00;
+                        pc+=addr;
+                        intreg=pc>>8;
+                        cycles+=8;
+                        NEXT;
+                        OP(main, 0x19): /*ADD HL,DE*/
+                        intreg=hl.b.h;
+                        z80_setadd16(hl.w,de.w);
+                        hl.w+=de.w;
+                        cycles+=11;
+                        NEXT;
+                        OP(main, 0x1A): /*LD A,(DE)*/
+                        cycles+=4; af.b.h=z80_readmem(de.w);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x1B): /*DEC DE*/
+                        de.w--;
+                        cycles+=6;
+                        NEXT;
+                        OP(main, 0x1C): /*INC E*/
+                        setinc(de.b.l);
+                        de.b.l++;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x1D): /*DEC E*/
+                        setdec(de.b.l);
+                        de.b.l--;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x1E): /*LD E,nn*/
+                        cycles+=4; de.b.l=z80_readmem(pc++);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x1F): /*RRA*/
+                        temp=af.b.h&1;
+                        af.b.h>>=1;
+                        if (tempc) af.b.h|=0x80;
+//                        setzn(af.b.h);
+                        if (temp) flags|=C_FLAG;
+                        else      flags&=~C_FLAG;
+                        cycles+=4;
+                        NEXT;
+
+                        OP(main, 0x20): /*JR NZ*/
+                        cycles+=4; addr=z80_readmem(pc++);
+                        if (addr&0x80) addr|=0xFF00;
+                        if (!(flags&Z_FLAG))
+                        {
+                                pc+=addr;
+                                cycles+=8;
+                        }
+                        else
+                           cycles+=3;
+                        NEXT;
+                        OP(main, 0x21): /*LD HL,nn*/
+                        cycles+=4; hl.b.l=z80_readmem(pc++);
+                        cycles+=3; hl.b.h=z80_readmem(pc++);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x22): /*LD (nn),HL*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        cycles+=3; z80_writemem(addr,hl.b.l);
+                        cycles+=3; z80_writemem(addr+1,hl.b.h);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x23): /*INC HL*/
+                        hl.w++;
+                        cycles+=6;
+                        NEXT;
+                        OP(main, 0x24): /*INC H*/
+                        setinc(hl.b.h);
+                        hl.b.h++;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x25): /*DEC H*/
+                        setdec(hl.b.h);
+                        hl.b.h--;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x26): /*LD H,nn*/
+                        cycles+=4; hl.b.h=z80_readmem(pc++);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x27): /*DAA*/
+                        addr=af.b.h;
+                        if (flags&C_FLAG) addr|=256;
+                        if (flags&H_FLAG) addr|=512;
+                        if (flags&S_FLAG) addr|=1024;
+                        af.w=DAATable[addr];
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x28): /*JR Z*/
+                        cycles+=4; addr=z80_readmem(pc++);
+                        if (addr&0x80) addr|=0xFF00;
+                        if (flags&Z_FLAG)
+                        {
+                                pc+=addr;
+                                cycles+=8;
+                        }
+                        else
+                           cycles+=3;
+                        NEXT;
+                        OP(main, 0x29): /*ADD HL,HL*/
+                        intreg=hl.b.h;
+                        z80_setadd16(hl.w,hl.w);
+                        hl.w+=hl.w;
+                        cycles+=11;
+                        NEXT;
+                        OP(main, 0x2A): /*LD HL,(nn)*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        cycles+=3; hl.b.l=z80_readmem(addr);
+                        cycles+=3; hl.b.h=z80_readmem(addr+1);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x2B): /*DEC HL*/
+                        hl.w--;
+                        cycles+=6;
+                        NEXT;
+                        OP(main, 0x2C): /*INC L*/
+                        setinc(hl.b.l);
+                        hl.b.l++;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x2D): /*DEC L*/
+                        setdec(hl.b.l);
+                        hl.b.l--;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x2E): /*LD L,nn*/
+                        cycles+=4; hl.b.l=z80_readmem(pc++);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x2F): /*CPL*/
+                        af.b.h^=0xFF;
+                        flags|=(H_FLAG|S_FLAG);
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x30): /*JR NC*/
+                        cycles+=4; addr=z80_readmem(pc++);
+                        if (addr&0x80) addr|=0xFF00;
+                        if (!(flags&C_FLAG))
+                        {
+                                pc+=addr;
+                                cycles+=8;
+                        }
+                        else
+                           cycles+=3;
+                        NEXT;
+                        OP(main, 0x31): /*LD SP,nn*/
+                        cycles+=4; temp=z80_readmem(pc++);
+                        cycles+=3; sp=(z80_readmem(pc++)<<8)|temp;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x32): /*LD (nn),A*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        cycles+=3; z80_writemem(addr,af.b.h);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x33): /*INC SP*/
+                        sp++;
+                        cycles+=6;
+                        NEXT;
+                        OP(main, 0x34): /*INC (HL)*/
+                        cycles+=4; temp=z80_readmem(hl.w);
+                        setinc(temp);
+                        cycles+=3; z80_writemem(hl.w,temp+1);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x35): /*DEC (HL)*/
+                        cycles+=4; temp=z80_readmem(hl.w);
+                        setdec(temp);
+                        cycles+=3; z80_writemem(hl.w,temp-1);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x36): /*LD (HL),nn*/
+                        cycles+=4; temp=z80_readmem(pc++);
+                        cycles+=3; z80_writemem(hl.w,temp);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x37): /*SCF*/
+                        flags|=C_FLAG;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x38): /*JR C*/
+                        cycles+=4; addr=z80_readmem(pc++);
+                        if (addr&0x80) addr|=0xFF00;
+                        if (flags&C_FLAG)
+                        {
+                                pc+=addr;
+                                cycles+=8;
+                        }
+                        else
+                           cycles+=3;
+                        NEXT;
+                        OP(main, 0x39): /*ADD HL,SP*/
+                        intreg=hl.b.h;
+                        z80_setadd16(hl.w,sp);
+                        hl.w+=sp;
+                        cycles+=11;
+                        NEXT;
+                        OP(main, 0x3A): /*LD A,(nn)*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        cycles+=3; af.b.h=z80_readmem(addr);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x3B): /*DEC SP*/
+                        sp--;
+                        cycles+=6;
+                        NEXT;
+                        OP(main, 0x3C): /*INC A*/
+                        setinc(af.b.h);
+                        af.b.h++;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x3D): /*DEC A*/
+                        setdec(af.b.h);
+                        af.b.h--;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0x3E): /*LD A,nn*/
+                        cycles+=4; af.b.h=z80_readmem(pc++);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0x3F): /*CCF*/
+                        flags^=C_FLAG;
+                        cycles+=4;
+                        NEXT;
+
+                        OP(main, 0x40): bc.b.h=bc.b.h;        cycles+=4; NEXT; /*LD B,B*/
+                        OP(main, 0x41): bc.b.h=bc.b.l;        cycles+=4; NEXT; /*LD B,C*/
+                        OP(main, 0x42): bc.b.h=de.b.h;        cycles+=4; NEXT; /*LD B,D*/
+                        OP(main, 0x43): bc.b.h=de.b.l;        cycles+=4; NEXT; /*LD B,E*/
+                        OP(main, 0x44): bc.b.h=hl.b.h;        cycles+=4; NEXT; /*LD B,H*/
+                        OP(main, 0x45): bc.b.h=hl.b.l;        cycles+=4; NEXT; /*LD B,L*/
+                        OP(main, 0x46): cycles+=4; bc.b.h=z80_readmem(hl.w); cycles+=3; NEXT; /*LD B,(HL)*/
+                        OP(main, 0x47): bc.b.h=af.b.h;        cycles+=4; NEXT; /*LD B,A*/
+                        OP(main, 0x48): bc.b.l=bc.b.h;        cycles+=4; NEXT; /*LD C,B*/
+                        OP(main, 0x49): bc.b.l=bc.b.l;        cycles+=4; NEXT; /*LD C,C*/
+                        OP(main, 0x4A): bc.b.l=de.b.h;        cycles+=4; NEXT; /*LD C,D*/
+                        OP(main, 0x4B): bc.b.l=de.b.l;        cycles+=4; NEXT; /*LD C,E*/
+                        OP(main, 0x4C): bc.b.l=hl.b.h;        cycles+=4; NEXT; /*LD C,H*/
+                        OP(main, 0x4D): bc.b.l=hl.b.l;        cycles+=4; NEXT; /*LD C,L*/
+                        OP(main, 0x4E): cycles+=4; bc.b.l=z80_readmem(hl.w); cycles+=3; NEXT; /*LD C,(HL)*/
+                        OP(main, 0x4F): bc.b.l=af.b.h;        cycles+=4; NEXT; /*LD C,A*/
+                        OP(main, 0x50): de.b.h=bc.b.h;        cycles+=4; NEXT; /*LD D,B*/
+                        OP(main, 0x51): de.b.h=bc.b.l;        cycles+=4; NEXT; /*LD D,C*/
+                        OP(main, 0x52): de.b.h=de.b.h;        cycles+=4; NEXT; /*LD D,D*/
+                        OP(main, 0x53): de.b.h=de.b.l;        cycles+=4; NEXT; /*LD D,E*/
+                        OP(main, 0x54): de.b.h=hl.b.h;        cycles+=4; NEXT; /*LD D,H*/
+                        OP(main, 0x55): de.b.h=hl.b.l;        cycles+=4; NEXT; /*LD D,L*/
+                        OP(main, 0x56): cycles+=4; de.b.h=z80_readmem(hl.w); cycles+=3; NEXT; /*LD D,(HL)*/
+                        OP(main, 0x57): de.b.h=af.b.h;        cycles+=4; NEXT; /*LD D,A*/
+                        OP(main, 0x58): de.b.l=bc.b.h;        cycles+=4; NEXT; /*LD E,B*/
+                        OP(main, 0x59): de.b.l=bc.b.l;        cycles+=4; NEXT; /*LD E,C*/
+                        OP(main, 0x5A): de.b.l=de.b.h;        cycles+=4; NEXT; /*LD E,D*/
+                        OP(main, 0x5B): de.b.l=de.b.l;        cycles+=4; NEXT; /*LD E,E*/
+                        OP(main, 0x5C): de.b.l=hl.b.h;        cycles+=4; NEXT; /*LD E,H*/
+                        OP(main, 0x5D): de.b.l=hl.b.l;        cycles+=4; NEXT; /*LD E,L*/
+                        OP(main, 0x5E): cycles+=4; de.b.l=z80_readmem(hl.w); cycles+=3; NEXT; /*LD E,(HL)*/
+                        OP(main, 0x5F): de.b.l=af.b.h;        cycles+=4; NEXT; /*LD E,A*/
+                        OP(main, 0x60): hl.b.h=bc.b.h;        cycles+=4; NEXT; /*LD H,B*/
+                        OP(main, 0x61): hl.b.h=bc.b.l;        cycles+=4; NEXT; /*LD H,C*/
+                        OP(main, 0x62): hl.b.h=de.b.h;        cycles+=4; NEXT; /*LD H,D*/
+                        OP(main, 0x63): hl.b.h=de.b.l;        cycles+=4; NEXT; /*LD H,E*/
+                        OP(main, 0x64): hl.b.h=hl.b.h;        cycles+=4; NEXT; /*LD H,H*/
+                        OP(main, 0x65): hl.b.h=hl.b.l;        cycles+=4; NEXT; /*LD H,L*/
+                        OP(main, 0x66): cycles+=4; hl.b.h=z80_readmem(hl.w); cycles+=3; NEXT; /*LD H,(HL)*/
+                        OP(main, 0x67): hl.b.h=af.b.h;        cycles+=4; NEXT; /*LD H,A*/
+                        OP(main, 0x68): hl.b.l=bc.b.h;        cycles+=4; NEXT; /*LD L,B*/
+                        OP(main, 0x69): hl.b.l=bc.b.l;        cycles+=4; NEXT; /*LD L,C*/
+                        OP(main, 0x6A): hl.b.l=de.b.h;        cycles+=4; NEXT; /*LD L,D*/
+                        OP(main, 0x6B): hl.b.l=de.b.l;        cycles+=4; NEXT; /*LD L,E*/
+                        OP(main, 0x6C): hl.b.l=hl.b.h;        cycles+=4; NEXT; /*LD L,H*/
+                        OP(main, 0x6D): hl.b.l=hl.b.l;        cycles+=4; NEXT; /*LD L,L*/
+                        OP(main, 0x6E): cycles+=4; hl.b.l=z80_readmem(hl.w); cycles+=3; NEXT; /*LD L,(HL)*/
+                        OP(main, 0x6F): hl.b.l=af.b.h;        cycles+=4; NEXT; /*LD L,A*/
+                        OP(main, 0x70): cycles+=4; z80_writemem(hl.w,bc.b.h); cycles+=3; NEXT; /*LD (HL),B*/
+                        OP(main, 0x71): cycles+=4; z80_writemem(hl.w,bc.b.l); cycles+=3; NEXT; /*LD (HL),C*/
+                        OP(main, 0x72): cycles+=4; z80_writemem(hl.w,de.b.h); cycles+=3; NEXT; /*LD (HL),D*/
+                        OP(main, 0x73): cycles+=4; z80_writemem(hl.w,de.b.l); cycles+=3; NEXT; /*LD (HL),E*/
+                        OP(main, 0x74): cycles+=4; z80_writemem(hl.w,hl.b.h); cycles+=3; NEXT; /*LD (HL),H*/
+                        OP(main, 0x75): cycles+=4; z80_writemem(hl.w,hl.b.l); cycles+=3; NEXT; /*LD (HL),L*/
+                        OP(main, 0x77): cycles+=4; z80_writemem(hl.w,af.b.h); cycles+=3; NEXT; /*LD (HL),A*/
+                        OP(main, 0x78): af.b.h=bc.b.h;        cycles+=4; NEXT; /*LD A,B*/
+                        OP(main, 0x79): af.b.h=bc.b.l;        cycles+=4; NEXT; /*LD A,C*/
+                        OP(main, 0x7A): af.b.h=de.b.h;        cycles+=4; NEXT; /*LD A,D*/
+                        OP(main, 0x7B): af.b.h=de.b.l;        cycles+=4; NEXT; /*LD A,E*/
+                        OP(main, 0x7C): af.b.h=hl.b.h;        cycles+=4; NEXT; /*LD A,H*/
+                        OP(main, 0x7D): af.b.h=hl.b.l;        cycles+=4; NEXT; /*LD A,L*/
+                        OP(main, 0x7E): cycles+=4; af.b.h=z80_readmem(hl.w); cycles+=3; NEXT; /*LD A,(HL)*/
+                        OP(main, 0x7F): af.b.h=af.b.h;        cycles+=4; NEXT; /*LD A,A*/
+
+                        OP(main, 0x76): /*HALT*/
+                        if (!enterint) pc--;
+//                        else printf("HALT %02X\n",bc.b.h);
+                        cycles+=4;
+                        NEXT;
+
+                        OP(main, 0x80): z80_setadd(af.b.h,bc.b.h); af.b.h+=bc.b.h; cycles+=4; NEXT; /*ADD B*/
+                        OP(main, 0x81): z80_setadd(af.b.h,bc.b.l); af.b.h+=bc.b.l; cycles+=4; NEXT; /*ADD C*/
+                        OP(main, 0x82): z80_setadd(af.b.h,de.b.h); af.b.h+=de.b.h; cycles+=4; NEXT; /*ADD D*/
+                        OP(main, 0x83): z80_setadd(af.b.h,de.b.l); af.b.h+=de.b.l; cycles+=4; NEXT; /*ADD E*/
+                        OP(main, 0x84): z80_setadd(af.b.h,hl.b.h); af.b.h+=hl.b.h; cycles+=4; NEXT; /*ADD H*/
+                        OP(main, 0x85): z80_setadd(af.b.h,hl.b.l); af.b.h+=hl.b.l; cycles+=4; NEXT; /*ADD L*/
+                        OP(main, 0x86): cycles+=4; temp=z80_readmem(hl.w); z80_setadd(af.b.h,temp); af.b.h+=temp; cycles+=3; NEXT; /*ADD (HL)*/
+                        OP(main, 0x87): z80_setadd(af.b.h,af.b.h); af.b.h+=af.b.h; cycles+=4; NEXT; /*ADD A*/
+                        OP(main, 0x88): setadc(af.b.h,bc.b.h); af.b.h+=bc.b.h+tempc; cycles+=4; NEXT; /*ADC B*/
+                        OP(main, 0x89): setadc(af.b.h,bc.b.l); af.b.h+=bc.b.l+tempc; cycles+=4; NEXT; /*ADC C*/
+                        OP(main, 0x8A): setadc(af.b.h,de.b.h); af.b.h+=de.b.h+tempc; cycles+=4; NEXT; /*ADC D*/
+                        OP(main, 0x8B): setadc(af.b.h,de.b.l); af.b.h+=de.b.l+tempc; cycles+=4; NEXT; /*ADC E*/
+                        OP(main, 0x8C): setadc(af.b.h,hl.b.h); af.b.h+=hl.b.h+tempc; cycles+=4; NEXT; /*ADC H*/
+                        OP(main, 0x8D): setadc(af.b.h,hl.b.l); af.b.h+=hl.b.l+tempc; cycles+=4; NEXT; /*ADC L*/
+                        OP(main, 0x8E): cycles+=4; temp=z80_readmem(hl.w); setadc(af.b.h,temp); af.b.h+=temp+tempc; cycles+=3; NEXT; /*ADC (HL)*/
+                        OP(main, 0x8F): setadc(af.b.h,af.b.h); af.b.h+=af.b.h+tempc; cycles+=4; NEXT; /*ADC A*/
+
+                        OP(main, 0x90): z80_setsub(af.b.h,bc.b.h); af.b.h-=bc.b.h; cycles+=4; NEXT; /*SUB B*/
+                        OP(main, 0x91): z80_setsub(af.b.h,bc.b.l); af.b.h-=bc.b.l; cycles+=4; NEXT; /*SUB C*/
+                        OP(main, 0x92): z80_setsub(af.b.h,de.b.h); af.b.h-=de.b.h; cycles+=4; NEXT; /*SUB D*/
+                        OP(main, 0x93): z80_setsub(af.b.h,de.b.l); af.b.h-=de.b.l; cycles+=4; NEXT; /*SUB E*/
+                        OP(main, 0x94): z80_setsub(af.b.h,hl.b.h); af.b.h-=hl.b.h; cycles+=4; NEXT; /*SUB H*/
+                        OP(main, 0x95): z80_setsub(af.b.h,hl.b.l); af.b.h-=hl.b.l; cycles+=4; NEXT; /*SUB L*/
+                        OP(main, 0x96): cycles+=4; temp=z80_readmem(hl.w); z80_setsub(af.b.h,temp); af.b.h-=temp; cycles+=3; NEXT; /*SUB (HL)*/
+                        OP(main, 0x97): z80_setsub(af.b.h,af.b.h); af.b.h-=af.b.h; cycles+=4; NEXT; /*SUB A*/
+                        OP(main, 0x98): setsbc(af.b.h,bc.b.h); af.b.h-=(bc.b.h+tempc); cycles+=4; NEXT; /*SBC B*/
+                        OP(main, 0x99): setsbc(af.b.h,bc.b.l); af.b.h-=(bc.b.l+tempc); cycles+=4; NEXT; /*SBC C*/
+                        OP(main, 0x9A): setsbc(af.b.h,de.b.h); af.b.h-=(de.b.h+tempc); cycles+=4; NEXT; /*SBC D*/
+                        OP(main, 0x9B): setsbc(af.b.h,de.b.l); af.b.h-=(de.b.l+tempc); cycles+=4; NEXT; /*SBC E*/
+                        OP(main, 0x9C): setsbc(af.b.h,hl.b.h); af.b.h-=(hl.b.h+tempc); cycles+=4; NEXT; /*SBC H*/
+                        OP(main, 0x9D): setsbc(af.b.h,hl.b.l); af.b.h-=(hl.b.l+tempc); cycles+=4; NEXT; /*SBC L*/
+                        OP(main, 0x9E): cycles+=4; temp=z80_readmem(hl.w); setsbc(af.b.h,temp); af.b.h-=(temp+tempc); cycles+=3; NEXT; /*SBC (HL)*/
+                        OP(main, 0x9F): setsbc(af.b.h,af.b.h); af.b.h-=(af.b.h+tempc); cycles+=4; NEXT; /*SBC A*/
+
+                        OP(main, 0xA0): af.b.h&=bc.b.h;        setand(af.b.h); cycles+=4; NEXT; /*AND B*/
+                        OP(main, 0xA1): af.b.h&=bc.b.l;        setand(af.b.h); cycles+=4; NEXT; /*AND C*/
+                        OP(main, 0xA2): af.b.h&=de.b.h;        setand(af.b.h); cycles+=4; NEXT; /*AND D*/
+                        OP(main, 0xA3): af.b.h&=de.b.l;        setand(af.b.h); cycles+=4; NEXT; /*AND E*/
+                        OP(main, 0xA4): af.b.h&=hl.b.h;        setand(af.b.h); cycles+=4; NEXT; /*AND H*/
+                        OP(main, 0xA5): af.b.h&=hl.b.l;        setand(af.b.h); cycles+=4; NEXT; /*AND L*/
+                        OP(main, 0xA6): cycles+=4; af.b.h&=z80_readmem(hl.w); setand(af.b.h); cycles+=3; NEXT; /*AND (HL)*/
+                        OP(main, 0xA7): af.b.h&=af.b.h;        setand(af.b.h); cycles+=4; NEXT; /*AND A*/
+                        OP(main, 0xA8): af.b.h^=bc.b.h;        setzn(af.b.h); cycles+=4; NEXT; /*XOR B*/
+                        OP(main, 0xA9): af.b.h^=bc.b.l;        setzn(af.b.h); cycles+=4; NEXT; /*XOR C*/
+                        OP(main, 0xAA): af.b.h^=de.b.h;        setzn(af.b.h); cycles+=4; NEXT; /*XOR D*/
+                        OP(main, 0xAB): af.b.h^=de.b.l;        setzn(af.b.h); cycles+=4; NEXT; /*XOR E*/
+                        OP(main, 0xAC): af.b.h^=hl.b.h;        setzn(af.b.h); cycles+=4; NEXT; /*XOR H*/
+                        OP(main, 0xAD): af.b.h^=hl.b.l;        setzn(af.b.h); cycles+=4; NEXT; /*XOR L*/
+                        OP(main, 0xAE): cycles+=4; af.b.h^=z80_readmem(hl.w); setzn(af.b.h); cycles+=3; NEXT; /*XOR (HL)*/
+                        OP(main, 0xAF): af.b.h^=af.b.h;        setzn(af.b.h); cycles+=4; NEXT; /*XOR A*/
+                        OP(main, 0xB0): af.b.h|=bc.b.h;        setzn(af.b.h); cycles+=4; NEXT; /*OR B*/
+                        OP(main, 0xB1): af.b.h|=bc.b.l;        setzn(af.b.h); cycles+=4; NEXT; /*OR C*/
+                        OP(main, 0xB2): af.b.h|=de.b.h;        setzn(af.b.h); cycles+=4; NEXT; /*OR D*/
+                        OP(main, 0xB3): af.b.h|=de.b.l;        setzn(af.b.h); cycles+=4; NEXT; /*OR E*/
+                        OP(main, 0xB4): af.b.h|=hl.b.h;        setzn(af.b.h); cycles+=4; NEXT; /*OR H*/
+                        OP(main, 0xB5): af.b.h|=hl.b.l;        setzn(af.b.h); cycles+=4; NEXT; /*OR L*/
+                        OP(main, 0xB6): cycles+=4; af.b.h|=z80_readmem(hl.w); setzn(af.b.h); cycles+=3; NEXT; /*OR (HL)*/
+                        OP(main, 0xB7): af.b.h|=af.b.h;        setzn(af.b.h); cycles+=4; NEXT; /*OR A*/
+                        OP(main, 0xB8): setcp(af.b.h,bc.b.h); cycles+=4; NEXT; /*CP B*/
+                        OP(main, 0xB9): setcp(af.b.h,bc.b.l); cycles+=4; NEXT; /*CP C*/
+                        OP(main, 0xBA): setcp(af.b.h,de.b.h); cycles+=4; NEXT; /*CP D*/
+                        OP(main, 0xBB): setcp(af.b.h,de.b.l); cycles+=4; NEXT; /*CP E*/
+                        OP(main, 0xBC): setcp(af.b.h,hl.b.h); cycles+=4; NEXT; /*CP H*/
+                        OP(main, 0xBD): setcp(af.b.h,hl.b.l); cycles+=4; NEXT; /*CP L*/
+                        OP(main, 0xBE): cycles+=4; temp=z80_readmem(hl.w); setcp(af.b.h,temp); cycles+=3; NEXT; /*CP (HL)*/
+                        OP(main, 0xBF): setcp(af.b.h,af.b.h); cycles+=4; NEXT; /*CP A*/
+
+                        OP(main, 0xC0): /*RET NZ*/
+                        cycles+=5;
+                        if (!(flags&Z_FLAG))
+                        {
+                                pc=z80_readmem(sp); sp++;
+                                cycles+=3; pc|=(z80_readmem(sp)<<8); sp++;
+                                cycles+=3;
+                        }
+                        NEXT;
+                        OP(main, 0xC1): /*POP BC*/
+                        cycles+=4; bc.b.l=z80_readmem(sp); sp++;
+                        cycles+=3; bc.b.h=z80_readmem(sp); sp++;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xC2): /*JP NZ*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (!(flags&Z_FLAG))
+                           pc=addr;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xC3): /*JP xxxx*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8);
+                        pc=addr;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xC4): /*CALL NZ,xxxx*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (!(flags&Z_FLAG))
+                        {
+                                cycles+=4; sp--; z80_writemem(sp,pc>>8);
+                                cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                                pc=addr;
+                                cycles+=3;
+                        }
+                        else
+                           cycles+=3;
+                        NEXT;
+                        OP(main, 0xC5): /*PUSH BC*/
+                        cycles+=5; sp--; z80_writemem(sp,bc.b.h);
+                        cycles+=3; sp--; z80_writemem(sp,bc.b.l);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xC6): /*ADD A,nn*/
+                        cycles+=4; temp=z80_readmem(pc++);
+//                        printf("%04X : ADD %02X %02X - ",pc-1,af.b.h,temp);
+                        z80_setadd(af.b.h,temp);
+                        af.b.h+=temp;
+                        cycles+=3;
+//                        printf("%04X\n",af.w);
+                        NEXT;
+                        OP(main, 0xC7): /*RST 0*/
+                        cycles+=5; sp--; z80_writemem(sp,pc>>8);
+                        cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                        pc=0x00;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xC8): /*RET Z*/
+                        cycles+=5;
+                        if (flags&Z_FLAG)
+                        {
+                                pc=z80_readmem(sp); sp++;
+                                cycles+=3; pc|=(z80_readmem(sp)<<8); sp++;
+                                cycles+=3;
+                        }
+                        NEXT;
+                        OP(main, 0xC9): /*RET*/
+                        cycles+=4; pc=z80_readmem(sp); sp++;
+                        cycles+=3; pc|=(z80_readmem(sp)<<8); sp++;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xCA): /*JP Z*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (flags&Z_FLAG)
+                           pc=addr;
+                        cycles+=3;
+                        NEXT;
+
+                        OP(main, 0xCB): /*More opcodes*/
+                        ir.b.l=((ir.b.l+1)&0x7F)|(ir.b.l&0x80);
+                        cycles+=4;
+                        opcode=z80_readmem(pc++);
+                        DISPATCH(cb, opcode)
+                        {
+                                OP(cb, 0x00): temp=bc.b.h&0x80; bc.b.h<<=1; if (temp) bc.b.h|=1; setzn(bc.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RLC B*/
+                                OP(cb, 0x01): temp=bc.b.l&0x80; bc.b.l<<=1; if (temp) bc.b.l|=1; setzn(bc.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*RLC C*/
+                                OP(cb, 0x02): temp=de.b.h&0x80; de.b.h<<=1; if (temp) de.b.h|=1; setzn(de.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RLC D*/
+                                OP(cb, 0x03): temp=de.b.l&0x80; de.b.l<<=1; if (temp) de.b.l|=1; setzn(de.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*RLC E*/
+                                OP(cb, 0x04): temp=hl.b.h&0x80; hl.b.h<<=1; if (temp) hl.b.h|=1; setzn(hl.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RLC H*/
+                                OP(cb, 0x05): temp=hl.b.l&0x80; hl.b.l<<=1; if (temp) hl.b.l|=1; setzn(hl.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*RLC L*/
+                                OP(cb, 0x07): temp=af.b.h&0x80; af.b.h<<=1; if (temp) af.b.h|=1; setzn(af.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RLC A*/
+                                OP(cb, 0x06): /*RLC (HL)*/
+                                cycles+=4; temp=z80_readmem(hl.w);
+                                tempc=temp&0x80;
+                                temp<<=1;
+                                if (tempc) temp|=1;
+                                setzn(temp);
+                                if (tempc) flags|=C_FLAG;
+                                cycles+=4; z80_writemem(hl.w,temp);
+                                cycles+=3;
+                                break;
+
+                                OP(cb, 0x08): temp=bc.b.h&1; bc.b.h>>=1; if (temp) bc.b.h|=0x80; setzn(bc.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RRC B*/
+                                OP(cb, 0x09): temp=bc.b.l&1; bc.b.l>>=1; if (temp) bc.b.l|=0x80; setzn(bc.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*RRC C*/
+                                OP(cb, 0x0A): temp=de.b.h&1; de.b.h>>=1; if (temp) de.b.h|=0x80; setzn(de.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RRC D*/
+                                OP(cb, 0x0B): temp=de.b.l&1; de.b.l>>=1; if (temp) de.b.l|=0x80; setzn(de.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*RRC E*/
+                                OP(cb, 0x0C): temp=hl.b.h&1; hl.b.h>>=1; if (temp) hl.b.h|=0x80; setzn(hl.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RRC H*/
+                                OP(cb, 0x0D): temp=hl.b.l&1; hl.b.l>>=1; if (temp) hl.b.l|=0x80; setzn(hl.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*RRC L*/
+                                OP(cb, 0x0F): temp=af.b.h&1; af.b.h>>=1; if (temp) af.b.h|=0x80; setzn(af.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RRC A*/
+                                OP(cb, 0x0E): /*RRC (HL)*/
+                                cycles+=4; temp=z80_readmem(hl.w);
+                                tempc=temp&1;
+                                temp>>=1;
+                                if (tempc) temp|=0x80;
+                                setzn(temp);
+                                if (tempc) flags|=C_FLAG;
+                                cycles+=4; z80_writemem(hl.w,temp);
+                                cycles+=3;
+                                break;
+
+                                OP(cb, 0x10): temp=bc.b.h&0x80; bc.b.h<<=1; if (tempc) bc.b.h|=1; setzn(bc.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RL B*/
+                                OP(cb, 0x11): temp=bc.b.l&0x80; bc.b.l<<=1; if (tempc) bc.b.l|=1; setzn(bc.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*RL C*/
+                                OP(cb, 0x12): temp=de.b.h&0x80; de.b.h<<=1; if (tempc) de.b.h|=1; setzn(de.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RL D*/
+                                OP(cb, 0x13): temp=de.b.l&0x80; de.b.l<<=1; if (tempc) de.b.l|=1; setzn(de.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*RL E*/
+                                OP(cb, 0x14): temp=hl.b.h&0x80; hl.b.h<<=1; if (tempc) hl.b.h|=1; setzn(hl.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RL H*/
+                                OP(cb, 0x15): temp=hl.b.l&0x80; hl.b.l<<=1; if (tempc) hl.b.l|=1; setzn(hl.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*RL L*/
+                                OP(cb, 0x17): temp=af.b.h&0x80; af.b.h<<=1; if (tempc) af.b.h|=1; setzn(af.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RL A*/
+                                OP(cb, 0x16):  /*RL (HL)*/
+                                cycles+=4; temp=z80_readmem(hl.w);
+                                addr=temp&0x80;
+                                temp<<=1;
+                                if (tempc) temp|=1;
+                                setzn(temp);
+                                if (addr) flags|=C_FLAG;
+                                cycles+=4; z80_writemem(hl.w,temp);
+                                cycles+=3;
+                                break;
+
+                                OP(cb, 0x18): temp=bc.b.h&1; bc.b.h>>=1; if (tempc) bc.b.h|=0x80; setzn(bc.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RR B*/
+                                OP(cb, 0x19): temp=bc.b.l&1; bc.b.l>>=1; if (tempc) bc.b.l|=0x80; setzn(bc.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*RR C*/
+                                OP(cb, 0x1A): temp=de.b.h&1; de.b.h>>=1; if (tempc) de.b.h|=0x80; setzn(de.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RR D*/
+                                OP(cb, 0x1B): temp=de.b.l&1; de.b.l>>=1; if (tempc) de.b.l|=0x80; setzn(de.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*RR E*/
+                                OP(cb, 0x1C): temp=hl.b.h&1; hl.b.h>>=1; if (tempc) hl.b.h|=0x80; setzn(hl.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RR H*/
+                                OP(cb, 0x1D): temp=hl.b.l&1; hl.b.l>>=1; if (tempc) hl.b.l|=0x80; setzn(hl.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*RR L*/
+                                OP(cb, 0x1F): temp=af.b.h&1; af.b.h>>=1; if (tempc) af.b.h|=0x80; setzn(af.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*RR A*/
+                                OP(cb, 0x1E):  /*RR (HL)*/
+                                cycles+=4; temp=z80_readmem(hl.w);
+                                addr=temp&1;
+                                temp>>=1;
+                                if (tempc) temp|=0x80;
+                                setzn(temp);
+                                if (addr) flags|=C_FLAG;
+                                cycles+=4; z80_writemem(hl.w,temp);
+                                cycles+=3;
+                                break;
+
+                                OP(cb, 0x20): temp=bc.b.h&0x80; bc.b.h<<=1; setzn(bc.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SLA B*/
+                                OP(cb, 0x21): temp=bc.b.l&0x80; bc.b.l<<=1; setzn(bc.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*SLA C*/
+                                OP(cb, 0x22): temp=de.b.h&0x80; de.b.h<<=1; setzn(de.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SLA D*/
+                                OP(cb, 0x23): temp=de.b.l&0x80; de.b.l<<=1; setzn(de.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*SLA E*/
+                                OP(cb, 0x24): temp=hl.b.h&0x80; hl.b.h<<=1; setzn(hl.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SLA H*/
+                                OP(cb, 0x25): temp=hl.b.l&0x80; hl.b.l<<=1; setzn(hl.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*SLA L*/
+                                OP(cb, 0x27): temp=af.b.h&0x80; af.b.h<<=1; setzn(af.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SLA H*/
+                                OP(cb, 0x26):  /*SLA (HL)*/
+                                cycles+=4; temp=z80_readmem(hl.w);
+                                tempc=temp&0x80;
+                                temp<<=1;
+                                setzn(temp);
+                                if (tempc) flags|=C_FLAG;
+                                cycles+=4; z80_writemem(hl.w,temp);
+                                cycles+=3;
+                                break;
+
+                                OP(cb, 0x28): temp=bc.b.h&1; bc.b.h>>=1; if (bc.b.h&0x40) bc.b.h|=0x80; setzn(bc.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SRA B*/
+                                OP(cb, 0x29): temp=bc.b.l&1; bc.b.l>>=1; if (bc.b.l&0x40) bc.b.l|=0x80; setzn(bc.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*SRA C*/
+                                OP(cb, 0x2A): temp=de.b.h&1; de.b.h>>=1; if (de.b.h&0x40) de.b.h|=0x80; setzn(de.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SRA D*/
+                                OP(cb, 0x2B): temp=de.b.l&1; de.b.l>>=1; if (de.b.l&0x40) de.b.l|=0x80; setzn(de.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*SRA E*/
+                                OP(cb, 0x2C): temp=hl.b.h&1; hl.b.h>>=1; if (hl.b.h&0x40) hl.b.h|=0x80; setzn(hl.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SRA H*/
+                                OP(cb, 0x2D): temp=hl.b.l&1; hl.b.l>>=1; if (hl.b.l&0x40) hl.b.l|=0x80; setzn(hl.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*SRA L*/
+                                OP(cb, 0x2F): temp=af.b.h&1; af.b.h>>=1; if (af.b.h&0x40) af.b.h|=0x80; setzn(af.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SRA A*/
+                                OP(cb, 0x2E):  /*SRA (HL)*/
+                                cycles+=4; temp=z80_readmem(hl.w);
+                                tempc=temp&1;
+                                temp>>=1;
+                                if (temp&0x40) temp|=0x80;
+                                setzn(temp);
+                                if (tempc) flags|=C_FLAG;
+                                cycles+=4; z80_writemem(hl.w,temp);
+                                cycles+=3;
+                                break;
+
+                                OP(cb, 0x30): temp=bc.b.h&0x80; bc.b.h<<=1; bc.b.h|=1; setzn(bc.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SLL B*/
+                                OP(cb, 0x31): temp=bc.b.l&0x80; bc.b.l<<=1; bc.b.l|=1; setzn(bc.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*SLL C*/
+                                OP(cb, 0x32): temp=de.b.h&0x80; de.b.h<<=1; de.b.h|=1; setzn(de.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SLL D*/
+                                OP(cb, 0x33): temp=de.b.l&0x80; de.b.l<<=1; de.b.l|=1; setzn(de.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*SLL E*/
+                                OP(cb, 0x34): temp=hl.b.h&0x80; hl.b.h<<=1; hl.b.h|=1; setzn(hl.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SLL H*/
+                                OP(cb, 0x35): temp=hl.b.l&0x80; hl.b.l<<=1; hl.b.l|=1; setzn(hl.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*SLL L*/
+                                OP(cb, 0x37): temp=af.b.h&0x80; af.b.h<<=1; af.b.h|=1; setzn(af.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SLL H*/
+                                OP(cb, 0x36):  /*SLL (HL)*/
+                                cycles+=4; temp=z80_readmem(hl.w);
+                                tempc=temp&0x80;
+                                temp<<=1;
+                                temp|=1;
+                                setzn(temp);
+                                if (tempc) flags|=C_FLAG;
+                                cycles+=4; z80_writemem(hl.w,temp);
+                                cycles+=3;
+                                break;
+
+                                OP(cb, 0x38): temp=bc.b.h&1; bc.b.h>>=1; setzn(bc.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SRL B*/
+                                OP(cb, 0x39): temp=bc.b.l&1; bc.b.l>>=1; setzn(bc.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*SRL C*/
+                                OP(cb, 0x3A): temp=de.b.h&1; de.b.h>>=1; setzn(de.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SRL D*/
+                                OP(cb, 0x3B): temp=de.b.l&1; de.b.l>>=1; setzn(de.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*SRL E*/
+                                OP(cb, 0x3C): temp=hl.b.h&1; hl.b.h>>=1; setzn(hl.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SRL H*/
+                                OP(cb, 0x3D): temp=hl.b.l&1; hl.b.l>>=1; setzn(hl.b.l); if (temp) flags|=C_FLAG; cycles+=4; break; /*SRL L*/
+                                OP(cb, 0x3F): temp=af.b.h&1; af.b.h>>=1; setzn(af.b.h); if (temp) flags|=C_FLAG; cycles+=4; break; /*SRL H*/
+                                OP(cb, 0x3E):  /*SRL (HL)*/
+                                cycles+=4; temp=z80_readmem(hl.w);
+                                tempc=temp&1;
+                                temp>>=1;
+                                setzn(temp);
+                                if (tempc) flags|=C_FLAG;
+                                cycles+=4; z80_writemem(hl.w,temp);
+                                cycles+=3;
+                                break;
+
+                                OP(cb, 0x40): setbit(bc.b.h&0x01); cycles+=4; break; /*BIT 0,B*/
+                                OP(cb, 0x41): setbit(bc.b.l&0x01); cycles+=4; break; /*BIT 0,C*/
+                                OP(cb, 0x42): setbit(de.b.h&0x01); cycles+=4; break; /*BIT 0,D*/
+                                OP(cb, 0x43): setbit(de.b.l&0x01); cycles+=4; break; /*BIT 0,E*/
+                                OP(cb, 0x44): setbit(hl.b.h&0x01); cycles+=4; break; /*BIT 0,H*/
+                                OP(cb, 0x45): setbit(hl.b.l&0x01); cycles+=4; break; /*BIT 0,L*/
+                                OP(cb, 0x47): setbit(af.b.h&0x01); cycles+=4; break; /*BIT 0,A*/
+                                OP(cb, 0x48): setbit(bc.b.h&0x02); cycles+=4; break; /*BIT 1,B*/
+                                OP(cb, 0x49): setbit(bc.b.l&0x02); cycles+=4; break; /*BIT 1,C*/
+                                OP(cb, 0x4A): setbit(de.b.h&0x02); cycles+=4; break; /*BIT 1,D*/
+                                OP(cb, 0x4B): setbit(de.b.l&0x02); cycles+=4; break; /*BIT 1,E*/
+                                OP(cb, 0x4C): setbit(hl.b.h&0x02); cycles+=4; break; /*BIT 1,H*/
+                                OP(cb, 0x4D): setbit(hl.b.l&0x02); cycles+=4; break; /*BIT 1,L*/
+                                OP(cb, 0x4F): setbit(af.b.h&0x02); cycles+=4; break; /*BIT 1,A*/
+                                OP(cb, 0x50): setbit(bc.b.h&0x04); cycles+=4; break; /*BIT 2,B*/
+                                OP(cb, 0x51): setbit(bc.b.l&0x04); cycles+=4; break; /*BIT 2,C*/
+                                OP(cb, 0x52): setbit(de.b.h&0x04); cycles+=4; break; /*BIT 2,D*/
+                                OP(cb, 0x53): setbit(de.b.l&0x04); cycles+=4; break; /*BIT 2,E*/
+                                OP(cb, 0x54): setbit(hl.b.h&0x04); cycles+=4; break; /*BIT 2,H*/
+                                OP(cb, 0x55): setbit(hl.b.l&0x04); cycles+=4; break; /*BIT 2,L*/
+                                OP(cb, 0x57): setbit(af.b.h&0x04); cycles+=4; break; /*BIT 2,A*/
+                                OP(cb, 0x58): setbit(bc.b.h&0x08); cycles+=4; break; /*BIT 3,B*/
+                                OP(cb, 0x59): setbit(bc.b.l&0x08); cycles+=4; break; /*BIT 3,C*/
+                                OP(cb, 0x5A): setbit(de.b.h&0x08); cycles+=4; break; /*BIT 3,D*/
+                                OP(cb, 0x5B): setbit(de.b.l&0x08); cycles+=4; break; /*BIT 3,E*/
+                                OP(cb, 0x5C): setbit(hl.b.h&0x08); cycles+=4; break; /*BIT 3,H*/
+                                OP(cb, 0x5D): setbit(hl.b.l&0x08); cycles+=4; break; /*BIT 3,L*/
+                                OP(cb, 0x5F): setbit(af.b.h&0x08); cycles+=4; break; /*BIT 3,A*/
+                                OP(cb, 0x60): setbit(bc.b.h&0x10); cycles+=4; break; /*BIT 4,B*/
+                                OP(cb, 0x61): setbit(bc.b.l&0x10); cycles+=4; break; /*BIT 4,C*/
+                                OP(cb, 0x62): setbit(de.b.h&0x10); cycles+=4; break; /*BIT 4,D*/
+                                OP(cb, 0x63): setbit(de.b.l&0x10); cycles+=4; break; /*BIT 4,E*/
+                                OP(cb, 0x64): setbit(hl.b.h&0x10); cycles+=4; break; /*BIT 4,H*/
+                                OP(cb, 0x65): setbit(hl.b.l&0x10); cycles+=4; break; /*BIT 4,L*/
+                                OP(cb, 0x67): setbit(af.b.h&0x10); cycles+=4; break; /*BIT 4,A*/
+                                OP(cb, 0x68): setbit(bc.b.h&0x20); cycles+=4; break; /*BIT 5,B*/
+                                OP(cb, 0x69): setbit(bc.b.l&0x20); cycles+=4; break; /*BIT 5,C*/
+                                OP(cb, 0x6A): setbit(de.b.h&0x20); cycles+=4; break; /*BIT 5,D*/
+                                OP(cb, 0x6B): setbit(de.b.l&0x20); cycles+=4; break; /*BIT 5,E*/
+                                OP(cb, 0x6C): setbit(hl.b.h&0x20); cycles+=4; break; /*BIT 5,H*/
+                                OP(cb, 0x6D): setbit(hl.b.l&0x20); cycles+=4; break; /*BIT 5,L*/
+                                OP(cb, 0x6F): setbit(af.b.h&0x20); cycles+=4; break; /*BIT 5,A*/
+                                OP(cb, 0x70): setbit(bc.b.h&0x40); cycles+=4; break; /*BIT 6,B*/
+                                OP(cb, 0x71): setbit(bc.b.l&0x40); cycles+=4; break; /*BIT 6,C*/
+                                OP(cb, 0x72): setbit(de.b.h&0x40); cycles+=4; break; /*BIT 6,D*/
+                                OP(cb, 0x73): setbit(de.b.l&0x40); cycles+=4; break; /*BIT 6,E*/
+                                OP(cb, 0x74): setbit(hl.b.h&0x40); cycles+=4; break; /*BIT 6,H*/
+                                OP(cb, 0x75): setbit(hl.b.l&0x40); cycles+=4; break; /*BIT 6,L*/
+                                OP(cb, 0x77): setbit(af.b.h&0x40); cycles+=4; break; /*BIT 6,A*/
+                                OP(cb, 0x78): setbit(bc.b.h&0x80); cycles+=4; break; /*BIT 7,B*/
+                                OP(cb, 0x79): setbit(bc.b.l&0x80); cycles+=4; break; /*BIT 7,C*/
+                                OP(cb, 0x7A): setbit(de.b.h&0x80); cycles+=4; break; /*BIT 7,D*/
+                                OP(cb, 0x7B): setbit(de.b.l&0x80); cycles+=4; break; /*BIT 7,E*/
+                                OP(cb, 0x7C): setbit(hl.b.h&0x80); cycles+=4; break; /*BIT 7,H*/
+                                OP(cb, 0x7D): setbit(hl.b.l&0x80); cycles+=4; break; /*BIT 7,L*/
+                                OP(cb, 0x7F): setbit(af.b.h&0x80); cycles+=4; break; /*BIT 7,A*/
+
+                                OP(cb, 0x46): cycles+=4; temp=z80_readmem(hl.w); setbit2(temp&0x01,intreg); cycles+=4; break; /*BIT 0,(HL)*/
+                                OP(cb, 0x4E): cycles+=4; temp=z80_readmem(hl.w); setbit2(temp&0x02,intreg); cycles+=4; break; /*BIT 1,(HL)*/
+                                OP(cb, 0x56): cycles+=4; temp=z80_readmem(hl.w); setbit2(temp&0x04,intreg); cycles+=4; break; /*BIT 2,(HL)*/
+                                OP(cb, 0x5E): cycles+=4; temp=z80_readmem(hl.w); setbit2(temp&0x08,intreg); cycles+=4; break; /*BIT 3,(HL)*/
+                                OP(cb, 0x66): cycles+=4; temp=z80_readmem(hl.w); setbit2(temp&0x10,intreg); cycles+=4; break; /*BIT 4,(HL)*/
+                                OP(cb, 0x6E): cycles+=4; temp=z80_readmem(hl.w); setbit2(temp&0x20,intreg); cycles+=4; break; /*BIT 5,(HL)*/
+                                OP(cb, 0x76): cycles+=4; temp=z80_readmem(hl.w); setbit2(temp&0x40,intreg); cycles+=4; break; /*BIT 6,(HL)*/
+                                OP(cb, 0x7E): cycles+=4; temp=z80_readmem(hl.w); setbit2(temp&0x80,intreg); cycles+=4; break; /*BIT 7,(HL)*/
+
+                                OP(cb, 0x80): bc.b.h&=~0x01; cycles+=4; break; /*RES 0,B*/
+                                OP(cb, 0x81): bc.b.l&=~0x01; cycles+=4; break; /*RES 0,C*/
+                                OP(cb, 0x82): de.b.h&=~0x01; cycles+=4; break; /*RES 0,D*/
+                                OP(cb, 0x83): de.b.l&=~0x01; cycles+=4; break; /*RES 0,E*/
+                                OP(cb, 0x84): hl.b.h&=~0x01; cycles+=4; break; /*RES 0,H*/
+                                OP(cb, 0x85): hl.b.l&=~0x01; cycles+=4; break; /*RES 0,L*/
+                                OP(cb, 0x87): af.b.h&=~0x01; cycles+=4; break; /*RES 0,A*/
+                                OP(cb, 0x88): bc.b.h&=~0x02; cycles+=4; break; /*RES 1,B*/
+                                OP(cb, 0x89): bc.b.l&=~0x02; cycles+=4; break; /*RES 1,C*/
+                                OP(cb, 0x8A): de.b.h&=~0x02; cycles+=4; break; /*RES 1,D*/
+                                OP(cb, 0x8B): de.b.l&=~0x02; cycles+=4; break; /*RES 1,E*/
+                                OP(cb, 0x8C): hl.b.h&=~0x02; cycles+=4; break; /*RES 1,H*/
+                                OP(cb, 0x8D): hl.b.l&=~0x02; cycles+=4; break; /*RES 1,L*/
+                                OP(cb, 0x8F): af.b.h&=~0x02; cycles+=4; break; /*RES 1,A*/
+                                OP(cb, 0x90): bc.b.h&=~0x04; cycles+=4; break; /*RES 2,B*/
+                                OP(cb, 0x91): bc.b.l&=~0x04; cycles+=4; break; /*RES 2,C*/
+                                OP(cb, 0x92): de.b.h&=~0x04; cycles+=4; break; /*RES 2,D*/
+                                OP(cb, 0x93): de.b.l&=~0x04; cycles+=4; break; /*RES 2,E*/
+                                OP(cb, 0x94): hl.b.h&=~0x04; cycles+=4; break; /*RES 2,H*/
+                                OP(cb, 0x95): hl.b.l&=~0x04; cycles+=4; break; /*RES 2,L*/
+                                OP(cb, 0x97): af.b.h&=~0x04; cycles+=4; break; /*RES 2,A*/
+                                OP(cb, 0x98): bc.b.h&=~0x08; cycles+=4; break; /*RES 3,B*/
+                                OP(cb, 0x99): bc.b.l&=~0x08; cycles+=4; break; /*RES 3,C*/
+                                OP(cb, 0x9A): de.b.h&=~0x08; cycles+=4; break; /*RES 3,D*/
+                                OP(cb, 0x9B): de.b.l&=~0x08; cycles+=4; break; /*RES 3,E*/
+                                OP(cb, 0x9C): hl.b.h&=~0x08; cycles+=4; break; /*RES 3,H*/
+                                OP(cb, 0x9D): hl.b.l&=~0x08; cycles+=4; break; /*RES 3,L*/
+                                OP(cb, 0x9F): af.b.h&=~0x08; cycles+=4; break; /*RES 3,A*/
+                                OP(cb, 0xA0): bc.b.h&=~0x10; cycles+=4; break; /*RES 4,B*/
+                                OP(cb, 0xA1): bc.b.l&=~0x10; cycles+=4; break; /*RES 4,C*/
+                                OP(cb, 0xA2): de.b.h&=~0x10; cycles+=4; break; /*RES 4,D*/
+                                OP(cb, 0xA3): de.b.l&=~0x10; cycles+=4; break; /*RES 4,E*/
+                                OP(cb, 0xA4): hl.b.h&=~0x10; cycles+=4; break; /*RES 4,H*/
+                                OP(cb, 0xA5): hl.b.l&=~0x10; cycles+=4; break; /*RES 4,L*/
+                                OP(cb, 0xA7): af.b.h&=~0x10; cycles+=4; break; /*RES 4,A*/
+                                OP(cb, 0xA8): bc.b.h&=~0x20; cycles+=4; break; /*RES 5,B*/
+                                OP(cb, 0xA9): bc.b.l&=~0x20; cycles+=4; break; /*RES 5,C*/
+                                OP(cb, 0xAA): de.b.h&=~0x20; cycles+=4; break; /*RES 5,D*/
+                                OP(cb, 0xAB): de.b.l&=~0x20; cycles+=4; break; /*RES 5,E*/
+                                OP(cb, 0xAC): hl.b.h&=~0x20; cycles+=4; break; /*RES 5,H*/
+                                OP(cb, 0xAD): hl.b.l&=~0x20; cycles+=4; break; /*RES 5,L*/
+                                OP(cb, 0xAF): af.b.h&=~0x20; cycles+=4; break; /*RES 5,A*/
+                                OP(cb, 0xB0): bc.b.h&=~0x40; cycles+=4; break; /*RES 6,B*/
+                                OP(cb, 0xB1): bc.b.l&=~0x40; cycles+=4; break; /*RES 6,C*/
+                                OP(cb, 0xB2): de.b.h&=~0x40; cycles+=4; break; /*RES 6,D*/
+                                OP(cb, 0xB3): de.b.l&=~0x40; cycles+=4; break; /*RES 6,E*/
+                                OP(cb, 0xB4): hl.b.h&=~0x40; cycles+=4; break; /*RES 6,H*/
+                                OP(cb, 0xB5): hl.b.l&=~0x40; cycles+=4; break; /*RES 6,L*/
+                                OP(cb, 0xB7): af.b.h&=~0x40; cycles+=4; break; /*RES 6,A*/
+                                OP(cb, 0xB8): bc.b.h&=~0x80; cycles+=4; break; /*RES 7,B*/
+                                OP(cb, 0xB9): bc.b.l&=~0x80; cycles+=4; break; /*RES 7,C*/
+                                OP(cb, 0xBA): de.b.h&=~0x80; cycles+=4; break; /*RES 7,D*/
+                                OP(cb, 0xBB): de.b.l&=~0x80; cycles+=4; break; /*RES 7,E*/
+                                OP(cb, 0xBC): hl.b.h&=~0x80; cycles+=4; break; /*RES 7,H*/
+                                OP(cb, 0xBD): hl.b.l&=~0x80; cycles+=4; break; /*RES 7,L*/
+                                OP(cb, 0xBF): af.b.h&=~0x80; cycles+=4; break; /*RES 7,A*/
+
+                                OP(cb, 0x86): cycles+=4; temp=z80_readmem(hl.w)&~0x01; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*RES 0,(HL)*/
+                                OP(cb, 0x8E): cycles+=4; temp=z80_readmem(hl.w)&~0x02; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*RES 1,(HL)*/
+                                OP(cb, 0x96): cycles+=4; temp=z80_readmem(hl.w)&~0x04; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*RES 2,(HL)*/
+                                OP(cb, 0x9E): cycles+=4; temp=z80_readmem(hl.w)&~0x08; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*RES 3,(HL)*/
+                                OP(cb, 0xA6): cycles+=4; temp=z80_readmem(hl.w)&~0x10; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*RES 4,(HL)*/
+                                OP(cb, 0xAE): cycles+=4; temp=z80_readmem(hl.w)&~0x20; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*RES 5,(HL)*/
+                                OP(cb, 0xB6): cycles+=4; temp=z80_readmem(hl.w)&~0x40; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*RES 6,(HL)*/
+                                OP(cb, 0xBE): cycles+=4; temp=z80_readmem(hl.w)&~0x80; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*RES 7,(HL)*/
+
+                                OP(cb, 0xC0): bc.b.h|=0x01; cycles+=4; break; /*SET 0,B*/
+                                OP(cb, 0xC1): bc.b.l|=0x01; cycles+=4; break; /*SET 0,C*/
+                                OP(cb, 0xC2): de.b.h|=0x01; cycles+=4; break; /*SET 0,D*/
+                                OP(cb, 0xC3): de.b.l|=0x01; cycles+=4; break; /*SET 0,E*/
+                                OP(cb, 0xC4): hl.b.h|=0x01; cycles+=4; break; /*SET 0,H*/
+                                OP(cb, 0xC5): hl.b.l|=0x01; cycles+=4; break; /*SET 0,L*/
+                                OP(cb, 0xC7): af.b.h|=0x01; cycles+=4; break; /*SET 0,A*/
+                                OP(cb, 0xC8): bc.b.h|=0x02; cycles+=4; break; /*SET 1,B*/
+                                OP(cb, 0xC9): bc.b.l|=0x02; cycles+=4; break; /*SET 1,C*/
+                                OP(cb, 0xCA): de.b.h|=0x02; cycles+=4; break; /*SET 1,D*/
+                                OP(cb, 0xCB): de.b.l|=0x02; cycles+=4; break; /*SET 1,E*/
+                                OP(cb, 0xCC): hl.b.h|=0x02; cycles+=4; break; /*SET 1,H*/
+                                OP(cb, 0xCD): hl.b.l|=0x02; cycles+=4; break; /*SET 1,L*/
+                                OP(cb, 0xCF): af.b.h|=0x02; cycles+=4; break; /*SET 1,A*/
+                                OP(cb, 0xD0): bc.b.h|=0x04; cycles+=4; break; /*SET 2,B*/
+                                OP(cb, 0xD1): bc.b.l|=0x04; cycles+=4; break; /*SET 2,C*/
+                                OP(cb, 0xD2): de.b.h|=0x04; cycles+=4; break; /*SET 2,D*/
+                                OP(cb, 0xD3): de.b.l|=0x04; cycles+=4; break; /*SET 2,E*/
+                                OP(cb, 0xD4): hl.b.h|=0x04; cycles+=4; break; /*SET 2,H*/
+                                OP(cb, 0xD5): hl.b.l|=0x04; cycles+=4; break; /*SET 2,L*/
+                                OP(cb, 0xD7): af.b.h|=0x04; cycles+=4; break; /*SET 2,A*/
+                                OP(cb, 0xD8): bc.b.h|=0x08; cycles+=4; break; /*SET 3,B*/
+                                OP(cb, 0xD9): bc.b.l|=0x08; cycles+=4; break; /*SET 3,C*/
+                                OP(cb, 0xDA): de.b.h|=0x08; cycles+=4; break; /*SET 3,D*/
+                                OP(cb, 0xDB): de.b.l|=0x08; cycles+=4; break; /*SET 3,E*/
+                                OP(cb, 0xDC): hl.b.h|=0x08; cycles+=4; break; /*SET 3,H*/
+                                OP(cb, 0xDD): hl.b.l|=0x08; cycles+=4; break; /*SET 3,L*/
+                                OP(cb, 0xDF): af.b.h|=0x08; cycles+=4; break; /*SET 3,A*/
+                                OP(cb, 0xE0): bc.b.h|=0x10; cycles+=4; break; /*SET 4,B*/
+                                OP(cb, 0xE1): bc.b.l|=0x10; cycles+=4; break; /*SET 4,C*/
+                                OP(cb, 0xE2): de.b.h|=0x10; cycles+=4; break; /*SET 4,D*/
+                                OP(cb, 0xE3): de.b.l|=0x10; cycles+=4; break; /*SET 4,E*/
+                                OP(cb, 0xE4): hl.b.h|=0x10; cycles+=4; break; /*SET 4,H*/
+                                OP(cb, 0xE5): hl.b.l|=0x10; cycles+=4; break; /*SET 4,L*/
+                                OP(cb, 0xE7): af.b.h|=0x10; cycles+=4; break; /*SET 4,A*/
+                                OP(cb, 0xE8): bc.b.h|=0x20; cycles+=4; break; /*SET 5,B*/
+                                OP(cb, 0xE9): bc.b.l|=0x20; cycles+=4; break; /*SET 5,C*/
+                                OP(cb, 0xEA): de.b.h|=0x20; cycles+=4; break; /*SET 5,D*/
+                                OP(cb, 0xEB): de.b.l|=0x20; cycles+=4; break; /*SET 5,E*/
+                                OP(cb, 0xEC): hl.b.h|=0x20; cycles+=4; break; /*SET 5,H*/
+                                OP(cb, 0xED): hl.b.l|=0x20; cycles+=4; break; /*SET 5,L*/
+                                OP(cb, 0xEF): af.b.h|=0x20; cycles+=4; break; /*SET 5,A*/
+                                OP(cb, 0xF0): bc.b.h|=0x40; cycles+=4; break; /*SET 6,B*/
+                                OP(cb, 0xF1): bc.b.l|=0x40; cycles+=4; break; /*SET 6,C*/
+                                OP(cb, 0xF2): de.b.h|=0x40; cycles+=4; break; /*SET 6,D*/
+                                OP(cb, 0xF3): de.b.l|=0x40; cycles+=4; break; /*SET 6,E*/
+                                OP(cb, 0xF4): hl.b.h|=0x40; cycles+=4; break; /*SET 6,H*/
+                                OP(cb, 0xF5): hl.b.l|=0x40; cycles+=4; break; /*SET 6,L*/
+                                OP(cb, 0xF7): af.b.h|=0x40; cycles+=4; break; /*SET 6,A*/
+                                OP(cb, 0xF8): bc.b.h|=0x80; cycles+=4; break; /*SET 7,B*/
+                                OP(cb, 0xF9): bc.b.l|=0x80; cycles+=4; break; /*SET 7,C*/
+                                OP(cb, 0xFA): de.b.h|=0x80; cycles+=4; break; /*SET 7,D*/
+                                OP(cb, 0xFB): de.b.l|=0x80; cycles+=4; break; /*SET 7,E*/
+                                OP(cb, 0xFC): hl.b.h|=0x80; cycles+=4; break; /*SET 7,H*/
+                                OP(cb, 0xFD): hl.b.l|=0x80; cycles+=4; break; /*SET 7,L*/
+                                OP(cb, 0xFF): af.b.h|=0x80; cycles+=4; break; /*SET 7,A*/
+
+                                OP(cb, 0xC6): cycles+=4; temp=z80_readmem(hl.w)|0x01; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*SET 0,(HL)*/
+                                OP(cb, 0xCE): cycles+=4; temp=z80_readmem(hl.w)|0x02; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*SET 1,(HL)*/
+                                OP(cb, 0xD6): cycles+=4; temp=z80_readmem(hl.w)|0x04; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*SET 2,(HL)*/
+                                OP(cb, 0xDE): cycles+=4; temp=z80_readmem(hl.w)|0x08; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*SET 3,(HL)*/
+                                OP(cb, 0xE6): cycles+=4; temp=z80_readmem(hl.w)|0x10; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*SET 4,(HL)*/
+                                OP(cb, 0xEE): cycles+=4; temp=z80_readmem(hl.w)|0x20; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*SET 5,(HL)*/
+                                OP(cb, 0xF6): cycles+=4; temp=z80_readmem(hl.w)|0x40; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*SET 6,(HL)*/
+                                OP(cb, 0xFE): cycles+=4; temp=z80_readmem(hl.w)|0x80; cycles+=4; z80_writemem(hl.w,temp); cycles+=3; break; /*SET 7,(HL)*/
+
+                                default:
+                                        break;
+//                                printf("Bad CB opcode %02X at %04X\n",opcode,pc);
+//                                z80_dumpregs();
+//                                exit(-1);
+                        }
+                        NEXT;
+
+                        OP(main, 0xCC): /*CALL Z,xxxx*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (flags&Z_FLAG)
+                        {
+                                cycles+=4; sp--; z80_writemem(sp,pc>>8);
+                                cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                                pc=addr;
+                                cycles+=3;
+                        }
+                        else
+                           cycles+=3;
+                        NEXT;
+                        OP(main, 0xCD): /*CALL xxxx*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        cycles+=4; sp--; z80_writemem(sp,pc>>8);
+                        cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                        pc=addr;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xCE): /*ADC A,nn*/
+                        cycles+=4; temp=z80_readmem(pc++);
+                        setadc(af.b.h,temp);
+                        af.b.h+=temp+tempc;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xCF): /*RST 8*/
+                        cycles+=5; sp--; z80_writemem(sp,pc>>8);
+                        cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                        pc=0x08;
+                        cycles+=3;
+                        NEXT;
+
+                        OP(main, 0xD0): /*RET NC*/
+                        cycles+=5;
+                        if (!(flags&C_FLAG))
+                        {
+                                pc=z80_readmem(sp); sp++;
+                                cycles+=3; pc|=(z80_readmem(sp)<<8); sp++;
+                                cycles+=3;
+                        }
+                        NEXT;
+                        OP(main, 0xD1): /*POP DE*/
+                        cycles+=4; de.b.l=z80_readmem(sp); sp++;
+                        cycles+=3; de.b.h=z80_readmem(sp); sp++;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xD2): /*JP NC*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (!(flags&C_FLAG))
+                           pc=addr;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xD3): /*OUT (nn),A*/
+                        cycles+=4; addr=z80_readmem(pc++);
+                        cycles+=3; z80out(addr,af.b.h);
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0xD4): /*CALL NC,xxxx*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (!(flags&C_FLAG))
+                        {
+                                cycles+=4; sp--; z80_writemem(sp,pc>>8);
+                                cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                                pc=addr;
+                                cycles+=3;
+                        }
+                        else
+                           cycles+=3;
+                        NEXT;
+                        OP(main, 0xD5): /*PUSH DE*/
+                        cycles+=5; sp--; z80_writemem(sp,de.b.h);
+                        cycles+=3; sp--; z80_writemem(sp,de.b.l);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xD6): /*SUB A,nn*/
+                        cycles+=4; temp=z80_readmem(pc++);
+                        z80_setsub(af.b.h,temp);
+                        af.b.h-=temp;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xD7): /*RST 10*/
+                        cycles+=5; sp--; z80_writemem(sp,pc>>8);
+                        cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                        pc=0x10;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xD8): /*RET C*/
+                        cycles+=5;
+                        if (flags&C_FLAG)
+                        {
+                                pc=z80_readmem(sp); sp++;
+                                cycles+=3; pc|=(z80_readmem(sp)<<8); sp++;
+                                cycles+=3;
+                        }
+                        NEXT;
+                        OP(main, 0xD9): /*EXX*/
+                        addr=bc.w; bc.w=sbc.w; sbc.w=addr;
+                        addr=de.w; de.w=sde.w; sde.w=addr;
+                        addr=hl.w; hl.w=shl.w; shl.w=addr;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0xDA): /*JP C*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (flags&C_FLAG)
+                           pc=addr;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xDB): /*IN A,(n)*/
+                        cycles+=4; temp=z80_readmem(pc++);
+                        cycles+=3; af.b.h=z80in((af.b.h<<8)|temp);
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0xDC): /*CALL C,xxxx*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (flags&C_FLAG)
+                        {
+                                cycles+=4; sp--; z80_writemem(sp,pc>>8);
+                                cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                                pc=addr;
+                                cycles+=3;
+                        }
+                        else
+                           cycles+=3;
+                        NEXT;
+
+                        OP(main, 0xDD): /*More opcodes*/
+                        ir.b.l=((ir.b.l+1)&0x7F)|(ir.b.l&0x80);
+                        cycles+=4;
+                        opcode=z80_readmem(pc++);
+                        DISPATCH(dd, opcode)
+                        {
+                                OP(dd, 0xCD):
+                                pc--;
+//                                cycles+=4;
+                                break;
+                                OP(dd, 0x09): /*ADD IX,BC*/
+                                z80_setadd16(ix.w,bc.w);
+                                ix.w+=bc.w;
+                                cycles+=11;
+                                break;
+                                OP(dd, 0x19): /*ADD IX,DE*/
+                                z80_setadd16(ix.w,de.w);
+                                ix.w+=de.w;
+                                cycles+=11;
+                                break;
+                                OP(dd, 0x21): /*LD IX,nn*/
+                                cycles+=4; ix.b.l=z80_readmem(pc++);
+                                cycles+=3; ix.b.h=z80_readmem(pc++);
+                                cycles+=3;
+                                break;
+                                OP(dd, 0x22): /*LD (nn),IX*/
+                                cycles+=4; addr=z80_readmem(pc);
+                                cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                                cycles+=3; z80_writemem(addr,ix.b.l);
+                                cycles+=3; z80_writemem(addr+1,ix.b.h);
+                                cycles+=3;
+                                break;
+                                OP(dd, 0x23): /*INC IX*/
+                                ix.w++;
+                                cycles+=6;
+                                break;
+                                OP(dd, 0x24): /*INC IXh*/
+                                setinc(ix.b.h);
+                                ix.b.h++;
+                                cycles+=4;
+                                break;
+                                OP(dd, 0x25): /*DEC IXh*/
+                                setdec(ix.b.h);
+                                ix.b.h--;
+                                cycles+=4;
+                                break;
+                                OP(dd, 0x26): /*LD IXh,nn*/
+                                cycles+=4; ix.b.h=z80_readmem(pc++);
+                                cycles+=3;
+                                break;
+                                OP(dd, 0x29): /*ADD IX,IX*/
+                                z80_setadd16(ix.w,ix.w);
+                                ix.w+=ix.w;
+                                cycles+=11;
+                                break;
+                                OP(dd, 0x2A): /*LD IX,(nn)*/
+                                cycles+=4; addr=z80_readmem(pc);
+                                cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                                cycles+=3; ix.b.l=z80_readmem(addr);
+                                cycles+=3; ix.b.h=z80_readmem(addr+1);
+                                cycles+=3;
+                                break;
+                                OP(dd, 0x2B): /*DEC IX*/
+                                ix.w--;
+                                cycles+=6;
+                                break;
+                                OP(dd, 0x2C): /*INC IXl*/
+                                setinc(ix.b.l);
+                                ix.b.l++;
+                                cycles+=4;
+                                break;
+                                OP(dd, 0x2D): /*DEC IXl*/
+                                setdec(ix.b.l);
+                                ix.b.l--;
+                                cycles+=4;
+                                break;
+                                OP(dd, 0x2E): /*LD IXl,nn*/
+                                cycles+=4; ix.b.l=z80_readmem(pc++);
+                                cycles+=3;
+                                break;
+                                OP(dd, 0x34): /*INC (IX+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                addr+=ix.w;
+                                cycles+=3; temp=z80_readmem(addr);
+                                setinc(temp);
+                                cycles+=5; z80_writemem(addr,temp+1);
+                                cycles+=7;
+                                break;
+                                OP(dd, 0x35): /*DEC (IX+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                addr+=ix.w;
+                                cycles+=3; temp=z80_readmem(addr);
+                                setdec(temp);
+                                cycles+=5; z80_writemem(addr,temp-1);
+                                cycles+=7;
+                                break;
+                                OP(dd, 0x36): /*LD (IX+nn),nn*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(pc++);
+                                cycles+=5; z80_writemem(ix.w+addr,temp);
+                                cycles+=3;
+                                break;
+                                OP(dd, 0x39): /*ADD IX,SP*/
+                                z80_setadd16(ix.w,sp);
+                                ix.w+=sp;
+                                cycles+=11;
+                                break;
+
+                                OP(dd, 0x46): /*LD B,(IX+nn)*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                intreg=(ix.w+addr)>>8;
+                                cycles+=7; bc.b.h=z80_readmem(ix.w+addr);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x4E): /*LD C,(IX+nn)*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                intreg=(ix.w+addr)>>8;
+                                cycles+=7; bc.b.l=z80_readmem(ix.w+addr);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x56): /*LD D,(IX+nn)*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                intreg=(ix.w+addr)>>8;
+                                cycles+=7; de.b.h=z80_readmem(ix.w+addr);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x44): bc.b.h=ix.b.h; cycles+=3; break; /*LD B,IXh*/
+                                OP(dd, 0x45): bc.b.h=ix.b.l; cycles+=3; break; /*LD B,IXl*/
+                                OP(dd, 0x54): de.b.h=ix.b.h; cycles+=3; break; /*LD D,IXh*/
+                                OP(dd, 0x55): de.b.h=ix.b.l; cycles+=3; break; /*LD D,IXl*/
+                                OP(dd, 0x5C): de.b.l=ix.b.h; cycles+=3; break; /*LD E,IXh*/
+                                OP(dd, 0x5D): de.b.l=ix.b.l; cycles+=3; break; /*LD E,IXl*/
+                                OP(dd, 0x5E): /*LD E,(IX+nn)*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                intreg=(ix.w+addr)>>8;
+                                cycles+=7; de.b.l=z80_readmem(ix.w+addr);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x66): /*LD H,(IX+nn)*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                intreg=(ix.w+addr)>>8;
+                                cycles+=7; hl.b.h=z80_readmem(ix.w+addr);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x6E): /*LD L,(IX+nn)*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                intreg=(ix.w+addr)>>8;
+                                cycles+=7; hl.b.l=z80_readmem(ix.w+addr);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x60): ix.b.h=bc.b.h; cycles+=3; break;  /*LD IXh,B*/
+                                OP(dd, 0x61): ix.b.h=bc.b.l; cycles+=3; break;  /*LD IXh,C*/
+                                OP(dd, 0x62): ix.b.h=de.b.h; cycles+=3; break;  /*LD IXh,D*/
+                                OP(dd, 0x63): ix.b.h=de.b.l; cycles+=3; break;  /*LD IXh,E*/
+                                OP(dd, 0x64): ix.b.h=hl.b.h; cycles+=3; break;  /*LD IXh,H*/
+                                OP(dd, 0x65): ix.b.h=hl.b.l; cycles+=3; break;  /*LD IXh,L*/
+                                OP(dd, 0x67): ix.b.h=af.b.h; cycles+=3; break;  /*LD IXh,A*/
+                                OP(dd, 0x68): ix.b.l=bc.b.h; cycles+=3; break;  /*LD IXl,B*/
+                                OP(dd, 0x69): ix.b.l=bc.b.l; cycles+=3; break;  /*LD IXl,C*/
+                                OP(dd, 0x6A): ix.b.l=de.b.h; cycles+=3; break;  /*LD IXl,D*/
+                                OP(dd, 0x6B): ix.b.l=de.b.l; cycles+=3; break;  /*LD IXl,E*/
+                                OP(dd, 0x6C): ix.b.l=hl.b.h; cycles+=3; break;  /*LD IXl,H*/
+                                OP(dd, 0x6D): ix.b.l=hl.b.l; cycles+=3; break;  /*LD IXl,L*/
+                                OP(dd, 0x6F): ix.b.l=af.b.h; cycles+=3; break;  /*LD IXl,A*/
+                                OP(dd, 0x70): /*LD (IX+nn),B*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; z80_writemem(ix.w+addr,bc.b.h);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x71): /*LD (IX+nn),C*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; z80_writemem(ix.w+addr,bc.b.l);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x72): /*LD (IX+nn),D*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; z80_writemem(ix.w+addr,de.b.h);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x73): /*LD (IX+nn),E*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; z80_writemem(ix.w+addr,de.b.l);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x74): /*LD (IX+nn),H*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; z80_writemem(ix.w+addr,hl.b.h);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x75): /*LD (IX+nn),L*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; z80_writemem(ix.w+addr,hl.b.l);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x77): /*LD (IX+nn),A*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; z80_writemem(ix.w+addr,af.b.h);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x7E): /*LD A,(IX+nn)*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; af.b.h=z80_readmem(ix.w+addr);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x7C): af.b.h=ix.b.h; cycles+=3; break; /*LD A,IXh*/
+                                OP(dd, 0x7D): af.b.h=ix.b.l; cycles+=3; break; /*LD A,IXl*/
+
+                                OP(dd, 0x84): z80_setadd(af.b.h,ix.b.h); af.b.h+=ix.b.h; cycles+=3; break;         /*ADD IXh*/
+                                OP(dd, 0x85): z80_setadd(af.b.h,ix.b.l); af.b.h+=ix.b.l; cycles+=3; break;         /*ADD IXl*/
+                                OP(dd, 0x8C): setadc(af.b.h,ix.b.h); af.b.h+=ix.b.h+tempc; cycles+=3; break;   /*ADC IXh*/
+                                OP(dd, 0x8D): setadc(af.b.h,ix.b.l); af.b.h+=ix.b.l+tempc; cycles+=3; break;   /*ADC IXl*/
+                                OP(dd, 0x94): z80_setsub(af.b.h,ix.b.h); af.b.h-=ix.b.h; cycles+=3; break;         /*SUB IXh*/
+                                OP(dd, 0x95): z80_setsub(af.b.h,ix.b.l); af.b.h-=ix.b.l; cycles+=3; break;         /*SUB IXl*/
+                                OP(dd, 0x9C): setsbc(af.b.h,ix.b.h); af.b.h-=(ix.b.h+tempc); cycles+=3; break; /*SBC IXh*/
+                                OP(dd, 0x9D): setsbc(af.b.h,ix.b.l); af.b.h-=(ix.b.l+tempc); cycles+=3; break; /*SBC IXl*/
+                                OP(dd, 0xA4): setand(af.b.h&ix.b.h); af.b.h&=ix.b.h; cycles+=3; break;         /*AND IXh*/
+                                OP(dd, 0xA5): setand(af.b.h&ix.b.l); af.b.h&=ix.b.l; cycles+=3; break;         /*AND IXl*/
+                                OP(dd, 0xAC): setzn(af.b.h^ix.b.h);  af.b.h^=ix.b.h; cycles+=3; break;         /*XOR IXh*/
+                                OP(dd, 0xAD): setzn(af.b.h^ix.b.l);  af.b.h^=ix.b.l; cycles+=3; break;         /*XOR IXl*/
+                                OP(dd, 0xB4): setzn(af.b.h|ix.b.h);  af.b.h|=ix.b.h; cycles+=3; break;         /*OR  IXh*/
+                                OP(dd, 0xB5): setzn(af.b.h|ix.b.l);  af.b.h|=ix.b.l; cycles+=3; break;         /*OR  IXl*/
+                                OP(dd, 0xBC): setcp(af.b.h,ix.b.h); cycles+=3; break;                          /*CP  IXh*/
+                                OP(dd, 0xBD): setcp(af.b.h,ix.b.l); cycles+=3; break;                          /*CP  IXl*/
+
+                                OP(dd, 0x86): /*ADD (IX+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(ix.w+addr);
+                                z80_setadd(af.b.h,temp);
+                                af.b.h+=temp;
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x8E): /*ADC (IX+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(ix.w+addr);
+                                setadc(af.b.h,temp);
+                                af.b.h+=(temp+tempc);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x96): /*SUB (IX+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(ix.w+addr);
+                                z80_setsub(af.b.h,temp);
+                                af.b.h-=temp;
+                                cycles+=8;
+                                break;
+                                OP(dd, 0x9E): /*SBC (IX+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(ix.w+addr);
+                                setsbc(af.b.h,temp);
+                                af.b.h-=(temp+tempc);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0xA6): /*AND (IX+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(ix.w+addr);
+                                setand(af.b.h);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0xAE): /*XOR (IX+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(ix.w+addr);
+                                setzn(af.b.h);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0xB6): /*OR (IX+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(ix.w+addr);
+                                setzn(af.b.h);
+                                cycles+=8;
+                                break;
+                                OP(dd, 0xBE): /*CP (IX+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(ix.w+addr);
+                                setcp(af.b.h,temp);
+                                cycles+=8;
+                                break;
+
+                                OP(dd, 0xCB): /*More opcodes*/
+                                ir.b.l=((ir.b.l+1)&0x7F)|(ir.b.l&0x80);
+                                cycles+=4; addr=z80_readmem(pc++);
+                                if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; opcode=z80_readmem(pc++);
+                                DISPATCH(ddcb, opcode)
+                                {
+                                        OP(ddcb, 0x06): /*RLC (IX+nn)*/
+                                        cycles+=5; temp=z80_readmem(addr+ix.w);
+                                        tempc=temp&0x80;
+                                        temp<<=1;
+                                        if (tempc) temp|=1;
+                                        setzn(temp);
+                                        if (tempc) flags|=C_FLAG;
+                                        cycles+=4; z80_writemem(addr+ix.w,temp);
+                                        cycles+=3;
+                                        break;
+                                        OP(ddcb, 0x0E): /*RRC (IX+nn)*/
+                                        cycles+=5; temp=z80_readmem(addr+ix.w);
+                                        tempc=temp&1;
+                                        temp>>=1;
+                                        if (tempc) temp|=0x80;
+                                        setzn(temp);
+                                        if (tempc) flags|=C_FLAG;
+                                        cycles+=4; z80_writemem(addr+ix.w,temp);
+                                        cycles+=3;
+                                        break;
+                                        OP(ddcb, 0x16):  /*RL (IX+nn)*/
+                                        cycles+=5; temp=z80_readmem(addr+ix.w);
+                                        addr=temp&0x80;
+                                        temp<<=1;
+                                        if (tempc) temp|=1;
+                                        setzn(temp);
+                                        if (addr) flags|=C_FLAG;
+                                        cycles+=4; z80_writemem(addr+ix.w,temp);
+                                        cycles+=3;
+                                        break;
+                                        OP(ddcb, 0x1E):  /*RR (IX+nn)*/
+                                        cycles+=5; temp=z80_readmem(addr+ix.w);
+                                        addr=temp&1;
+                                        temp>>=1;
+                                        if (tempc) temp|=0x80;
+                                        setzn(temp);
+                                        if (addr) flags|=C_FLAG;
+                                        cycles+=4; z80_writemem(addr+ix.w,temp);
+                                        cycles+=3;
+                                        break;
+                                        OP(ddcb, 0x26):  /*SLA (IX+nn)*/
+                                        cycles+=5; temp=z80_readmem(addr+ix.w);
+                                        tempc=temp&0x80;
+                                        temp<<=1;
+                                        setzn(temp);
+                                        if (tempc) flags|=C_FLAG;
+                                        cycles+=4; z80_writemem(addr+ix.w,temp);
+                                        cycles+=3;
+                                        break;
+                                        OP(ddcb, 0x2E):  /*SRA (IX+nn)*/
+                                        cycles+=5; temp=z80_readmem(addr+ix.w);
+                                        tempc=temp&1;
+                                        temp>>=1;
+                                        if (temp&0x40) temp|=0x80;
+                                        setzn(temp);
+                                        if (tempc) flags|=C_FLAG;
+                                        cycles+=4; z80_writemem(addr+ix.w,temp);
+                                        cycles+=3;
+                                        break;
+                                        OP(ddcb, 0x3E):  /*SRL (IX+nn)*/
+                                        cycles+=5; temp=z80_readmem(addr+ix.w);
+                                        tempc=temp&1;
+                                        temp>>=1;
+                                        setzn(temp);
+                                        if (tempc) flags|=C_FLAG;
+                                        cycles+=4; z80_writemem(addr+ix.w,temp);
+                                        cycles+=3;
+                                        break;
+
+
+                                        OP(ddcb, 0x46): cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&1,ix.w+addr); cycles+=4; break; /*BIT 0,(IX+nn)*/
+                                        OP(ddcb, 0x4E): cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&2,ix.w+addr); cycles+=4; break; /*BIT 1,(IX+nn)*/
+                                        OP(ddcb, 0x56): cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&4,ix.w+addr); cycles+=4; break; /*BIT 2,(IX+nn)*/
+                                        OP(ddcb, 0x5E): cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&8,ix.w+addr); cycles+=4; break; /*BIT 3,(IX+nn)*/
+                                        OP(ddcb, 0x66): cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&0x10,ix.w+addr); cycles+=4; break; /*BIT 4,(IX+nn)*/
+                                        OP(ddcb, 0x6E): cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&0x20,ix.w+addr); cycles+=4; break; /*BIT 5,(IX+nn)*/
+                                        OP(ddcb, 0x76): cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&0x40,ix.w+addr); cycles+=4; break; /*BIT 6,(IX+nn)*/
+                                        OP(ddcb, 0x7E): cycles+=5; temp=z80_readmem(ix.w+addr); setbit2(temp&0x80,ix.w+addr); cycles+=4; break; /*BIT 7,(IX+nn)*/
+
+                                        OP(ddcb, 0x86): cycles+=5; temp=z80_readmem(ix.w+addr)&~1; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;    /*RES 0,(IX+nn)*/
+                                        OP(ddcb, 0x8E): cycles+=5; temp=z80_readmem(ix.w+addr)&~2; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;    /*RES 1,(IX+nn)*/
+                                        OP(ddcb, 0x96): cycles+=5; temp=z80_readmem(ix.w+addr)&~4; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;    /*RES 2,(IX+nn)*/
+                                        OP(ddcb, 0x9E): cycles+=5; temp=z80_readmem(ix.w+addr)&~8; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;    /*RES 3,(IX+nn)*/
+                                        OP(ddcb, 0xA6): cycles+=5; temp=z80_readmem(ix.w+addr)&~0x10; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break; /*RES 4,(IX+nn)*/
+                                        OP(ddcb, 0xAE): cycles+=5; temp=z80_readmem(ix.w+addr)&~0x20; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break; /*RES 5,(IX+nn)*/
+                                        OP(ddcb, 0xB6): cycles+=5; temp=z80_readmem(ix.w+addr)&~0x40; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break; /*RES 6,(IX+nn)*/
+                                        OP(ddcb, 0xBE): cycles+=5; temp=z80_readmem(ix.w+addr)&~0x80; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break; /*RES 7,(IX+nn)*/
+                                        OP(ddcb, 0xC6): cycles+=5; temp=z80_readmem(ix.w+addr)|1; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;     /*SET 0,(IX+nn)*/
+                                        OP(ddcb, 0xCE): cycles+=5; temp=z80_readmem(ix.w+addr)|2; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;     /*SET 1,(IX+nn)*/
+                                        OP(ddcb, 0xD6): cycles+=5; temp=z80_readmem(ix.w+addr)|4; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;     /*SET 2,(IX+nn)*/
+                                        OP(ddcb, 0xDE): cycles+=5; temp=z80_readmem(ix.w+addr)|8; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;     /*SET 3,(IX+nn)*/
+                                        OP(ddcb, 0xE6): cycles+=5; temp=z80_readmem(ix.w+addr)|0x10; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;  /*SET 4,(IX+nn)*/
+                                        OP(ddcb, 0xEE): cycles+=5; temp=z80_readmem(ix.w+addr)|0x20; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;  /*SET 5,(IX+nn)*/
+                                        OP(ddcb, 0xF6): cycles+=5; temp=z80_readmem(ix.w+addr)|0x40; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;  /*SET 6,(IX+nn)*/
+                                        OP(ddcb, 0xFE): cycles+=5; temp=z80_readmem(ix.w+addr)|0x80; cycles+=4; z80_writemem(ix.w+addr,temp); cycles+=3; break;  /*SET 7,(IX+nn)*/
+
+                                        OP_DEFAULT(ddcb):
+                                        break;
+//                                        printf("Bad DD CB opcode %02X at %04X\n",opcode,pc);
+//                                        z80_dumpregs();
+//                                        exit(-1);
+                                }
+                                break;
+
+                                OP(dd, 0xE1): /*POP IX*/
+                                cycles+=4; ix.b.l=z80_readmem(sp); sp++;
+                                cycles+=3; ix.b.h=z80_readmem(sp); sp++;
+                                cycles+=3;
+                                break;
+                                OP(dd, 0xE3): /*EX (SP),IX*/
+                                cycles+=4; addr=z80_readmem(sp);
+                                cycles+=3; addr|=(z80_readmem(sp+1)<<8);
+                                cycles+=4; z80_writemem(sp,ix.b.l);
+                                cycles+=3; z80_writemem(sp+1,ix.b.h);
+                                ix.w=addr;
+                                cycles+=5;
+                                break;
+                                OP(dd, 0xE5): /*PUSH IX*/
+                                cycles+=5; sp--; z80_writemem(sp,ix.b.h);
+                                cycles+=3; sp--; z80_writemem(sp,ix.b.l);
+                                cycles+=3;
+                                break;
+                                OP(dd, 0xE9): /*JP (IX)*/
+                                pc=ix.w;
+                                cycles+=4;
+                                break;
+
+                                OP(dd, 0xF9): /*LD SP,IX*/
+                                sp=ix.w;
+                                cycles+=6;
+                                break;
+
+                                OP_DEFAULT(dd):
+                                break;
+//                                printf("Bad DD opcode %02X at %04X\n",opcode,pc);
+//                                z80_dumpregs();
+//                                exit(-1);
+                        }
+                        NEXT;
+
+                        OP(main, 0xDE): /*SBC A,nn*/
+                        cycles+=4; temp=z80_readmem(pc++);
+                        setsbc(af.b.h,temp);
+                        af.b.h-=(temp+tempc);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xDF): /*RST 18*/
+                        cycles+=5; sp--; z80_writemem(sp,pc>>8);
+                        cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                        pc=0x18;
+                        cycles+=3;
+                        NEXT;
+
+                        OP(main, 0xE0): /*RET PO*/
+                        cycles+=5;
+                        if (!(flags&V_FLAG))
+                        {
+                                pc=z80_readmem(sp); sp++;
+                                cycles+=3; pc|=(z80_readmem(sp)<<8); sp++;
+                                cycles+=3;
+                        }
+                        NEXT;
+                        OP(main, 0xE1): /*POP HL*/
+                        cycles+=4; hl.b.l=z80_readmem(sp); sp++;
+                        cycles+=3; hl.b.h=z80_readmem(sp); sp++;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xE2): /*JP PO*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (!(flags&V_FLAG))
+                           pc=addr;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xE3): /*EX (SP),HL*/
+                        cycles+=4; addr=z80_readmem(sp);
+                        cycles+=3; addr|=(z80_readmem(sp+1)<<8);
+                        cycles+=4; z80_writemem(sp,hl.b.l);
+                        cycles+=3; z80_writemem(sp+1,hl.b.h);
+                        hl.w=addr;
+                        cycles+=5;
+                        NEXT;
+                        OP(main, 0xE4): /*CALL PO,xxxx*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (!(flags&V_FLAG))
+                        {
+                                cycles+=4; sp--; z80_writemem(sp,pc>>8);
+                                cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                                pc=addr;
+                                cycles+=3;
+                        }
+                        else
+                           cycles+=3;
+                        NEXT;
+                        OP(main, 0xE5): /*PUSH HL*/
+                        cycles+=5; sp--; z80_writemem(sp,hl.b.h);
+                        cycles+=3; sp--; z80_writemem(sp,hl.b.l);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xE6): /*AND nn*/
+                        cycles+=4; af.b.h&=z80_readmem(pc++);
+                        setand(af.b.h);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xE7): /*RST 20*/
+                        cycles+=5; sp--; z80_writemem(sp,pc>>8);
+                        cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                        pc=0x20;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xE8): /*RET PE*/
+                        cycles+=5;
+                        if (flags&V_FLAG)
+                        {
+                                pc=z80_readmem(sp); sp++;
+                                cycles+=3; pc|=(z80_readmem(sp)<<8); sp++;
+                                cycles+=3;
+                        }
+                        NEXT;
+                        OP(main, 0xE9): /*JP (HL)*/
+                        pc=hl.w;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0xEA): /*JP PE*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (flags&V_FLAG)
+                           pc=addr;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xEB): /*EX DE,HL*/
+                        addr=de.w; de.w=hl.w; hl.w=addr;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0xEC): /*CALL PE,xxxx*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (flags&V_FLAG)
+                        {
+                                cycles+=4; sp--; z80_writemem(sp,pc>>8);
+                                cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                                pc=addr;
+                                cycles+=3;
+                        }
+                        else
+                           cycles+=3;
+                        NEXT;
+
+                        OP(main, 0xED): /*More opcodes*/
+                        ir.b.l=((ir.b.l+1)&0x7F)|(ir.b.l&0x80);
+                        cycles+=4;
+                        opcode=z80_readmem(pc++);
+                        DISPATCH(ed, opcode)
+                        {
+                                OP(ed, 0x40): /*IN B,(C)*/
+                                cycles+=4; bc.b.h=z80in(bc.w);
+                                setzn(bc.b.h);
+                                cycles+=4;
+                                break;
+                                OP(ed, 0x42): /*SBC HL,BC*/
+                                setsbc16(hl.w,bc.w);
+                                hl.w-=(bc.w+tempc);
+                                cycles+=11;
+                                break;
+                                OP(ed, 0x43): /*LD (nn),BC*/
+                                cycles+=4; addr=z80_readmem(pc);
+                                cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                                cycles+=3; z80_writemem(addr,bc.b.l);
+                                cycles+=3; z80_writemem(addr+1,bc.b.h);
+                                cycles+=3;
+                                break;
+                                OP(ed, 0x44): /*NEG*/
+                                z80_setsub(0,af.b.h);
+                                af.b.h=0-af.b.h;
+                                cycles+=4;
+                                break;
+                                OP(ed, 0x45): /*RETN*/
+                                output=0;
+                                iff1=iff2;
+                                cycles+=4; pc=z80_readmem(sp); sp++;
+                                cycles+=3; pc|=(z80_readmem(sp)<<8); sp++;
+                                cycles+=3;
+                                break;
+                                OP(ed, 0x47): /*LD I,A*/
+                                ir.b.h=af.b.h;
+                                log_debug("I now %02X %04X\n",ir.b.h,ir.w);
+                                cycles+=5;
+                                break;
+                                OP(ed, 0x4A): /*ADC HL,BC*/
+                                setadc16(hl.w,bc.w);
+                                hl.w+=(bc.w+tempc);
+                                cycles+=11;
+                                break;
+                                OP(ed, 0x4B): /*LD BC,(nn)*/
+                                cycles+=4; addr=z80_readmem(pc);
+                                cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                                cycles+=3; bc.b.l=z80_readmem(addr);
+                                cycles+=3; bc.b.h=z80_readmem(addr+1);
+                                cycles+=3;
+                                break;
+                                OP(ed, 0x4D): /*RETI*/
+                                cycles+=4; pc=z80_readmem(sp); sp++;
+                                cycles+=3; pc|=(z80_readmem(sp)<<8); sp++;
+                                cycles+=3;
+                                break;
+                                OP(ed, 0x4F): /*LD R,A*/
+                                ir.b.l=af.b.h;
+                                cycles+=5;
+                                break;
+                                OP(ed, 0x50): /*IN D,(C)*/
+                                cycles+=4; de.b.h=z80in(bc.w);
+                                setzn(de.b.h);
+                                cycles+=4;
+                                break;
+                                OP(ed, 0x51): /*OUT (C),D*/
+                                cycles+=4; z80out(bc.w,de.b.h);
+                                cycles+=4;
+                                break;
+                                OP(ed, 0x52): /*SBC HL,DE*/
+                                setsbc16(hl.w,de.w);
+                                hl.w-=(de.w+tempc);
+                                cycles+=11;
+                                break;
+                                OP(ed, 0x53): /*LD (nn),DE*/
+                                cycles+=4; addr=z80_readmem(pc);
+                                cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                                cycles+=3; z80_writemem(addr,de.b.l);
+                                cycles+=3; z80_writemem(addr+1,de.b.h);
+                                cycles+=3;
+                                break;
+                                OP(ed, 0x56): /*IM 1*/
+                                im=1;
+                                cycles+=4;
+                                break;
+                                OP(ed, 0x57): /*LD A,I*/
+                                af.b.h=ir.b.h;
+                                cycles+=5;
+                                break;
+                                OP(ed, 0x58): /*IN E,(C)*/
+                                cycles+=4; de.b.l=z80in(bc.w);
+                                setzn(de.b.l);
+                                cycles+=4;
+                                break;
+                                OP(ed, 0x59): /*OUT (C),E*/
+                                cycles+=4; z80out(bc.w,de.b.l);
+                                cycles+=4;
+                                break;
+                                OP(ed, 0x5A): /*ADC HL,DE*/
+                                setadc16(hl.w,de.w);
+                                hl.w+=(de.w+tempc);
+                                cycles+=11;
+                                break;
+                                OP(ed, 0x5B): /*LD DE,(nn)*/
+                                cycles+=4; addr=z80_readmem(pc);
+                                cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                                cycles+=3; de.b.l=z80_readmem(addr);
+                                cycles+=3; de.b.h=z80_readmem(addr+1);
+                                cycles+=3;
+                                break;
+                                OP(ed, 0x5E): /*IM 2*/
+//                                printf("IM 2\n");
+                                im=2;
+                                cycles+=4;
+                                break;
+                                OP(ed, 0x5F): /*LD A,R*/
+                                af.b.h=ir.b.l;
+                                flags&=C_FLAG;
+                                flags|=(af.b.h&0xA8);
+                                if (!af.b.h) flags|=Z_FLAG;
+                                if (iff2 && !enterint) flags|=V_FLAG;
+                                cycles+=5;
+                                break;
+                                OP(ed, 0x60): /*IN H,(C)*/
+                                cycles+=4; hl.b.h=z80in(bc.w);
+                                setzn(hl.b.h);
+                                cycles+=4;
+                                break;
+                                OP(ed, 0x61): /*OUT (C),H*/
+                                cycles+=4; z80out(bc.w,hl.b.h);
+                                cycles+=4;
+                                break;
+                                OP(ed, 0x62): /*SBC HL,HL*/
+                                setsbc16(hl.w,hl.w);
+                                hl.w-=(hl.w+tempc);
+                                cycles+=11;
+                                break;
+                                OP(ed, 0x67): /*RRD*/
+                                cycles+=4; addr=z80_readmem(hl.w)|((af.b.h&0xF)<<8);
+                                addr=(addr>>4)|((addr<<8)&0xF00);
+                                cycles+=3; z80_writemem(hl.w,addr&0xFF);
+                                af.b.h=(af.b.h&0xF0)|(addr>>8);
+                                setznc(af.b.h);
+                                cycles+=7;
+                                break;
+                                OP(ed, 0x69): /*OUT (C),L*/
+                                cycles+=4; z80out(bc.w,hl.b.l);
+                                cycles+=4;
+                                break;
+                                OP(ed, 0x6A): /*ADC HL,HL*/
+                                setadc16(hl.w,hl.w);
+                                hl.w+=(hl.w+tempc);
+                                cycles+=11;
+                                break;
+                                OP(ed, 0x6F): /*RLD*/
+                                cycles+=4; addr=z80_readmem(hl.w)|((af.b.h&0xF)<<8);
+                                addr=((addr<<4)&0xFF0)|(addr>>8);
+                                cycles+=3; z80_writemem(hl.w,addr&0xFF);
+                                af.b.h=(af.b.h&0xF0)|(addr>>8);
+                                setznc(af.b.h);
+                                cycles+=7;
+                                break;
+                                OP(ed, 0x72): /*SBC HL,SP*/
+                                setsbc16(hl.w,sp);
+                                hl.w-=(sp+tempc);
+                                cycles+=11;
+                                break;
+                                OP(ed, 0x73): /*LD (nn),SP*/
+                                cycles+=4; addr=z80_readmem(pc);
+                                cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                                cycles+=3; z80_writemem(addr,sp);
+                                cycles+=3; z80_writemem(addr+1,sp>>8);
+                                cycles+=3;
+                                break;
+                                OP(ed, 0x78): /*IN A,(C)*/
+                                cycles+=4; af.b.h=z80in(bc.w);
+                                setzn(af.b.h);
+                                cycles+=4;
+                                break;
+                                OP(ed, 0x79): /*OUT (C),A*/
+                                cycles+=4; z80out(bc.w,af.b.h);
+                                cycles+=4;
+                                break;
+                                OP(ed, 0x7A): /*ADC HL,SP*/
+                                setadc16(hl.w,sp);
+                                hl.w+=(sp+tempc);
+                                cycles+=11;
+                                break;
+                                OP(ed, 0x7B): /*LD SP,(nn)*/
+                                cycles+=4; addr=z80_readmem(pc);
+                                cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                                cycles+=3; sp=z80_readmem(addr);
+                                cycles+=3; sp|=(z80_readmem(addr+1)<<8);
+                                cycles+=3;
+                                break;
+                                OP(ed, 0xA0): /*LDI*/
+                                cycles+=4; temp=z80_readmem(hl.w++);
+                                cycles+=3; z80_writemem(de.w,temp); de.w++;
+                                bc.w--;
+                                flags&=~(H_FLAG|S_FLAG|V_FLAG);
+                                if (bc.w) flags|=V_FLAG;
+                                cycles+=5;
+                                break;
+                                OP(ed, 0xA1): /*CPI*/
+                                cycles+=4; temp=z80_readmem(hl.w++);
+                                setcpED(af.b.h,temp);
+                                bc.w--;
+                                if (bc.w) flags|=V_FLAG;
+                                else      flags&=~V_FLAG;
+                                cycles+=8;
+                                break;
+                                OP(ed, 0xA2): /*INI*/
+                                cycles+=5; temp=z80in(bc.w); //z80_readmem(hl.w++);
+                                cycles+=3; z80_writemem(hl.w++,temp);
+                                flags|=N_FLAG;
+                                bc.b.h--;
+                                if (!bc.b.h) flags|=Z_FLAG;
+                                else         flags&=~Z_FLAG;
+                                flags|=S_FLAG;
+                                cycles+=4;
+                                break;
+                                OP(ed, 0xA3): /*OUTI*/
+                                cycles+=5; temp=z80_readmem(hl.w++);
+                                cycles+=3; z80out(bc.w,temp);
+                                bc.b.h--;
+                                if (!bc.b.h) flags|=Z_FLAG;
+                                else         flags&=~Z_FLAG;
+                                flags|=S_FLAG;
+                                cycles+=4;
+                                break;
+                                OP(ed, 0xA8): /*LDD*/
+                                cycles+=4; temp=z80_readmem(hl.w--);
+                                cycles+=3; z80_writemem(de.w,temp); de.w--;
+                                bc.w--;
+                                flags&=~(H_FLAG|S_FLAG|V_FLAG);
+                                if (bc.w) flags|=V_FLAG;
+                                cycles+=5;
+                                break;
+                                OP(ed, 0xAB): /*OUTD*/
+                                cycles+=5; temp=z80_readmem(hl.w--);
+                                cycles+=3; z80out(bc.w,temp);
+                                bc.b.h--;
+                                if (!bc.b.h) flags|=Z_FLAG;
+                                else         flags&=~Z_FLAG;
+                                flags|=S_FLAG;
+                                cycles+=4;
+                                break;
+                                OP(ed, 0xB0): /*LDIR*/
+                                cycles+=4; temp=z80_readmem(hl.w++);
+                                cycles+=3; z80_writemem(de.w,temp); de.w++;
+                                bc.w--;
+                                if (bc.w) { pc-=2; cycles+=5; }
+                                flags&=~(H_FLAG|S_FLAG|V_FLAG);
+                                cycles+=5;
+                                break;
+                                OP(ed, 0xB1): /*CPIR*/
+                                cycles+=4; temp=z80_readmem(hl.w++);
+                                bc.w--;
+                                setcpED(af.b.h,temp);
+                                if (bc.w && (af.b.h!=temp))
+                                {
+                                        pc-=2;
+                                        cycles+=13;
+                                        flags&=~V_FLAG;
+                                }
+                                else
+                                {
+                                        flags|=V_FLAG;
+                                        cycles+=8;
+                                }
+                                break;
+                                OP(ed, 0xB8): /*LDDR*/
+                                cycles+=4; temp=z80_readmem(hl.w--);
+                                cycles+=3; z80_writemem(de.w,temp); de.w--;
+                                bc.w--;
+                                if (bc.w) { pc-=2; cycles+=5; }
+                                flags&=~(H_FLAG|S_FLAG|V_FLAG);
+                                cycles+=5;
+                                break;
+                                OP(ed, 0xB9): /*CPDR*/
+                                cycles+=4; temp=z80_readmem(hl.w--);
+                                bc.w--;
+                                setcpED(af.b.h,temp);
+                                if (bc.w && (af.b.h!=temp))
+                                {
+                                        pc-=2;
+                                        cycles+=13;
+                                        flags&=~V_FLAG;
+                                }
+                                else
+                                {
+                                        flags|=V_FLAG;
+                                        cycles+=8;
+                                }
+                                break;
+
+                                OP_DEFAULT(ed):
+                                break;
+//                                printf("Bad ED opcode %02X at %04X\n",opcode,pc);
+//                                z80_dumpregs();
+//                                exit(-1);
+                        }
+                        NEXT;
+
+                        OP(main, 0xEE): /*XOR nn*/
+                        cycles+=4; af.b.h^=z80_readmem(pc++);
+                        flags&=~3;
+                        setzn(af.b.h);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xEF): /*RST 28*/
+                        cycles+=5; sp--; z80_writemem(sp,pc>>8);
+                        cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                        pc=0x28;
+                        cycles+=3;
+                        NEXT;
+
+                        OP(main, 0xF0): /*RET P*/
+                        cycles+=5;
+                        if (!(flags&N_FLAG))
+                        {
+                                pc=z80_readmem(sp); sp++;
+                                cycles+=3; pc|=(z80_readmem(sp)<<8); sp++;
+                                cycles+=3;
+                        }
+                        NEXT;
+                        OP(main, 0xF1): /*POP AF*/
+                        cycles+=4; flags=z80_readmem(sp); sp++;
+                        cycles+=3; af.b.h=z80_readmem(sp); sp++;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xF2): /*JP P*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (!(flags&N_FLAG))
+                           pc=addr;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xF3): /*DI*/
+                        iff1=iff2=0;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0xF4): /*CALL P,xxxx*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (!(flags&N_FLAG))
+                        {
+                                cycles+=4; sp--; z80_writemem(sp,pc>>8);
+                                cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                                pc=addr;
+                                cycles+=3;
+                        }
+                        else
+                           cycles+=3;
+                        NEXT;
+                        OP(main, 0xF5): /*PUSH AF*/
+                        cycles+=5; sp--; z80_writemem(sp,af.b.h);
+                        cycles+=3; sp--; z80_writemem(sp,flags);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xF6): /*OR nn*/
+                        cycles+=4; af.b.h|=z80_readmem(pc++);
+                        flags&=~3;
+                        setzn(af.b.h);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xF7): /*RST 30*/
+                        cycles+=5; sp--; z80_writemem(sp,pc>>8);
+                        cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                        pc=0x30;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xF8): /*RET M*/
+                        cycles+=5;
+                        if (flags&N_FLAG)
+                        {
+                                pc=z80_readmem(sp); sp++;
+                                cycles+=3; pc|=(z80_readmem(sp)<<8); sp++;
+                                cycles+=3;
+                        }
+                        NEXT;
+                        OP(main, 0xF9): /*LD SP,HL*/
+                        sp=hl.w;
+                        cycles+=6;
+                        NEXT;
+                        OP(main, 0xFA): /*JP M*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (flags&N_FLAG)
+                           pc=addr;
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xFB): /*EI*/
+                        iff1=iff2=1;
+                        cycles+=4;
+                        NEXT;
+                        OP(main, 0xFC): /*CALL M,xxxx*/
+                        cycles+=4; addr=z80_readmem(pc);
+                        cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                        if (flags&N_FLAG)
+                        {
+                                cycles+=4; sp--; z80_writemem(sp,pc>>8);
+                                cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                                pc=addr;
+                                cycles+=3;
+                        }
+                        else
+                           cycles+=3;
+                        NEXT;
+
+                        OP(main, 0xFD): /*More opcodes*/
+                        ir.b.l=((ir.b.l+1)&0x7F)|(ir.b.l&0x80);
+                        cycles+=4;
+                        opcode=z80_readmem(pc++);
+                        DISPATCH(fd, opcode)
+                        {
+                                OP(fd, 0x3A):
+                                pc--;
+                                break;
+
+                                OP(fd, 0x09): /*ADD IY,BC*/
+                                z80_setadd16(iy.w,bc.w);
+                                iy.w+=bc.w;
+                                cycles+=11;
+                                break;
+                                OP(fd, 0x19): /*ADD IY,DE*/
+                                z80_setadd16(iy.w,de.w);
+                                iy.w+=de.w;
+                                cycles+=11;
+                                break;
+                                OP(fd, 0x21): /*LD IY,nn*/
+                                cycles+=4; iy.b.l=z80_readmem(pc++);
+                                cycles+=3; iy.b.h=z80_readmem(pc++);
+                                cycles+=3;
+                                break;
+                                OP(fd, 0x22): /*LD (nn),IY*/
+                                cycles+=4; addr=z80_readmem(pc);
+                                cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                                cycles+=3; z80_writemem(addr,iy.b.l);
+                                cycles+=3; z80_writemem(addr+1,iy.b.h);
+                                cycles+=3;
+                                break;
+                                OP(fd, 0x23): /*INC IY*/
+                                iy.w++;
+                                cycles+=6;
+                                break;
+                                OP(fd, 0x24): /*INC IYh*/
+                                setinc(iy.b.h);
+                                iy.b.h++;
+                                cycles+=4;
+                                break;
+                                OP(fd, 0x25): /*DEC IYh*/
+                                setdec(iy.b.h);
+                                iy.b.h--;
+                                cycles+=4;
+                                break;
+                                OP(fd, 0x26): /*LD IYh,nn*/
+                                cycles+=4; iy.b.h=z80_readmem(pc++);
+                                cycles+=3;
+                                break;
+                                OP(fd, 0x29): /*ADD IY,IY*/
+                                z80_setadd16(iy.w,iy.w);
+                                iy.w+=iy.w;
+                                cycles+=11;
+                                break;
+                                OP(fd, 0x2A): /*LD IY,(nn)*/
+                                cycles+=4; addr=z80_readmem(pc);
+                                cycles+=3; addr|=(z80_readmem(pc+1)<<8); pc+=2;
+                                cycles+=3; iy.b.l=z80_readmem(addr);
+                                cycles+=3; iy.b.h=z80_readmem(addr+1);
+                                cycles+=3;
+                                break;
+                                OP(fd, 0x2B): /*DEC IY*/
+                                iy.w--;
+                                cycles+=6;
+                                break;
+                                OP(fd, 0x2C): /*INC IYl*/
+                                setinc(iy.b.l);
+                                iy.b.l++;
+                                cycles+=4;
+                                break;
+                                OP(fd, 0x2D): /*DEC IYl*/
+                                setdec(iy.b.l);
+                                iy.b.l--;
+                                cycles+=4;
+                                break;
+                                OP(fd, 0x2E): /*LD IYl,nn*/
+                                cycles+=4; iy.b.l=z80_readmem(pc++);
+                                cycles+=3;
+                                break;
+                                OP(fd, 0x34): /*INC (IY+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                addr+=iy.w;
+                                cycles+=3; temp=z80_readmem(addr);
+                                setinc(temp);
+                                cycles+=5; z80_writemem(addr,temp+1);
+                                cycles+=7;
+                                break;
+                                OP(fd, 0x35): /*DEC (IY+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                addr+=iy.w;
+                                cycles+=3; temp=z80_readmem(addr);
+                                setdec(temp);
+                                cycles+=5; z80_writemem(addr,temp-1);
+                                cycles+=7;
+                                break;
+                                OP(fd, 0x36): /*LD (IY+nn),nn*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(pc++);
+                                cycles+=5; z80_writemem(iy.w+addr,temp);
+                                cycles+=3;
+                                break;
+                                OP(fd, 0x39): /*ADD IY,SP*/
+//                                output=1;
+                                z80_setadd16(iy.w,sp);
+                                iy.w+=sp;
+                                cycles+=11;
+                                break;
+
+                                OP(fd, 0x44): bc.b.h=iy.b.h; cycles+=3; break; /*LD B,IYh*/
+                                OP(fd, 0x45): bc.b.h=iy.b.l; cycles+=3; break; /*LD B,IYl*/
+                                OP(fd, 0x4C): bc.b.l=iy.b.h; cycles+=3; break; /*LD C,IYh*/
+                                OP(fd, 0x4D): bc.b.l=iy.b.l; cycles+=3; break; /*LD C,IYl*/
+                                OP(fd, 0x54): de.b.h=iy.b.h; cycles+=3; break; /*LD D,IYh*/
+                                OP(fd, 0x55): de.b.h=iy.b.l; cycles+=3; break; /*LD D,IYl*/
+                                OP(fd, 0x5C): de.b.l=iy.b.h; cycles+=3; break; /*LD E,IYh*/
+                                OP(fd, 0x5D): de.b.l=iy.b.l; cycles+=3; break; /*LD E,IYl*/
+
+                                OP(fd, 0x46): /*LD B,(IY+nn)*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                intreg=(iy.w+addr)>>8;
+                                cycles+=7; bc.b.h=z80_readmem(iy.w+addr);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x4E): /*LD C,(IY+nn)*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                intreg=(iy.w+addr)>>8;
+                                cycles+=7; bc.b.l=z80_readmem(iy.w+addr);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x56): /*LD D,(IY+nn)*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                intreg=(iy.w+addr)>>8;
+                                cycles+=7; de.b.h=z80_readmem(iy.w+addr);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x5E): /*LD E,(IY+nn)*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                intreg=(iy.w+addr)>>8;
+                                cycles+=7; de.b.l=z80_readmem(iy.w+addr);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x66): /*LD H,(IY+nn)*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                intreg=(iy.w+addr)>>8;
+                                cycles+=7; hl.b.h=z80_readmem(iy.w+addr);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x6E): /*LD L,(IY+nn)*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                intreg=(iy.w+addr)>>8;
+                                cycles+=7; hl.b.l=z80_readmem(iy.w+addr);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x60): iy.b.h=bc.b.h; cycles+=3; break;  /*LD IYh,B*/
+                                OP(fd, 0x61): iy.b.h=bc.b.l; cycles+=3; break;  /*LD IYh,C*/
+                                OP(fd, 0x62): iy.b.h=de.b.h; cycles+=3; break;  /*LD IYh,D*/
+                                OP(fd, 0x63): iy.b.h=de.b.l; cycles+=3; break;  /*LD IYh,E*/
+                                OP(fd, 0x64): iy.b.h=hl.b.h; cycles+=3; break;  /*LD IYh,H*/
+                                OP(fd, 0x65): iy.b.h=hl.b.l; cycles+=3; break;  /*LD IYh,L*/
+                                OP(fd, 0x67): iy.b.h=af.b.h; cycles+=3; break;  /*LD IYh,A*/
+                                OP(fd, 0x68): iy.b.l=bc.b.h; cycles+=3; break;  /*LD IYl,B*/
+                                OP(fd, 0x69): iy.b.l=bc.b.l; cycles+=3; break;  /*LD IYl,C*/
+                                OP(fd, 0x6A): iy.b.l=de.b.h; cycles+=3; break;  /*LD IYl,D*/
+                                OP(fd, 0x6B): iy.b.l=de.b.l; cycles+=3; break;  /*LD IYl,E*/
+                                OP(fd, 0x6C): iy.b.l=hl.b.h; cycles+=3; break;  /*LD IYl,H*/
+                                OP(fd, 0x6D): iy.b.l=hl.b.l; cycles+=3; break;  /*LD IYl,L*/
+                                OP(fd, 0x6F): iy.b.l=af.b.h; cycles+=3; break;  /*LD IYl,A*/
+
+                                OP(fd, 0x84): z80_setadd(af.b.h,iy.b.h); af.b.h+=iy.b.h; cycles+=3; break;         /*ADD IYh*/
+                                OP(fd, 0x85): z80_setadd(af.b.h,iy.b.l); af.b.h+=iy.b.l; cycles+=3; break;         /*ADD IYl*/
+                                OP(fd, 0x8C): setadc(af.b.h,iy.b.h); af.b.h+=iy.b.h+tempc; cycles+=3; break;   /*ADC IYh*/
+                                OP(fd, 0x8D): setadc(af.b.h,iy.b.l); af.b.h+=iy.b.l+tempc; cycles+=3; break;   /*ADC IYl*/
+                                OP(fd, 0x94): z80_setsub(af.b.h,iy.b.h); af.b.h-=iy.b.h; cycles+=3; break;         /*SUB IYh*/
+                                OP(fd, 0x95): z80_setsub(af.b.h,iy.b.l); af.b.h-=iy.b.l; cycles+=3; break;         /*SUB IYl*/
+                                OP(fd, 0x9C): setsbc(af.b.h,iy.b.h); af.b.h-=(iy.b.h+tempc); cycles+=3; break; /*SBC IYh*/
+                                OP(fd, 0x9D): setsbc(af.b.h,iy.b.l); af.b.h-=(iy.b.l+tempc); cycles+=3; break; /*SBC IYl*/
+                                OP(fd, 0xA4): setand(af.b.h&iy.b.h); af.b.h&=iy.b.h; cycles+=3; break;         /*AND IYh*/
+                                OP(fd, 0xA5): setand(af.b.h&iy.b.l); af.b.h&=iy.b.l; cycles+=3; break;         /*AND IYl*/
+                                OP(fd, 0xAC): setzn(af.b.h^iy.b.h);  af.b.h^=iy.b.h; cycles+=3; break;         /*XOR IYh*/
+                                OP(fd, 0xAD): setzn(af.b.h^iy.b.l);  af.b.h^=iy.b.l; cycles+=3; break;         /*XOR IYl*/
+                                OP(fd, 0xB4): setzn(af.b.h|iy.b.h);  af.b.h|=iy.b.h; cycles+=3; break;         /*OR  IYh*/
+                                OP(fd, 0xB5): setzn(af.b.h|iy.b.l);  af.b.h|=iy.b.l; cycles+=3; break;         /*OR  IYl*/
+                                OP(fd, 0xBC): setcp(af.b.h,iy.b.h); cycles+=3; break;                          /*CP  IYh*/
+                                OP(fd, 0xBD): setcp(af.b.h,iy.b.l); cycles+=3; break;                          /*CP  IYl*/
+
+                                OP(fd, 0x70): /*LD (IY+nn),B*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; z80_writemem(iy.w+addr,bc.b.h);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x71): /*LD (IY+nn),C*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; z80_writemem(iy.w+addr,bc.b.l);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x72): /*LD (IY+nn),D*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; z80_writemem(iy.w+addr,de.b.h);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x73): /*LD (IY+nn),E*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; z80_writemem(iy.w+addr,de.b.l);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x74): /*LD (IY+nn),H*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; z80_writemem(iy.w+addr,hl.b.h);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x75): /*LD (IY+nn),L*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; z80_writemem(iy.w+addr,hl.b.l);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x77): /*LD (IY+nn),A*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; z80_writemem(iy.w+addr,af.b.h);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x7E): /*LD A,(IY+nn)*/
+                                addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=7; af.b.h=z80_readmem(iy.w+addr);
+                                cycles+=8;
+                                break;
+
+                                OP(fd, 0x7C): af.b.h=iy.b.h; cycles+=3; break; /*LD A,IYh*/
+                                OP(fd, 0x7D): af.b.h=iy.b.l; cycles+=3; break; /*LD A,IYl*/
+
+                                OP(fd, 0x86): /*ADD (IY+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(iy.w+addr);
+                                z80_setadd(af.b.h,temp);
+                                af.b.h+=temp;
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x8E): /*ADC (IY+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(iy.w+addr);
+                                setadc(af.b.h,temp);
+                                af.b.h+=(temp+tempc);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x96): /*SUB (IY+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(iy.w+addr);
+                                z80_setsub(af.b.h,temp);
+                                af.b.h-=temp;
+                                cycles+=8;
+                                break;
+                                OP(fd, 0x9E): /*SBC (IY+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(iy.w+addr);
+                                setsbc(af.b.h,temp);
+                                af.b.h-=(temp+tempc);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0xA6): /*AND (IY+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; af.b.h&=z80_readmem(iy.w+addr);
+                                setand(af.b.h);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0xAE): /*XOR (IY+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; af.b.h^=z80_readmem(iy.w+addr);
+                                setzn(af.b.h);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0xB6): /*OR (IY+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; af.b.h|=z80_readmem(iy.w+addr);
+                                setzn(af.b.h);
+                                cycles+=8;
+                                break;
+                                OP(fd, 0xBE): /*CP (IY+nn)*/
+                                cycles+=4; addr=z80_readmem(pc++); if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; temp=z80_readmem(iy.w+addr);
+                                setcp(af.b.h,temp);
+                                cycles+=8;
+                                break;
+
+                                OP(fd, 0xCB): /*More opcodes*/
+                                ir.b.l=((ir.b.l+1)&0x7F)|(ir.b.l&0x80);
+                                cycles+=4; addr=z80_readmem(pc++);
+                                if (addr&0x80) addr|=0xFF00;
+                                cycles+=3; opcode=z80_readmem(pc++);
+                                DISPATCH(fdcb, opcode)
+                                {
+                                        OP(fdcb, 0x06): /*RLC (IY+nn)*/
+                                        cycles+=5; temp=z80_readmem(addr+iy.w);
+                                        tempc=temp&0x80;
+                                        temp<<=1;
+                                        if (tempc) temp|=1;
+                                        setzn(temp);
+                                        if (tempc) flags|=C_FLAG;
+                                        cycles+=4; z80_writemem(addr+iy.w,temp);
+                                        cycles+=3;
+                                        break;
+                                        OP(fdcb, 0x0E): /*RRC (IY+nn)*/
+                                        cycles+=5; temp=z80_readmem(addr+iy.w);
+                                        tempc=temp&1;
+                                        temp>>=1;
+                                        if (tempc) temp|=0x80;
+                                        setzn(temp);
+                                        if (tempc) flags|=C_FLAG;
+                                        cycles+=4; z80_writemem(addr+iy.w,temp);
+                                        cycles+=3;
+                                        break;
+                                        OP(fdcb, 0x16):  /*RL (IY+nn)*/
+                                        cycles+=5; temp=z80_readmem(addr+iy.w);
+                                        addr=temp&0x80;
+                                        temp<<=1;
+                                        if (tempc) temp|=1;
+                                        setzn(temp);
+                                        if (addr) flags|=C_FLAG;
+                                        cycles+=4; z80_writemem(addr+iy.w,temp);
+                                        cycles+=3;
+                                        break;
+                                        OP(fdcb, 0x1E):  /*RR (IY+nn)*/
+                                        cycles+=5; temp=z80_readmem(addr+iy.w);
+                                        addr=temp&1;
+                                        temp>>=1;
+                                        if (tempc) temp|=0x80;
+                                        setzn(temp);
+                                        if (addr) flags|=C_FLAG;
+                                        cycles+=4; z80_writemem(addr+iy.w,temp);
+                                        cycles+=3;
+                                        break;
+                                        OP(fdcb, 0x2E):  /*SRA (IY+nn)*/
+                                        cycles+=5; temp=z80_readmem(addr+iy.w);
+                                        tempc=temp&1;
+                                        temp>>=1;
+                                        if (temp&0x40) temp|=0x80;
+                                        setzn(temp);
+                                        if (tempc) flags|=C_FLAG;
+                                        cycles+=4; z80_writemem(addr+iy.w,temp);
+                                        cycles+=3;
+                                        break;
+
+                                        OP(fdcb, 0x46): cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&1,iy.w+addr); cycles+=4; break; /*BIT 0,(iy+nn)*/
+                                        OP(fdcb, 0x4E): cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&2,iy.w+addr); cycles+=4; break; /*BIT 1,(iy+nn)*/
+                                        OP(fdcb, 0x56): cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&4,iy.w+addr); cycles+=4; break; /*BIT 2,(iy+nn)*/
+                                        OP(fdcb, 0x5E): cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&8,iy.w+addr); cycles+=4; break; /*BIT 3,(iy+nn)*/
+                                        OP(fdcb, 0x66): cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&0x10,iy.w+addr); cycles+=4; break; /*BIT 4,(iy+nn)*/
+                                        OP(fdcb, 0x6E): cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&0x20,iy.w+addr); cycles+=4; break; /*BIT 5,(iy+nn)*/
+                                        OP(fdcb, 0x76): cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&0x40,iy.w+addr); cycles+=4; break; /*BIT 6,(iy+nn)*/
+                                        OP(fdcb, 0x7E): cycles+=5; temp=z80_readmem(iy.w+addr); setbit2(temp&0x80,iy.w+addr); cycles+=4; break; /*BIT 7,(iy+nn)*/
+
+                                        OP(fdcb, 0x86): cycles+=5; temp=z80_readmem(iy.w+addr)&~1; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;    /*RES 0,(iy+nn)*/
+                                        OP(fdcb, 0x8E): cycles+=5; temp=z80_readmem(iy.w+addr)&~2; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;    /*RES 1,(iy+nn)*/
+                                        OP(fdcb, 0x96): cycles+=5; temp=z80_readmem(iy.w+addr)&~4; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;    /*RES 2,(iy+nn)*/
+                                        OP(fdcb, 0x9E): cycles+=5; temp=z80_readmem(iy.w+addr)&~8; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;    /*RES 3,(iy+nn)*/
+                                        OP(fdcb, 0xA6): cycles+=5; temp=z80_readmem(iy.w+addr)&~0x10; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break; /*RES 4,(iy+nn)*/
+                                        OP(fdcb, 0xAE): cycles+=5; temp=z80_readmem(iy.w+addr)&~0x20; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break; /*RES 5,(iy+nn)*/
+                                        OP(fdcb, 0xB6): cycles+=5; temp=z80_readmem(iy.w+addr)&~0x40; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break; /*RES 6,(iy+nn)*/
+                                        OP(fdcb, 0xBE): cycles+=5; temp=z80_readmem(iy.w+addr)&~0x80; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break; /*RES 7,(iy+nn)*/
+                                        OP(fdcb, 0xC6): cycles+=5; temp=z80_readmem(iy.w+addr)|1; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;     /*SET 0,(iy+nn)*/
+                                        OP(fdcb, 0xCE): cycles+=5; temp=z80_readmem(iy.w+addr)|2; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;     /*SET 1,(iy+nn)*/
+                                        OP(fdcb, 0xD6): cycles+=5; temp=z80_readmem(iy.w+addr)|4; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;     /*SET 2,(iy+nn)*/
+                                        OP(fdcb, 0xDE): cycles+=5; temp=z80_readmem(iy.w+addr)|8; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;     /*SET 3,(iy+nn)*/
+                                        OP(fdcb, 0xE6): cycles+=5; temp=z80_readmem(iy.w+addr)|0x10; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;  /*SET 4,(iy+nn)*/
+                                        OP(fdcb, 0xEE): cycles+=5; temp=z80_readmem(iy.w+addr)|0x20; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;  /*SET 5,(iy+nn)*/
+                                        OP(fdcb, 0xF6): cycles+=5; temp=z80_readmem(iy.w+addr)|0x40; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;  /*SET 6,(iy+nn)*/
+                                        OP(fdcb, 0xFE): cycles+=5; temp=z80_readmem(iy.w+addr)|0x80; cycles+=4; z80_writemem(iy.w+addr,temp); cycles+=3; break;  /*SET 7,(iy+nn)*/
+
+                                        OP_DEFAULT(fdcb):
+                                        break;
+//                                        printf("Bad FD CB opcode %02X at %04X\n",opcode,pc);
+//                                        z80_dumpregs();
+//                                        exit(-1);
+                                }
+                                break;
+
+                                OP(fd, 0xE1): /*POP IY*/
+                                cycles+=4; iy.b.l=z80_readmem(sp); sp++;
+                                cycles+=3; iy.b.h=z80_readmem(sp); sp++;
+                                cycles+=3;
+                                break;
+                                OP(fd, 0xE3): /*EX (SP),IY*/
+                                cycles+=4; addr=z80_readmem(sp);
+                                cycles+=3; addr|=(z80_readmem(sp+1)<<8);
+                                cycles+=4; z80_writemem(sp,iy.b.l);
+                                cycles+=3; z80_writemem(sp+1,iy.b.h);
+                                iy.w=addr;
+                                cycles+=5;
+                                break;
+                                OP(fd, 0xE5): /*PUSH IY*/
+                                cycles+=5; sp--; z80_writemem(sp,iy.b.h);
+                                cycles+=3; sp--; z80_writemem(sp,iy.b.l);
+                                cycles+=3;
+                                break;
+                                OP(fd, 0xE9): /*JP (IY)*/
+                                pc=iy.w;
+                                cycles+=4;
+                                break;
+
+                                OP(fd, 0xF9): /*LD SP,IY*/
+                                sp=iy.w;
+                                cycles+=6;
+                                break;
+
+/*                                case 0x95:
+                                ir.b.l--;
+                                pc--;
+                                cycles+=4;
+                                break;*/
+
+                                OP_DEFAULT(fd):
+                                break;
+//                                printf("Bad FD opcode %02X at %04X\n",opcode,pc);
+//                                z80_dumpregs();
+//                                exit(-1);
+                        }
+                        NEXT;
+
+                        OP(main, 0xFE): /*CP nn*/
+                        cycles+=4; temp=z80_readmem(pc++);
+                        setcp(af.b.h,temp);
+                        cycles+=3;
+                        NEXT;
+                        OP(main, 0xFF): /*RST 38*/
+                        cycles+=5; sp--; z80_writemem(sp,pc>>8);
+                        cycles+=3; sp--; z80_writemem(sp,pc&0xFF);
+                        pc=0x38;
+                        cycles+=3;
+                        NEXT;
+
+                        default:
+                        NEXT;
+//                        printf("Bad opcode %02X at %04X\n",opcode,pc);
+//                        z80_dumpregs();
+//                        z80_mem_dump();
+//                        exit(-1);
+                }
+/*                if (pc==0)
+                {
+                        printf("PC = 0\n");
+                        z80_dumpregs();
+                        exit(-1);
+                }*/
+//                if (ins==200000) { z80_dumpregs(); exit(-1); }
+//                if (pc==0xC3CF) output=1;
+//                if (pc==0x90B7) { z80_dumpregs(); exit(-1); }
+//                if (pc==0x8066) { z80_dumpregs(); exit(-1); }
+//                if (output) ins++;
+                ins++;
+//                if (ins==107000) output=1;
+//                if (ins==108000) output=0;
+//                if (pc==0xC8D7) output=1;
+//                if (pc==0xC8E7) output=0;
+//                if (ins==11329) output=1;
+                if (output) printf("%04X : %04X %04X %04X %04X %04X %04X %04X %04X %02X\n",pc,af.w&0xFF00,bc.w,de.w,hl.w,ix.w,iy.w,sp,ir.w,opcode);
+//                if ((pc<0x37) && !(pc&7)) printf("RST %02X\n",pc);
+//                if (pc==8) { z80_dumpregs(); exit(-1); }
+//                if (pc==0xC3DC) output=1;
+//                if (ins==500) { z80_dumpregs(); exit(-1); }
+                if (enterint)
+                {
+//                        printf("Interrupt at %04X IM %i\n",pc,im);
+                        iff2=iff1;
+                        iff1=0;
+                        sp--; z80_writemem(sp,pc>>8);
+                        sp--; z80_writemem(sp,pc&0xFF);
+                        switch (im)
+                        {
+                                case 0: case 1: pc=0x38; break;
+                                case 2:
+//                                printf("IM2 %04X %02X %02X %02X\n",ir.w,z80_readmem(ir.w|0xFF),z80_readmem(ir.w&~0xFF),z80_readmem((ir.w|0xFF)+1));
+                                pc=z80_readmem(0xFFFE)|(z80_readmem(0xFFFF)<<8);
+//                                pc=z80_readmem(ir.w|0xFF);
+//                                pc|=(z80_readmem((ir.w|0xFF)+1)<<8);
+//                                printf("PC now %04X\n",pc);
+                                cycles+=8;
+                                break;
+                        }
+//                        printf("PC now %04X\n",pc);
+                        z80int=enterint=0;
+                        cycles+=11;
+                }
+                if (tube_irq&2 && !z80_oldnmi)
+                {
+//                        printf("NMI at %04X IM %i\n",pc,im);
+                        iff2=iff1;
+                        iff1=0;
+                        sp--; z80_writemem(sp,pc>>8);
+                        sp--; z80_writemem(sp,pc&0xFF);
+                        pc=0x66;
+                        z80_rom_in = true;
+//                        printf("PC now %04X\n",pc);
+                        z80int=enterint=0;
+                        cycles+=11;
+//                        output=1;
+                }
+                z80_oldnmi=tube_irq&2;
+//                pollula(cycles);
+                tubecycles-=cycles;
+        }
+}
+
+#undef NEXT
+#undef z80_readmem
+#undef z80_writemem
+#undef z80_fetch
+#undef z80_exec